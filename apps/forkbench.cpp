@@ -0,0 +1,90 @@
+// forkbench.cpp - fork / fork+exec latency benchmark
+//
+// Parent pehle apna 1MB buffer dirty karta hai, phir teen cheezein naapta hai:
+//   1. fork + child turant exit         (COW: sirf page tables copy)
+//   2. fork + execve(/TRUE.ELF) + wait  (shell ka asli pattern)
+//   3. fork + child poora buffer likhe  (har page ka copy - purane eager
+//                                        pd_clone jaisa kharcha)
+// Number rdtsc cycles per iteration hain. Purane kernel pe 1 aur 2 bhi
+// lagbhag 3 jitne mehenge the, kyunki fork har present page copy karta tha.
+
+#include "include/userlib.h"
+
+#define BENCH_ITERS 32 // Power of two - 64-bit divide ki jagah shift
+#define BENCH_ITERS_SHIFT 5
+#define BENCH_BUF_SIZE (1024 * 1024)
+
+static char bench_buf[BENCH_BUF_SIZE];
+
+static inline uint64_t bench_rdtsc() {
+  uint32_t lo, hi;
+  asm volatile("rdtsc" : "=a"(lo), "=d"(hi));
+  return ((uint64_t)hi << 32) | lo;
+}
+
+static void dirty_buffer() {
+  for (uint32_t i = 0; i < BENCH_BUF_SIZE; i += 4096)
+    bench_buf[i]++;
+}
+
+static void report(const char *name, uint64_t cycles) {
+  syscall_print("  ");
+  syscall_print(name);
+  print_uint((uint32_t)(cycles >> BENCH_ITERS_SHIFT));
+  syscall_print(" cycles/iter\n");
+}
+
+static uint64_t bench_fork_exit() {
+  int status;
+  uint64_t t1 = bench_rdtsc();
+  for (int i = 0; i < BENCH_ITERS; i++) {
+    int pid = syscall_fork();
+    if (pid == 0)
+      syscall_exit(0);
+    syscall_wait(&status);
+  }
+  return bench_rdtsc() - t1;
+}
+
+static uint64_t bench_fork_exec() {
+  int status;
+  char *argv[2] = {(char *)"/TRUE.ELF", 0};
+  uint64_t t1 = bench_rdtsc();
+  for (int i = 0; i < BENCH_ITERS; i++) {
+    int pid = syscall_fork();
+    if (pid == 0) {
+      syscall_execve(argv[0], argv, 0);
+      syscall_exit(127);
+    }
+    syscall_wait(&status);
+  }
+  return bench_rdtsc() - t1;
+}
+
+static uint64_t bench_fork_dirty() {
+  int status;
+  uint64_t t1 = bench_rdtsc();
+  for (int i = 0; i < BENCH_ITERS; i++) {
+    int pid = syscall_fork();
+    if (pid == 0) {
+      dirty_buffer(); // Har page pe COW break
+      syscall_exit(0);
+    }
+    syscall_wait(&status);
+  }
+  return bench_rdtsc() - t1;
+}
+
+extern "C" void _start() {
+  syscall_print("forkbench: parent RSS ~1MB, ");
+  print_uint(BENCH_ITERS);
+  syscall_print(" iterations each\n");
+
+  dirty_buffer(); // Saare pages present + private
+
+  report("fork+exit:       ", bench_fork_exit());
+  report("fork+exec+wait:  ", bench_fork_exec());
+  report("fork+dirty 1MB:  ", bench_fork_dirty());
+
+  syscall_exit(0);
+}
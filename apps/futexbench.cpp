@@ -0,0 +1,117 @@
+// futexbench.cpp - futex mutex / semaphore contention benchmark
+//
+// Pehle akele process mein lock+unlock ka kharcha naapte hain - koi waiter
+// nahi, to ye sirf user space ka cmpxchg/xchg hai, ek bhi syscall nahi.
+// Phir FB_WORKERS children ek shmat wale segment mein rakhe mutex (aur phir
+// sem_t) ke neeche shared counter FB_ITERS baar badhate hain. Threads abhi
+// nahi hain, isliye fork + shm - futex key physical address hai, to alag
+// processes ke waiters bhi ek hi bucket mein milte hain. Aakhri count
+// FB_WORKERS * FB_ITERS na ho to lock toota hua hai.
+
+#include "include/userlib.h"
+#include "pthread.h"
+#include "semaphore.h"
+
+#define FB_WORKERS 4
+#define FB_ITERS 4096 // Power of two - 64-bit divide ki jagah shift
+#define FB_ITERS_SHIFT 12
+#define FB_SHM_KEY 0x46555458 // "FUTX"
+
+struct fb_shared {
+  pthread_mutex_t mutex;
+  sem_t sem;
+  volatile uint32_t counter;
+};
+
+static inline uint64_t fb_rdtsc() {
+  uint32_t lo, hi;
+  asm volatile("rdtsc" : "=a"(lo), "=d"(hi));
+  return ((uint64_t)hi << 32) | lo;
+}
+
+static void report(const char *name, uint64_t cycles, uint32_t ops) {
+  syscall_print("  ");
+  syscall_print(name);
+  print_uint((uint32_t)(cycles >> FB_ITERS_SHIFT) / (ops >> FB_ITERS_SHIFT));
+  syscall_print(" cycles/op\n");
+}
+
+static void check(struct fb_shared *sh) {
+  syscall_print("  counter ");
+  print_uint(sh->counter);
+  syscall_print(sh->counter == FB_WORKERS * FB_ITERS ? " (ok)\n"
+                                                     : " (LOST UPDATES)\n");
+}
+
+static uint64_t bench_uncontended(struct fb_shared *sh) {
+  uint64_t t1 = fb_rdtsc();
+  for (int i = 0; i < FB_ITERS; i++) {
+    pthread_mutex_lock(&sh->mutex);
+    sh->counter++;
+    pthread_mutex_unlock(&sh->mutex);
+  }
+  return fb_rdtsc() - t1;
+}
+
+// use_sem 0: mutex, 1: binary semaphore
+static uint64_t bench_contended(struct fb_shared *sh, int use_sem) {
+  int status;
+  sh->counter = 0;
+  uint64_t t1 = fb_rdtsc();
+  for (int w = 0; w < FB_WORKERS; w++) {
+    if (syscall_fork() == 0) {
+      for (int i = 0; i < FB_ITERS; i++) {
+        if (use_sem)
+          sem_wait(&sh->sem);
+        else
+          pthread_mutex_lock(&sh->mutex);
+        // Read-modify-write jaan bujh ke lamba - lock ke andar preempt
+        // hone ka mauka, taaki doosre sach mein futex pe soyein
+        uint32_t v = sh->counter;
+        for (volatile int spin = 0; spin < 16; spin++)
+          ;
+        sh->counter = v + 1;
+        if (use_sem)
+          sem_post(&sh->sem);
+        else
+          pthread_mutex_unlock(&sh->mutex);
+      }
+      syscall_exit(0);
+    }
+  }
+  for (int w = 0; w < FB_WORKERS; w++)
+    syscall_wait(&status);
+  return fb_rdtsc() - t1;
+}
+
+extern "C" void _start() {
+  int shmid = syscall_shmget(FB_SHM_KEY, sizeof(struct fb_shared), 0);
+  struct fb_shared *sh =
+      shmid < 0 ? 0 : (struct fb_shared *)syscall_shmat(shmid);
+  if (!sh) {
+    syscall_print("futexbench: shm segment nahi mila\n");
+    syscall_exit(1);
+  }
+  pthread_mutex_init(&sh->mutex, 0);
+  sem_init(&sh->sem, 1, 1);
+  sh->counter = 0;
+
+  syscall_print("futexbench: ");
+  print_uint(FB_WORKERS);
+  syscall_print(" workers x ");
+  print_uint(FB_ITERS);
+  syscall_print(" iters\n");
+
+  report("mutex, uncontended:   ", bench_uncontended(sh), FB_ITERS);
+
+  report("mutex, contended:     ", bench_contended(sh, 0),
+         FB_WORKERS * FB_ITERS);
+  check(sh);
+
+  report("semaphore, contended: ", bench_contended(sh, 1),
+         FB_WORKERS * FB_ITERS);
+  check(sh);
+
+  syscall_shmdt(sh);
+  syscall_exit(0);
+}
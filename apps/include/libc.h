@@ -553,9 +553,12 @@ struct tm {
 
 /* Time stubs */
 static inline time_t time(time_t *t) {
+  struct timespec ts;
+  if (syscall_clock_gettime(CLOCK_REALTIME_COARSE, &ts) < 0)
+    ts.tv_sec = 0;
   if (t)
-    *t = 0;
-  return 0;
+    *t = ts.tv_sec;
+  return ts.tv_sec;
 }
 
 static inline struct tm *localtime(const time_t *timer) {
@@ -7,6 +7,7 @@
 #define _SYSCALL_H
 
 #include "types.h"
+#include "vdso.h"
 #include <stdint.h>
 
 /* Syscall numbers */
@@ -161,6 +162,11 @@
 #define SYS_MSYNC 142
 #define SYS_MLOCK 143
 #define SYS_SYSCONF 144
+#define SYS_PMM_STATS 145
+#define SYS_VM_STATS 146
+#define SYS_SLAB_STATS 147
+#define SYS_SCHED_SETATTR 148
+#define SYS_SCHED_SETSCHEDULER 149
 
 // Graphics / Framebuffer (Added for TextView Contract)
 #define SYS_GET_FRAMEBUFFER 150
@@ -169,6 +175,17 @@
 #define SYS_FB_SWAP 153
 #define SYS_PTY_CREATE 154
 #define SYS_NET_PING 155
+#define SYS_SCHED_SETPARAM 160
+#define SYS_FUTEX 161
+#define SYS_LOCK_STATS 162
+#define SYS_CPU_INFO 163
+#define SYS_URING_SETUP 164
+#define SYS_URING_ENTER 165
+
+/* futex ops */
+#define FUTEX_WAIT 0
+#define FUTEX_WAKE 1
+#define FUTEX_REQUEUE 3
 
 #define AF_UNIX 1
 #define SOCK_STREAM 1
@@ -237,13 +254,115 @@ struct meminfo {
   uint32_t used;
 };
 
+/* Physical buddy allocator stats, one per zone (DMA, Normal) */
+#define PMM_MAX_ORDER 10
+struct pmm_zone_stats {
+  uint32_t start;
+  uint32_t end;
+  uint32_t free_blocks;              /* free 4KB frames */
+  uint32_t nr_free[PMM_MAX_ORDER + 1]; /* free buddy blocks per order */
+};
+
+/* Lazy anonymous memory counters (system wide) */
+struct vm_stats {
+  uint32_t zero_page_hits; /* read faults served by the shared zero page */
+  uint32_t anon_pages;     /* anonymous pages actually materialized */
+  uint32_t cow_copies;     /* COW breaks that copied a shared frame */
+};
+
+/* Per-cache slab allocator stats (kernel kmem_cache_stats_t) */
+#define SLAB_NAME_LEN 24
+#define SLAB_MAX_CACHES 32
+struct slab_stats {
+  char name[SLAB_NAME_LEN];
+  uint32_t object_size;
+  uint32_t objs_per_slab;
+  uint32_t active_objs; /* currently allocated objects */
+  uint32_t total_objs;  /* capacity of all slabs */
+  uint32_t slabs;
+  uint32_t empty_slabs;
+  uint32_t hits;      /* allocs served from an existing slab */
+  uint32_t misses;    /* allocs that needed a fresh slab page */
+  uint32_t frees;
+  uint32_t reclaimed; /* slab pages returned to the heap */
+};
+
+/* Per-lock kernel spinlock stats (kernel spinlock_stats_t) */
+#define LOCK_NAME_LEN 24
+#define LOCK_MAX_LOCKS 64
+struct lock_stats {
+  char name[LOCK_NAME_LEN];
+  uint32_t acquisitions;
+  uint32_t contended;  /* acquisitions that found the lock held */
+  uint64_t hold_max;   /* longest hold, TSC cycles */
+  uint64_t hold_total; /* sum of all holds, TSC cycles */
+};
+
+/* Per-CPU scheduler stats (kernel cpu_info_t) */
+#define CPU_INFO_MAX 8
+struct cpu_info {
+  uint32_t cpu;
+  uint32_t apic_id;
+  uint32_t online;
+  uint32_t nr_running;     /* queued + running tasks, idle excluded */
+  uint32_t nr_switches;
+  uint32_t nr_migrations;  /* tasks this CPU stole from others */
+  uint32_t nr_ipi_resched;
+  uint32_t nr_ipi_tlb;
+  uint64_t busy_ns;
+  uint64_t idle_ns;
+};
+
+/* Async ring geometry from SYS_URING_SETUP (kernel uring_params_t) */
+struct uring_params {
+  uint32_t sq_entries;
+  uint32_t cq_entries;
+  uint32_t ring_addr; /* Region base, offsets below are from here */
+  uint32_t ring_size;
+  uint32_t sq_off;
+  uint32_t cq_off;
+  uint32_t sqes_off;
+  uint32_t cqes_off;
+};
+
 /* Process info structure */
 struct procinfo {
   uint32_t pid;
   uint32_t ppid;
   uint32_t state;
   char name[64];
+  uint32_t rss_pages; /* resident 4KB pages */
+  uint32_t vm_pages;  /* mapped address space in 4KB pages */
+  uint32_t sched_class; /* SCHED_CLASS_PRIO / SCHED_CLASS_FAIR */
+  int32_t nice;
+  int32_t priority;
+  uint32_t runtime_ms;  /* total CPU time */
+  uint32_t wait_ms;     /* time spent runnable but not running */
+  uint32_t nr_switches; /* times the task was switched in */
+  uint32_t vruntime_ms; /* fair class virtual runtime */
+  int32_t rt_priority;  /* SCHED_FIFO/SCHED_RR priority, else 0 */
+  uint32_t wakeup_lat_us;     /* last wakeup-to-run delay */
+  uint32_t wakeup_lat_max_us; /* worst wakeup-to-run delay */
+};
+
+/* Scheduling classes for syscall_sched_setattr */
+#define SCHED_CLASS_PRIO 0 /* strict priority, fixed time slice */
+#define SCHED_CLASS_FAIR 1 /* vruntime fair share, weighted by nice */
+#define SCHED_CLASS_FIFO 2 /* real-time, runs until it blocks or yields */
+#define SCHED_CLASS_RR 3   /* real-time, round robin among equals */
+#define SCHED_CLASS_IDLE 4 /* idle task (pid 0), runs when nothing else can */
+
+/* POSIX policies for syscall_sched_setscheduler */
+#define SCHED_OTHER 0
+#define SCHED_FIFO 1
+#define SCHED_RR 2
+
+#ifndef _STRUCT_SCHED_PARAM
+#define _STRUCT_SCHED_PARAM /* pthread.h defines it too */
+struct sched_param {
+  int sched_priority; /* 1..99 for SCHED_FIFO/SCHED_RR, 0 for SCHED_OTHER */
 };
+#endif
 
 /* RTC time structure */
 struct rtc_time {
@@ -255,16 +374,73 @@ struct rtc_time {
   uint8_t year;
 };
 
+/*
+ * Fast system calls: SYSENTER/SYSEXIT when the CPU has SEP, int $0x80
+ * otherwise. The kernel takes the user stack from %ebp and the return
+ * address from the top of that stack; SYSEXIT comes back with %ecx/%edx
+ * clobbered. Only the common calls below use it - fork, execve, exit and
+ * friends stay on int $0x80.
+ */
+#define CPUID_EDX_SEP (1u << 11)
+
+static inline int syscall_sysenter_available(void) {
+  static int avail = -1;
+  if (avail < 0) {
+    uint32_t eax, ebx, ecx, edx;
+    asm volatile("cpuid"
+                 : "=a"(eax), "=b"(ebx), "=c"(ecx), "=d"(edx)
+                 : "a"(1));
+    /* Pentium Pro reports SEP without a working SYSENTER */
+    uint32_t family = (eax >> 8) & 0xF, model = (eax >> 4) & 0xF;
+    avail = (edx & CPUID_EDX_SEP) &&
+            !(family == 6 && model < 3 && (eax & 0xF) < 3);
+  }
+  return avail;
+}
+
+/* Raw SYSENTER, up to five arguments (caller checked availability) */
+static inline int syscall_sysenter(int nr, uint32_t b, uint32_t c, uint32_t d,
+                                   uint32_t S, uint32_t D) {
+  int res;
+  asm volatile("push %%ebp\n\t"
+               "push $1f\n\t"
+               "mov %%esp, %%ebp\n\t"
+               "sysenter\n"
+               "1:\n\t"
+               "add $4, %%esp\n\t"
+               "pop %%ebp"
+               : "=a"(res), "+c"(c), "+d"(d)
+               : "0"(nr), "b"(b), "S"(S), "D"(D)
+               : "memory", "cc");
+  return res;
+}
+
+/* Raw int $0x80, same arguments */
+static inline int syscall_int80(int nr, uint32_t b, uint32_t c, uint32_t d,
+                                uint32_t S, uint32_t D) {
+  int res;
+  asm volatile("int $0x80"
+               : "=a"(res)
+               : "a"(nr), "b"(b), "c"(c), "d"(d), "S"(S), "D"(D)
+               : "memory");
+  return res;
+}
+
+static inline int syscall_fast(int nr, uint32_t b, uint32_t c, uint32_t d,
+                               uint32_t S, uint32_t D) {
+  if (syscall_sysenter_available())
+    return syscall_sysenter(nr, b, c, d, S, D);
+  return syscall_int80(nr, b, c, d, S, D);
+}
+
 /* Basic syscall - print string */
 static inline void syscall_print(const char *str) {
-  asm volatile("int $0x80" ::"a"(SYS_PRINT), "b"(str));
+  syscall_fast(SYS_PRINT, (uint32_t)str, 0, 0, 0, 0);
 }
 
 /* Get process ID */
 static inline int syscall_getpid(void) {
-  int res;
-  asm volatile("int $0x80" : "=a"(res) : "a"(SYS_GETPID));
-  return res;
+  return syscall_fast(SYS_GETPID, 0, 0, 0, 0, 0);
 }
 
 /* Open file */
@@ -276,27 +452,17 @@ static inline int syscall_open(const char *path, int flags) {
 
 /* Read from file */
 static inline int syscall_read(int fd, void *buf, uint32_t size) {
-  int res;
-  asm volatile("int $0x80"
-               : "=a"(res)
-               : "a"(SYS_READ), "b"(fd), "c"(buf), "d"(size));
-  return res;
+  return syscall_fast(SYS_READ, (uint32_t)fd, (uint32_t)buf, size, 0, 0);
 }
 
 /* Write to file */
 static inline int syscall_write(int fd, const void *buf, uint32_t size) {
-  int res;
-  asm volatile("int $0x80"
-               : "=a"(res)
-               : "a"(SYS_WRITE), "b"(fd), "c"(buf), "d"(size));
-  return res;
+  return syscall_fast(SYS_WRITE, (uint32_t)fd, (uint32_t)buf, size, 0, 0);
 }
 
 /* Close file */
 static inline int syscall_close(int fd) {
-  int res;
-  asm volatile("int $0x80" : "=a"(res) : "a"(SYS_CLOSE), "b"(fd));
-  return res;
+  return syscall_fast(SYS_CLOSE, (uint32_t)fd, 0, 0, 0, 0);
 }
 
 /* sbrk - Change data segment size */
@@ -413,11 +579,8 @@ static inline int syscall_fstat(int fd, struct stat *st) {
 
 /* Seek in file */
 static inline int syscall_lseek(int fd, int offset, int whence) {
-  int res;
-  asm volatile("int $0x80"
-               : "=a"(res)
-               : "a"(SYS_SEEK), "b"(fd), "c"(offset), "d"(whence));
-  return res;
+  return syscall_fast(SYS_SEEK, (uint32_t)fd, (uint32_t)offset,
+                      (uint32_t)whence, 0, 0);
 }
 
 /* Duplicate file descriptor */
@@ -441,12 +604,8 @@ static inline int syscall_gettime(struct rtc_time *time) {
   return res;
 }
 
-/* Get system uptime in ticks */
-static inline uint32_t syscall_uptime(void) {
-  uint32_t res;
-  asm volatile("int $0x80" : "=a"(res) : "a"(SYS_UPTIME));
-  return res;
-}
+/* Get system uptime in ticks (read from the vDSO time page) */
+static inline uint32_t syscall_uptime(void) { return vdso_uptime(); }
 
 /* Sleep for ticks */
 static inline int syscall_sleep(uint32_t ticks) {
@@ -515,7 +674,111 @@ static inline int syscall_meminfo(struct meminfo *info) {
   return res;
 }
 
-/* Get process info */
+/* Get per-order buddy stats for both zones; returns number of zones */
+static inline int syscall_pmm_stats(struct pmm_zone_stats *zones) {
+  int res;
+  asm volatile("int $0x80" : "=a"(res) : "a"(SYS_PMM_STATS), "b"(zones));
+  return res;
+}
+
+/* Get lazy anonymous memory counters */
+static inline int syscall_vm_stats(struct vm_stats *stats) {
+  int res;
+  asm volatile("int $0x80" : "=a"(res) : "a"(SYS_VM_STATS), "b"(stats));
+  return res;
+}
+
+/* Fill up to max slab_stats entries, returns number of caches */
+static inline int syscall_slab_stats(struct slab_stats *stats, int max) {
+  int res;
+  asm volatile("int $0x80"
+               : "=a"(res)
+               : "a"(SYS_SLAB_STATS), "b"(stats), "c"(max));
+  return res;
+}
+
+/* Set scheduling class and nice (-20..19) of pid (0 = self) */
+static inline int syscall_sched_setattr(int pid, int sched_class, int nice) {
+  int res;
+  asm volatile("int $0x80"
+               : "=a"(res)
+               : "a"(SYS_SCHED_SETATTR), "b"(pid), "c"(sched_class),
+                 "d"(nice));
+  return res;
+}
+
+/* Set POSIX policy and RT priority of pid (0 = self); RT needs root */
+static inline int syscall_sched_setscheduler(int pid, int policy,
+                                             const struct sched_param *param) {
+  int res;
+  asm volatile("int $0x80"
+               : "=a"(res)
+               : "a"(SYS_SCHED_SETSCHEDULER), "b"(pid), "c"(policy),
+                 "d"(param));
+  return res;
+}
+
+/* Change RT priority of pid (0 = self), keeping its policy */
+static inline int syscall_sched_setparam(int pid,
+                                         const struct sched_param *param) {
+  int res;
+  asm volatile("int $0x80"
+               : "=a"(res)
+               : "a"(SYS_SCHED_SETPARAM), "b"(pid), "c"(param));
+  return res;
+}
+
+/* Fill up to max lock_stats entries, returns number of named locks */
+static inline int syscall_lock_stats(struct lock_stats *stats, int max) {
+  int res;
+  asm volatile("int $0x80"
+               : "=a"(res)
+               : "a"(SYS_LOCK_STATS), "b"(stats), "c"(max)
+               : "memory");
+  return res;
+}
+
+/* Fill up to max cpu_info entries, returns number of online CPUs */
+static inline int syscall_cpu_info(struct cpu_info *info, int max) {
+  int res;
+  asm volatile("int $0x80"
+               : "=a"(res)
+               : "a"(SYS_CPU_INFO), "b"(info), "c"(max)
+               : "memory");
+  return res;
+}
+
+/* Create this process's submission/completion rings (see uring.h) */
+static inline int syscall_uring_setup(uint32_t entries,
+                                      struct uring_params *params) {
+  int res;
+  asm volatile("int $0x80"
+               : "=a"(res)
+               : "a"(SYS_URING_SETUP), "b"(entries), "c"(params)
+               : "memory");
+  return res;
+}
+
+/* Submit up to to_submit SQEs; with flags = 1 (GETEVENTS) wait for
+ * min_complete CQEs. Returns SQEs consumed. */
+static inline int syscall_uring_enter(uint32_t to_submit,
+                                      uint32_t min_complete, uint32_t flags) {
+  return syscall_fast(SYS_URING_ENTER, to_submit, min_complete, flags, 0, 0);
+}
+
+/*
+ * futex(uaddr, op, val, val2, uaddr2)
+ *   FUTEX_WAIT:    sleep while *uaddr == val, val2 = timeout ms (0 = forever)
+ *   FUTEX_WAKE:    wake up to val waiters on uaddr
+ *   FUTEX_REQUEUE: wake val waiters, move up to val2 others onto uaddr2
+ */
+static inline int syscall_futex(volatile uint32_t *uaddr, int op, uint32_t val,
+                                uint32_t val2, volatile uint32_t *uaddr2) {
+  return syscall_fast(SYS_FUTEX, (uint32_t)uaddr, (uint32_t)op, val, val2,
+                      (uint32_t)uaddr2);
+}
+
+/* Get process info (pid 0 = self) */
 static inline int syscall_procinfo(int pid, struct procinfo *info) {
   int res;
   asm volatile("int $0x80"
@@ -607,12 +870,12 @@ static inline int syscall_sigprocmask(int how, const void *set, void *oldset) {
   return res;
 }
 
+/* vDSO time page first; the syscall only for clocks it cannot answer */
 static inline int syscall_clock_gettime(clockid_t clk_id, struct timespec *tp) {
-  int res;
-  asm volatile("int $0x80"
-               : "=a"(res)
-               : "a"(SYS_CLOCK_GETTIME), "b"(clk_id), "c"(tp));
-  return res;
+  if (vdso_clock_gettime(clk_id, tp) == 0)
+    return 0;
+  return syscall_fast(SYS_CLOCK_GETTIME, (uint32_t)clk_id, (uint32_t)tp, 0, 0,
+                      0);
 }
 
 static inline int syscall_nanosleep(const struct timespec *req,
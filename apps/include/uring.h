@@ -0,0 +1,213 @@
+/*
+ * uring.h - Asynchronous syscall submission/completion rings
+ *
+ * SYS_URING_SETUP maps one region into the process: a submission ring
+ * header, a completion ring header, the SQE array and the CQE array
+ * (src/kernel/uring.h - keep the layout in sync). The app fills SQEs and
+ * publishes them by advancing sq->tail; one SYS_URING_ENTER hands the whole
+ * batch to the kernel. Results come back as CQEs carrying the SQE's
+ * user_data. Ops that would block (read on an empty pipe, poll) are parked
+ * in the kernel and complete on a later enter, so CQEs may arrive out of
+ * submission order.
+ *
+ *   struct uring ring;
+ *   uring_init(&ring, 32);
+ *   struct uring_sqe *sqe = uring_get_sqe(&ring);
+ *   uring_prep_read(sqe, fd, buf, len, URING_OFF_CUR);
+ *   sqe->user_data = 1;
+ *   uring_submit_and_wait(&ring, 1);
+ *   struct uring_cqe *cqe;
+ *   if (uring_peek_cqe(&ring, &cqe) == 0) { ...; uring_cqe_seen(&ring); }
+ */
+#ifndef _URING_H
+#define _URING_H
+
+#include "syscall.h"
+#include <stdint.h>
+
+#define URING_OP_NOP 0
+#define URING_OP_READ 1
+#define URING_OP_WRITE 2
+#define URING_OP_SEND 3
+#define URING_OP_RECV 4
+#define URING_OP_OPEN 5
+#define URING_OP_CLOSE 6
+#define URING_OP_POLL 7 /* res = revents */
+
+#define URING_OFF_CUR 0xFFFFFFFF /* Use (and advance) the fd position */
+
+#define URING_ENTER_GETEVENTS 0x1
+
+#ifndef POLLIN
+#define POLLIN 0x0001
+#define POLLPRI 0x0002
+#define POLLOUT 0x0004
+#define POLLERR 0x0008
+#define POLLHUP 0x0010
+#define POLLNVAL 0x0020
+#endif
+
+struct uring_sqe {
+  uint8_t op;
+  uint8_t flags; /* None yet, must be 0 */
+  uint16_t pad;
+  int32_t fd;
+  uint32_t addr; /* Buffer or path */
+  uint32_t len;
+  uint32_t off;
+  uint32_t op_flags; /* send/recv flags, O_* for open, POLL* for poll */
+  uint64_t user_data;
+};
+
+struct uring_cqe {
+  uint64_t user_data;
+  int32_t res; /* Syscall result: >= 0 on success, -errno on failure */
+  uint32_t flags;
+};
+
+struct uring_ring {
+  volatile uint32_t head; /* Advanced by the consumer */
+  volatile uint32_t tail; /* Advanced by the producer */
+  uint32_t mask;
+  uint32_t entries;
+  uint32_t pad[4];
+};
+
+struct uring {
+  struct uring_ring *sq;
+  struct uring_ring *cq;
+  struct uring_sqe *sqes;
+  struct uring_cqe *cqes;
+  uint32_t sq_tail; /* SQEs handed out, published on submit */
+};
+
+/* x86 keeps stores (and loads) in order - only the compiler needs a fence */
+#define uring_barrier() asm volatile("" ::: "memory")
+
+static inline int uring_init(struct uring *ring, uint32_t entries) {
+  struct uring_params p;
+  int res = syscall_uring_setup(entries, &p);
+  if (res < 0)
+    return res;
+  ring->sq = (struct uring_ring *)(p.ring_addr + p.sq_off);
+  ring->cq = (struct uring_ring *)(p.ring_addr + p.cq_off);
+  ring->sqes = (struct uring_sqe *)(p.ring_addr + p.sqes_off);
+  ring->cqes = (struct uring_cqe *)(p.ring_addr + p.cqes_off);
+  ring->sq_tail = 0;
+  return 0;
+}
+
+/* Next free SQE, or 0 when the SQ is full (submit first) */
+static inline struct uring_sqe *uring_get_sqe(struct uring *ring) {
+  struct uring_ring *sq = ring->sq;
+  if (ring->sq_tail - sq->head >= sq->entries)
+    return 0;
+  struct uring_sqe *sqe = &ring->sqes[ring->sq_tail & sq->mask];
+  ring->sq_tail++;
+  return sqe;
+}
+
+static inline void uring_prep_rw(struct uring_sqe *sqe, uint8_t op, int fd,
+                                 const void *addr, uint32_t len,
+                                 uint32_t off) {
+  sqe->op = op;
+  sqe->flags = 0;
+  sqe->pad = 0;
+  sqe->fd = fd;
+  sqe->addr = (uint32_t)addr;
+  sqe->len = len;
+  sqe->off = off;
+  sqe->op_flags = 0;
+  sqe->user_data = 0;
+}
+
+static inline void uring_prep_nop(struct uring_sqe *sqe) {
+  uring_prep_rw(sqe, URING_OP_NOP, -1, 0, 0, 0);
+}
+
+static inline void uring_prep_read(struct uring_sqe *sqe, int fd, void *buf,
+                                   uint32_t len, uint32_t off) {
+  uring_prep_rw(sqe, URING_OP_READ, fd, buf, len, off);
+}
+
+static inline void uring_prep_write(struct uring_sqe *sqe, int fd,
+                                    const void *buf, uint32_t len,
+                                    uint32_t off) {
+  uring_prep_rw(sqe, URING_OP_WRITE, fd, buf, len, off);
+}
+
+static inline void uring_prep_send(struct uring_sqe *sqe, int fd,
+                                   const void *buf, uint32_t len, int flags) {
+  uring_prep_rw(sqe, URING_OP_SEND, fd, buf, len, 0);
+  sqe->op_flags = (uint32_t)flags;
+}
+
+static inline void uring_prep_recv(struct uring_sqe *sqe, int fd, void *buf,
+                                   uint32_t len, int flags) {
+  uring_prep_rw(sqe, URING_OP_RECV, fd, buf, len, 0);
+  sqe->op_flags = (uint32_t)flags;
+}
+
+static inline void uring_prep_open(struct uring_sqe *sqe, const char *path,
+                                   int flags) {
+  uring_prep_rw(sqe, URING_OP_OPEN, -1, path, 0, 0);
+  sqe->op_flags = (uint32_t)flags;
+}
+
+static inline void uring_prep_close(struct uring_sqe *sqe, int fd) {
+  uring_prep_rw(sqe, URING_OP_CLOSE, fd, 0, 0, 0);
+}
+
+static inline void uring_prep_poll(struct uring_sqe *sqe, int fd,
+                                   int events) {
+  uring_prep_rw(sqe, URING_OP_POLL, fd, 0, 0, 0);
+  sqe->op_flags = (uint32_t)events;
+}
+
+/* Publish pending SQEs and enter once. Returns SQEs the kernel took. */
+static inline int uring_submit_and_wait(struct uring *ring,
+                                        uint32_t wait_nr) {
+  uring_barrier(); /* SQE contents before the tail */
+  ring->sq->tail = ring->sq_tail;
+  uint32_t pending = ring->sq_tail - ring->sq->head;
+  return syscall_uring_enter(pending, wait_nr,
+                             wait_nr ? URING_ENTER_GETEVENTS : 0);
+}
+
+static inline int uring_submit(struct uring *ring) {
+  return uring_submit_and_wait(ring, 0);
+}
+
+/* Oldest unseen CQE without entering the kernel; -1 if there is none */
+static inline int uring_peek_cqe(struct uring *ring,
+                                 struct uring_cqe **cqe) {
+  struct uring_ring *cq = ring->cq;
+  uint32_t head = cq->head;
+  if (head == cq->tail)
+    return -1;
+  uring_barrier(); /* tail before the CQE contents */
+  *cqe = &ring->cqes[head & cq->mask];
+  return 0;
+}
+
+/* Like peek, but enter and sleep until a parked op completes. -1 when
+ * nothing is in flight to wait for. */
+static inline int uring_wait_cqe(struct uring *ring, struct uring_cqe **cqe) {
+  if (uring_peek_cqe(ring, cqe) == 0)
+    return 0;
+  if (uring_submit_and_wait(ring, 1) < 0)
+    return -1;
+  return uring_peek_cqe(ring, cqe);
+}
+
+static inline void uring_cqe_seen(struct uring *ring) {
+  uring_barrier(); /* Done reading the CQE before the kernel reuses it */
+  ring->cq->head = ring->cq->head + 1;
+}
+
+/* Ready CQEs not yet marked seen */
+static inline uint32_t uring_cq_ready(struct uring *ring) {
+  return ring->cq->tail - ring->cq->head;
+}
+
+#endif /* _URING_H */
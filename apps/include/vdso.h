@@ -0,0 +1,112 @@
+/*
+ * vdso.h - Kernel time page, read without a syscall
+ *
+ * The kernel maps one read-only page at VDSO_TIME_ADDR into every process
+ * (src/kernel/vdso.h - keep the layout in sync). It holds a seqlock-protected
+ * snapshot: the tick count, the TSC value where monotonic time is zero, the
+ * cycles -> ns factors and the boot epoch second. The readers below return
+ * -1 when the page cannot answer (no TSC clocksource, CPU time clocks); the
+ * caller then falls back to the syscall.
+ */
+#ifndef _VDSO_H
+#define _VDSO_H
+
+#include "types.h"
+#include <stdint.h>
+
+#define VDSO_TIME_ADDR 0xFFFFE000
+
+#define VDSO_CLOCK_NONE 0
+#define VDSO_CLOCK_TSC 1
+
+#ifndef CLOCK_REALTIME
+#define CLOCK_REALTIME 0
+#define CLOCK_MONOTONIC 1
+#define CLOCK_PROCESS_CPUTIME_ID 2
+#define CLOCK_THREAD_CPUTIME_ID 3
+#define CLOCK_MONOTONIC_RAW 4
+#define CLOCK_REALTIME_COARSE 5
+#define CLOCK_MONOTONIC_COARSE 6
+#define CLOCK_BOOTTIME 7
+#endif
+
+struct vdso_time {
+  volatile uint32_t seq; /* Odd while the kernel is writing */
+  uint32_t clock_mode;
+  uint64_t cycle_base;
+  uint32_t mult; /* ns = ((tsc - cycle_base) * mult) >> shift */
+  uint32_t shift;
+  uint32_t tick;
+  uint32_t hz;
+  uint64_t tick_ns; /* Monotonic ns at the last tick */
+  uint32_t boot_time_sec;
+};
+
+#define vdso_time_page() ((const struct vdso_time *)VDSO_TIME_ADDR)
+
+static inline uint64_t vdso_rdtsc(void) {
+  uint32_t lo, hi;
+  asm volatile("rdtsc" : "=a"(lo), "=d"(hi));
+  return ((uint64_t)hi << 32) | lo;
+}
+
+/* (a * mul) >> shift without a 64x64 multiply (shift <= 32) */
+static inline uint64_t vdso_mul_shr(uint64_t a, uint32_t mul,
+                                    uint32_t shift) {
+  uint64_t lo = (uint64_t)(uint32_t)a * mul;
+  uint64_t hi = (uint64_t)(uint32_t)(a >> 32) * mul;
+  return (lo >> shift) + (hi << (32 - shift));
+}
+
+/* ns -> sec + nsec without a 64-bit divide (2^61 / 10^9 reciprocal) */
+static inline void vdso_ns_to_timespec(uint64_t ns, uint32_t base_sec,
+                                       struct timespec *tp) {
+  uint64_t lo = (uint64_t)(uint32_t)ns * 2305843009U;
+  uint64_t hi = (uint64_t)(uint32_t)(ns >> 32) * 2305843009U;
+  uint32_t s = (uint32_t)((lo >> 61) + (hi >> 29));
+  uint64_t rem = ns - (uint64_t)s * 1000000000U;
+  while (rem >= 1000000000U) {
+    rem -= 1000000000U;
+    s++;
+  }
+  tp->tv_sec = (time_t)(base_sec + s);
+  tp->tv_nsec = (long)rem;
+}
+
+/* Tick count (SYS_UPTIME) - a single aligned word, no retry needed */
+static inline uint32_t vdso_uptime(void) { return vdso_time_page()->tick; }
+
+static inline int vdso_clock_gettime(clockid_t clk_id, struct timespec *tp) {
+  const struct vdso_time *v = vdso_time_page();
+  int coarse = clk_id == CLOCK_REALTIME_COARSE ||
+               clk_id == CLOCK_MONOTONIC_COARSE;
+  int real = clk_id == CLOCK_REALTIME || clk_id == CLOCK_REALTIME_COARSE;
+
+  if (!real && !coarse && clk_id != CLOCK_MONOTONIC &&
+      clk_id != CLOCK_MONOTONIC_RAW && clk_id != CLOCK_BOOTTIME)
+    return -1;
+  if (!coarse && v->clock_mode != VDSO_CLOCK_TSC)
+    return -1;
+
+  uint32_t seq, base_sec = 0;
+  uint64_t ns = 0;
+  do {
+    seq = v->seq;
+    if (seq & 1) {
+      asm volatile("pause");
+      continue;
+    }
+    asm volatile("" ::: "memory");
+    if (coarse)
+      ns = v->tick_ns;
+    else
+      ns = vdso_mul_shr(vdso_rdtsc() - v->cycle_base, v->mult, v->shift);
+    base_sec = real ? v->boot_time_sec : 0;
+    asm volatile("" ::: "memory");
+  } while ((seq & 1) || v->seq != seq);
+
+  vdso_ns_to_timespec(ns, base_sec, tp);
+  return 0;
+}
+
+#endif /* _VDSO_H */
@@ -0,0 +1,50 @@
+// lockstat.cpp - kernel ke naam wale spinlocks ka haal
+//
+// Har lock ke liye: kitni baar liya, kitni baar pehle se pakda mila
+// (contended), sabse lamba hold aur average hold - dono TSC cycles mein.
+// Per-object locks (wait queues, futex buckets) bina naam hain, yahan nahi.
+
+#include "include/userlib.h"
+
+static struct lock_stats stats[LOCK_MAX_LOCKS];
+
+static void column(const char *label, uint32_t value) {
+  syscall_print(label);
+  print_uint(value);
+}
+
+static uint32_t clamp32(uint64_t v) {
+  return (v >> 32) ? 0xFFFFFFFFu : (uint32_t)v;
+}
+
+// 64-bit divide (libgcc nahi hai) ki jagah dono ko 32 bit mein le aao
+static uint32_t avg_hold(uint64_t total, uint32_t count) {
+  while ((total >> 32) && count > 1) {
+    total >>= 1;
+    count >>= 1;
+  }
+  if (!count)
+    return 0;
+  return clamp32(total) / count;
+}
+
+extern "C" void _start() {
+  int n = syscall_lock_stats(stats, LOCK_MAX_LOCKS);
+  if (n < 0) {
+    syscall_print("lockstat: SYS_LOCK_STATS failed\n");
+    syscall_exit(1);
+  }
+
+  for (int i = 0; i < n; i++) {
+    struct lock_stats *s = &stats[i];
+    s->name[LOCK_NAME_LEN - 1] = 0;
+    syscall_print(s->name);
+    column("  acq=", s->acquisitions);
+    column(" contended=", s->contended);
+    column(" hold_max=", clamp32(s->hold_max));
+    column(" hold_avg=", avg_hold(s->hold_total, s->acquisitions));
+    syscall_print("\n");
+  }
+
+  syscall_exit(0);
+}
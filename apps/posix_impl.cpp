@@ -1,3 +1,6 @@
+#include "errno.h"
+#include "pthread.h"
+#include "semaphore.h"
 #include "syscall.h"
 #include "types.h"
 #include <stddef.h>
@@ -63,26 +66,14 @@ int open(const char *path, int flags, ...) {
   return res;
 }
 
-int close(int fd) {
-  int res;
-  asm volatile("int $0x80" : "=a"(res) : "a"(5), "b"(fd)); // SYS_CLOSE = 5
-  return res;
-}
+int close(int fd) { return syscall_close(fd); }
 
 ssize_t read(int fd, void *buf, size_t count) {
-  int res;
-  asm volatile("int $0x80"
-               : "=a"(res)
-               : "a"(3), "b"(fd), "c"(buf), "d"(count)); // SYS_READ = 3
-  return (ssize_t)res;
+  return (ssize_t)syscall_read(fd, buf, count);
 }
 
 ssize_t write(int fd, const void *buf, size_t count) {
-  int res;
-  asm volatile("int $0x80"
-               : "=a"(res)
-               : "a"(4), "b"(fd), "c"(buf), "d"(count)); // SYS_WRITE = 4
-  return (ssize_t)res;
+  return (ssize_t)syscall_write(fd, buf, count);
 }
 
 int mkdir(const char *path, mode_t mode) {
@@ -152,17 +143,13 @@ int rmdir(const char *path) {
   return res;
 }
 
+// vDSO time page se, syscall sirf jab page jawab na de sake
 int clock_gettime(clockid_t clk_id, struct timespec *tp) {
-  int res;
-  asm volatile("int $0x80"
-               : "=a"(res)
-               : "a"(78), "b"(clk_id), "c"(tp)); // SYS_CLOCK_GETTIME = 78
-  return res;
+  return syscall_clock_gettime(clk_id, tp);
 }
 
-// ------------------- Pthreads & Semaphores Stubs -------------------
-typedef uint32_t pthread_t;
-int pthread_create(pthread_t *thread, const void *attr,
+// ------------------- Pthreads & Semaphores -------------------
+int pthread_create(pthread_t *thread, const pthread_attr_t *attr,
                    void *(*start_routine)(void *), void *arg) {
   int res;
   asm volatile("int $0x80"
@@ -176,28 +163,330 @@ int pthread_join(pthread_t thread, void **retval) {
   return res;
 }
 
-typedef struct {
-  uint32_t id;
-  uint32_t value;
-} sem_t;
+// Lock/unlock ka fast path yahin ek atomic op hai - kernel (SYS_FUTEX) sirf
+// tab jab koi sach mein so raha ho ya sona pade. Algorithm kernel ke
+// pthread.cpp wale hi hain, words wahi (pthread.h, semaphore.h).
+static inline int atomic_cas(volatile int *ptr, int expected, int desired) {
+  int result;
+  asm volatile("lock cmpxchgl %2, %1"
+               : "=a"(result), "+m"(*ptr)
+               : "r"(desired), "0"(expected)
+               : "memory");
+  return result == expected;
+}
+
+static inline int atomic_xchg(volatile int *ptr, int val) {
+  asm volatile("xchgl %0, %1" : "+r"(val), "+m"(*ptr) : : "memory");
+  return val;
+}
+
+static inline int atomic_add(volatile int *ptr, int delta) {
+  asm volatile("lock xaddl %0, %1" : "+r"(delta), "+m"(*ptr) : : "memory");
+  return delta;
+}
+
+#define FUTEX_WORD(p) ((volatile uint32_t *)(p))
+#define FUTEX_WAKE_ALL 0x7FFFFFFF
+
+static inline int futex_wait(volatile int *word, int val) {
+  return syscall_futex(FUTEX_WORD(word), FUTEX_WAIT, (uint32_t)val, 0, 0);
+}
+
+static inline int futex_wake(volatile int *word, int nr) {
+  return syscall_futex(FUTEX_WORD(word), FUTEX_WAKE, (uint32_t)nr, 0, 0);
+}
+
+// Owner sirf recursive/errorcheck ke liye chahiye - normal mutex ka fast
+// path syscall nahi karta
+static inline pthread_t mutex_self(pthread_mutex_t *mutex) {
+  return mutex->type == PTHREAD_MUTEX_NORMAL ? 0
+                                             : (pthread_t)syscall_getpid();
+}
+
+// 0 khula, 1 band, 2 band + waiters
+static void mutex_lock_slow(pthread_mutex_t *mutex) {
+  while (atomic_xchg(&mutex->locked, 2) != 0)
+    futex_wait(&mutex->locked, 2);
+}
+
+int pthread_mutex_init(pthread_mutex_t *mutex,
+                       const pthread_mutexattr_t *attr) {
+  if (!mutex)
+    return EINVAL;
+  mutex->locked = 0;
+  mutex->owner = 0;
+  mutex->type = attr ? attr->type : PTHREAD_MUTEX_DEFAULT;
+  mutex->recursive_count = 0;
+  return 0;
+}
+
+int pthread_mutex_destroy(pthread_mutex_t *mutex) {
+  if (!mutex)
+    return EINVAL;
+  return mutex->locked ? EBUSY : 0;
+}
+
+int pthread_mutex_lock(pthread_mutex_t *mutex) {
+  if (!mutex)
+    return EINVAL;
+  pthread_t self = mutex_self(mutex);
+  if (self && mutex->owner == self && mutex->locked) {
+    if (mutex->type == PTHREAD_MUTEX_ERRORCHECK)
+      return EDEADLK;
+    mutex->recursive_count++;
+    return 0;
+  }
+  if (!atomic_cas(&mutex->locked, 0, 1))
+    mutex_lock_slow(mutex);
+  mutex->owner = self;
+  mutex->recursive_count = 1;
+  return 0;
+}
+
+int pthread_mutex_trylock(pthread_mutex_t *mutex) {
+  if (!mutex)
+    return EINVAL;
+  pthread_t self = mutex_self(mutex);
+  if (self && mutex->owner == self && mutex->locked &&
+      mutex->type == PTHREAD_MUTEX_RECURSIVE) {
+    mutex->recursive_count++;
+    return 0;
+  }
+  if (!atomic_cas(&mutex->locked, 0, 1))
+    return EBUSY;
+  mutex->owner = self;
+  mutex->recursive_count = 1;
+  return 0;
+}
+
+int pthread_mutex_unlock(pthread_mutex_t *mutex) {
+  if (!mutex)
+    return EINVAL;
+  if (mutex->type != PTHREAD_MUTEX_NORMAL) {
+    if (mutex->owner != mutex_self(mutex) || !mutex->locked)
+      return EPERM;
+    if (mutex->type == PTHREAD_MUTEX_RECURSIVE && --mutex->recursive_count > 0)
+      return 0;
+  }
+  mutex->owner = 0;
+  if (atomic_xchg(&mutex->locked, 0) == 2)
+    futex_wake(&mutex->locked, 1);
+  return 0;
+}
+
+int pthread_cond_init(pthread_cond_t *cond, const pthread_condattr_t *attr) {
+  (void)attr;
+  if (!cond)
+    return EINVAL;
+  cond->waiters = 0;
+  cond->signal_count = 0;
+  cond->mutex = 0;
+  return 0;
+}
+
+int pthread_cond_destroy(pthread_cond_t *cond) {
+  if (!cond)
+    return EINVAL;
+  return cond->waiters > 0 ? EBUSY : 0;
+}
+
+int pthread_cond_wait(pthread_cond_t *cond, pthread_mutex_t *mutex) {
+  if (!cond || !mutex)
+    return EINVAL;
+  cond->mutex = mutex;
+  int seq = cond->signal_count;
+  atomic_add(&cond->waiters, 1);
+
+  pthread_t self = mutex->owner;
+  int count = mutex->recursive_count;
+  mutex->owner = 0;
+  if (atomic_xchg(&mutex->locked, 0) == 2)
+    futex_wake(&mutex->locked, 1);
+
+  // Beech mein signal aaya to seq badal chuka - kernel -EAGAIN deta hai
+  futex_wait(&cond->signal_count, seq);
+  atomic_add(&cond->waiters, -1);
+
+  // Broadcast ne baaki waiters mutex pe requeue kiye honge - 2 likh ke lo
+  // taaki hamara unlock unhe jagaye
+  mutex_lock_slow(mutex);
+  mutex->owner = self;
+  mutex->recursive_count = count;
+  return 0;
+}
+
+int pthread_cond_signal(pthread_cond_t *cond) {
+  if (!cond)
+    return EINVAL;
+  if (cond->waiters > 0) {
+    atomic_add(&cond->signal_count, 1);
+    futex_wake(&cond->signal_count, 1);
+  }
+  return 0;
+}
+
+int pthread_cond_broadcast(pthread_cond_t *cond) {
+  if (!cond)
+    return EINVAL;
+  if (cond->waiters == 0)
+    return 0;
+  atomic_add(&cond->signal_count, 1);
+  if (cond->mutex)
+    syscall_futex(FUTEX_WORD(&cond->signal_count), FUTEX_REQUEUE, 1,
+                  FUTEX_WAKE_ALL, FUTEX_WORD(&cond->mutex->locked));
+  else
+    futex_wake(&cond->signal_count, FUTEX_WAKE_ALL);
+  return 0;
+}
+
+int pthread_rwlock_init(pthread_rwlock_t *rwlock,
+                        const pthread_rwlockattr_t *attr) {
+  (void)attr;
+  if (!rwlock)
+    return EINVAL;
+  rwlock->state = 0;
+  rwlock->seq = 0;
+  rwlock->waiters = 0;
+  rwlock->write_waiters = 0;
+  rwlock->write_owner = 0;
+  return 0;
+}
+
+int pthread_rwlock_destroy(pthread_rwlock_t *rwlock) {
+  if (!rwlock)
+    return EINVAL;
+  return rwlock->state != 0 ? EBUSY : 0;
+}
+
+static int rwlock_try_read(pthread_rwlock_t *rwlock) {
+  int state = rwlock->state;
+  while (state >= 0 && !rwlock->write_waiters) {
+    if (atomic_cas(&rwlock->state, state, state + 1))
+      return 1;
+    state = rwlock->state;
+  }
+  return 0;
+}
+
+int pthread_rwlock_rdlock(pthread_rwlock_t *rwlock) {
+  if (!rwlock)
+    return EINVAL;
+  if (rwlock_try_read(rwlock))
+    return 0;
+  atomic_add(&rwlock->waiters, 1);
+  for (;;) {
+    int seq = rwlock->seq;
+    if (rwlock_try_read(rwlock))
+      break;
+    futex_wait(&rwlock->seq, seq);
+  }
+  atomic_add(&rwlock->waiters, -1);
+  return 0;
+}
+
+int pthread_rwlock_tryrdlock(pthread_rwlock_t *rwlock) {
+  if (!rwlock)
+    return EINVAL;
+  return rwlock_try_read(rwlock) ? 0 : EBUSY;
+}
+
+int pthread_rwlock_wrlock(pthread_rwlock_t *rwlock) {
+  if (!rwlock)
+    return EINVAL;
+  if (!atomic_cas(&rwlock->state, 0, PTHREAD_RWLOCK_WRLOCKED)) {
+    atomic_add(&rwlock->write_waiters, 1);
+    atomic_add(&rwlock->waiters, 1);
+    for (;;) {
+      int seq = rwlock->seq;
+      if (atomic_cas(&rwlock->state, 0, PTHREAD_RWLOCK_WRLOCKED))
+        break;
+      futex_wait(&rwlock->seq, seq);
+    }
+    atomic_add(&rwlock->waiters, -1);
+    atomic_add(&rwlock->write_waiters, -1);
+  }
+  return 0;
+}
+
+int pthread_rwlock_trywrlock(pthread_rwlock_t *rwlock) {
+  if (!rwlock)
+    return EINVAL;
+  return atomic_cas(&rwlock->state, 0, PTHREAD_RWLOCK_WRLOCKED) ? 0 : EBUSY;
+}
+
+int pthread_rwlock_unlock(pthread_rwlock_t *rwlock) {
+  if (!rwlock)
+    return EINVAL;
+  int state = rwlock->state;
+  if (state == PTHREAD_RWLOCK_WRLOCKED) {
+    atomic_xchg(&rwlock->state, 0);
+  } else if (state > 0) {
+    if (atomic_add(&rwlock->state, -1) != 1)
+      return 0;
+  } else {
+    return EPERM;
+  }
+  if (rwlock->waiters > 0) {
+    atomic_add(&rwlock->seq, 1);
+    futex_wake(&rwlock->seq, FUTEX_WAKE_ALL);
+  }
+  return 0;
+}
+
+// value hi futex word hai; waiters > 0 ho tabhi post syscall karta hai.
+// pshared sem shmat wale segment mein ho to bhi chalta hai - key physical.
 int sem_init(sem_t *sem, int pshared, unsigned int value) {
-  int res;
-  asm volatile("int $0x80"
-               : "=a"(res)
-               : "a"(106), "b"(sem), "c"(pshared), "d"(value));
-  return res;
+  (void)pshared;
+  if (!sem)
+    return -1;
+  sem->value = (int)value;
+  sem->waiters = 0;
+  return 0;
+}
+
+int sem_trywait(sem_t *sem) {
+  int v = sem->value;
+  while (v > 0) {
+    if (atomic_cas(&sem->value, v, v - 1))
+      return 0;
+    v = sem->value;
+  }
+  return -1;
 }
+
 int sem_wait(sem_t *sem) {
-  int res;
-  asm volatile("int $0x80" : "=a"(res) : "a"(109), "b"(sem));
-  return res;
+  if (!sem)
+    return -1;
+  if (sem_trywait(sem) == 0)
+    return 0;
+  atomic_add(&sem->waiters, 1);
+  while (sem_trywait(sem) != 0)
+    futex_wait(&sem->value, 0);
+  atomic_add(&sem->waiters, -1);
+  return 0;
 }
+
 int sem_post(sem_t *sem) {
-  int res;
-  asm volatile("int $0x80" : "=a"(res) : "a"(110), "b"(sem));
-  return res;
+  if (!sem)
+    return -1;
+  atomic_add(&sem->value, 1);
+  if (sem->waiters > 0)
+    futex_wake(&sem->value, 1);
+  return 0;
+}
+
+int sem_getvalue(sem_t *sem, int *sval) {
+  if (!sem || !sval)
+    return -1;
+  *sval = sem->value;
+  return 0;
+}
+
+int sem_destroy(sem_t *sem) {
+  if (!sem)
+    return -1;
+  return sem->waiters > 0 ? -1 : 0;
 }
-int sem_destroy(sem_t *sem) { return 0; }
 
 typedef uint32_t sigset_t;
 int sigemptyset(sigset_t *set) {
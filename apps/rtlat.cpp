@@ -0,0 +1,96 @@
+// rtlat.cpp - wakeup-to-run latency histogram, normal vs SCHED_FIFO
+//
+// RTLAT_HOGS children CPU pe lagataar ghoomte hain (fair class). Hum har
+// baar syscall_sleep(1) se ek tick sote hain, aur jaagne ke baad kernel se
+// poochte hain ki timer ne READY kiya tab se CPU milne tak kitna
+// time laga (procinfo.wakeup_lat_us). Pehle normal task ki tarah naapte
+// hain, phir SCHED_FIFO priority RTLAT_RT_PRIO pe. RT task ko timer IRQ se
+// seedha CPU milna chahiye, normal task ko hogs ke slice khatam hone tak
+// rukna padta hai.
+
+#include "include/userlib.h"
+
+#define RTLAT_HOGS 4
+#define RTLAT_SAMPLES 100
+#define RTLAT_RT_PRIO 50
+#define RTLAT_NR_BUCKETS 8
+
+// Bucket ki upper limit (us), aakhri bucket baaki sab
+static const uint32_t rtlat_bounds[RTLAT_NR_BUCKETS - 1] = {
+    10, 50, 100, 500, 1000, 5000, 20000};
+static const char *rtlat_labels[RTLAT_NR_BUCKETS] = {
+    "    <10us  ", "    <50us  ", "   <100us  ", "   <500us  ",
+    "     <1ms  ", "     <5ms  ", "    <20ms  ", "   >=20ms  "};
+
+static int hogs[RTLAT_HOGS];
+
+static void measure(const char *name) {
+  uint32_t hist[RTLAT_NR_BUCKETS] = {0};
+  uint32_t max_us = 0;
+  uint32_t sum_us = 0; // 64-bit divide libgcc maangta hai
+  struct procinfo info;
+
+  for (int i = 0; i < RTLAT_SAMPLES; i++) {
+    syscall_sleep(1);
+    if (syscall_procinfo(0, &info) < 0)
+      continue;
+    uint32_t us = info.wakeup_lat_us;
+    int b = 0;
+    while (b < RTLAT_NR_BUCKETS - 1 && us >= rtlat_bounds[b])
+      b++;
+    hist[b]++;
+    sum_us += us;
+    if (us > max_us)
+      max_us = us;
+  }
+
+  syscall_print(name);
+  syscall_print(": avg ");
+  print_uint(sum_us / RTLAT_SAMPLES);
+  syscall_print("us, max ");
+  print_uint(max_us);
+  syscall_print("us\n");
+  for (int b = 0; b < RTLAT_NR_BUCKETS; b++) {
+    syscall_print(rtlat_labels[b]);
+    print_uint(hist[b]);
+    syscall_print("\n");
+  }
+}
+
+extern "C" void _start() {
+  syscall_print("rtlat: ");
+  print_uint(RTLAT_SAMPLES);
+  syscall_print(" wakeups, ");
+  print_uint(RTLAT_HOGS);
+  syscall_print(" CPU hogs\n");
+
+  // Hogs pehle fork karo - RT parent ke bachche bhi RT ban jaate
+  for (int i = 0; i < RTLAT_HOGS; i++) {
+    hogs[i] = syscall_fork();
+    if (hogs[i] == 0) {
+      for (;;)
+        asm volatile("" ::: "memory");
+    }
+  }
+
+  measure("SCHED_OTHER");
+
+  struct sched_param param;
+  param.sched_priority = RTLAT_RT_PRIO;
+  if (syscall_sched_setscheduler(0, SCHED_FIFO, &param) < 0) {
+    syscall_print("rtlat: sched_setscheduler(SCHED_FIFO) failed\n");
+  } else {
+    measure("SCHED_FIFO ");
+    param.sched_priority = 0;
+    syscall_sched_setscheduler(0, SCHED_OTHER, &param);
+  }
+
+  int status;
+  for (int i = 0; i < RTLAT_HOGS; i++) {
+    if (hogs[i] > 0) {
+      syscall_kill(hogs[i], SIGKILL);
+      syscall_wait(&status);
+    }
+  }
+  syscall_exit(0);
+}
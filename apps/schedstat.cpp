@@ -0,0 +1,54 @@
+// schedstat.cpp - har process ka scheduler haal
+//
+// Class (prio/fair/fifo/rr), nice, priority (RT ke liye rt_priority), kul CPU time, READY-par-intezaar time,
+// kitni baar CPU mila, aur fair class ka vruntime. Sab times ms mein.
+
+#include "include/userlib.h"
+
+#define SCHEDSTAT_MAX_PID 256
+
+static const char *class_name(uint32_t sched_class) {
+  switch (sched_class) {
+  case SCHED_CLASS_FAIR:
+    return "  fair ";
+  case SCHED_CLASS_FIFO:
+    return "  fifo ";
+  case SCHED_CLASS_RR:
+    return "  rr   ";
+  case SCHED_CLASS_IDLE:
+    return "  idle ";
+  default:
+    return "  prio ";
+  }
+}
+
+static void column(const char *label, uint32_t value) {
+  syscall_print(label);
+  print_uint(value);
+}
+
+extern "C" void _start() {
+  struct procinfo info;
+  syscall_print("PID  NAME  CLASS NICE PRIO  RUN(ms)  WAIT(ms)  SWITCHES  "
+                "VRUN(ms)\n");
+  for (int pid = 1; pid < SCHEDSTAT_MAX_PID; pid++) {
+    if (syscall_procinfo(pid, &info) < 0)
+      continue;
+    print_uint(info.pid);
+    syscall_print(" ");
+    syscall_print(info.name);
+    syscall_print(class_name(info.sched_class));
+    print_int(info.nice);
+    if (info.rt_priority)
+      column(" rt", info.rt_priority);
+    else
+      column(" ", info.priority);
+    column(" ", info.runtime_ms);
+    column(" ", info.wait_ms);
+    column(" ", info.nr_switches);
+    if (info.sched_class == SCHED_CLASS_FAIR)
+      column(" ", info.vruntime_ms);
+    syscall_print("\n");
+  }
+  syscall_exit(0);
+}
@@ -0,0 +1,40 @@
+// slabinfo.cpp - kernel slab caches ka runtime haal
+//
+// Har cache ke liye: object size, active/total objects, slabs (empty kitne),
+// hits (pehle se maujood slab se alloc), misses (naya slab page) aur
+// reclaimed (heap ko wapas diye gaye pages).
+
+#include "include/userlib.h"
+
+static struct slab_stats stats[SLAB_MAX_CACHES];
+
+static void column(const char *label, uint32_t value) {
+  syscall_print(label);
+  print_uint(value);
+}
+
+extern "C" void _start() {
+  int n = syscall_slab_stats(stats, SLAB_MAX_CACHES);
+  if (n < 0) {
+    syscall_print("slabinfo: SYS_SLAB_STATS failed\n");
+    syscall_exit(1);
+  }
+
+  for (int i = 0; i < n; i++) {
+    struct slab_stats *s = &stats[i];
+    s->name[SLAB_NAME_LEN - 1] = 0;
+    syscall_print(s->name);
+    column("  size=", s->object_size);
+    column(" active=", s->active_objs);
+    column("/", s->total_objs);
+    column(" slabs=", s->slabs);
+    column(" empty=", s->empty_slabs);
+    column(" hits=", s->hits);
+    column(" misses=", s->misses);
+    column(" frees=", s->frees);
+    column(" reclaimed=", s->reclaimed);
+    syscall_print("\n");
+  }
+
+  syscall_exit(0);
+}
@@ -0,0 +1,109 @@
+// smpbench.cpp - SMP scaling benchmark
+//
+// k = 1..(online CPUs) ke liye k CPU-bound children fork karte hain, har ek
+// utna hi kaam (SB_WORK loops, koi syscall nahi), aur sabke khatam hone tak
+// ka rdtsc time naapte hain. Ek CPU pe k workers k guna time lete; k CPUs pe
+// lagbhag utna hi jitna ek worker. speedup = k * T(1) / T(k), x100 mein.
+// Aakhir mein har CPU ke stats: switches, kitne tasks churaaye (migrations),
+// IPIs aur busy %.
+
+#include "include/userlib.h"
+
+#define SB_WORK (1u << 26)
+
+static struct cpu_info cpus[CPU_INFO_MAX];
+
+static inline uint64_t sb_rdtsc() {
+  uint32_t lo, hi;
+  asm volatile("rdtsc" : "=a"(lo), "=d"(hi));
+  return ((uint64_t)hi << 32) | lo;
+}
+
+static void sb_work() {
+  volatile uint32_t acc = 0;
+  for (uint32_t i = 0; i < SB_WORK; i++)
+    acc += i ^ (acc >> 3);
+}
+
+static uint64_t bench_workers(int k) {
+  int status;
+  uint64_t t1 = sb_rdtsc();
+  for (int w = 0; w < k; w++) {
+    if (syscall_fork() == 0) {
+      sb_work();
+      syscall_exit(0);
+    }
+  }
+  for (int w = 0; w < k; w++)
+    syscall_wait(&status);
+  return sb_rdtsc() - t1;
+}
+
+static void column(const char *label, uint32_t value) {
+  syscall_print(label);
+  print_uint(value);
+}
+
+// k * base * 100 / t, 64-bit divide (libgcc nahi hai) ke bina - dono ko
+// itna chhota karo ki guna 32 bit mein aaye
+static uint32_t speedup_x100(int k, uint64_t base, uint64_t t) {
+  while (base >= (1u << 20) || t >= (1u << 20)) {
+    base >>= 1;
+    t >>= 1;
+  }
+  if (!t)
+    return 0;
+  return (uint32_t)(k * 100 * (uint32_t)base) / (uint32_t)t;
+}
+
+static uint32_t busy_percent(uint64_t busy, uint64_t idle) {
+  uint64_t total = busy + idle;
+  while (total >> 24) {
+    busy >>= 1;
+    total >>= 1;
+  }
+  if (!total)
+    return 0;
+  return (uint32_t)busy * 100 / (uint32_t)total;
+}
+
+extern "C" void _start() {
+  int ncpu = syscall_cpu_info(cpus, CPU_INFO_MAX);
+  if (ncpu <= 0) {
+    syscall_print("smpbench: SYS_CPU_INFO failed\n");
+    syscall_exit(1);
+  }
+  column("smpbench: CPUs online ", ncpu);
+  syscall_print("\n");
+
+  uint64_t base = 0;
+  for (int k = 1; k <= ncpu; k++) {
+    uint64_t t = bench_workers(k);
+    if (k == 1)
+      base = t;
+    uint32_t s = speedup_x100(k, base, t);
+    column("  workers=", k);
+    column(" Mcycles=", (uint32_t)(t >> 20));
+    column(" speedup=", s / 100);
+    syscall_print(".");
+    if (s % 100 < 10)
+      syscall_print("0");
+    print_uint(s % 100);
+    syscall_print("x\n");
+  }
+
+  ncpu = syscall_cpu_info(cpus, CPU_INFO_MAX);
+  for (int i = 0; i < ncpu; i++) {
+    struct cpu_info *c = &cpus[i];
+    column("  cpu", c->cpu);
+    column(" apic=", c->apic_id);
+    column(" switches=", c->nr_switches);
+    column(" migrations=", c->nr_migrations);
+    column(" ipi_resched=", c->nr_ipi_resched);
+    column(" ipi_tlb=", c->nr_ipi_tlb);
+    column(" busy=", busy_percent(c->busy_ns, c->idle_ns));
+    syscall_print("%\n");
+  }
+
+  syscall_exit(0);
+}
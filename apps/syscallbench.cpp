@@ -0,0 +1,76 @@
+// syscallbench.cpp - null syscall latency: int $0x80 vs SYSENTER
+//
+// getpid kernel mein lagbhag kuch nahi karta, to jo cycles dikhte hain wo
+// entry/exit ka kharcha hai: int 0x80 ka gate + iret + segment reloads, ya
+// SYSENTER/SYSEXIT. Dono raaste seedhe bulaate hain (syscall_int80 /
+// syscall_sysenter), syscall_fast wala chunaav nahi. Best of SB_ROUNDS -
+// beech mein timer IRQ ya switch aaye to wo round chhod do.
+
+#include "include/userlib.h"
+
+#define SB_ITERS 4096 // Power of two - 64-bit divide ki jagah shift
+#define SB_ITERS_SHIFT 12
+#define SB_ROUNDS 8
+
+static inline uint64_t sb_rdtsc() {
+  uint32_t lo, hi;
+  asm volatile("rdtsc" : "=a"(lo), "=d"(hi));
+  return ((uint64_t)hi << 32) | lo;
+}
+
+static uint32_t bench(int use_sysenter) {
+  uint64_t best = ~0ULL;
+  for (int r = 0; r < SB_ROUNDS; r++) {
+    uint64_t t1 = sb_rdtsc();
+    for (int i = 0; i < SB_ITERS; i++) {
+      if (use_sysenter)
+        syscall_sysenter(SYS_GETPID, 0, 0, 0, 0, 0);
+      else
+        syscall_int80(SYS_GETPID, 0, 0, 0, 0, 0);
+    }
+    uint64_t t = sb_rdtsc() - t1;
+    if (t < best)
+      best = t;
+  }
+  return (uint32_t)(best >> SB_ITERS_SHIFT);
+}
+
+static void report(const char *name, uint32_t cycles) {
+  syscall_print("  ");
+  syscall_print(name);
+  print_uint(cycles);
+  syscall_print(" cycles/call\n");
+}
+
+extern "C" void _start() {
+  syscall_print("syscallbench: getpid, best of ");
+  print_uint(SB_ROUNDS);
+  syscall_print(" x ");
+  print_uint(SB_ITERS);
+  syscall_print("\n");
+
+  // Sahi pid dono se - frame aur return value dono raaston pe ek jaise
+  int pid = syscall_int80(SYS_GETPID, 0, 0, 0, 0, 0);
+  uint32_t int80 = bench(0);
+  report("int $0x80:  ", int80);
+
+  if (!syscall_sysenter_available()) {
+    syscall_print("  SYSENTER:   not supported on this CPU\n");
+    syscall_exit(0);
+  }
+  if (syscall_sysenter(SYS_GETPID, 0, 0, 0, 0, 0) != pid) {
+    syscall_print("  SYSENTER:   wrong getpid result\n");
+    syscall_exit(1);
+  }
+  uint32_t fast = bench(1);
+  report("SYSENTER:   ", fast);
+  if (fast) {
+    syscall_print("  speedup x");
+    print_uint(int80 / fast);
+    syscall_print(".");
+    print_uint((int80 % fast) * 10 / fast);
+    syscall_print("\n");
+  }
+
+  syscall_exit(0);
+}
@@ -0,0 +1,95 @@
+// timebench.cpp - clock_gettime: syscall vs vDSO time page
+//
+// Tight loop mein CLOCK_MONOTONIC: pehle seedha SYS_CLOCK_GETTIME (SYSENTER
+// ho to wahi, warna int 0x80), phir vDSO reader jo kernel mein jaata hi
+// nahi. Best of TB_ROUNDS. Aakhir mein dono ka time mila ke dekho - vDSO aur
+// kernel ek hi clock padh rahe hain, fark microseconds mein hona chahiye.
+
+#include "include/userlib.h"
+
+#define TB_ITERS 4096 // Power of two - 64-bit divide ki jagah shift
+#define TB_ITERS_SHIFT 12
+#define TB_ROUNDS 8
+
+static int gettime_syscall(clockid_t clk, struct timespec *tp) {
+  return syscall_fast(SYS_CLOCK_GETTIME, (uint32_t)clk, (uint32_t)tp, 0, 0, 0);
+}
+
+static uint32_t bench(int (*fn)(clockid_t, struct timespec *), clockid_t clk) {
+  struct timespec ts;
+  uint64_t best = ~0ULL;
+  for (int r = 0; r < TB_ROUNDS; r++) {
+    uint64_t t1 = vdso_rdtsc();
+    for (int i = 0; i < TB_ITERS; i++)
+      fn(clk, &ts);
+    uint64_t t = vdso_rdtsc() - t1;
+    if (t < best)
+      best = t;
+  }
+  return (uint32_t)(best >> TB_ITERS_SHIFT);
+}
+
+static void report(const char *name, uint32_t cycles) {
+  syscall_print("  ");
+  syscall_print(name);
+  print_uint(cycles);
+  syscall_print(" cycles/call\n");
+}
+
+static void report_speedup(uint32_t slow, uint32_t fast) {
+  if (!fast)
+    return;
+  syscall_print("  speedup x");
+  print_uint(slow / fast);
+  syscall_print(".");
+  print_uint((slow % fast) * 10 / fast);
+  syscall_print("\n");
+}
+
+extern "C" void _start() {
+  syscall_print("timebench: clock_gettime, best of ");
+  print_uint(TB_ROUNDS);
+  syscall_print(" x ");
+  print_uint(TB_ITERS);
+  syscall_print("\n");
+
+  const struct vdso_time *v = vdso_time_page();
+  syscall_print(v->clock_mode == VDSO_CLOCK_TSC
+                    ? "  time page: tsc\n"
+                    : "  time page: coarse only (no TSC clocksource)\n");
+
+  uint32_t sys = bench(gettime_syscall, CLOCK_MONOTONIC);
+  report("MONOTONIC syscall:        ", sys);
+
+  struct timespec a, b;
+  if (vdso_clock_gettime(CLOCK_MONOTONIC, &a) == 0) {
+    uint32_t fast = bench(vdso_clock_gettime, CLOCK_MONOTONIC);
+    report("MONOTONIC vDSO:           ", fast);
+    report_speedup(sys, fast);
+
+    // vDSO -> kernel -> vDSO: beech wala dono ke beech hona chahiye
+    struct timespec k;
+    vdso_clock_gettime(CLOCK_MONOTONIC, &a);
+    gettime_syscall(CLOCK_MONOTONIC, &k);
+    vdso_clock_gettime(CLOCK_MONOTONIC, &b);
+    uint32_t ns_a = (uint32_t)a.tv_sec * 1000000000u + (uint32_t)a.tv_nsec;
+    uint32_t ns_k = (uint32_t)k.tv_sec * 1000000000u + (uint32_t)k.tv_nsec;
+    uint32_t ns_b = (uint32_t)b.tv_sec * 1000000000u + (uint32_t)b.tv_nsec;
+    if ((int32_t)(ns_k - ns_a) < 0 || (int32_t)(ns_b - ns_k) < 0) {
+      syscall_print("  vDSO and kernel clocks disagree!\n");
+      syscall_exit(1);
+    }
+  }
+
+  uint32_t coarse = bench(vdso_clock_gettime, CLOCK_MONOTONIC_COARSE);
+  report("MONOTONIC_COARSE vDSO:    ", coarse);
+  report_speedup(sys, coarse);
+
+  syscall_print("  uptime ticks (vDSO):    ");
+  print_uint(syscall_uptime());
+  syscall_print(" / syscall: ");
+  print_uint((uint32_t)syscall_fast(SYS_UPTIME, 0, 0, 0, 0, 0));
+  syscall_print("\n");
+
+  syscall_exit(0);
+}
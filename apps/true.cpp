@@ -0,0 +1,6 @@
+// true.cpp - Kuch nahi karta, bas exit(0)
+// forkbench ka exec target (sabse chhota possible program)
+
+#include "include/syscall.h"
+
+extern "C" void _start() { syscall_exit(0); }
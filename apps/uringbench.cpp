@@ -0,0 +1,160 @@
+// uringbench.cpp - har op pe syscall vs uring batch
+//
+// Ek pipe pe UB_BATCH write+read jodiyan: pehle seedhe syscalls (har op ka
+// apna kernel entry), phir wahi ops SQ mein bharke ek SYS_URING_ENTER. NOP
+// wala number sirf entry/exit ka hissa dikhata hai. Best of UB_ROUNDS.
+// Aakhir mein khaali pipe pe read park karke dekho ki baad ke write se wo
+// CQE deta hai - bina thread ke async.
+
+#include "include/uring.h"
+#include "include/userlib.h"
+
+#define UB_BATCH 16      // Write+read jodiyan per enter (SQ = 2x)
+#define UB_LOOPS 128     // UB_BATCH * UB_LOOPS * 2 = UB_OPS
+#define UB_OPS_SHIFT 12  // Power of two - 64-bit divide ki jagah shift
+#define UB_ROUNDS 8
+#define UB_MSG 64
+
+static int pipefd[2];
+static char msg[UB_MSG];
+static char buf[UB_BATCH][UB_MSG];
+static struct uring ring;
+
+static void fail(const char *what) {
+  syscall_print("  FAIL: ");
+  syscall_print(what);
+  syscall_print("\n");
+  syscall_exit(1);
+}
+
+static void rw_syscalls() {
+  for (int l = 0; l < UB_LOOPS; l++) {
+    for (int i = 0; i < UB_BATCH; i++) {
+      syscall_write(pipefd[1], msg, UB_MSG);
+      syscall_read(pipefd[0], buf[i], UB_MSG);
+    }
+  }
+}
+
+static void nop_syscalls() {
+  for (int i = 0; i < UB_BATCH * UB_LOOPS * 2; i++)
+    syscall_getpid();
+}
+
+// Saare CQEs utha lo; res expect se alag ho to batao
+static void reap(int count, int expect) {
+  struct uring_cqe *cqe;
+  for (int i = 0; i < count; i++) {
+    if (uring_peek_cqe(&ring, &cqe) != 0)
+      fail("missing CQE");
+    if (cqe->res != expect)
+      fail("bad CQE result");
+    uring_cqe_seen(&ring);
+  }
+}
+
+static void rw_uring() {
+  for (int l = 0; l < UB_LOOPS; l++) {
+    // Ops SQ ke kram mein chalte hain - har read apne write ke baad
+    for (int i = 0; i < UB_BATCH; i++) {
+      uring_prep_write(uring_get_sqe(&ring), pipefd[1], msg, UB_MSG,
+                       URING_OFF_CUR);
+      uring_prep_read(uring_get_sqe(&ring), pipefd[0], buf[i], UB_MSG,
+                      URING_OFF_CUR);
+    }
+    uring_submit(&ring);
+    reap(UB_BATCH * 2, UB_MSG);
+  }
+}
+
+static void nop_uring() {
+  for (int l = 0; l < UB_LOOPS; l++) {
+    for (int i = 0; i < UB_BATCH * 2; i++)
+      uring_prep_nop(uring_get_sqe(&ring));
+    uring_submit(&ring);
+    reap(UB_BATCH * 2, 0);
+  }
+}
+
+static uint32_t bench(void (*fn)()) {
+  uint64_t best = ~0ULL;
+  for (int r = 0; r < UB_ROUNDS; r++) {
+    uint64_t t1 = vdso_rdtsc();
+    fn();
+    uint64_t t = vdso_rdtsc() - t1;
+    if (t < best)
+      best = t;
+  }
+  return (uint32_t)(best >> UB_OPS_SHIFT);
+}
+
+static void report(const char *name, uint32_t cycles) {
+  syscall_print("  ");
+  syscall_print(name);
+  print_uint(cycles);
+  syscall_print(" cycles/op\n");
+}
+
+static void report_speedup(uint32_t slow, uint32_t fast) {
+  if (!fast)
+    return;
+  syscall_print("  speedup x");
+  print_uint(slow / fast);
+  syscall_print(".");
+  print_uint((slow % fast) * 10 / fast);
+  syscall_print("\n");
+}
+
+// Khaali pipe pe read park hota hai; syscall write ke baad wait pe CQE
+static void check_parked_read() {
+  struct uring_sqe *sqe = uring_get_sqe(&ring);
+  uring_prep_read(sqe, pipefd[0], buf[0], UB_MSG, URING_OFF_CUR);
+  sqe->user_data = 0xC0FFEE;
+  uring_submit(&ring);
+  if (uring_cq_ready(&ring))
+    fail("read on empty pipe did not park");
+
+  syscall_write(pipefd[1], "parked", 6);
+  struct uring_cqe *cqe;
+  if (uring_wait_cqe(&ring, &cqe) != 0)
+    fail("parked read never completed");
+  if (cqe->user_data != 0xC0FFEE || cqe->res != 6 ||
+      memcmp(buf[0], "parked", 6) != 0)
+    fail("parked read returned wrong data");
+  uring_cqe_seen(&ring);
+  syscall_print("  parked read: completed after write\n");
+}
+
+extern "C" void _start() {
+  syscall_print("uringbench: pipe write+read, batch of ");
+  print_uint(UB_BATCH * 2);
+  syscall_print(" ops, best of ");
+  print_uint(UB_ROUNDS);
+  syscall_print(" x ");
+  print_uint(1 << UB_OPS_SHIFT);
+  syscall_print("\n");
+
+  if (syscall_pipe(pipefd) < 0)
+    fail("pipe");
+  if (uring_init(&ring, UB_BATCH * 2) < 0)
+    fail("uring_setup");
+  for (int i = 0; i < UB_MSG; i++)
+    msg[i] = (char)('a' + i % 26);
+
+  uint32_t sys = bench(rw_syscalls);
+  report("read/write syscalls:  ", sys);
+  uint32_t batched = bench(rw_uring);
+  report("read/write uring:     ", batched);
+  report_speedup(sys, batched);
+  if (memcmp(buf[UB_BATCH - 1], msg, UB_MSG) != 0)
+    fail("uring read returned wrong data");
+
+  uint32_t getpid = bench(nop_syscalls);
+  report("getpid syscalls:      ", getpid);
+  uint32_t nop = bench(nop_uring);
+  report("NOP uring:            ", nop);
+  report_speedup(getpid, nop);
+
+  check_parked_read();
+  syscall_exit(0);
+}
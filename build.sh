@@ -46,6 +46,17 @@ build_app "ping"
 build_app "tcptest"
 build_app "wavplay"
 build_app "chrome_installer"
+build_app "true"
+build_app "forkbench"
+build_app "slabinfo"
+build_app "schedstat"
+build_app "rtlat"
+build_app "futexbench"
+build_app "lockstat"
+build_app "smpbench"
+build_app "syscallbench"
+build_app "timebench"
+build_app "uringbench"
 # build_app "explorer"
 
 echo "  Building apps/posix_test.cpp..."
@@ -74,6 +85,9 @@ nasm src/kernel/process_asm.asm -f elf32 -o src/kernel/process_asm.o
 echo "Compiling gdt_asm.asm..."
 nasm src/kernel/gdt_asm.asm -f elf32 -o src/kernel/gdt_asm.o
 
+echo "Compiling smp_trampoline.asm..."
+nasm src/kernel/smp_trampoline.asm -f elf32 -o src/kernel/smp_trampoline.o
+
 echo "Compiling setjmp.asm..."
 nasm src/kernel/setjmp.asm -f elf32 -o src/kernel/setjmp.o
 
@@ -96,6 +96,17 @@ def inject():
             ("TEST.ELF", "apps/test.elf"),
             ("PING.ELF", "apps/ping.elf"),
             ("TCPTEST.ELF", "apps/tcptest.elf"),
+            ("TRUE.ELF", "apps/true.elf"),
+            ("FORKBNCH.ELF", "apps/forkbench.elf"),
+            ("SLABINFO.ELF", "apps/slabinfo.elf"),
+            ("SCHEDST.ELF", "apps/schedstat.elf"),
+            ("RTLAT.ELF", "apps/rtlat.elf"),
+            ("FUTEXBN.ELF", "apps/futexbench.elf"),
+            ("LOCKSTAT.ELF", "apps/lockstat.elf"),
+            ("SMPBENCH.ELF", "apps/smpbench.elf"),
+            ("SYSCBNCH.ELF", "apps/syscallbench.elf"),
+            ("TIMEBNCH.ELF", "apps/timebench.elf"),
+            ("URINGBCH.ELF", "apps/uringbench.elf"),
             ("TRUTH.DAT", "TRUTH.DAT"),
         ]
         
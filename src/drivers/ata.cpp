@@ -1,7 +1,13 @@
 #include "ata.h"
 #include "../include/io.h"
+#include "../include/string.h"
+#include "../kernel/spinlock.h"
 #include "serial.h"
 
+// Ek command register set - poora PIO transfer ek task ka. IRQ14 use nahi
+// hota, to irqsave ki zaroorat nahi; preemption band rehna kaafi hai.
+static DEFINE_SPINLOCK(ata_lock, "ata");
+
 void ata_wait_bsy() {
   while (inb(ATA_STATUS) & ATA_SR_BSY)
     ;
@@ -12,8 +18,11 @@ void ata_wait_drq() {
     ;
 }
 
+// Caller ka buffer user page ho sakta hai - lock ke andar uspe fault nahi
+// chahiye, to PIO sirf stack wale sector pe, copy lock ke baahar
 void ata_read_sector(uint32_t lba, uint8_t *buffer) {
-  asm volatile("cli");
+  uint16_t sec[256];
+  spin_lock(&ata_lock);
   ata_wait_bsy();
 
   outb(ATA_DRIVE_HEAD, 0xE0 | ((lba >> 24) & 0x0F)); // Select Master Drive
@@ -28,14 +37,17 @@ void ata_read_sector(uint32_t lba, uint8_t *buffer) {
   ata_wait_drq();
 
   // Read 256 words (512 bytes)
-  uint16_t *buf16 = (uint16_t *)buffer;
   for (int i = 0; i < 256; i++) {
-    buf16[i] = inw(ATA_DATA);
+    sec[i] = inw(ATA_DATA);
   }
-  asm volatile("sti");
+  spin_unlock(&ata_lock);
+  memcpy(buffer, sec, sizeof(sec));
 }
 
 void ata_write_sector(uint32_t lba, uint8_t *buffer) {
+  uint16_t sec[256];
+  memcpy(sec, buffer, sizeof(sec));
+  spin_lock(&ata_lock);
   ata_wait_bsy();
 
   outb(ATA_DRIVE_HEAD, 0xE0 | ((lba >> 24) & 0x0F));
@@ -50,12 +62,12 @@ void ata_write_sector(uint32_t lba, uint8_t *buffer) {
   ata_wait_drq();
 
   // Write 256 words
-  uint16_t *buf16 = (uint16_t *)buffer;
   for (int i = 0; i < 256; i++) {
-    outw(ATA_DATA, buf16[i]);
+    outw(ATA_DATA, sec[i]);
   }
 
   // Flush Cache
   outb(ATA_COMMAND, 0xE7);
   ata_wait_bsy();
+  spin_unlock(&ata_lock);
 }
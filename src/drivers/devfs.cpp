@@ -5,6 +5,7 @@
 #include "../include/vfs.h"
 #include "../kernel/heap.h"
 #include "../kernel/memory.h"
+#include "../kernel/slab.h"
 #include "serial.h"
 
 #include "../kernel/tty.h"
@@ -170,7 +171,7 @@ vfs_node_t *devfs_init() {
   serial_log("DEVFS: Initializing...");
 
   // Create root /dev directory
-  devfs_root = (vfs_node_t *)kmalloc(sizeof(vfs_node_t));
+  devfs_root = (vfs_node_t *)kmem_cache_alloc(vfs_node_cache);
   memset(devfs_root, 0, sizeof(vfs_node_t));
   strcpy(devfs_root->name, "dev");
   devfs_root->flags = VFS_DIRECTORY;
@@ -179,7 +180,7 @@ vfs_node_t *devfs_init() {
   devfs_root->ref_count = 0xFFFFFFFF; // Never free
 
   // Create /dev/null
-  null_node = (vfs_node_t *)kmalloc(sizeof(vfs_node_t));
+  null_node = (vfs_node_t *)kmem_cache_alloc(vfs_node_cache);
   memset(null_node, 0, sizeof(vfs_node_t));
   strcpy(null_node->name, "null");
   null_node->flags = VFS_DEVICE;
@@ -188,7 +189,7 @@ vfs_node_t *devfs_init() {
   null_node->ref_count = 0xFFFFFFFF;
 
   // Create /dev/zero
-  zero_node = (vfs_node_t *)kmalloc(sizeof(vfs_node_t));
+  zero_node = (vfs_node_t *)kmem_cache_alloc(vfs_node_cache);
   memset(zero_node, 0, sizeof(vfs_node_t));
   strcpy(zero_node->name, "zero");
   zero_node->flags = VFS_DEVICE;
@@ -197,7 +198,7 @@ vfs_node_t *devfs_init() {
   zero_node->ref_count = 0xFFFFFFFF;
 
   // Create /dev/tty
-  tty_node = (vfs_node_t *)kmalloc(sizeof(vfs_node_t));
+  tty_node = (vfs_node_t *)kmem_cache_alloc(vfs_node_cache);
   memset(tty_node, 0, sizeof(vfs_node_t));
   strcpy(tty_node->name, "tty");
   tty_node->flags = VFS_DEVICE;
@@ -206,7 +207,7 @@ vfs_node_t *devfs_init() {
   tty_node->ref_count = 0xFFFFFFFF;
 
   // Create /dev/pts
-  pts_dir_node = (vfs_node_t *)kmalloc(sizeof(vfs_node_t));
+  pts_dir_node = (vfs_node_t *)kmem_cache_alloc(vfs_node_cache);
   memset(pts_dir_node, 0, sizeof(vfs_node_t));
   strcpy(pts_dir_node->name, "pts");
   pts_dir_node->flags = VFS_DIRECTORY;
@@ -215,7 +216,7 @@ vfs_node_t *devfs_init() {
   pts_dir_node->ref_count = 0xFFFFFFFF;
 
   // Create /dev/ptmx (Placeholder)
-  ptmx_node = (vfs_node_t *)kmalloc(sizeof(vfs_node_t));
+  ptmx_node = (vfs_node_t *)kmem_cache_alloc(vfs_node_cache);
   memset(ptmx_node, 0, sizeof(vfs_node_t));
   strcpy(ptmx_node->name, "ptmx");
   ptmx_node->flags = VFS_DEVICE;
@@ -4,6 +4,7 @@
 #include "../include/vfs.h"
 #include "../kernel/heap.h"
 #include "../kernel/memory.h"
+#include "../kernel/slab.h"
 #include "ata.h"
 #include "serial.h"
 
@@ -487,27 +488,43 @@ static uint32_t fat16_write_vfs(vfs_node_t *node, uint32_t offset,
 
 static uint32_t fat16_read_vfs(vfs_node_t *node, uint32_t offset, uint32_t size,
                                uint8_t *buffer) {
-  fat16_entry_t entry;
-  entry.first_cluster_low = (uint16_t)(uintptr_t)node->impl;
-  entry.file_size = node->size;
-
-  // Full read temp buffer strategy
-  uint8_t *tmp = (uint8_t *)kmalloc((entry.file_size + 511) & ~511);
-  if (!tmp)
+  uint32_t file_size = node->size;
+  if (offset >= file_size)
     return 0;
+  if (offset + size > file_size)
+    size = file_size - offset;
 
-  fat16_read_file(&entry, tmp);
+  // Sirf [offset, offset+size) wale sectors padho - poori file nahi. ELF
+  // demand paging isi pe page-by-page chalti hai.
+  uint32_t cluster_bytes = bpb.sectors_per_cluster * 512;
+  uint16_t cluster = (uint16_t)(uintptr_t)node->impl;
+  for (uint32_t skip = offset / cluster_bytes;
+       skip > 0 && cluster >= 2 && cluster < 0xFFF0; skip--)
+    cluster = fat16_get_fat_entry(cluster);
 
-  if (offset > entry.file_size) {
-    kfree(tmp);
-    return 0;
+  uint32_t pos = offset % cluster_bytes; // Cluster ke andar position
+  uint32_t done = 0;
+  while (done < size && cluster >= 2 && cluster < 0xFFF0) {
+    uint32_t sector = fat16_cluster_to_sector(cluster) + pos / 512;
+    uint32_t in_sector = pos % 512;
+    uint32_t chunk = 512 - in_sector;
+    if (chunk > size - done)
+      chunk = size - done;
+
+    // Hamesha kernel buffer mein - buffer user ka ho sakta hai, aur uska
+    // page fault (ELF/anon demand paging) PIO ke beech dobara ATA chalata
+    uint8_t sec_buf[512];
+    ata_read_sector(sector, sec_buf);
+    memcpy(buffer + done, sec_buf + in_sector, chunk);
+
+    done += chunk;
+    pos += chunk;
+    if (pos == cluster_bytes) {
+      pos = 0;
+      cluster = fat16_get_fat_entry(cluster);
+    }
   }
-  if (offset + size > entry.file_size)
-    size = entry.file_size - offset;
-
-  memcpy(buffer, tmp + offset, size);
-  kfree(tmp);
-  return size;
+  return done;
 }
 
 static vfs_node_t *fat16_finddir_vfs(vfs_node_t *node, const char *name) {
@@ -519,7 +536,7 @@ static vfs_node_t *fat16_finddir_vfs(vfs_node_t *node, const char *name) {
 
   fat16_entry_t entry;
   if (fat16_find_entry((uint16_t)(uintptr_t)node->impl, name, &entry)) {
-    vfs_node_t *res = (vfs_node_t *)kmalloc(sizeof(vfs_node_t));
+    vfs_node_t *res = (vfs_node_t *)kmem_cache_alloc(vfs_node_cache);
     memset(res, 0, sizeof(vfs_node_t));
     strcpy(res->name, name);
     res->size = entry.file_size;
@@ -677,7 +694,7 @@ static int fat16_create_vfs(vfs_node_t *node, const char *name,
 }
 
 vfs_node_t *fat16_vfs_init() {
-  vfs_node_t *root = (vfs_node_t *)kmalloc(sizeof(vfs_node_t));
+  vfs_node_t *root = (vfs_node_t *)kmem_cache_alloc(vfs_node_cache);
   memset(root, 0, sizeof(vfs_node_t));
   strcpy(root->name, "/");
   root->flags = VFS_DIRECTORY;
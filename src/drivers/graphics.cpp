@@ -5,6 +5,7 @@
 
 #include "graphics.h"
 #include "../include/string.h"
+#include "../kernel/vmalloc.h"
 #include "serial.h"
 
 // Screen dimensions
@@ -15,14 +16,12 @@
 uint32_t *screen_buffer = nullptr; // Hardware LFB
 uint32_t *back_buffer = nullptr;   // Off-screen render target
 
-// Forward declare heap function
-extern "C" void *malloc(uint32_t size);
-
 extern "C" void init_graphics(uint32_t lfb_address) {
   screen_buffer = (uint32_t *)(uintptr_t)lfb_address;
 
-  // Allocate backbuffer (3MB for 1024x768x32)
-  back_buffer = (uint32_t *)malloc(SCREEN_W * SCREEN_H * sizeof(uint32_t));
+  // Allocate backbuffer (3MB for 1024x768x32) - vmalloc se, warna buddy
+  // heap ko 4MB ka contiguous block dhoondna padta
+  back_buffer = (uint32_t *)vmalloc(SCREEN_W * SCREEN_H * sizeof(uint32_t));
 
   if (!back_buffer) {
     serial_log("GRAPHICS: FATAL - Backbuffer allocation failed!");
@@ -42,12 +41,9 @@ extern "C" void swap_buffers() {
   if (!screen_buffer || !back_buffer)
     return;
 
-  // Fast memcpy from back to front
-  uint32_t *src = back_buffer;
-  uint32_t *dst = screen_buffer;
-  for (int i = 0; i < SCREEN_W * SCREEN_H; i++) {
-    dst[i] = src[i];
-  }
+  // 3MB frame: memcpy yahan SSE2 non-temporal stores leta hai, back buffer
+  // (framebuffer) ko cache mein nahi kheenchta
+  memcpy(screen_buffer, back_buffer, SCREEN_W * SCREEN_H * sizeof(uint32_t));
 }
 
 extern "C" void gfx_clear_screen(uint32_t color) {
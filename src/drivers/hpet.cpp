@@ -33,6 +33,13 @@ uint64_t hpet_read_counter() {
   return ((uint64_t)high << 32) | low;
 }
 
+// Counter period in femtoseconds (GCAP_ID bits 63:32), 0 if no HPET
+uint32_t hpet_get_period_fs() {
+  if (!hpet_base)
+    return 0;
+  return *(volatile uint32_t *)(hpet_base + HPET_CAPABILITIES + 4);
+}
+
 void hpet_map_hardware() {
   // Standard HPET address
   paging_map(0xFED00000, 0xFED00000, 3);
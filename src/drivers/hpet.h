@@ -17,6 +17,7 @@ extern "C" {
 
 void hpet_init();
 uint64_t hpet_read_counter();
+uint32_t hpet_get_period_fs();
 void hpet_map_hardware();
 
 #ifdef __cplusplus
@@ -4,8 +4,13 @@
 #include "../include/types.h"
 #include "../kernel/process.h"
 #include "../kernel/tty.h"
+#include "keyboard.h"
 #include "serial.h"
 
+wait_queue_t input_wait = WAIT_QUEUE_INIT;
+
+void input_wake() { wake_up_all(&input_wait); }
+
 // US Keyboard Layout (Normal)
 char kbd_us[128] = {
     0,    27,   '1', '2', '3', '4', '5', '6', '7', '8', '9', '0', '-',  '=',
@@ -36,6 +41,7 @@ extern "C" void keyboard_set_last_key(int k);
 static void keyboard_callback(registers_t *regs) {
   uint8_t scancode = inb(0x60);
   serial_log_hex("KEYBOARD: Scancode ", scancode);
+  input_wake();
 
   // Modifier Keys (Daba ke rakha hai)
   if (scancode == 0x2A || scancode == 0x36) { // LShift, RShift
@@ -1,6 +1,12 @@
 #ifndef KEYBOARD_H
 #define KEYBOARD_H
 
+#include "../kernel/wait_queue.h"
+
 void init_keyboard();
 
+// Keyboard ya mouse ka koi bhi event - GUI loop isi pe sota hai
+extern wait_queue_t input_wait;
+void input_wake();
+
 #endif
@@ -2,6 +2,7 @@
 #include "../include/irq.h"
 #include "../include/types.h"
 #include "../kernel/apic.h"
+#include "keyboard.h"
 #include "serial.h"
 
 uint8_t mouse_cycle = 0;
@@ -89,6 +90,7 @@ void mouse_callback(registers_t *regs) {
       mouse_y = 767;
 
     mouse_btn = state & 0x07; // Fill left, right, middle buttons
+    input_wake();
   }
 }
 
@@ -2,7 +2,9 @@
 #include "../include/io.h"
 #include "../include/irq.h"
 #include "../include/isr.h"
+#include "../include/string.h"
 #include "../kernel/paging.h"
+#include "../kernel/pmm.h"
 #include "serial.h"
 
 
@@ -10,6 +12,22 @@
 static volatile int g_audio_in_use = 0;
 static volatile int g_audio_buffer_index = 1; // 0 or 1 for double buffering
 
+// ISA DMA sirf neeche ke 16MB dekhta hai aur 64K (8-bit) / 128K (16-bit)
+// boundary paar nahi karta - buffer PMM ke DMA zone se, 64KB buddy block
+// (apne size pe aligned, to boundary kabhi nahi katti). Caller ka buffer
+// kahin bhi ho, samples yahan copy hote hain.
+#define SB16_DMA_BYTES 0x10000
+static uint8_t *g_dma_buffer = 0;
+
+static uint8_t *sb16_dma_buffer() {
+  if (!g_dma_buffer) {
+    void *phys = pmm_alloc_dma_blocks(SB16_DMA_BYTES / PMM_BLOCK_SIZE);
+    if (phys)
+      g_dma_buffer = (uint8_t *)PHYS_TO_VIRT(phys);
+  }
+  return g_dma_buffer;
+}
+
 // Hardware Delay
 static void sb16_delay() {
   for (volatile int i = 0; i < 1000; i++)
@@ -79,6 +97,8 @@ void sb16_init() {
   if (sb16_reset()) {
     serial_log("SB16: Sound Blaster 16 Detected!");
     sb16_write(SB_CMD_SPEAKER_ON);
+    if (!sb16_dma_buffer())
+      serial_log("SB16: DMA buffer nahi mila (DMA zone bhara)");
 
     // Register IRQ 5 handler
     // register_interrupt_handler(IRQ5, sb16_interrupt_handler);
@@ -89,7 +109,13 @@ void sb16_init() {
 
 void sb16_play_16bit(int16_t *buffer, uint32_t length_bytes,
                      uint16_t sample_rate) {
-  uint32_t phys = VIRT_TO_PHYS(buffer);
+  uint8_t *dma = sb16_dma_buffer();
+  if (!dma)
+    return;
+  if (length_bytes > SB16_DMA_BYTES)
+    length_bytes = SB16_DMA_BYTES;
+  memcpy(dma, buffer, length_bytes);
+  uint32_t phys = VIRT_TO_PHYS(dma);
   uint32_t word_count = length_bytes / 2;
 
   // 1. Setup DMA Channel 5
@@ -116,7 +142,13 @@ extern "C" int32_t sys_audio_cstatus() { return g_audio_buffer_index; }
 
 extern "C" void sb16_play_8bit(uint8_t *buffer, uint32_t length,
                                uint16_t sample_rate) {
-  uint32_t phys = VIRT_TO_PHYS(buffer);
+  uint8_t *dma = sb16_dma_buffer();
+  if (!dma)
+    return;
+  if (length > SB16_DMA_BYTES)
+    length = SB16_DMA_BYTES;
+  memcpy(dma, buffer, length);
+  uint32_t phys = VIRT_TO_PHYS(dma);
 
   // Setup DMA 1 (Existing logic)
   outb(0x0A, 5);
@@ -3,25 +3,21 @@
 #include "../include/irq.h"
 #include "../include/string.h"
 #include "../include/types.h"
+#include "../kernel/clockevent.h"
+#include "../kernel/ktimer.h"
 #include "../kernel/process.h"
+#include "../kernel/sched.h"
+#include "../kernel/vdso.h"
 #include "serial.h"
 
 uint32_t tick = 0;
 
 static void timer_callback(registers_t *regs) {
   tick++;
+  vdso_update_tick(ktime_get_ns());
 
-  // Wake up sleeping processes
-  process_t *p = ready_queue;
-  if (p) {
-    process_t *start = p;
-    do {
-      if (p->state == PROCESS_SLEEPING && tick >= p->sleep_until) {
-        p->state = PROCESS_READY;
-      }
-      p = p->next;
-    } while (p && p != start);
-  }
+  // Sleepers, alarms, POSIX timers, network timeouts - sab timer wheel pe
+  run_timers();
 
   schedule();
 }
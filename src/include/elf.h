@@ -38,6 +38,11 @@ typedef struct {
 #define PT_SHLIB 5
 #define PT_PHDR 6
 
+// p_flags
+#define PF_X 0x1
+#define PF_W 0x2
+#define PF_R 0x4
+
 typedef struct {
   Elf32_Word p_type;
   Elf32_Off p_offset;
@@ -48,5 +48,6 @@
 #define EWOULDBLOCK EAGAIN /* Operation would block */
 #define ENOMSG 42          /* No message of desired type */
 #define EIDRM 43           /* Identifier removed */
+#define ETIMEDOUT 110      /* Connection timed out */
 
 #endif
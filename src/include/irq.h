@@ -10,6 +10,7 @@ extern "C" {
 
 void irq_install();
 void irq_handler(registers_t *regs);
+void irq_set_mask(uint8_t irq, bool masked);
 
 extern void isr32();
 extern void isr33();
@@ -27,6 +28,9 @@ extern void isr44();
 extern void isr45();
 extern void isr46();
 extern void isr47();
+extern void isr48(); // LAPIC timer
+extern void isr49(); // IPI: resched (smp.h)
+extern void isr50(); // IPI: TLB shootdown
 
 #ifdef __cplusplus
 }
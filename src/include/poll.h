@@ -37,6 +37,16 @@ int poll(struct pollfd *fds, unsigned int nfds, int timeout);
 int ppoll(struct pollfd *fds, unsigned int nfds, const void *timeout,
           const void *sigmask);
 
+// Kernel: fd ke abhi taiyaar events (POLLIN/POLLOUT/POLLHUP/POLLERR/
+// POLLNVAL). *wq = jis queue pe events ke liye sona ho, 0 = koi nahi (regular
+// file hamesha taiyaar, AF_INET ko timer se dobara dekho). wq 0 pass karo
+// to sirf events.
+struct wait_queue;
+int fd_poll(int fd, int events, struct wait_queue **wq);
+// Wahi, seedha node pe (fd table ke bina)
+struct vfs_node;
+int node_poll(struct vfs_node *node, int events, struct wait_queue **wq);
+
 // ============================================================================
 // select Structures
 // ============================================================================
@@ -26,6 +26,8 @@ typedef struct {
 // ============================================================================
 // Mutex Types
 // ============================================================================
+// locked futex word hai: 0 khula, 1 band, 2 band + koi so raha hai (unlock
+// tabhi futex wake karta hai). Bina contention lock/unlock ek atomic op.
 typedef struct {
   volatile int locked;
   volatile pthread_t owner;
@@ -53,6 +55,8 @@ typedef struct {
 // ============================================================================
 // Condition Variable Types
 // ============================================================================
+// signal_count futex word hai - har signal/broadcast pe badhta, waiter
+// purani value pe sota hai
 typedef struct {
   volatile int waiters;
   volatile int signal_count;
@@ -70,19 +74,25 @@ typedef struct {
 // ============================================================================
 // Read-Write Lock Types
 // ============================================================================
+// state ek CAS se lock hota hai: >0 readers, 0 khula, -1 writer. Sone wale
+// seq (futex word) pe sote hain, unlock tabhi seq badha ke jagata hai jab
+// waiters > 0. write_waiters > 0 ho to naye readers rukte hain (writer
+// bhookha na rahe).
+#define PTHREAD_RWLOCK_WRLOCKED (-1)
+
 typedef struct {
-  volatile int readers;
-  volatile int writers;
+  volatile int state;
+  volatile int seq;
+  volatile int waiters;
   volatile int write_waiters;
   volatile pthread_t write_owner;
-  pthread_mutex_t lock;
 } pthread_rwlock_t;
 
 typedef struct {
   int pshared;
 } pthread_rwlockattr_t;
 
-#define PTHREAD_RWLOCK_INITIALIZER {0, 0, 0, 0, PTHREAD_MUTEX_INITIALIZER}
+#define PTHREAD_RWLOCK_INITIALIZER {0, 0, 0, 0, 0}
 
 // ============================================================================
 // Barrier Types
@@ -146,6 +156,13 @@ typedef struct {
 #define SCHED_FIFO 1
 #define SCHED_RR 2
 
+#ifndef _STRUCT_SCHED_PARAM
+#define _STRUCT_SCHED_PARAM // Apps ka syscall.h bhi deta hai
+struct sched_param {
+  int sched_priority; // SCHED_FIFO/SCHED_RR: 1-99, SCHED_OTHER: 0
+};
+#endif
+
 // ============================================================================
 // Cancel State/Type Constants
 // ============================================================================
@@ -184,6 +201,10 @@ int pthread_attr_setstackaddr(pthread_attr_t *attr, void *stackaddr);
 int pthread_attr_getstackaddr(const pthread_attr_t *attr, void **stackaddr);
 int pthread_attr_setschedpolicy(pthread_attr_t *attr, int policy);
 int pthread_attr_getschedpolicy(const pthread_attr_t *attr, int *policy);
+int pthread_attr_setschedparam(pthread_attr_t *attr,
+                               const struct sched_param *param);
+int pthread_attr_getschedparam(const pthread_attr_t *attr,
+                               struct sched_param *param);
 
 // ============================================================================
 // Mutex Functions
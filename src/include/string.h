@@ -11,6 +11,7 @@ void *memcpy(void *dest, const void *src, int count);
 void *memmove(void *dest, const void *src, int count);
 void *memset(void *dest, char val, int count);
 int memcmp(const void *s1, const void *s2, int n);
+void *memchr(const void *s, int c, int n);
 int strlen(const char *str);
 int strcmp(const char *s1, const char *s2);
 char *strcat(char *dest, const char *src);
@@ -69,6 +69,7 @@ unsigned int sleep(unsigned int seconds);
 int usleep(unsigned int usec);
 
 int gettimeofday(struct timeval *tv, struct timezone *tz);
+uint32_t clock_boot_time_sec(void); // Boot ka epoch second (RTC se, ek baar)
 int settimeofday(const struct timeval *tv, const struct timezone *tz);
 
 // Timer functions
@@ -27,18 +27,26 @@
 
 // From src/kernel
 #include "e1000.h"
+#include "fpu.h"
 #include "gdt.h"
 #include "heap.h"
+#include "clockevent.h"
+#include "clocksource.h"
+#include "ktimer.h"
+#include "membench.h"
 #include "memory.h"
 #include "net.h"
 #include "paging.h"
 #include "pmm.h"
 #include "process.h"
+#include "sched.h"
 #include "slab.h"
+#include "smp.h"
 #include "socket.h"
 #include "syscall.h"
 #include "tsc.h"
 #include "tty.h"
+#include "vdso.h"
 
 extern "C" void gui_main();
 extern uint32_t *back_buffer;   // graphics se liya
@@ -138,7 +146,7 @@ extern "C" void sys_get_mouse(int *x, int *y, int *btn) {
 
 extern "C" uint32_t tick;
 extern "C" uint32_t sys_time_ms() {
-  return tick * 20; // 50Hz = 20ms per tick
+  return ktime_get_ms(); // Clocksource, tick se nahi
 }
 
 // Advanced network stack initialization
@@ -154,18 +162,19 @@ extern "C" void net_thread() {
   net_advanced_init();
   net_print_status();
 
-  uint32_t lease_check_timer = 0;
+  uint32_t last_lease_check = sys_time_ms();
 
   while (1) {
     net_poll();
 
     // Periodically check DHCP lease renewal (every 60 seconds)
-    if (++lease_check_timer > 3000) { // 60s at 50Hz poll rate
-      lease_check_timer = 0;
+    if (sys_time_ms() - last_lease_check > 60000) {
+      last_lease_check = sys_time_ms();
       dhcp_check_lease();
     }
 
-    schedule();
+    // Packet (e1000 IRQ) ya net timer tak so jao - idle task chal sake
+    net_wait(1000);
   }
 }
 
@@ -326,16 +335,6 @@ extern "C" int sys_stat(const char *path, void *stat_out) {
   return 0;
 }
 
-static void enable_fpu(void) {
-  asm volatile("clts");
-  uint32_t cr0;
-  asm volatile("mov %%cr0, %0" : "=r"(cr0));
-  cr0 &= ~0x2;
-  cr0 &= ~0x200000;
-  asm volatile("mov %0, %%cr0" ::"r"(cr0));
-  asm volatile("fninit");
-}
-
 static void isr8_handler(registers_t *regs) {
   (void)regs;
   serial_log("FATAL: DOUBLE FAULT!");
@@ -343,12 +342,6 @@ static void isr8_handler(registers_t *regs) {
     ;
 }
 
-static void isr9_handler(registers_t *regs) {
-  (void)regs;
-  serial_log("EXCEPTION: #NM (FPU not available)");
-  enable_fpu();
-}
-
 extern "C" void __cxx_global_ctor_init();
 
 extern "C" int main() {
@@ -381,9 +374,11 @@ extern "C" int main() {
 
   pmm_mark_region_used(0x0, 0x100000);      // Low Memory (0-1MB)
   pmm_mark_region_used(0x100000, 0x700000); // Kernel + Placement Heap (1-8MB)
-  pmm_mark_region_used(VIRT_TO_PHYS(bitmap_addr), 16384); // PMM Bitmap at 8MB
-  // pmm_mark_region_used(0x01000000, 0x20000000); // Kernel Heap Physical
-  // (512MB) - Don't mark used!
+  // PMM Bitmap + frame table at 8MB
+  pmm_mark_region_used(VIRT_TO_PHYS(bitmap_addr), pmm_get_metadata_size());
+  // Kernel Heap boot arena (32MB, 16MB - 48MB) - buddy heap ka hai, PMM ka
+  // nahi. Baaki heap zaroorat pe PMM se 4MB arenas mein badhta hai.
+  pmm_mark_region_used(0x01000000, 0x02000000);
 
   serial_log("KERNEL: PMM After Reservations:");
   pmm_print_stats();
@@ -391,11 +386,12 @@ extern "C" int main() {
   // 3. Full paging setup (Boot mapping se unified map ki taraf)
   serial_log("KERNEL: Init Paging...");
   init_paging();
+  pmm_enable_normal_zone();
 
   // 4. Paging ke baad ki taiyari
   init_syscalls();
   register_interrupt_handler(8, (isr_t)isr8_handler);
-  register_interrupt_handler(9, (isr_t)isr9_handler);
+  fpu_init(); // x87 + SSE on, #NM (vector 7) pe lazy FXSAVE/FXRSTOR
 
   serial_log("KERNEL: Interrupts & Syscalls & GDT Ready.");
 
@@ -410,20 +406,24 @@ extern "C" int main() {
   asm volatile("sti");
 
   hpet_init();
-  tsc_calibrate();
+  clocksource_init(); // TSC (HPET se calibrated) ya HPET
+  vdso_init();        // Time page - processes se pehle (PDE copy hoti hai)
   serial_log("KERNEL: Drivers & Timers Active.");
 
-  enable_fpu();
+  pmm_benchmark();
 
-  // 6. Heap & Filesystem - 256MB heap (16MB to 272MB physical)
-  // Note: init_paging maps 0-512MB physical. Heap must stay within this range.
-  // Using 256MB to leave room for kernel, page tables, etc.
-  init_kheap(PHYS_TO_VIRT(0x01000000), PHYS_TO_VIRT(0x11000000),
+  // 6. Heap & Filesystem - 32MB boot arena (16MB to 48MB physical), 256MB tak
+  // badh sakta hai. Note: init_paging maps 0-512MB physical, aur growth
+  // arenas bhi PMM se isi direct map ke andar aate hain.
+  init_kheap(PHYS_TO_VIRT(0x01000000), PHYS_TO_VIRT(0x03000000),
              PHYS_TO_VIRT(0x11000000));
   set_heap_status(1);
   slab_init();
   extern int slab_is_initialized;
   slab_is_initialized = 1;
+  fpu_cache_init(); // FXSAVE areas - kernel_fpu_begin se pehle
+  kheap_benchmark();
+  string_benchmark();
 
   // C++ global constructors initialize karo (vtables ke liye zaroori hai)
   __cxx_global_ctor_init();
@@ -441,6 +441,7 @@ extern "C" int main() {
 
   serial_log("KERNEL: PMM After VFS:");
   pmm_print_stats();
+  pmm_print_buddy_stats();
 
   kernel_core_init();
   kernel_advanced_init();
@@ -486,6 +487,7 @@ extern "C" int main() {
 
     // 8. User Space ki shuruat
     init_multitasking();
+    sched_benchmark();
 
     // gui_main ko kernel thread ki tarah start karo
     serial_log("KERNEL: Starting GUI System...");
@@ -497,10 +499,17 @@ extern "C" int main() {
 
     // User space start karo - Non-GUI INIT chala rahe hain
     create_user_process("INIT.ELF", nullptr);
-    init_timer(50);
+    if (clockevent_init() < 0)
+      init_timer(TIMER_HZ); // LAPIC/HPET nahi - PIT ka periodic tick
+    else
+      smp_init(); // APs ka tick BSP ki LAPIC calibration pe chalta hai
     serial_log("KERNEL: Higher-Half Kernel Running.");
   }
 
+  // Boot ka kaam khatam - ab ye context idle task hai
+  if (current_process)
+    cpu_idle();
+
   while (1) {
     asm volatile("hlt");
   }
@@ -5,6 +5,7 @@
 #include "../include/string.h"
 #include "../include/types.h"
 #include "paging.h"
+#include "spinlock.h"
 
 extern "C" {
 
@@ -43,6 +44,57 @@ void lapic_init() {
 
 void lapic_eoi() { lapic_write(LAPIC_EOI, 0); }
 
+uint32_t lapic_id() { return (lapic_read(LAPIC_ID) >> 24) & 0xFF; }
+
+void lapic_init_ap() {
+  // BSP ka lapic_base hi - har CPU ko apna LAPIC usi address pe dikhta hai
+  lapic_write(LAPIC_TPR, 0);
+  lapic_write(LAPIC_SPURIOUS, lapic_read(LAPIC_SPURIOUS) | 0x1FF);
+}
+
+// ICR_HIGH mein destination, ICR_LOW likhte hi delivery. Pichla IPI abhi
+// nikla na ho to ICR likhna use kha jaata - pehle busy bit ka intezaar.
+// Beech mein IRQ is CPU ka ICR na chhede, isliye interrupts band.
+static void lapic_send(uint32_t apic_id, uint32_t low) {
+  uint32_t eflags = local_irq_save();
+  while (lapic_read(LAPIC_ICR_LOW) & LAPIC_ICR_BUSY)
+    asm volatile("pause");
+  lapic_write(LAPIC_ICR_HIGH, apic_id << 24);
+  lapic_write(LAPIC_ICR_LOW, low);
+  while (lapic_read(LAPIC_ICR_LOW) & LAPIC_ICR_BUSY)
+    asm volatile("pause");
+  local_irq_restore(eflags);
+}
+
+void lapic_send_ipi(uint32_t apic_id, uint8_t vector) {
+  lapic_send(apic_id, LAPIC_ICR_FIXED | LAPIC_ICR_ASSERT | vector);
+}
+
+void lapic_send_init(uint32_t apic_id) {
+  lapic_send(apic_id, LAPIC_ICR_INIT | LAPIC_ICR_ASSERT);
+}
+
+void lapic_send_startup(uint32_t apic_id, uint8_t page) {
+  lapic_send(apic_id, LAPIC_ICR_STARTUP | LAPIC_ICR_ASSERT | page);
+}
+
+void lapic_timer_setup(uint8_t vector, bool masked) {
+  // Bus clock / 16, mode bits 17-18 = 00 (one-shot)
+  lapic_write(LAPIC_TDCR, LAPIC_TDCR_DIV16);
+  lapic_write(LAPIC_LVT_TIMER, vector | (masked ? LAPIC_LVT_MASKED : 0));
+}
+
+// Initial count likhte hi ulti ginti shuru, 0 pe ek interrupt
+void lapic_timer_oneshot(uint32_t count) { lapic_write(LAPIC_TIC, count); }
+
+uint32_t lapic_timer_current() { return lapic_read(LAPIC_TCC); }
+
+void lapic_timer_periodic(uint8_t vector, uint32_t count) {
+  lapic_write(LAPIC_TDCR, LAPIC_TDCR_DIV16);
+  lapic_write(LAPIC_LVT_TIMER, vector | LAPIC_LVT_PERIODIC);
+  lapic_write(LAPIC_TIC, count);
+}
+
 static void ioapic_write(uint32_t reg, uint32_t value) {
   *(volatile uint32_t *)(ioapic_base) = reg;
   *(volatile uint32_t *)(ioapic_base + 0x10) = value;
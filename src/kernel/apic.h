@@ -25,6 +25,18 @@
 #define LAPIC_TCC 0x390
 #define LAPIC_TDCR 0x3E0
 
+// LVT timer / divide config
+#define LAPIC_LVT_MASKED (1 << 16)
+#define LAPIC_LVT_PERIODIC (1 << 17)
+#define LAPIC_TDCR_DIV16 0x3
+
+// ICR (Interrupt Command Register): low word likhte hi IPI nikal jaata hai
+#define LAPIC_ICR_FIXED 0x00000000
+#define LAPIC_ICR_INIT 0x00000500
+#define LAPIC_ICR_STARTUP 0x00000600
+#define LAPIC_ICR_BUSY (1 << 12)   // Delivery status: abhi bhej raha hai
+#define LAPIC_ICR_ASSERT (1 << 14) // Level assert (INIT de-assert ke alawa sab)
+
 // IO-APIC Registers (Offsets for IOREGSEL)
 #define IOAPIC_ID 0x00
 #define IOAPIC_VER 0x01
@@ -40,11 +52,28 @@ extern uint32_t ioapic_base;
 
 void lapic_init();
 void lapic_eoi();
+uint32_t lapic_id(); // Is CPU ka APIC ID
+
+// AP pe: apna LAPIC chalu (spurious vector + enable bit)
+void lapic_init_ap();
+
+// Ek CPU ko fixed-vector IPI (resched, TLB shootdown)
+void lapic_send_ipi(uint32_t apic_id, uint8_t vector);
+// AP bring-up: INIT, phir STARTUP - AP real mode mein page * 4KB se shuru
+void lapic_send_init(uint32_t apic_id);
+void lapic_send_startup(uint32_t apic_id, uint8_t page);
 void ioapic_init();
 void ioapic_set_irq(uint8_t irq, uint64_t vector_data);
 void ioapic_set_mask(uint8_t irq, bool masked);
 void apic_map_hardware();
 
+// LAPIC timer, one-shot mode: count 0 = band
+void lapic_timer_setup(uint8_t vector, bool masked);
+void lapic_timer_oneshot(uint32_t count);
+uint32_t lapic_timer_current();
+// Periodic mode (APs ka tick): har count pe ek interrupt, khud reload
+void lapic_timer_periodic(uint8_t vector, uint32_t count);
+
 #ifdef __cplusplus
 }
 #endif
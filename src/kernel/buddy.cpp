@@ -23,11 +23,78 @@ static int get_order_floor(size_t n) {
   return order;
 }
 
-void buddy_init(buddy_t *b, uintptr_t start, uintptr_t end) {
+// Block ka index uske order pe (start_addr se relative)
+static inline uint32_t block_index(buddy_t *b, uintptr_t addr, int order) {
+  return (uint32_t)((addr - b->start_addr) >> order);
+}
+
+static inline int bit_test(uint32_t *map, uint32_t i) {
+  return (map[i >> 5] >> (i & 31)) & 1;
+}
+
+static inline void bit_set(uint32_t *map, uint32_t i) {
+  map[i >> 5] |= 1u << (i & 31);
+}
+
+static inline void bit_clear(uint32_t *map, uint32_t i) {
+  map[i >> 5] &= ~(1u << (i & 31));
+}
+
+static void list_insert(buddy_t *b, uintptr_t addr, int order) {
+  int idx = order - BUDDY_MIN_ORDER;
+  buddy_block_t *block = (buddy_block_t *)addr;
+  block->prev = nullptr;
+  block->next = b->free_lists[idx];
+  if (block->next)
+    block->next->prev = block;
+  b->free_lists[idx] = block;
+  bit_set(b->free_bitmap[idx], block_index(b, addr, order));
+  b->nr_free[idx]++;
+  b->free_bytes += (uint32_t)1 << order;
+}
+
+static void list_remove(buddy_t *b, uintptr_t addr, int order) {
+  int idx = order - BUDDY_MIN_ORDER;
+  buddy_block_t *block = (buddy_block_t *)addr;
+  if (block->prev)
+    block->prev->next = block->next;
+  else
+    b->free_lists[idx] = block->next;
+  if (block->next)
+    block->next->prev = block->prev;
+  bit_clear(b->free_bitmap[idx], block_index(b, addr, order));
+  b->nr_free[idx]--;
+  b->free_bytes -= (uint32_t)1 << order;
+}
+
+// Har order pe (range >> order) bits, +2 taaki aakhri block ka buddy index
+// bhi bitmap ke andar rahe
+static uint32_t bitmap_words(uintptr_t start, uintptr_t end, int i) {
+  uint32_t bits = (uint32_t)((end - start) >> (i + BUDDY_MIN_ORDER)) + 2;
+  return (bits + 31) / 32;
+}
+
+uint32_t buddy_bitmap_bytes(uintptr_t start, uintptr_t end) {
+  uint32_t bytes = 0;
+  for (int i = 0; i < BUDDY_NUM_ORDERS; i++)
+    bytes += bitmap_words(start, end, i) * sizeof(uint32_t);
+  return bytes;
+}
+
+void buddy_init_bitmap(buddy_t *b, uintptr_t start, uintptr_t end,
+                       uint32_t *map) {
+  for (int i = 0; i < BUDDY_NUM_ORDERS; i++) {
+    b->free_lists[i] = nullptr;
+    b->nr_free[i] = 0;
+  }
+  b->free_bytes = 0;
   b->start_addr = start;
   b->end_addr = end;
+
+  memset(map, 0, buddy_bitmap_bytes(start, end));
   for (int i = 0; i < BUDDY_NUM_ORDERS; i++) {
-    b->free_lists[i] = nullptr;
+    b->free_bitmap[i] = map;
+    map += bitmap_words(start, end, i);
   }
 
   // Initialize with varying sized blocks to cover the entire range
@@ -41,21 +108,21 @@ void buddy_init(buddy_t *b, uintptr_t start, uintptr_t end) {
     if (order < BUDDY_MIN_ORDER)
       break;
 
-    size_t block_size = (size_t)1 << order;
-    int list_idx = order - BUDDY_MIN_ORDER;
-    if (list_idx >= 0 && list_idx < BUDDY_NUM_ORDERS) {
-      buddy_block_t *block = (buddy_block_t *)current;
-      block->next = b->free_lists[list_idx];
-      b->free_lists[list_idx] = block;
-    }
-
-    current += block_size;
+    list_insert(b, current, order);
+    current += (size_t)1 << order;
   }
+}
+
+void buddy_init(buddy_t *b, uintptr_t start, uintptr_t end) {
+  // Bitmaps range ke shuru mein, pool unke baad (page aligned) se
+  uintptr_t meta = (buddy_bitmap_bytes(start, end) + 0xFFF) & ~(uintptr_t)0xFFF;
+  buddy_init_bitmap(b, start + meta, end, (uint32_t *)start);
 
   serial_log("BUDDY: Initialized pool over full range.");
+  serial_log_hex("BUDDY: Bitmap bytes: ", (uint32_t)meta);
 }
 
-void *buddy_alloc(buddy_t *b, size_t size) {
+void *buddy_alloc_flags(buddy_t *b, size_t size, uint32_t flags) {
   int order = get_order(size);
   if (order < BUDDY_MIN_ORDER)
     order = BUDDY_MIN_ORDER;
@@ -66,93 +133,69 @@ void *buddy_alloc(buddy_t *b, size_t size) {
 
   for (int i = list_idx; i < BUDDY_NUM_ORDERS; i++) {
     if (b->free_lists[i]) {
-      buddy_block_t *block = b->free_lists[i];
-      b->free_lists[i] = block->next;
+      uintptr_t addr = (uintptr_t)b->free_lists[i];
+      list_remove(b, addr, i + BUDDY_MIN_ORDER);
 
+      // Upar wala aadha free list mein, neeche wala aage split hota hai
       while (i > list_idx) {
         i--;
-        uintptr_t addr = (uintptr_t)block;
-        buddy_block_t *buddy =
-            (buddy_block_t *)(addr + ((uintptr_t)1 << (i + BUDDY_MIN_ORDER)));
-        buddy->next = b->free_lists[i];
-        b->free_lists[i] = buddy;
+        list_insert(b, addr + ((uintptr_t)1 << (i + BUDDY_MIN_ORDER)),
+                    i + BUDDY_MIN_ORDER);
       }
 
-      memset(block, 0, (size_t)1 << order);
-      return (void *)block;
+      if (!(flags & BUDDY_NOZERO))
+        memset((void *)addr, 0, (size_t)1 << order);
+      return (void *)addr;
     }
   }
 
   return nullptr;
 }
 
+void *buddy_alloc(buddy_t *b, size_t size) {
+  return buddy_alloc_flags(b, size, 0);
+}
+
 void buddy_free(buddy_t *b, void *ptr, size_t size) {
   if (!ptr)
     return;
 
-  int current_order =
-      get_order(size); // This is the order of the block being freed
-  if (current_order < BUDDY_MIN_ORDER)
-    current_order = BUDDY_MIN_ORDER;
+  int order = get_order(size);
+  if (order < BUDDY_MIN_ORDER)
+    order = BUDDY_MIN_ORDER;
 
   uintptr_t addr = (uintptr_t)ptr;
 
-  // Loop to coalesce with buddies of increasing order
-  // The loop variable 'current_order' here represents the *order* of the block
-  // we are currently trying to free/coalesce It starts at the initial block's
-  // order and goes up as blocks are coalesced.
-  for (; current_order < BUDDY_MAX_ORDER; current_order++) {
-    int list_idx = current_order - BUDDY_MIN_ORDER;
-
-    if (list_idx >= BUDDY_NUM_ORDERS) {
-      // This should ideally not be reached if BUDDY_MAX_ORDER is correctly
-      // defined relative to BUDDY_NUM_ORDERS.
+  // Har level pe buddy ka bit O(1) mein: free hai toh list se nikaal ke jodo
+  for (; order < BUDDY_MAX_ORDER; order++) {
+    uintptr_t block_size = (uintptr_t)1 << order;
+    uintptr_t buddy_addr = ((addr - b->start_addr) ^ block_size) + b->start_addr;
+    if (buddy_addr + block_size > b->end_addr)
       break;
-    }
-
-    size_t block_size = (size_t)1 << current_order;
-    uintptr_t relative_addr = addr - b->start_addr;
-    uintptr_t buddy_addr = (relative_addr ^ block_size) + b->start_addr;
-
-    // Search for the buddy in the free list for the current_order
-    buddy_block_t **prev = &b->free_lists[list_idx];
-    buddy_block_t *curr = b->free_lists[list_idx];
-    bool found_buddy = false;
-
-    while (curr) {
-      if ((uintptr_t)curr == buddy_addr) {
-        // Remove buddy from free list
-        *prev = curr->next;
-        found_buddy = true;
-        break;
-      }
-      prev = &curr->next;
-      curr = curr->next;
-    }
-
-    if (!found_buddy) {
-      // Buddy not free, or not found in the current order's list.
-      // Stop coalescing and add the current block (addr) to this order's list.
+    if (!bit_test(b->free_bitmap[order - BUDDY_MIN_ORDER],
+                  block_index(b, buddy_addr, order)))
       break;
-    }
+
+    list_remove(b, buddy_addr, order);
 
     // Coalesce: new block starts at the lower of the two addresses
-    if (buddy_addr < addr) {
+    if (buddy_addr < addr)
       addr = buddy_addr;
-    }
-    // Continue to next order with the newly coalesced block (addr)
   }
 
-  // After the loop, 'addr' is the base address of the largest coalesced block,
-  // and 'current_order' is its order.
-  int final_list_idx = current_order - BUDDY_MIN_ORDER;
-  if (final_list_idx < 0 || final_list_idx >= BUDDY_NUM_ORDERS) {
-    // This indicates an error in order calculation or bounds.
-    // For safety, we might log an error or panic here in a real system.
-    return;
-  }
+  list_insert(b, addr, order);
+}
 
-  buddy_block_t *block = (buddy_block_t *)addr;
-  block->next = b->free_lists[final_list_idx];
-  b->free_lists[final_list_idx] = block;
+void buddy_get_stats(buddy_t *b, buddy_stats_t *out) {
+  out->free_bytes = b->free_bytes;
+  out->largest_free = 0;
+  for (int i = 0; i < BUDDY_NUM_ORDERS; i++) {
+    out->nr_free[i] = b->nr_free[i];
+    if (b->nr_free[i])
+      out->largest_free = (uint32_t)1 << (i + BUDDY_MIN_ORDER);
+  }
+  // Dono 4KB ke multiple hain - pages mein gino taaki 32-bit mein rahe
+  out->frag_pct = b->free_bytes ? 100 - ((out->largest_free >> 12) * 100) /
+                                            (b->free_bytes >> 12)
+                                : 0;
 }
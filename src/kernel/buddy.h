@@ -7,23 +7,48 @@
 #define BUDDY_MAX_ORDER 28 // 256MB
 #define BUDDY_NUM_ORDERS (BUDDY_MAX_ORDER - BUDDY_MIN_ORDER + 1)
 
+// buddy_alloc_flags flags
+#define BUDDY_NOZERO 0x01 // Caller poora block khud likhega - memset skip
+
+// Free block ke andar hi list links (doubly linked -> O(1) remove)
 typedef struct buddy_block {
   struct buddy_block *next;
+  struct buddy_block *prev;
 } buddy_block_t;
 
 typedef struct {
   uintptr_t start_addr;
   uintptr_t end_addr;
   buddy_block_t *free_lists[BUDDY_NUM_ORDERS];
+  // Per-order bitmap: bit set = is order pe ye block free list mein hai.
+  // Coalesce ke waqt buddy ka bit dekh lo, list walk nahi.
+  uint32_t *free_bitmap[BUDDY_NUM_ORDERS];
+  uint32_t nr_free[BUDDY_NUM_ORDERS];
+  uint32_t free_bytes;
 } buddy_t;
 
+// Fragmentation dekhne ke liye
+typedef struct {
+  uint32_t free_bytes;
+  uint32_t largest_free; // Sabse bada free block (bytes)
+  uint32_t frag_pct; // 100 - largest_free * 100 / free_bytes
+  uint32_t nr_free[BUDDY_NUM_ORDERS];
+} buddy_stats_t;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+// Bitmaps range ke start se carve hote hain, start_addr unke baad se
 void buddy_init(buddy_t *b, uintptr_t start, uintptr_t end);
-void *buddy_alloc(buddy_t *b, size_t size);
+// Bitmap storage caller deta hai (buddy_bitmap_bytes jitni), poori range pool
+void buddy_init_bitmap(buddy_t *b, uintptr_t start, uintptr_t end,
+                       uint32_t *map);
+uint32_t buddy_bitmap_bytes(uintptr_t start, uintptr_t end);
+void *buddy_alloc(buddy_t *b, size_t size); // Zeroed block
+void *buddy_alloc_flags(buddy_t *b, size_t size, uint32_t flags);
 void buddy_free(buddy_t *b, void *ptr, size_t size);
+void buddy_get_stats(buddy_t *b, buddy_stats_t *out);
 
 #ifdef __cplusplus
 }
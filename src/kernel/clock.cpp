@@ -9,17 +9,62 @@
 #include "../include/signal.h"
 #include "../include/time.h"
 #include "heap.h"
+#include "clockevent.h"
+#include "clocksource.h"
+#include "ktimer.h"
 #include "process.h"
 
 extern "C" {
 
-// Global tick counter (100Hz maan ke chal rahe hain)
+// Global tick counter (TIMER_HZ pe - LAPIC clockevent ya PIT)
 extern uint32_t tick;
-#define TICKS_PER_SEC 100
+#define TICKS_PER_SEC TIMER_HZ
 
-// Boot time (init ke waqt set hota hai)
+// timespec -> ticks, upar round
+static uint32_t timespec_to_ticks(const struct timespec *ts) {
+  return ts->tv_sec * TICKS_PER_SEC +
+         (ts->tv_nsec + NS_PER_TICK - 1) / NS_PER_TICK;
+}
+
+// Boot ka epoch second - pehli baar RTC padh ke, us waqt ka uptime ghata
+// ke. Uske baad REALTIME = boot_time_sec + monotonic: CMOS har call pe nahi
+// padhna padta, aur vDSO page bhi yahi formula chala sakta hai.
 static uint32_t boot_time_sec = 0;
 
+// RTC -> seconds since epoch (simplified - assumes 2000 base)
+static uint32_t rtc_to_epoch(const rtc_time_t *rtc) {
+  uint32_t days = 0;
+  for (int y = 2000; y < 2000 + rtc->year; y++) {
+    bool leap = ((y % 4 == 0) && (y % 100 != 0)) || (y % 400 == 0);
+    days += leap ? 366 : 365;
+  }
+
+  int month_days[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+  bool is_leap = ((2000 + rtc->year) % 4 == 0);
+  if (is_leap)
+    month_days[1] = 29;
+
+  for (int m = 0; m < rtc->month - 1; m++) {
+    days += month_days[m];
+  }
+  days += rtc->day - 1;
+
+  uint32_t secs =
+      days * 86400 + rtc->hour * 3600 + rtc->minute * 60 + rtc->second;
+  return secs + 946684800; // Seconds from 1970 to 2000
+}
+
+uint32_t clock_boot_time_sec(void) {
+  if (!boot_time_sec) {
+    rtc_time_t rtc;
+    rtc_read(&rtc);
+    uint32_t up, nsec;
+    ns_to_sec_nsec(ktime_get_ns(), &up, &nsec);
+    boot_time_sec = rtc_to_epoch(&rtc) - up;
+  }
+  return boot_time_sec;
+}
+
 // ============================================================================
 // clock_gettime - High-resolution time nikalne ke liye
 // ============================================================================
@@ -28,38 +73,13 @@ int clock_gettime(clockid_t clk_id, struct timespec *tp) {
   if (!tp)
     return -EFAULT;
 
-  uint32_t current_tick = tick;
-
   switch (clk_id) {
   case CLOCK_REALTIME:
   case CLOCK_REALTIME_COARSE: {
-    // Get RTC time
-    rtc_time_t rtc;
-    rtc_read(&rtc);
-
-    // Convert to seconds since epoch (simplified - assumes 2000 base)
-    uint32_t days = 0;
-    for (int y = 2000; y < 2000 + rtc.year; y++) {
-      bool leap = ((y % 4 == 0) && (y % 100 != 0)) || (y % 400 == 0);
-      days += leap ? 366 : 365;
-    }
-
-    int month_days[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
-    bool is_leap = ((2000 + rtc.year) % 4 == 0);
-    if (is_leap)
-      month_days[1] = 29;
-
-    for (int m = 0; m < rtc.month - 1; m++) {
-      days += month_days[m];
-    }
-    days += rtc.day - 1;
-
-    uint32_t secs =
-        days * 86400 + rtc.hour * 3600 + rtc.minute * 60 + rtc.second;
-    secs += 946684800; // Seconds from 1970 to 2000
-
-    tp->tv_sec = secs;
-    tp->tv_nsec = (current_tick % TICKS_PER_SEC) * (1000000000 / TICKS_PER_SEC);
+    uint32_t sec, nsec;
+    ns_to_sec_nsec(ktime_get_ns(), &sec, &nsec);
+    tp->tv_sec = clock_boot_time_sec() + sec;
+    tp->tv_nsec = nsec;
     return 0;
   }
 
@@ -67,9 +87,11 @@ int clock_gettime(clockid_t clk_id, struct timespec *tp) {
   case CLOCK_MONOTONIC_RAW:
   case CLOCK_MONOTONIC_COARSE:
   case CLOCK_BOOTTIME: {
-    // Time since boot
-    tp->tv_sec = current_tick / TICKS_PER_SEC;
-    tp->tv_nsec = (current_tick % TICKS_PER_SEC) * (1000000000 / TICKS_PER_SEC);
+    // Time since boot - clocksource se ns resolution
+    uint32_t sec, nsec;
+    ns_to_sec_nsec(ktime_get_ns(), &sec, &nsec);
+    tp->tv_sec = sec;
+    tp->tv_nsec = nsec;
     return 0;
   }
 
@@ -125,21 +147,26 @@ int clock_getres(clockid_t clk_id, struct timespec *res) {
     return 0; // NULL is valid, just don't fill anything
 
   switch (clk_id) {
-  case CLOCK_REALTIME:
   case CLOCK_MONOTONIC:
+  case CLOCK_MONOTONIC_RAW:
   case CLOCK_BOOTTIME:
+    // Clocksource ka ek step (TSC ~1ns, HPET ~10ns), warna ek tick
+    res->tv_sec = 0;
+    res->tv_nsec = clocksource ? clocksource_resolution_ns() : NS_PER_TICK;
+    return 0;
+
+  case CLOCK_REALTIME:
   case CLOCK_REALTIME_COARSE:
   case CLOCK_MONOTONIC_COARSE:
-    // 10ms resolution (100Hz timer)
+    // Ek tick ki resolution
     res->tv_sec = 0;
-    res->tv_nsec = 10000000; // 10ms in nanoseconds
+    res->tv_nsec = NS_PER_TICK;
     return 0;
 
-  case CLOCK_MONOTONIC_RAW:
   case CLOCK_PROCESS_CPUTIME_ID:
   case CLOCK_THREAD_CPUTIME_ID:
     res->tv_sec = 0;
-    res->tv_nsec = 10000000;
+    res->tv_nsec = NS_PER_TICK;
     return 0;
 
   default:
@@ -159,16 +186,13 @@ int nanosleep(const struct timespec *req, struct timespec *rem) {
     return -EINVAL;
 
   // Convert to ticks
-  uint32_t sleep_ticks = req->tv_sec * TICKS_PER_SEC;
-  sleep_ticks += (req->tv_nsec + 9999999) / 10000000; // Round up
+  uint32_t sleep_ticks = timespec_to_ticks(req);
 
   if (sleep_ticks == 0)
     sleep_ticks = 1; // Minimum 1 tick
 
   uint32_t start = tick;
-  current_process->sleep_until = tick + sleep_ticks;
-  current_process->state = PROCESS_SLEEPING;
-  schedule();
+  process_sleep(sleep_ticks);
 
   // Check karo agar jaldi jag gaye (kisi signal ki wajah se)
   uint32_t elapsed = tick - start;
@@ -177,7 +201,7 @@ int nanosleep(const struct timespec *req, struct timespec *rem) {
     if (rem) {
       uint32_t remaining = sleep_ticks - elapsed;
       rem->tv_sec = remaining / TICKS_PER_SEC;
-      rem->tv_nsec = (remaining % TICKS_PER_SEC) * 10000000;
+      rem->tv_nsec = (remaining % TICKS_PER_SEC) * NS_PER_TICK;
     }
     return -EINTR;
   }
@@ -322,10 +346,25 @@ struct kernel_timer {
   int signo; // Signal to send
   struct itimerspec value;
   uint32_t next_fire; // Is tick pe timer bajega
+  ktimer_t wheel;     // next_fire pe posix_timer_fire
 };
 
 static struct kernel_timer timers[MAX_TIMERS];
 
+// Timer baja - owner ko signal, periodic ho to agla interval arm karo
+static void posix_timer_fire(ktimer_t *wheel) {
+  struct kernel_timer *t = (struct kernel_timer *)wheel->data;
+  sys_kill(t->pid, t->signo);
+
+  if (t->value.it_interval.tv_sec != 0 || t->value.it_interval.tv_nsec != 0) {
+    t->next_fire = tick + timespec_to_ticks(&t->value.it_interval);
+    timer_add(&t->wheel, t->next_fire);
+  } else {
+    // One-shot timer
+    t->next_fire = 0;
+  }
+}
+
 int timer_create(clockid_t clockid, void *sevp, timer_t *timerid) {
   (void)sevp; // Signal event structure - simplified
 
@@ -347,6 +386,7 @@ int timer_create(clockid_t clockid, void *sevp, timer_t *timerid) {
       timers[i].value.it_interval.tv_nsec = 0;
       timers[i].value.it_value.tv_sec = 0;
       timers[i].value.it_value.tv_nsec = 0;
+      timer_setup(&timers[i].wheel, posix_timer_fire, &timers[i]);
       *timerid = i;
       return 0;
     }
@@ -359,6 +399,7 @@ int timer_delete(timer_t timerid) {
   if (timerid < 0 || timerid >= MAX_TIMERS || !timers[timerid].in_use)
     return -EINVAL;
 
+  timer_del(&timers[timerid].wheel);
   timers[timerid].in_use = 0;
   return 0;
 }
@@ -383,9 +424,9 @@ int timer_settime(timer_t timerid, int flags,
   if (new_value->it_value.tv_sec == 0 && new_value->it_value.tv_nsec == 0) {
     // Disarm timer
     t->next_fire = 0;
+    timer_del(&t->wheel);
   } else {
-    uint32_t fire_ticks = new_value->it_value.tv_sec * TICKS_PER_SEC;
-    fire_ticks += (new_value->it_value.tv_nsec + 9999999) / 10000000;
+    uint32_t fire_ticks = timespec_to_ticks(&new_value->it_value);
 
     if (flags & TIMER_ABSTIME) {
       // Absolute time - need to convert
@@ -394,6 +435,7 @@ int timer_settime(timer_t timerid, int flags,
       // Relative time
       t->next_fire = tick + fire_ticks;
     }
+    mod_timer(&t->wheel, t->next_fire);
   }
 
   return 0;
@@ -430,35 +472,6 @@ int timer_getoverrun(timer_t timerid) {
   return 0; // Overrun tracking not implemented
 }
 
-// ============================================================================
-// check_timers - Timer interrupt se bar-bar call hota hai
-// ============================================================================
-
-void check_timers(void) {
-  for (int i = 0; i < MAX_TIMERS; i++) {
-    if (!timers[i].in_use || timers[i].next_fire == 0)
-      continue;
-
-    if (tick >= timers[i].next_fire) {
-      // Timer fired - send signal to owner
-      sys_kill(timers[i].pid, timers[i].signo);
-
-      // Check for periodic timer
-      if (timers[i].value.it_interval.tv_sec != 0 ||
-          timers[i].value.it_interval.tv_nsec != 0) {
-        // Reset for next interval
-        uint32_t interval_ticks =
-            timers[i].value.it_interval.tv_sec * TICKS_PER_SEC +
-            (timers[i].value.it_interval.tv_nsec + 9999999) / 10000000;
-        timers[i].next_fire = tick + interval_ticks;
-      } else {
-        // One-shot timer
-        timers[i].next_fire = 0;
-      }
-    }
-  }
-}
-
 // ============================================================================
 // clock_init - Initialize clock subsystem
 // ============================================================================
@@ -475,8 +488,7 @@ void clock_init(void) {
 // ============================================================================
 
 uint32_t timer_now_ms(void) {
-  // tick runs at 100Hz, so each tick is 10ms
-  return tick * 10;
+  return ktime_get_ms();
 }
 
 } // extern "C"
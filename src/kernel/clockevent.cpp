@@ -0,0 +1,175 @@
+#include "clockevent.h"
+#include "../drivers/hpet.h"
+#include "../drivers/serial.h"
+#include "../include/isr.h"
+#include "apic.h"
+#include "clocksource.h"
+#include "ktimer.h"
+#include "sched.h"
+#include "smp.h"
+#include "spinlock.h"
+#include "vdso.h"
+
+extern uint32_t tick;
+
+static int clockevent_active = 0;
+static uint32_t lapic_per_ms = 0; // LAPIC counts per ms (bus / 16)
+static uint32_t lapic_mult = 0;   // counts = (ns * lapic_mult) >> 32
+static uint64_t tick_next_ns = 0; // Is waqt tick agli baar badhega
+static uint64_t event_ns = 0;     // LAPIC is waqt bajega
+static int tick_stopped = 0;      // Agli deadline tick boundary nahi
+
+// tick kisi bhi CPU ke schedule() se badh sakta hai - ek waqt mein ek
+static DEFINE_SPINLOCK(jiffies_lock, "jiffies");
+
+uint64_t ktime_get_ns() {
+  if (clocksource)
+    return clocksource_ns();
+  return (uint64_t)tick * NS_PER_TICK;
+}
+
+uint32_t ktime_get_ms() {
+  uint32_t sec, nsec;
+  ns_to_sec_nsec(ktime_get_ns(), &sec, &nsec);
+  return sec * 1000 + nsec / 1000000;
+}
+
+void clockevent_update_jiffies(uint64_t now) {
+  if (!clockevent_active || now < tick_next_ns)
+    return;
+  // Doosra CPU badha raha hai to wahi kaafi - yahan intezaar nahi
+  if (!spin_trylock(&jiffies_lock))
+    return;
+  if (now >= tick_next_ns) {
+    // Aam taur pe ek hi tick - division (__udivdi3) sirf lambe idle ke baad
+    uint64_t late = now - tick_next_ns;
+    uint64_t n = late < NS_PER_TICK ? 1 : late / NS_PER_TICK + 1;
+    tick += (uint32_t)n;
+    tick_next_ns += n * NS_PER_TICK;
+    vdso_update_tick(now);
+  }
+  spin_unlock(&jiffies_lock);
+}
+
+// Tick number t kab shuru hoga (ns)
+static uint64_t tick_to_ns(uint32_t t) {
+  int32_t d = (int32_t)(t - tick);
+  if (d <= 1)
+    return tick_next_ns;
+  return tick_next_ns + (uint64_t)(d - 1) * NS_PER_TICK;
+}
+
+static void clockevent_program(uint64_t when, uint64_t now) {
+  uint64_t delta = when > now ? when - now : 0;
+  if (delta > CLOCKEVENT_MAX_NS)
+    delta = CLOCKEVENT_MAX_NS;
+  uint64_t count = mul_u64_u32_shr(delta, lapic_mult, 32);
+  if (count < CLOCKEVENT_MIN_COUNT)
+    count = CLOCKEVENT_MIN_COUNT;
+  event_ns = now + delta;
+  lapic_timer_oneshot((uint32_t)count);
+}
+
+// Agli deadline: runnable tasks ke beech baantna ho to agla tick, warna
+// sirf agla timer. Sirf BSP (uska LAPIC, usi ki queue).
+static void clockevent_reprogram(uint64_t now) {
+  // Throttled RT ki window tick pe hi khatam hoti hai
+  if (sched_nr_runnable_cpu(0) > 1 || cpu_rq(0)->rt.throttled) {
+    tick_stopped = 0;
+    clockevent_program(tick_next_ns, now);
+  } else {
+    tick_stopped = 1;
+    clockevent_program(tick_to_ns(timer_next_expiry()), now);
+  }
+}
+
+static void clockevent_interrupt(registers_t *regs) {
+  (void)regs;
+  uint64_t now = sched_clock_ns();
+  clockevent_update_jiffies(now);
+
+  if (smp_processor_id()) {
+    // AP ka periodic tick: sirf time slicing aur balancing. Timers aur
+    // tickless BSP pe hi (big kernel lock ke andar).
+    sched_balance_tick();
+    schedule();
+    return;
+  }
+
+  // Sleepers, alarms, POSIX timers, network timeouts - sab timer wheel pe
+  run_timers();
+
+  clockevent_reprogram(now);
+  sched_balance_tick();
+  schedule();
+}
+
+void clockevent_kick() {
+  if (!clockevent_active || !tick_stopped || sched_nr_runnable_cpu(0) <= 1)
+    return;
+  if (smp_processor_id()) {
+    // BSP ka LAPIC wahi program kare - IPI pe clockevent_ipi
+    smp_send_reschedule(0);
+    return;
+  }
+  tick_stopped = 0;
+  if (event_ns > tick_next_ns)
+    clockevent_program(tick_next_ns, sched_clock_ns());
+}
+
+void clockevent_timer_added(uint32_t expires) {
+  if (!clockevent_active || !tick_stopped)
+    return;
+  if (smp_processor_id()) {
+    smp_send_reschedule(0);
+    return;
+  }
+  uint64_t when = tick_to_ns(expires);
+  if (when < event_ns)
+    clockevent_program(when, sched_clock_ns());
+}
+
+void clockevent_ipi() {
+  if (!clockevent_active || !tick_stopped)
+    return;
+  clockevent_reprogram(sched_clock_ns());
+}
+
+void clockevent_init_ap() {
+  lapic_timer_periodic(LAPIC_TIMER_VECTOR,
+                       lapic_per_ms * (NS_PER_TICK / 1000000));
+}
+
+int clockevent_init() {
+  if (!lapic_base || !hpet_get_period_fs()) {
+    serial_log("CLOCKEVENT: No LAPIC/HPET, using PIT.");
+    return -1;
+  }
+
+  // Masked LAPIC timer ko poori ginti se chhodo, HPET pe 10ms gino
+  lapic_timer_setup(LAPIC_TIMER_VECTOR, true);
+  uint64_t start = sched_clock_ns();
+  lapic_timer_oneshot(0xFFFFFFFF);
+  while (sched_clock_ns() - start < CLOCKEVENT_CALIB_NS)
+    asm volatile("pause");
+  uint32_t elapsed = 0xFFFFFFFF - lapic_timer_current();
+  lapic_timer_oneshot(0);
+
+  lapic_per_ms = elapsed / (uint32_t)(CLOCKEVENT_CALIB_NS / 1000000ULL);
+  if (!lapic_per_ms) {
+    serial_log("CLOCKEVENT: LAPIC calibration failed, using PIT.");
+    return -1;
+  }
+  lapic_mult = (uint32_t)(((uint64_t)lapic_per_ms << 32) / 1000000ULL);
+  serial_log_hex("CLOCKEVENT: LAPIC counts per ms: ", lapic_per_ms);
+
+  uint32_t eflags = local_irq_save();
+  register_interrupt_handler(LAPIC_TIMER_VECTOR, clockevent_interrupt);
+  lapic_timer_setup(LAPIC_TIMER_VECTOR, false);
+  uint64_t now = sched_clock_ns();
+  tick_next_ns = now + NS_PER_TICK;
+  clockevent_active = 1;
+  clockevent_program(tick_next_ns, now);
+  local_irq_restore(eflags);
+  return 0;
+}
@@ -0,0 +1,58 @@
+// Clockevent - LAPIC timer one-shot mode mein, tickless idle ke saath
+#ifndef CLOCKEVENT_H
+#define CLOCKEVENT_H
+
+#include "../include/types.h"
+
+// Har interrupt pe LAPIC ko agli deadline pe program karte hain:
+// - ek se zyada task runnable: agla tick boundary (periodic jaisa, time
+//   slicing ke liye)
+// - nahi to: timer wheel ki agli expiry tak kuch nahi - idle CPU pe
+//   50 interrupts/sec ki jagah sirf jab koi timer bajna ho
+// tick (jiffies) har baar HPET clock se aage badhaya jaata hai, isliye
+// chhoote hue ticks bhi gin liye jaate hain. LAPIC ki rate HPET se
+// calibrate hoti hai. LAPIC/HPET na ho to purana PIT periodic tick.
+// ns -> LAPIC counts bhi mult/shift se, programming mein division nahi.
+// SMP: ye sab BSP ka; APs ka LAPIC periodic tick (slicing + balancing).
+#define LAPIC_TIMER_VECTOR 48
+#define CLOCKEVENT_CALIB_NS 10000000ULL   // Calibration window (10ms)
+#define CLOCKEVENT_MAX_NS 10000000000ULL  // Ek one-shot ki max doori
+#define CLOCKEVENT_MIN_COUNT 16           // Isse chhoti LAPIC ginti nahi
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// LAPIC timer calibrate karke chalu. 0, ya -1 agar LAPIC/HPET nahi (tab
+// caller init_timer se PIT lagaye)
+int clockevent_init();
+
+// Monotonic ns since boot: clocksource se, warna tick * NS_PER_TICK
+uint64_t ktime_get_ns();
+uint32_t ktime_get_ms();
+
+// HPET clock (now) ke hisaab se tick aage badhao. schedule() se bhi -
+// tick band ho tab bhi tick padhne wale loops ko sahi waqt mile.
+void clockevent_update_jiffies(uint64_t now);
+
+// Tick band hai aur ab ek se zyada task runnable: periodic tick wapas.
+// sched_wakeup se, interrupts band.
+void clockevent_kick();
+
+// Naya timer expires tick pe - tick band ho aur ye programmed deadline se
+// pehle ho to LAPIC jaldi bajao. ktimer se, interrupts band.
+void clockevent_timer_added(uint32_t expires);
+
+// BSP pe resched IPI: kisi AP ne BSP ki queue pe task ya naya timer daala
+// (kick/timer_added AP pe sirf IPI bhejte hain) - tick band ho to deadline
+// dobara nikalo
+void clockevent_ipi();
+
+// AP ka LAPIC timer: BSP ki calibration se periodic tick, usi vector pe
+void clockevent_init_ap();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,96 @@
+#include "clocksource.h"
+#include "../drivers/hpet.h"
+#include "../drivers/serial.h"
+#include "tsc.h"
+
+clocksource_t *clocksource = 0;
+static uint64_t clocksource_base = 0; // Init pe counter value
+
+static clocksource_t hpet_clocksource = {"hpet", hpet_read_counter, 0, 0, 0,
+                                         CLOCKSOURCE_RATING_HPET};
+static clocksource_t tsc_clocksource = {"tsc", rdtsc, 0, 0, 0,
+                                        CLOCKSOURCE_RATING_TSC};
+
+// ns per cycle = num / den. Sabse bada shift (<= 32) jisme mult 32 bits
+// mein aaye - jitna bada shift utni precision.
+static void clocksource_calc_mult_shift(clocksource_t *cs, uint64_t num,
+                                        uint64_t den) {
+  uint32_t shift = 32;
+  uint64_t mult;
+  for (;;) {
+    mult = (num << shift) / den;
+    if (mult <= 0xFFFFFFFFULL || shift == 0)
+      break;
+    shift--;
+  }
+  cs->mult = (uint32_t)mult;
+  cs->shift = shift;
+}
+
+int clocksource_init() {
+  uint32_t period_fs = hpet_get_period_fs();
+  if (!period_fs) {
+    serial_log("CLOCKSOURCE: No HPET, no clocksource.");
+    return -1;
+  }
+
+  hpet_clocksource.khz = (uint32_t)(1000000000000ULL / period_fs);
+  clocksource_calc_mult_shift(&hpet_clocksource, period_fs, 1000000ULL);
+  clocksource_t *best = &hpet_clocksource;
+
+  uint32_t tsc_khz = tsc_calibrate();
+  if (tsc_khz) {
+    tsc_clocksource.khz = tsc_khz;
+    clocksource_calc_mult_shift(&tsc_clocksource, 1000000ULL, tsc_khz);
+    if (!tsc_invariant())
+      serial_log("CLOCKSOURCE: TSC not invariant, idle mein drift ho sakta");
+    if (tsc_clocksource.rating > best->rating)
+      best = &tsc_clocksource;
+  }
+
+  clocksource_base = best->read();
+  clocksource = best;
+  serial_log(best == &tsc_clocksource ? "CLOCKSOURCE: Using tsc"
+                                      : "CLOCKSOURCE: Using hpet");
+  serial_log_hex("  mult: ", best->mult);
+  serial_log_hex("  shift: ", best->shift);
+  return 0;
+}
+
+uint64_t clocksource_ns() {
+  clocksource_t *cs = clocksource;
+  if (!cs)
+    return 0;
+  return mul_u64_u32_shr(cs->read() - clocksource_base, cs->mult, cs->shift);
+}
+
+uint64_t clocksource_cycle_base() { return clocksource_base; }
+
+uint32_t clocksource_resolution_ns() {
+  clocksource_t *cs = clocksource;
+  if (!cs)
+    return 0;
+  uint32_t res = (uint32_t)(((uint64_t)cs->mult + (1ULL << cs->shift) - 1) >>
+                            cs->shift);
+  return res ? res : 1;
+}
+
+// 2^61 / 10^9 - ns se seconds ka andaaza multiply se, phir chhota correction
+#define NS_PER_SEC 1000000000U
+#define SEC_PER_NS_MULT 2305843009U
+#define SEC_PER_NS_SHIFT 61
+
+void ns_to_sec_nsec(uint64_t ns, uint32_t *sec, uint32_t *nsec) {
+  uint64_t lo = (uint64_t)(uint32_t)ns * SEC_PER_NS_MULT;
+  uint64_t hi = (uint64_t)(uint32_t)(ns >> 32) * SEC_PER_NS_MULT;
+  uint32_t s = (uint32_t)((lo >> SEC_PER_NS_SHIFT) +
+                          (hi >> (SEC_PER_NS_SHIFT - 32)));
+  // mult neeche round hai, isliye s kabhi zyada nahi - bas 1-2 kam
+  uint64_t rem = ns - (uint64_t)s * NS_PER_SEC;
+  while (rem >= NS_PER_SEC) {
+    rem -= NS_PER_SEC;
+    s++;
+  }
+  *sec = s;
+  *nsec = (uint32_t)rem;
+}
@@ -0,0 +1,58 @@
+// Clocksource - free-running counter (TSC ya HPET) se monotonic ns
+#ifndef CLOCKSOURCE_H
+#define CLOCKSOURCE_H
+
+#include "../include/types.h"
+
+// Counter -> ns conversion fixed-point mein: ns = (cycles * mult) >> shift.
+// Hot path mein 64-bit division nahi (yahan __udivdi3 bit-by-bit loop hai).
+// Boot pe har source ki frequency se mult/shift ek baar nikalte hain, aur
+// sabse oonchi rating wala source chunte hain: TSC (HPET se calibrated,
+// ek instruction mein padh lo) > HPET (MMIO read, VM mein mehenga).
+typedef struct clocksource {
+  const char *name;
+  uint64_t (*read)();
+  uint32_t mult;
+  uint32_t shift;
+  uint32_t khz;   // Counter frequency
+  int rating;     // Zyada = behtar
+} clocksource_t;
+
+#define CLOCKSOURCE_RATING_HPET 250
+#define CLOCKSOURCE_RATING_TSC 300
+
+extern clocksource_t *clocksource; // Chalu source, init se pehle 0
+
+// (a * mul) >> shift, 64x32 multiply do hisson mein (shift <= 32)
+static inline uint64_t mul_u64_u32_shr(uint64_t a, uint32_t mul,
+                                       uint32_t shift) {
+  uint64_t lo = (uint64_t)(uint32_t)a * mul;
+  uint64_t hi = (uint64_t)(uint32_t)(a >> 32) * mul;
+  return (lo >> shift) + (hi << (32 - shift));
+}
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// HPET aur TSC register karo, best chuno. HPET na ho to -1 (tab TSC
+// calibrate bhi nahi hota aur clocksource_ns 0 deta hai).
+int clocksource_init();
+
+// Init ke baad se ns, source na ho to 0
+uint64_t clocksource_ns();
+
+// Counter ki woh value jahan clocksource_ns() = 0 (vDSO ko chahiye)
+uint64_t clocksource_cycle_base();
+
+// Ek counter step kitne ns ka (upar round, kam se kam 1)
+uint32_t clocksource_resolution_ns();
+
+// ns -> seconds + ns, bina 64-bit division ke
+void ns_to_sec_nsec(uint64_t ns, uint32_t *sec, uint32_t *nsec);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -327,7 +327,7 @@ extern "C" int dhcp_configure() {
       return 0; // Success
     }
     net_poll();
-    schedule();
+    net_wait(NET_WAIT_MS);
   }
 
   serial_log("DHCP: Configuration timeout");
@@ -4,6 +4,7 @@
 #include "../drivers/serial.h"
 #include "../include/string.h"
 #include "heap.h"
+#include "ktimer.h"
 #include "net.h"
 #include <stddef.h>
 #include <stdint.h>
@@ -368,6 +369,16 @@ static void dns_send_query(const char *hostname, uint16_t qtype) {
 
 /* ===================== PUBLIC API ===================== */
 
+// Query timeout - IRQ mein sirf flag, resend dns_resolve ke loop se
+static ktimer_t dns_timer;
+static volatile int dns_timed_out;
+
+static void dns_timeout(ktimer_t *timer) {
+  (void)timer;
+  dns_timed_out = 1;
+  net_kick();
+}
+
 // Resolve hostname to IP address (blocking)
 extern "C" uint32_t dns_resolve(const char *hostname) {
   // Check cache first
@@ -380,27 +391,32 @@ extern "C" uint32_t dns_resolve(const char *hostname) {
   dns_send_query(hostname, DNS_TYPE_A);
 
   // Wait for response with timeout
-  uint32_t start = timer_now_ms();
   int retries = 0;
+  dns_timed_out = 0;
+  timer_setup(&dns_timer, dns_timeout, nullptr);
+  mod_timer_ms(&dns_timer, DNS_TIMEOUT_MS);
 
   while (retries < DNS_MAX_RETRIES) {
     if (dns_response_received == 1) {
+      timer_del(&dns_timer);
       // Cache the result
       dns_cache_insert(hostname, dns_resolved_ip, 300); // 5 min TTL
       return dns_resolved_ip;
     }
 
     if (dns_response_received == -1) {
+      timer_del(&dns_timer);
       serial_log("DNS: Resolution failed");
       return 0;
     }
 
-    if (timer_now_ms() - start > DNS_TIMEOUT_MS) {
+    if (dns_timed_out) {
+      dns_timed_out = 0;
       retries++;
       if (retries < DNS_MAX_RETRIES) {
         serial_log("DNS: Timeout, retrying...");
         dns_send_query(hostname, DNS_TYPE_A);
-        start = timer_now_ms();
+        mod_timer_ms(&dns_timer, DNS_TIMEOUT_MS);
       }
     }
 
@@ -408,11 +424,8 @@ extern "C" uint32_t dns_resolve(const char *hostname) {
     // syscall)
     net_poll();
 
-    // Yield to scheduler
-    schedule();
-
-    // Yield to scheduler
-    schedule();
+    // Jawab ya timeout tak so jao
+    net_wait(NET_WAIT_MS);
   }
 
   serial_log("DNS: Resolution timed out");
@@ -4,6 +4,7 @@
 // Retro-OS Networking Phase 1
 
 #include "../drivers/pci.h"
+#include "../include/irq.h"
 #include "paging.h"
 #include "vm.h"
 #include <stddef.h>
@@ -44,6 +45,15 @@ extern "C" uint32_t virt_to_phys(void *addr) {
 
 #define E1000_CTRL 0x0000
 #define E1000_STATUS 0x0008
+#define E1000_ICR 0x00C0 // Padhte hi clear
+#define E1000_IMS 0x00D0
+#define E1000_IMC 0x00D8
+
+#define E1000_ICR_LSC (1 << 2)    // Link status change
+#define E1000_ICR_RXDMT0 (1 << 4) // RX descriptors kam bache
+#define E1000_ICR_RXO (1 << 6)    // RX overrun
+#define E1000_ICR_RXT0 (1 << 7)   // RX timer - packet aaya
+#define E1000_RX_INTS (E1000_ICR_RXDMT0 | E1000_ICR_RXO | E1000_ICR_RXT0)
 
 #define E1000_TCTL 0x0400
 #define E1000_TIPG 0x0410
@@ -99,6 +109,10 @@ static uint8_t tx_buffers[TX_DESC_COUNT][2048] __attribute__((aligned(16)));
 
 static uint32_t rx_tail = 0;
 static uint32_t tx_tail = 0;
+static int e1000_irq_line = -1;
+
+// Net stack ke waiters jagao (net.cpp) - packet ring mein hai, net_poll karo
+extern "C" void net_kick(void);
 
 // =======================================================
 // MMIO ACCESS
@@ -110,6 +124,20 @@ static inline void e1000_write(uint32_t reg, uint32_t val) {
 
 static inline uint32_t e1000_read(uint32_t reg) { return e1000_mmio[reg / 4]; }
 
+// =======================================================
+// INTERRUPT
+// =======================================================
+
+// RX interrupt sirf jagata hai - packets net_poll hi nikaalta hai
+static void e1000_irq(registers_t *regs) {
+  (void)regs;
+  uint32_t icr = e1000_read(E1000_ICR);
+  if (icr & E1000_RX_INTS)
+    net_kick();
+}
+
+extern "C" int e1000_irq_enabled(void) { return e1000_irq_line >= 0; }
+
 // =======================================================
 // INITIALIZATION
 // =======================================================
@@ -185,6 +213,18 @@ extern "C" void e1000_init(uint8_t bus, uint8_t slot, uint8_t func) {
 
   e1000_write(E1000_TIPG, 0x0060200A);
 
+  // RX interrupts: PCI interrupt line (legacy IRQ 0-15) pe handler
+  uint8_t line = pci_read(bus, slot, func, 0x3C) & 0xFF;
+  if (line < 16) {
+    e1000_irq_line = line;
+    register_interrupt_handler(32 + line, e1000_irq);
+    e1000_write(E1000_IMC, 0xFFFFFFFF);
+    e1000_read(E1000_ICR);
+    e1000_write(E1000_IMS, E1000_RX_INTS);
+    irq_set_mask(line, false);
+    serial_log_hex("e1000: RX interrupts on IRQ ", line);
+  }
+
   // VERIFICATION: Dump all critical RX registers
   serial_log("e1000: === RX Register Verification ===");
   serial_log_hex("  RCTL  = ", e1000_read(E1000_RCTL));
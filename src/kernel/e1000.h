@@ -7,4 +7,7 @@ extern "C" void e1000_init(uint8_t bus, uint8_t slot, uint8_t func);
 extern "C" void e1000_send(void *data, uint16_t length);
 extern "C" int e1000_receive(uint8_t *out);
 
+// RX interrupt chalu hai? Nahi to net_wait ko har tick poll karna padega
+extern "C" int e1000_irq_enabled(void);
+
 #endif
@@ -1,15 +1,13 @@
+#include "elf_loader.h"
 #include "../drivers/serial.h"
-#include "../include/elf.h"
 #include "../include/string.h"
-#include "../include/vfs.h"
-#include "../kernel/heap.h" // Added for kfree
 #include "../kernel/memory.h"
+#include "../kernel/paging.h"
 #include "../kernel/pmm.h"
 #include "../kernel/vm.h"
 
-// ... imports ...
-
-uint32_t load_elf(const char *filename, uint32_t *top_address) {
+uint32_t load_elf(const char *filename, uint32_t *top_address,
+                  elf_image_t *image) {
   serial_log("ELF: Loading file via VFS...");
   serial_log(filename);
 
@@ -19,85 +17,121 @@ uint32_t load_elf(const char *filename, uint32_t *top_address) {
     return 0;
   }
 
-  uint8_t *buffer = (uint8_t *)kmalloc(node->size + 512);
-  vfs_read(node, 0, buffer, node->size);
-
-  Elf32_Ehdr *ehdr = (Elf32_Ehdr *)buffer;
+  // Poori file nahi - sirf ELF header aur program headers padho
+  Elf32_Ehdr ehdr;
+  if (vfs_read(node, 0, &ehdr, sizeof(ehdr)) != sizeof(ehdr)) {
+    serial_log("ELF ERROR: Header read failed.");
+    return 0;
+  }
 
   // Check karo ki Magic sahi hai ya nahi
-  if (memcmp(ehdr->e_ident, "\x7f\x45\x4c\x46", 4) != 0) {
+  if (memcmp(ehdr.e_ident, "\x7f\x45\x4c\x46", 4) != 0) {
     serial_log("ELF ERROR: Invalid Magic.");
-    kfree(buffer); // Achhi aadat
     return 0;
   }
 
   serial_log("ELF: Valid Magic found.");
-  serial_log_hex("ELF: Entry Point: ", ehdr->e_entry);
-  uint32_t entry_point = ehdr->e_entry;
+  serial_log_hex("ELF: Entry Point: ", ehdr.e_entry);
+  uint32_t entry_point = ehdr.e_entry;
 
   uint32_t max_addr = 0;
+  image->node = 0;
+  image->count = 0;
 
   // Program Headers ko padho
-  Elf32_Phdr *phdr = (Elf32_Phdr *)(buffer + ehdr->e_phoff);
-  for (int i = 0; i < ehdr->e_phnum; i++) {
-    if (phdr[i].p_type == PT_LOAD) {
-      serial_log_hex("ELF: Loading segment at ", phdr[i].p_vaddr);
-      serial_log_hex("ELF: Segment size: ", phdr[i].p_memsz);
-
-      // Pages ka map hona zaroori hai!
-      // Ye user processes ke liye bahut important hai jahan shuru mein sab
-      // khali hota hai.
-      uint32_t start_addr = phdr[i].p_vaddr;
-      uint32_t end_addr = start_addr + phdr[i].p_memsz;
-
-      if (end_addr > max_addr) {
-        max_addr = end_addr;
-      }
-
-      uint32_t start_page = start_addr & 0xFFFFF000;
-      uint32_t end_page = (end_addr + 0xFFF) & 0xFFFFF000;
-
-      // Map pages (Silent)
-      for (uint32_t page = start_page; page < end_page; page += 4096) {
-        if (vm_get_phys(page) == 0) {
-          void *phys = pmm_alloc_block();
-          if (!phys) {
-            serial_log("ELF ERROR: PMM allocation failed!");
-            kfree(buffer);
-            return 0;
-          }
-          vm_map_page((uint32_t)phys, page, 7);
-        }
-      }
-
-      // Copy content
-      memcpy((void *)phdr[i].p_vaddr, buffer + phdr[i].p_offset,
-             phdr[i].p_filesz);
-
-      // Verify Entry Point Content
-      if (entry_point >= phdr[i].p_vaddr &&
-          entry_point < phdr[i].p_vaddr + phdr[i].p_memsz) {
-        uint8_t *code = (uint8_t *)entry_point;
-        serial_log("ELF: Code at Entry Point:");
-        serial_log_hex(" [0]: ", code[0]);
-        serial_log_hex(" [1]: ", code[1]);
-        serial_log_hex(" [2]: ", code[2]);
-        serial_log_hex(" [3]: ", code[3]);
-      }
-
-      // Zero BSS
-      if (phdr[i].p_memsz > phdr[i].p_filesz) {
-        memset((void *)(phdr[i].p_vaddr + phdr[i].p_filesz), 0,
-               phdr[i].p_memsz - phdr[i].p_filesz);
-      }
+  for (int i = 0; i < ehdr.e_phnum; i++) {
+    Elf32_Phdr phdr;
+    if (vfs_read(node, ehdr.e_phoff + i * ehdr.e_phentsize, &phdr,
+                 sizeof(phdr)) != sizeof(phdr)) {
+      serial_log("ELF ERROR: Program header read failed.");
+      return 0;
+    }
+    if (phdr.p_type != PT_LOAD)
+      continue;
+
+    serial_log_hex("ELF: Segment at ", phdr.p_vaddr);
+    serial_log_hex("ELF: Segment size: ", phdr.p_memsz);
+
+    if (image->count == ELF_MAX_REGIONS || phdr.p_filesz > phdr.p_memsz ||
+        phdr.p_offset + phdr.p_filesz > node->size) {
+      serial_log("ELF ERROR: Bad or too many PT_LOAD segments.");
+      return 0;
     }
+
+    elf_region_t *r = &image->regions[image->count++];
+    r->vaddr = phdr.p_vaddr;
+    r->memsz = phdr.p_memsz;
+    r->filesz = phdr.p_filesz;
+    r->offset = phdr.p_offset;
+    r->flags = phdr.p_flags;
+
+    uint32_t end_addr = phdr.p_vaddr + phdr.p_memsz;
+    if (end_addr > max_addr)
+      max_addr = end_addr;
   }
 
+  image->node = node;
+  node->ref_count++;
+
   if (top_address) {
     *top_address = (max_addr + 0xFFF) & 0xFFFFF000;
   }
 
-  kfree(buffer);
   serial_log_hex("ELF: Returning entry point ", entry_point);
   return entry_point;
 }
+
+bool elf_handle_fault(elf_image_t *image, uint32_t addr, uint32_t pte_flags) {
+  if (!image || !image->node)
+    return false;
+
+  uint32_t page = addr & 0xFFFFF000;
+  bool hit = false;
+  for (int i = 0; i < image->count; i++) {
+    elf_region_t *r = &image->regions[i];
+    if (page < r->vaddr + r->memsz && page + 4096 > r->vaddr)
+      hit = true;
+  }
+  if (!hit)
+    return false;
+
+  uint32_t phys = (uint32_t)pmm_alloc_block();
+  if (!phys)
+    return false;
+
+  // BSS aur segments ke beech ke gaps zero rehte hain
+  uint8_t *kpage = (uint8_t *)PHYS_TO_VIRT(phys);
+  memset(kpage, 0, 4096);
+
+  // Ek page pe do segments aa sakte hain (text ka end + data ka start)
+  for (int i = 0; i < image->count; i++) {
+    elf_region_t *r = &image->regions[i];
+    if (page >= r->vaddr + r->memsz || page + 4096 <= r->vaddr)
+      continue;
+
+    uint32_t lo = page > r->vaddr ? page : r->vaddr;
+    uint32_t hi = page + 4096;
+    if (hi > r->vaddr + r->filesz)
+      hi = r->vaddr + r->filesz;
+    if (lo < hi)
+      vfs_read(image->node, r->offset + (lo - r->vaddr), kpage + (lo - page),
+               hi - lo);
+  }
+
+  vm_map_page(phys, page, pte_flags);
+  return true;
+}
+
+void elf_image_copy(elf_image_t *dst, const elf_image_t *src) {
+  *dst = *src;
+  if (dst->node)
+    dst->node->ref_count++;
+}
+
+void elf_image_release(elf_image_t *image) {
+  // Node VFS ka hai (baaki callers bhi free nahi karte), sirf ref chhodo
+  if (image->node)
+    image->node->ref_count--;
+  image->node = 0;
+  image->count = 0;
+}
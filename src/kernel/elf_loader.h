@@ -4,7 +4,38 @@
 #include "../include/elf.h"
 
 #include "../include/types.h"
+#include "../include/vfs.h"
 
-uint32_t load_elf(const char *filename, uint32_t *top_address);
+#define ELF_MAX_REGIONS 8
+
+// Ek PT_LOAD segment, file-backed (VMA_FILE). Pages pehle touch pe file se
+// aate hain; [vaddr + filesz, vaddr + memsz) BSS hai jo zero-filled milta hai.
+typedef struct elf_region {
+  uint32_t vaddr;
+  uint32_t memsz;
+  uint32_t filesz;
+  uint32_t offset; // File mein segment ka offset
+  uint32_t flags;  // PF_*
+} elf_region_t;
+
+// Process ka executable image (process_t mein rehta hai)
+typedef struct elf_image {
+  vfs_node_t *node; // Backing file (ek ref pakad ke rakhte hain)
+  elf_region_t regions[ELF_MAX_REGIONS];
+  int count;
+} elf_image_t;
+
+// Sirf headers padhta hai aur segments image mein record karta hai. Koi page
+// map nahi hota - elf_handle_fault() unhe lazily laata hai.
+uint32_t load_elf(const char *filename, uint32_t *top_address,
+                  elf_image_t *image);
+
+// Current address space mein faulting page ko image se bharo aur pte_flags
+// ke saath map karo (VMA ka prot). true = page map ho gaya.
+bool elf_handle_fault(elf_image_t *image, uint32_t addr, uint32_t pte_flags);
+
+// fork ke liye image copy (backing file ka ref badhata hai)
+void elf_image_copy(elf_image_t *dst, const elf_image_t *src);
+void elf_image_release(elf_image_t *image);
 
 #endif
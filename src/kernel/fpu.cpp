@@ -0,0 +1,263 @@
+#include "fpu.h"
+#include "../drivers/serial.h"
+#include "../include/isr.h"
+#include "../include/string.h"
+#include "process.h"
+#include "slab.h"
+#include "smp.h"
+
+// Har CPU ke apne registers, to ye cpu_t mein (smp.h). fpu_owner: jis
+// process ke FPU/SSE registers is CPU mein "live" hain. 0 ka matlab ya to
+// koi nahi (TS set), ya boot/idle context jiska state abhi kisi process ko
+// assign nahi hua (TS clear) - dekho fpu_switch_to. fpu_ts: CR0.TS ki
+// software copy, bekaar CR0 writes bachao. Sab raaste interrupts band
+// rakhte hain, to beech mein CPU nahi badalta.
+#define fpu_owner (this_cpu()->fpu_owner)
+#define fpu_ts (this_cpu()->fpu_ts)
+
+static kmem_cache_t *fpu_cache = 0;
+static fpu_stats_t fpu_stats;
+
+// fninit + default MXCSR ke baad ka saaf state, naye processes isse shuru
+static uint8_t fpu_default_state[FPU_STATE_SIZE] __attribute__((aligned(16)));
+
+#define CR0_MP (1 << 1)
+#define CR0_EM (1 << 2)
+#define CR0_TS (1 << 3)
+#define CR0_NE (1 << 5)
+#define CR4_OSFXSR (1 << 9)
+#define CR4_OSXMMEXCPT (1 << 10)
+
+#define CPUID_EDX_FPU (1 << 0)
+#define CPUID_EDX_FXSR (1 << 24)
+#define CPUID_EDX_SSE (1 << 25)
+#define CPUID_EDX_SSE2 (1 << 26)
+
+static inline void fpu_clts() {
+  asm volatile("clts");
+  fpu_ts = 0;
+}
+
+static inline void fpu_stts() {
+  uint32_t cr0;
+  asm volatile("mov %%cr0, %0" : "=r"(cr0));
+  asm volatile("mov %0, %%cr0" ::"r"(cr0 | CR0_TS));
+  fpu_ts = 1;
+}
+
+// Registers -> memory. fnsave (FXSR ke bina) FPU ko reinit bhi kar deta hai.
+static inline void fpu_save(void *state) {
+  if (fpu_stats.has_fxsr)
+    asm volatile("fxsave (%0)" ::"r"(state) : "memory");
+  else
+    asm volatile("fnsave (%0)" ::"r"(state) : "memory");
+}
+
+static inline void fpu_restore(void *state) {
+  if (fpu_stats.has_fxsr)
+    asm volatile("fxrstor (%0)" ::"r"(state) : "memory");
+  else
+    asm volatile("frstor (%0)" ::"r"(state) : "memory");
+}
+
+static void *fpu_alloc_state() {
+  return fpu_cache ? kmem_cache_alloc(fpu_cache) : 0;
+}
+
+// Owner ke live registers uske FXSAVE area mein. TS clear hona chahiye.
+static void fpu_save_owner() {
+  if (!fpu_owner)
+    return;
+  if (!fpu_owner->fpu_state)
+    fpu_owner->fpu_state = fpu_alloc_state();
+  if (fpu_owner->fpu_state) {
+    fpu_save(fpu_owner->fpu_state);
+    fpu_stats.saves++;
+  }
+}
+
+// #NM: kisi non-owner ne FPU/SSE chhooa. Interrupt gate hai, IF already off.
+static void fpu_nm_handler(registers_t *regs) {
+  (void)regs;
+  fpu_clts();
+  fpu_stats.nm_traps++;
+
+  process_t *cur = current_process;
+  if (fpu_owner == cur)
+    return;
+
+  fpu_save_owner();
+  fpu_owner = cur;
+  if (!cur)
+    return;
+
+  if (cur->fpu_state) {
+    fpu_restore(cur->fpu_state);
+    fpu_stats.restores++;
+  } else {
+    // Pehli baar: saaf state load karo, area agle save pe ban jaayega
+    cur->fpu_state = fpu_alloc_state();
+    fpu_restore(fpu_default_state);
+    fpu_stats.fresh++;
+  }
+}
+
+// Is CPU ke control registers + saaf FPU (BSP aur har AP)
+static void fpu_cpu_setup() {
+  // EM off (asli FPU), MP on (TS pe WAIT bhi trap kare), NE on (#MF native)
+  uint32_t cr0;
+  asm volatile("mov %%cr0, %0" : "=r"(cr0));
+  cr0 &= ~(CR0_EM | CR0_TS);
+  cr0 |= CR0_MP | CR0_NE;
+  asm volatile("mov %0, %%cr0" ::"r"(cr0));
+  fpu_ts = 0;
+
+  if (fpu_stats.has_sse) {
+    uint32_t cr4;
+    asm volatile("mov %%cr4, %0" : "=r"(cr4));
+    cr4 |= CR4_OSFXSR | CR4_OSXMMEXCPT;
+    asm volatile("mov %0, %%cr4" ::"r"(cr4));
+  }
+
+  asm volatile("fninit");
+  if (fpu_stats.has_sse) {
+    uint32_t mxcsr = 0x1F80; // Saare SSE exceptions masked, round-to-nearest
+    asm volatile("ldmxcsr %0" ::"m"(mxcsr));
+  }
+}
+
+void fpu_init() {
+  uint32_t eax, ebx, ecx, edx;
+  asm volatile("cpuid"
+               : "=a"(eax), "=b"(ebx), "=c"(ecx), "=d"(edx)
+               : "a"(1));
+  if (!(edx & CPUID_EDX_FPU)) {
+    serial_log("FPU: x87 FPU nahi mila!");
+    return;
+  }
+  fpu_stats.has_fxsr = (edx & CPUID_EDX_FXSR) ? 1 : 0;
+  fpu_stats.has_sse = (fpu_stats.has_fxsr && (edx & CPUID_EDX_SSE)) ? 1 : 0;
+  fpu_stats.has_sse2 = (fpu_stats.has_sse && (edx & CPUID_EDX_SSE2)) ? 1 : 0;
+
+  fpu_cpu_setup();
+  memset(fpu_default_state, 0, sizeof(fpu_default_state));
+  fpu_save(fpu_default_state);
+  if (!fpu_stats.has_fxsr)
+    fpu_restore(fpu_default_state);
+
+  register_interrupt_handler(7, (isr_t)fpu_nm_handler);
+
+  serial_log(fpu_stats.has_sse2  ? "FPU: x87 + SSE2, lazy FXSAVE switching"
+             : fpu_stats.has_sse ? "FPU: x87 + SSE, lazy FXSAVE switching"
+                                 : "FPU: x87 only, lazy FNSAVE switching");
+}
+
+void fpu_cache_init() {
+  fpu_cache = kmem_cache_create("fpu_state", FPU_STATE_SIZE, KMEM_HWALIGN);
+  if (!fpu_cache)
+    serial_log("FPU: fpu_state cache nahi bani!");
+}
+
+void fpu_init_ap() {
+  // Features BSP ke cpuid se - saare CPUs ek jaise maante hain
+  fpu_cpu_setup();
+}
+
+void fpu_switch_to(process_t *prev, process_t *next) {
+  // TS clear aur koi owner nahi: boot context ke live registers, jo ab tak
+  // chal raha tha wahi unka maalik hai
+  if (!fpu_owner && !fpu_ts)
+    fpu_owner = prev;
+
+  // Kai CPUs: prev agli baar doosre CPU pe chal sakta hai, jahan #NM uska
+  // saved state restore karega - live registers abhi memory mein daalo
+  // (restore phir bhi lazy)
+  if (smp_nr_online > 1 && fpu_owner == prev && !fpu_ts) {
+    fpu_save_owner();
+    fpu_owner = 0;
+    fpu_stts();
+  }
+
+  if (next == fpu_owner) {
+    if (fpu_ts)
+      fpu_clts();
+  } else if (!fpu_ts) {
+    fpu_stts();
+  }
+}
+
+void fpu_fork(process_t *child, process_t *parent) {
+  child->fpu_state = 0;
+  uint32_t eflags = local_irq_save();
+  int live = (parent == fpu_owner && !fpu_ts);
+  local_irq_restore(eflags);
+  if (!live && !parent->fpu_state)
+    return; // Parent ne FPU chhooa hi nahi, child bhi default se shuru
+
+  // Beech mein preempt hoke state save ho gaya ho to bhi theek - fxsave
+  // #NM se parent ka state wapas la ke hi chalega
+  child->fpu_state = fpu_alloc_state();
+  if (!child->fpu_state)
+    return;
+  if (live) {
+    fpu_save(child->fpu_state);
+    if (!fpu_stats.has_fxsr)
+      fpu_restore(child->fpu_state); // fnsave ne parent ke registers reset kiye
+  } else {
+    memcpy(child->fpu_state, parent->fpu_state, FPU_STATE_SIZE);
+  }
+}
+
+void fpu_release(process_t *proc) {
+  uint32_t eflags = local_irq_save();
+  if (fpu_owner == proc) {
+    fpu_owner = 0;
+    if (!fpu_ts)
+      fpu_stts(); // Agla FPU use #NM se saaf state paayega
+  }
+  local_irq_restore(eflags);
+  if (proc->fpu_state) {
+    kmem_cache_free(fpu_cache, proc->fpu_state);
+    proc->fpu_state = 0;
+  }
+}
+
+#define kernel_fpu_eflags (this_cpu()->kernel_fpu_eflags)
+#define kernel_fpu_active (this_cpu()->kernel_fpu_active)
+
+int kernel_fpu_begin() {
+  if (!fpu_stats.has_sse2)
+    return 0;
+  uint32_t eflags = local_irq_save();
+  // Live registers ka maalik hai par save area nahi (boot context, ya #NM
+  // ki allocation fail) - yahan allocate karna heap ke andar se heap mein
+  // ghusna ho sakta hai, to scalar path
+  int no_area = fpu_owner ? !fpu_owner->fpu_state : !fpu_ts;
+  if (kernel_fpu_active || no_area) {
+    local_irq_restore(eflags);
+    return 0;
+  }
+  kernel_fpu_active = 1;
+  kernel_fpu_eflags = eflags;
+
+  fpu_clts();
+  fpu_save_owner(); // SSE2 hai to FXSR bhi hai, registers bache rehte hain
+  fpu_owner = 0;
+  return 1;
+}
+
+void kernel_fpu_end() {
+  // Registers ab kernel ke kachre se bhare hain; jo bhi agla FPU chhooye,
+  // #NM se apna state wapas le
+  fpu_stts();
+  kernel_fpu_active = 0;
+  uint32_t eflags = kernel_fpu_eflags;
+  local_irq_restore(eflags);
+}
+
+int fpu_has_sse2() { return fpu_stats.has_sse2; }
+
+void fpu_get_stats(fpu_stats_t *out) {
+  if (out)
+    *out = fpu_stats;
+}
@@ -0,0 +1,64 @@
+#ifndef FPU_H
+#define FPU_H
+
+#include "../include/types.h"
+
+// Lazy FPU/SSE context switching
+// Boot pe x87 + SSE on (CR0.MP/NE, CR4.OSFXSR/OSXMMEXCPT). Registers sirf
+// ek "owner" process ke hote hain; baaki processes ke liye CR0.TS set rehta
+// hai. Koi bhi FPU/SSE instruction #NM (vector 7) maarti hai, handler owner
+// ka state FXSAVE karke naye process ka FXRSTOR karta hai. Jo process FPU
+// chhoota hi nahi, uska switch bilkul free hai. Kai CPUs online hon to
+// switch pe owner ka state turant save hota hai (task doosre CPU pe jaa
+// sakta hai), restore phir bhi #NM pe.
+
+#define FPU_STATE_SIZE 512 // FXSAVE area (16-byte aligned)
+
+struct process;
+
+typedef struct fpu_stats {
+  uint32_t has_fxsr;  // FXSAVE/FXRSTOR available
+  uint32_t has_sse;   // SSE enabled
+  uint32_t has_sse2;  // SSE2 (kernel memcpy fast paths)
+  uint32_t nm_traps;  // #NM exceptions handled
+  uint32_t saves;     // Owner state FXSAVE
+  uint32_t restores;  // Saved state FXRSTOR
+  uint32_t fresh;     // Pehli baar FPU chhoone wale processes
+} fpu_stats_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void fpu_init();
+// AP pe: wahi CR0/CR4 bits aur saaf FPU (features BSP ke fpu_init se)
+void fpu_init_ap();
+// slab_init ke baad: FXSAVE areas ki cache. fpu_init heap se pehle chalta
+// hai, aur baad mein lazily banana heap ke andar se (bada memset ->
+// kernel_fpu_begin) heap lock dobara le leta.
+void fpu_cache_init();
+
+// Scheduler: next process owner nahi hai to TS set karo, hai to clear.
+// TS clear ho aur owner 0 ho to live registers prev ke maane jaate hain.
+void fpu_switch_to(struct process *prev, struct process *next);
+
+// fork: child ko parent ka FPU state milta hai
+void fpu_fork(struct process *child, struct process *parent);
+// exec/exit/reap: state chhod do, ownership bhi
+void fpu_release(struct process *proc);
+
+// Kernel code jo SSE registers use karna chahta hai (memcpy etc.): owner ka
+// state save karo aur preemption band. Nest nahi hota - 0 return ho (SSE2
+// nahi, pehle se andar hain, ya owner ke paas save area nahi) to scalar path
+// lo aur kernel_fpu_end mat karo. Kabhi allocate nahi karta.
+int kernel_fpu_begin();
+void kernel_fpu_end();
+
+int fpu_has_sse2();
+void fpu_get_stats(fpu_stats_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,237 @@
+// Futex - physical address pe hashed wait table
+#include "futex.h"
+#include "../include/errno.h"
+#include "ktimer.h"
+#include "paging.h"
+#include "process.h"
+#include "sched.h"
+#include "spinlock.h"
+#include "vm.h"
+#include "vma.h"
+#include "wait_queue.h"
+
+// Sone wale ke stack pe - wait_queue_entry jaisa, par key ke saath taaki ek
+// bucket mein alag words ke waiters ek doosre ke wakeup na kha jaayein
+typedef struct futex_q {
+  uint32_t key; // Word ka physical address
+  process_t *proc;
+  // 0 = jagaya ja chuka. Sirf bucket lock(s) ke andar badalta hai - requeue
+  // dono pakad ke seedha naya bucket likhta hai, beech mein 0 nahi
+  struct futex_bucket *volatile bucket;
+  struct futex_q *next;
+  struct futex_q *prev;
+} futex_q_t;
+
+typedef struct futex_bucket {
+  futex_q_t *head;
+  futex_q_t *tail;
+  spinlock_t lock; // Bina naam (zero = khula). Order: bucket -> runqueue
+} futex_bucket_t;
+
+static futex_bucket_t futex_table[FUTEX_HASH_SIZE];
+
+// Requeue ko do buckets chahiye - hamesha address order mein, ABBA nahi
+static void futex_lock_pair(futex_bucket_t *a, futex_bucket_t *b) {
+  if (a > b) {
+    futex_bucket_t *t = a;
+    a = b;
+    b = t;
+  }
+  spin_lock(&a->lock);
+  if (b != a)
+    spin_lock(&b->lock);
+}
+
+static void futex_unlock_pair(futex_bucket_t *a, futex_bucket_t *b) {
+  if (b != a)
+    spin_unlock(&b->lock);
+  spin_unlock(&a->lock);
+}
+
+static inline futex_bucket_t *futex_hash(uint32_t key) {
+  return &futex_table[((key >> 2) * 0x9E3779B1u) >> (32 - FUTEX_HASH_BITS)];
+}
+
+// Word ka physical address, 0 agar kharab. lock add $0 se write fault -
+// COW / zero page / demand paging sab yahin nipat jaate hain. Usse pehle
+// pakka karo ki word user ke likhne laayak VMA mein hai - warna user kernel
+// ke kisi bhi word pe locked RMW karwa sakta.
+static uint32_t futex_key(volatile uint32_t *uaddr) {
+  uint32_t addr = (uint32_t)uaddr;
+  if ((addr & 3) || addr > KERNEL_VIRTUAL_BASE - sizeof(uint32_t))
+    return 0;
+  vma_t *vma = vma_find(&current_process->vmas, addr);
+  if (!vma || !(vma->prot & VMA_WRITE))
+    return 0;
+  asm volatile("lock addl $0, %0" : "+m"(*uaddr) : : "memory", "cc");
+  return vm_get_phys((uint32_t)uaddr);
+}
+
+// FIFO - pehle soya pehle jaage. Bucket lock pakda hua.
+static void futex_q_link(futex_bucket_t *b, futex_q_t *q) {
+  q->next = 0;
+  q->prev = b->tail;
+  if (b->tail)
+    b->tail->next = q;
+  else
+    b->head = q;
+  b->tail = q;
+  q->bucket = b;
+}
+
+// List se nikaalo - q->bucket waisa hi rehta hai, caller badle
+static void futex_q_unlink(futex_q_t *q) {
+  futex_bucket_t *b = q->bucket;
+  if (q->prev)
+    q->prev->next = q->next;
+  else
+    b->head = q->next;
+  if (q->next)
+    q->next->prev = q->prev;
+  else
+    b->tail = q->prev;
+  q->next = 0;
+  q->prev = 0;
+}
+
+// Waiter ko jagao. bucket = 0 aakhri likhai - uske baad waiter futex_wait
+// se laut ke stack wala q kabhi bhi hata sakta hai, q ko chhoona mana.
+static void futex_q_wake(futex_q_t *q) {
+  process_t *proc = q->proc;
+  futex_q_unlink(q);
+  __sync_synchronize();
+  q->bucket = 0;
+  sched_wakeup(proc);
+}
+
+extern "C" {
+
+int futex_wait(volatile uint32_t *uaddr, uint32_t val, uint32_t timeout_ms) {
+  uint32_t key = futex_key(uaddr);
+  if (!key)
+    return -EFAULT;
+
+  // Bucket lock mein compare - unlock karne wala (IRQ se jagaya hua task
+  // bhi) check aur sone ke beech mein ghus nahi sakta. Interrupts schedule
+  // tak band.
+  futex_bucket_t *b = futex_hash(key);
+  uint32_t eflags = local_irq_save();
+  spin_lock(&b->lock);
+  if (*uaddr != val) {
+    spin_unlock(&b->lock);
+    local_irq_restore(eflags);
+    return -EAGAIN;
+  }
+
+  futex_q_t q;
+  q.key = key;
+  q.proc = current_process;
+  futex_q_link(b, &q);
+  current_process->state = PROCESS_WAITING;
+  spin_unlock(&b->lock);
+
+  uint32_t left = 1;
+  if (timeout_ms)
+    left = schedule_timeout(msecs_to_ticks(timeout_ms));
+  else
+    schedule();
+  current_process->state = PROCESS_RUNNING;
+
+  // Wake nahi mila (timeout ya signal) to khud queue se utro. Doosre CPU
+  // pe requeue padhne aur lock lene ke beech q ko naye bucket pe le ja
+  // sakta hai - lock ke andar dobara dekho, badla ho to phir se.
+  int ret = 0;
+  for (;;) {
+    futex_bucket_t *qb = q.bucket;
+    if (!qb)
+      break;
+    spin_lock(&qb->lock);
+    if (q.bucket != qb) {
+      spin_unlock(&qb->lock);
+      continue;
+    }
+    futex_q_unlink(&q);
+    q.bucket = 0;
+    spin_unlock(&qb->lock);
+    ret = left ? -EINTR : -ETIMEDOUT;
+    break;
+  }
+  local_irq_restore(eflags);
+  return ret;
+}
+
+int futex_wake(volatile uint32_t *uaddr, int nr_wake) {
+  uint32_t key = futex_key(uaddr);
+  if (!key)
+    return -EFAULT;
+
+  futex_bucket_t *b = futex_hash(key);
+  uint32_t eflags = spin_lock_irqsave(&b->lock);
+  int woken = 0;
+  futex_q_t *q = b->head;
+  while (q && woken < nr_wake) {
+    futex_q_t *next = q->next;
+    if (q->key == key) {
+      futex_q_wake(q);
+      woken++;
+    }
+    q = next;
+  }
+  spin_unlock_irqrestore(&b->lock, eflags);
+  return woken;
+}
+
+int futex_requeue(volatile uint32_t *uaddr, int nr_wake,
+                  volatile uint32_t *uaddr2, int nr_requeue) {
+  uint32_t key = futex_key(uaddr);
+  uint32_t key2 = futex_key(uaddr2);
+  if (!key || !key2)
+    return -EFAULT;
+
+  if (key == key2) // Khud pe requeue - bas jagao
+    return futex_wake(uaddr, nr_wake);
+
+  futex_bucket_t *b = futex_hash(key);
+  futex_bucket_t *b2 = futex_hash(key2);
+  uint32_t eflags = local_irq_save();
+  futex_lock_pair(b, b2);
+  int woken = 0, moved = 0;
+  futex_q_t *q = b->head;
+  while (q && (woken < nr_wake || moved < nr_requeue)) {
+    futex_q_t *next = q->next;
+    if (q->key == key) {
+      if (woken < nr_wake) {
+        futex_q_wake(q);
+        woken++;
+      } else {
+        // Cond broadcast: sab ek saath mutex pe na toot padein, mutex ke
+        // unlock pe ek ek karke jaagein. Dono locks pakde hain - bucket
+        // b se seedha b2 (futex_q_link), waiter ko 0 kabhi na dikhe.
+        futex_q_unlink(q);
+        q->key = key2;
+        futex_q_link(b2, q);
+        moved++;
+      }
+    }
+    q = next;
+  }
+  futex_unlock_pair(b, b2);
+  local_irq_restore(eflags);
+  return woken + moved;
+}
+
+int sys_futex(uint32_t *uaddr, int op, uint32_t val, uint32_t val2,
+              uint32_t *uaddr2) {
+  switch (op) {
+  case FUTEX_WAIT:
+    return futex_wait(uaddr, val, val2);
+  case FUTEX_WAKE:
+    return futex_wake(uaddr, (int)val);
+  case FUTEX_REQUEUE:
+    return futex_requeue(uaddr, (int)val, uaddr2, (int)val2);
+  default:
+    return -EINVAL;
+  }
+}
+
+} // extern "C"
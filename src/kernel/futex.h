@@ -0,0 +1,42 @@
+// Futex - user memory ke ek word pe sona/jagaana (Linux futex(2) jaisa)
+#ifndef FUTEX_H
+#define FUTEX_H
+
+#include "../include/types.h"
+
+// Lock ka fast path user space mein ek atomic op hai, kernel sirf contention
+// pe aata hai. Waiter ka key word ka *physical* address hai - shmat se do
+// processes alag virtual address pe same word dekhen to bhi milte hain.
+// Key nikaalne se pehle word pe write-touch hota hai, taaki COW / zero page
+// toot ke apna frame ban jaye (warna fork ke baad sharers ke key takraate).
+#define FUTEX_WAIT 0    // *uaddr == val ho to so, warna -EAGAIN
+#define FUTEX_WAKE 1    // uaddr pe zyada se zyada val waiters jagao
+#define FUTEX_REQUEUE 3 // val jagao, baaki mein se val2 ko uaddr2 pe le jao
+
+#define FUTEX_HASH_BITS 6
+#define FUTEX_HASH_SIZE (1 << FUTEX_HASH_BITS)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// timeout_ms 0 = hamesha. 0 (jagaya gaya), -EAGAIN (value badal chuki),
+// -ETIMEDOUT, -EINTR (signal), -EFAULT / -EINVAL.
+int futex_wait(volatile uint32_t *uaddr, uint32_t val, uint32_t timeout_ms);
+
+// Kitne jagaaye
+int futex_wake(volatile uint32_t *uaddr, int nr_wake);
+
+// Jagaaye + requeue kiye
+int futex_requeue(volatile uint32_t *uaddr, int nr_wake,
+                  volatile uint32_t *uaddr2, int nr_requeue);
+
+// Syscall entry: WAIT mein val2 = timeout (ms), REQUEUE mein nr_requeue
+int sys_futex(uint32_t *uaddr, int op, uint32_t val, uint32_t val2,
+              uint32_t *uaddr2);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -5,11 +5,10 @@
 extern "C" {
 
 extern void gdt_flush(uint32_t);
-extern void tss_flush();
 
-gdt_entry_t gdt_entries[6];
+gdt_entry_t gdt_entries[GDT_ENTRIES];
 gdt_ptr_t gdt_ptr;
-tss_entry_t tss_entry;
+tss_entry_t tss_entries[SMP_MAX_CPUS]; // Har CPU ka apna esp0
 
 void gdt_set_gate(int32_t num, uint32_t base, uint32_t limit, uint8_t access,
                   uint8_t gran) {
@@ -24,27 +23,44 @@ void gdt_set_gate(int32_t num, uint32_t base, uint32_t limit, uint8_t access,
   gdt_entries[num].access = access;
 }
 
-void write_tss(int32_t num, uint16_t ss0, uint32_t esp0) {
-  uint32_t base = (uint32_t)&tss_entry;
-  uint32_t limit = base + sizeof(tss_entry);
+void write_tss(uint32_t cpu, uint16_t ss0, uint32_t esp0) {
+  tss_entry_t *tss = &tss_entries[cpu];
+  uint32_t base = (uint32_t)tss;
+  uint32_t limit = base + sizeof(tss_entry_t);
 
-  gdt_set_gate(num, base, limit, 0xE9, 0x00);
+  gdt_set_gate(GDT_TSS_ENTRY(cpu), base, limit, 0xE9, 0x00);
 
-  memset(&tss_entry, 0, sizeof(tss_entry));
+  memset(tss, 0, sizeof(tss_entry_t));
 
-  tss_entry.ss0 = ss0;
-  tss_entry.esp0 = esp0;
+  tss->ss0 = ss0;
+  tss->esp0 = esp0;
 
   // CS, DS, ES, FS, GS, SS set karo jo CPU user mode mein jump karte waqt load
   // karega Hum unhe current segments + 3 (Ring 3 ke liye) pe set karte hain
-  tss_entry.cs = 0x0b;
-  tss_entry.ss = tss_entry.ds = tss_entry.es = tss_entry.fs = tss_entry.gs =
-      0x13;
+  tss->cs = 0x0b;
+  tss->ss = tss->ds = tss->es = tss->fs = tss->gs = 0x13;
+}
+
+// Ring 0 data segment, sirf cpus[n] jitna bada - %gs:0 = cpus[n].self
+static void write_percpu(uint32_t cpu, uint32_t canary) {
+  cpus[cpu].self = &cpus[cpu];
+  cpus[cpu].id = cpu;
+  cpus[cpu].stack_canary = canary;
+  gdt_set_gate(GDT_PERCPU_ENTRY(cpu), (uint32_t)&cpus[cpu],
+               sizeof(cpu_t) - 1, 0x92, 0x40);
+}
+
+// TR aur %gs is CPU ke entries pe
+static void load_cpu_segments(uint32_t cpu) {
+  uint16_t tss_sel = GDT_TSS_ENTRY(cpu) * 8;
+  uint16_t percpu_sel = GDT_PERCPU_ENTRY(cpu) * 8;
+  asm volatile("ltr %0" ::"r"(tss_sel));
+  asm volatile("mov %0, %%gs" ::"r"(percpu_sel) : "memory");
 }
 
 void init_gdt() {
   serial_log("GDT: Initializing...");
-  gdt_ptr.limit = (sizeof(gdt_entry_t) * 6) - 1;
+  gdt_ptr.limit = (sizeof(gdt_entry_t) * GDT_ENTRIES) - 1;
   gdt_ptr.base = (uint32_t)&gdt_entries;
 
   gdt_set_gate(0, 0, 0, 0, 0);                // Null segment (Kuch nahi)
@@ -53,14 +69,32 @@ void init_gdt() {
   gdt_set_gate(3, 0, 0xFFFFFFFF, 0xFA, 0xCF); // User mode code segment (Ring 3)
   gdt_set_gate(4, 0, 0xFFFFFFFF, 0xF2, 0xCF); // User mode data segment (Ring 3)
 
-  write_tss(5, 0x10, 0x0); // TSS (Task State Segment)
+  // Boot %gs (flat) wala canary hi aage - jo frames abhi stack pe hain
+  // (kernel_main waghera) wo %gs badalne ke baad bhi wahi value dekhein
+  uint32_t canary;
+  asm volatile("mov %%gs:20, %0" : "=r"(canary));
+
+  // Har CPU ka TSS (Task State Segment) aur per-CPU segment, APs ke bhi -
+  // wo baad mein sirf load karte hain
+  for (uint32_t cpu = 0; cpu < SMP_MAX_CPUS; cpu++) {
+    write_tss(cpu, 0x10, 0x0);
+    write_percpu(cpu, canary);
+  }
+  cpus[0].online = 1;
 
   gdt_flush((uint32_t)&gdt_ptr);
-  tss_flush();
+  load_cpu_segments(0); // TR = 0x28 aur %gs
 
   serial_log("GDT: Sab set hai. User Segments aur TSS taiyar.");
 }
 
-void set_kernel_stack(uint32_t stack) { tss_entry.esp0 = stack; }
+void gdt_init_ap(uint32_t cpu) {
+  gdt_flush((uint32_t)&gdt_ptr);
+  load_cpu_segments(cpu);
+}
+
+void set_kernel_stack(uint32_t stack) {
+  tss_entries[smp_processor_id()].esp0 = stack;
+}
 
 } // extern "C"
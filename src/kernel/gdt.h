@@ -2,6 +2,7 @@
 #define GDT_H
 
 #include "../include/types.h"
+#include "smp.h"
 
 // GDT entry structure
 struct gdt_entry_struct {
@@ -58,11 +59,22 @@ struct tss_entry_struct {
 
 typedef struct tss_entry_struct tss_entry_t;
 
+// 0-4: null, kernel code/data, user code/data. Phir har CPU ke do: TSS aur
+// per-CPU data segment (base = &cpus[n], %gs). CPU 0 ka TSS 0x28 pe hi hai.
+#define GDT_TSS_ENTRY(cpu) (5 + 2 * (cpu))
+#define GDT_PERCPU_ENTRY(cpu) (6 + 2 * (cpu))
+#define GDT_ENTRIES (5 + 2 * SMP_MAX_CPUS)
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+extern tss_entry_t tss_entries[SMP_MAX_CPUS];
+
 void init_gdt();
+// AP: shared GDT load karo, phir apna TSS aur %gs
+void gdt_init_ap(uint32_t cpu);
+// Is CPU ke TSS ka esp0
 void set_kernel_stack(uint32_t stack);
 
 #ifdef __cplusplus
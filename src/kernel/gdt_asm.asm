@@ -12,9 +12,3 @@ gdt_flush:
     jmp 0x08:.flush   ; 0x08 is the offset to our code segment: Far jump!
 .flush:
     ret
-
-[GLOBAL tss_flush]
-tss_flush:
-    mov ax, 0x28      ; Index of TSS (5) * 8 = 40 (0x28)
-    ltr ax            ; Load task register
-    ret
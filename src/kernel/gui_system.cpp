@@ -13,7 +13,11 @@
 #include "../include/vfs.h"
 #include "net_advanced.h" // Access to HTTP stack
 #include "pmm.h"
+#include "../drivers/keyboard.h"
+#include "clockevent.h"
+#include "clocksource.h"
 #include "process.h"
+#include "sched.h"
 #include <stdint.h>
 
 /* 🧱 SYSTEM INTERFACES (Kernel ke saath baat-cheet ka jariya) */
@@ -2612,6 +2616,60 @@ void format_kb(char *out, uint32_t kb) {
   }
 }
 
+// "hh:mm:ss"
+static void format_hms(char *out, uint32_t total_sec) {
+  uint32_t hours = total_sec / 3600;
+  uint32_t mins = (total_sec % 3600) / 60;
+  uint32_t secs = total_sec % 60;
+  char *p = out;
+  *p++ = '0' + (hours / 10) % 10;
+  *p++ = '0' + hours % 10;
+  *p++ = ':';
+  *p++ = '0' + mins / 10;
+  *p++ = '0' + mins % 10;
+  *p++ = ':';
+  *p++ = '0' + secs / 10;
+  *p++ = '0' + secs % 10;
+  *p = 0;
+}
+
+// Fixed-point load -> "1.05 "
+static char *format_load(char *p, uint32_t load) {
+  uint32_t whole = LOAD_INT(load);
+  uint32_t frac = LOAD_FRAC(load);
+  if (whole >= 10)
+    *p++ = '0' + (whole / 10) % 10;
+  *p++ = '0' + whole % 10;
+  *p++ = '.';
+  *p++ = '0' + frac / 10;
+  *p++ = '0' + frac % 10;
+  *p++ = ' ';
+  *p = 0;
+  return p;
+}
+
+// CPU usage: pichhle sample se idle task ka time vs baaki. Har draw pe
+// nahi - itna chhota window ho to percent kaanpta rehta hai.
+#define SYSMON_CPU_SAMPLE_NS 500000000ULL
+static uint64_t cpu_prev_idle = 0;
+static uint64_t cpu_prev_busy = 0;
+static int cpu_percent = 0;
+
+static void sample_cpu() {
+  uint64_t idle, busy;
+  sched_cpu_time(&idle, &busy);
+  uint64_t di = idle - cpu_prev_idle;
+  uint64_t db = busy - cpu_prev_busy;
+  if (di + db < SYSMON_CPU_SAMPLE_NS)
+    return;
+  // ~us mein, 32-bit maths (64-bit divide libgcc wala loop hai)
+  uint32_t busy_us = (uint32_t)(db >> 10);
+  uint32_t total_us = (uint32_t)((di + db) >> 10);
+  cpu_percent = total_us ? (int)(busy_us * 100 / total_us) : 0;
+  cpu_prev_idle = idle;
+  cpu_prev_busy = busy;
+}
+
 void sysmon_draw(Window *w) {
   int px = w->x;
   int py = w->y;
@@ -2686,23 +2744,9 @@ void sysmon_draw(Window *w) {
   line_y += 18;
 
   // Uptime
-  uint32_t uptime_sec = tick / 1000;
-  uint32_t hours = uptime_sec / 3600;
-  uint32_t mins = (uptime_sec % 3600) / 60;
-  uint32_t secs = uptime_sec % 60;
-
   FontSystem::draw_text(font, label_x, line_y, "Uptime:", 0xCCCCCC);
   char uptime_buf[32];
-  char *p = uptime_buf;
-  *p++ = '0' + hours / 10;
-  *p++ = '0' + hours % 10;
-  *p++ = ':';
-  *p++ = '0' + mins / 10;
-  *p++ = '0' + mins % 10;
-  *p++ = ':';
-  *p++ = '0' + secs / 10;
-  *p++ = '0' + secs % 10;
-  *p = 0;
+  format_hms(uptime_buf, ktime_get_ms() / 1000);
   FontSystem::draw_text(font, value_x, line_y, uptime_buf, 0xFFFFFF);
   line_y += 14;
 
@@ -2716,6 +2760,43 @@ void sysmon_draw(Window *w) {
 
   FontSystem::draw_text(font, label_x, line_y, "Kernel:", 0xCCCCCC);
   FontSystem::draw_text(font, value_x, line_y, "Higher-Half", 0xFFFFFF);
+  line_y += 25;
+
+  // CPU Section
+  FontSystem::draw_text(font, label_x, line_y, "=== CPU ===", 0x81D4FA);
+  line_y += 18;
+
+  sample_cpu();
+  FontSystem::draw_text(font, label_x, line_y, "CPU Usage:", 0xCCCCCC);
+  draw_progress_bar(value_x, line_y, 120, 12, cpu_percent,
+                    cpu_percent > 80 ? 0xFF5252
+                                     : (cpu_percent > 50 ? 0xFFB74D : 0x81C784),
+                    0x1A2A3A);
+  char *q = pct;
+  if (cpu_percent >= 100)
+    *q++ = '1';
+  if (cpu_percent >= 10)
+    *q++ = '0' + (cpu_percent / 10) % 10;
+  *q++ = '0' + cpu_percent % 10;
+  *q++ = '%';
+  *q = 0;
+  FontSystem::draw_text(font, value_x + 130, line_y, pct, 0xFFFFFF);
+  line_y += 18;
+
+  uint64_t idle_ns, busy_ns;
+  uint32_t idle_sec, idle_rem;
+  sched_cpu_time(&idle_ns, &busy_ns);
+  ns_to_sec_nsec(idle_ns, &idle_sec, &idle_rem);
+  FontSystem::draw_text(font, label_x, line_y, "Idle Time:", 0xCCCCCC);
+  format_hms(buf, idle_sec);
+  FontSystem::draw_text(font, value_x, line_y, buf, 0xFFFFFF);
+  line_y += 14;
+
+  FontSystem::draw_text(font, label_x, line_y, "Load Average:", 0xCCCCCC);
+  char *l = buf;
+  for (int i = 0; i < 3; i++)
+    l = format_load(l, avenrun[i]);
+  FontSystem::draw_text(font, value_x, line_y, buf, 0xFFFFFF);
 }
 
 bool sysmon_click(Window *w, int x, int y) {
@@ -2729,7 +2810,7 @@ bool sysmon_click(Window *w, int x, int y) {
 
 void launch_sysmonitor() {
   serial_log("GUI: Launching System Monitor...");
-  create_window(250, 150, 320, 280, "System Monitor", &SysMonitor::sysmon_theme,
+  create_window(250, 150, 320, 350, "System Monitor", &SysMonitor::sysmon_theme,
                 SysMonitor::sysmon_draw, SysMonitor::sysmon_click);
 }
 
@@ -3267,6 +3348,8 @@ void poll() {
 
 } // namespace WindowServer
 
+#define GUI_FRAME_TICKS 1 // Max ~TIMER_HZ frames/sec
+
 extern "C" void gui_main() {
   bga_set_video_mode(1024, 768, 32);
   FB::init();
@@ -3369,5 +3452,9 @@ extern "C" void gui_main() {
     }
 
     FB::swap();
+
+    // Agle frame (ek tick) ya input event tak so jao - pehle ye loop CPU
+    // 100% ghumata tha aur idle task kabhi nahi chalta tha
+    sleep_on_timeout(&input_wait, GUI_FRAME_TICKS);
   }
 }
@@ -1,20 +1,72 @@
 #include "heap.h"
+#include "../drivers/hpet.h"
 #include "../drivers/serial.h"
 #include "../include/string.h"
 #include "memory.h"
 #include "paging.h" // For getting physical address if needed
+#include "pmm.h"
 #include "slab.h"
+#include "spinlock.h"
+#include "tsc.h"
+#include "vmalloc.h"
 
 kheap_t kheap;
 int slab_is_initialized = 0;
 
+// Saare buddy arenas + arena list. Order: slab cache -> kheap -> pmm
+static DEFINE_SPINLOCK(heap_lock, "kheap");
+
 extern uint32_t *kernel_directory;
 
-// Heap badhane ka jugad
-void expand_unix_heap(uint32_t new_size) {
-  // Abhi toh fixed size hi hai
-  // Dynamic expansion baad mein dekhenge
-  serial_log("HEAP: Abhi fixed size hi chalne do.");
+// Grown arenas ke bitmaps yahan (4MB arena ko ~320 bytes chahiye) - arena
+// ke andar carve karte toh sabse bada block 2MB reh jaata
+#define KHEAP_ARENA_MAP_WORDS 96
+static uint32_t kheap_arena_maps[KHEAP_MAX_ARENAS][KHEAP_ARENA_MAP_WORDS];
+
+static buddy_t *kheap_arena_of(uint32_t addr) {
+  for (uint32_t i = 0; i < kheap.nr_arenas; i++) {
+    buddy_t *b = &kheap.arenas[i];
+    if (addr >= b->start_addr && addr < b->end_addr)
+      return b;
+  }
+  return 0;
+}
+
+// Heap badhane ka jugad: PMM se ek 4MB contiguous run (direct map mein hai,
+// toh PHYS_TO_VIRT se seedha use) aur usse naya buddy arena
+int expand_unix_heap(uint32_t min_size) {
+  if (min_size > KHEAP_GROW_SIZE) {
+    serial_log_hex("HEAP: Itna bada block arena mein nahi aayega, vmalloc "
+                   "use karo: ",
+                   min_size);
+    return 0;
+  }
+  if (kheap.nr_arenas >= KHEAP_MAX_ARENAS ||
+      kheap.committed + KHEAP_GROW_SIZE >
+          kheap.max_address - kheap.start_address) {
+    serial_log("HEAP: Max size tak pahunch gaye, aur nahi badhega.");
+    return 0;
+  }
+
+  uint32_t phys = (uint32_t)pmm_alloc_contiguous_blocks(KHEAP_GROW_SIZE / 4096);
+  if (!phys) {
+    serial_log("HEAP: PMM ke paas 4MB contiguous nahi hai.");
+    return 0;
+  }
+
+  uint32_t start = PHYS_TO_VIRT(phys);
+  uint32_t end = start + KHEAP_GROW_SIZE;
+  if (buddy_bitmap_bytes(start, end) > sizeof(kheap_arena_maps[0])) {
+    pmm_free_contiguous_blocks((void *)phys, KHEAP_GROW_SIZE / 4096);
+    return 0;
+  }
+
+  buddy_t *b = &kheap.arenas[kheap.nr_arenas];
+  buddy_init_bitmap(b, start, end, kheap_arena_maps[kheap.nr_arenas]);
+  kheap.nr_arenas++;
+  kheap.committed += KHEAP_GROW_SIZE;
+  serial_log_hex("HEAP: Naya arena jud gaya, committed: ", kheap.committed);
+  return 1;
 }
 
 void init_kheap(uint32_t start, uint32_t end, uint32_t max) {
@@ -29,29 +81,75 @@ void init_kheap(uint32_t start, uint32_t end, uint32_t max) {
   kheap.supervisor = 1;
   kheap.readonly = 0;
 
-  buddy_init(&kheap.buddy, start, end);
+  buddy_init(&kheap.arenas[0], start, end);
+  kheap.nr_arenas = 1;
+  kheap.committed = end - start;
 }
 
-#include "../include/io.h"
+// heap_lock pakda hua
+static void *kheap_arenas_alloc(size_t size, uint32_t flags) {
+  for (uint32_t i = 0; i < kheap.nr_arenas; i++) {
+    void *p = buddy_alloc_flags(&kheap.arenas[i], size, flags);
+    if (p)
+      return p;
+  }
+  return 0;
+}
 
-void *kmalloc_real(uint32_t size, int align, uint32_t *phys) {
-  cli();
+// Pehle maujood arenas, phir slab ke khaali pages (kmem_reap), phir naya arena
+static void *kheap_buddy_alloc(size_t size, uint32_t flags) {
+  uint32_t eflags = spin_lock_irqsave(&heap_lock);
+  void *p = kheap_arenas_alloc(size, flags);
+  spin_unlock_irqrestore(&heap_lock, eflags);
+  if (p)
+    return p;
+
+  // Reap cache locks leta hai jo heap_lock se pehle aate hain - lock chhod ke
+  uint32_t reaped = slab_is_initialized ? kmem_reap() : 0;
 
+  eflags = spin_lock_irqsave(&heap_lock);
+  if (reaped)
+    p = kheap_arenas_alloc(size, flags);
+  if (!p && expand_unix_heap(size))
+    p = buddy_alloc_flags(&kheap.arenas[kheap.nr_arenas - 1], size, flags);
+  spin_unlock_irqrestore(&heap_lock, eflags);
+  return p;
+}
+
+void kheap_get_stats(buddy_stats_t *out) {
+  buddy_stats_t st;
+  memset(out, 0, sizeof(buddy_stats_t));
+  uint32_t eflags = spin_lock_irqsave(&heap_lock);
+  for (uint32_t i = 0; i < kheap.nr_arenas; i++) {
+    buddy_get_stats(&kheap.arenas[i], &st);
+    out->free_bytes += st.free_bytes;
+    if (st.largest_free > out->largest_free)
+      out->largest_free = st.largest_free;
+    for (int o = 0; o < BUDDY_NUM_ORDERS; o++)
+      out->nr_free[o] += st.nr_free[o];
+  }
+  spin_unlock_irqrestore(&heap_lock, eflags);
+  out->frag_pct = out->free_bytes ? 100 - ((out->largest_free >> 12) * 100) /
+                                              (out->free_bytes >> 12)
+                                  : 0;
+}
+
+// flags = BUDDY_NOZERO: buddy block ka memset skip (sirf > 2048 wale sizes;
+// chhote slab objects kmalloc-N caches mein hamesha zeroed)
+static void *heap_alloc(uint32_t size, int align, uint32_t *phys,
+                        uint32_t flags) {
   // Pehle Slab Allocator check karo (agar chhota size hai)
   if (slab_is_initialized && size <= 2048 && !align) {
     void *ptr = slab_alloc(size);
     if (ptr) {
       if (phys)
         *phys = (uint32_t)ptr;
-      sti();
       return ptr;
     }
   }
 
-  if (size == 0) {
-    sti();
+  if (size == 0)
     return 0;
-  }
 
   // Buddy Allocator use karenge
   // Kitne bytes chahiye? header + padding + pointer sab milake
@@ -59,10 +157,9 @@ void *kmalloc_real(uint32_t size, int align, uint32_t *phys) {
   if (align)
     required_size += 4096;
 
-  void *buddy_ptr = buddy_alloc(&kheap.buddy, required_size);
+  void *buddy_ptr = kheap_buddy_alloc(required_size, flags);
   if (!buddy_ptr) {
     serial_log("HEAP: OOM in Buddy Allocator!");
-    sti();
     return nullptr;
   }
 
@@ -85,35 +182,41 @@ void *kmalloc_real(uint32_t size, int align, uint32_t *phys) {
   if (phys)
     *phys = (uint32_t)data;
 
-  sti();
   return data;
 }
 
+void *kmalloc_real(uint32_t size, int align, uint32_t *phys) {
+  return heap_alloc(size, align, phys, 0);
+}
+
 void kfree(void *p) {
-  cli();
-  if (p == 0) {
-    sti();
+  if (p == 0)
     return;
-  }
 
-  // Try Slab Free
-  if (slab_is_initialized && slab_free(p)) {
-    sti();
+  // vmalloc buffer galti se kfree ho gaya - sahi jagah bhejo
+  if (is_vmalloc_addr(p)) {
+    vfree(p);
     return;
   }
 
+  // Try Slab Free (cache ka apna lock)
+  if (slab_is_initialized && slab_free(p))
+    return;
+
   // Asli Buddy block pointer nikalo jo humne chhupa ke rakha tha
   uint32_t buddy_ptr = *((uint32_t *)((uintptr_t)p - 4));
-  if (buddy_ptr < kheap.start_address || buddy_ptr > kheap.end_address) {
+  uint32_t eflags = spin_lock_irqsave(&heap_lock);
+  buddy_t *arena = kheap_arena_of(buddy_ptr);
+  if (!arena) {
+    spin_unlock_irqrestore(&heap_lock, eflags);
     serial_log("HEAP: Pointer galat hai - corruption lag raha hai!");
-    sti();
     return;
   }
 
   header_t *header = (header_t *)buddy_ptr;
   if (header->magic != 0xCAFEBABE) {
+    spin_unlock_irqrestore(&heap_lock, eflags);
     serial_log("HEAP: Double free ya corruption, kuch toh gadbad hai!");
-    sti();
     return;
   }
 
@@ -121,10 +224,102 @@ void kfree(void *p) {
   header->allocated = 0;
   header->magic = 0xBADB00B5;
 
-  buddy_free(&kheap.buddy, header, size);
-  sti();
+  buddy_free(arena, header, size);
+  spin_unlock_irqrestore(&heap_lock, eflags);
+}
+
+// Exact 4KB page aligned blocks, header/hidden pointer ke bina (slab pages,
+// socket rings). kfree() nahi - kheap_free_page() se hi wapas karo.
+void *kheap_alloc_page() { return kheap_buddy_alloc(4096, BUDDY_NOZERO); }
+
+void kheap_free_page(void *page) {
+  uint32_t eflags = spin_lock_irqsave(&heap_lock);
+  buddy_t *arena = kheap_arena_of((uint32_t)page);
+  if (arena)
+    buddy_free(arena, page, 4096);
+  spin_unlock_irqrestore(&heap_lock, eflags);
 }
 
 void *malloc(uint32_t size) { return kmalloc_real(size, 0, 0); }
 
 void free(void *p) { kfree(p); }
+
+void *malloc_nozero(uint32_t size) {
+  return heap_alloc(size, 0, 0, BUDDY_NOZERO);
+}
+
+// Boot-time stress benchmark: random alloc/free mix (2KB..64KB, buddy path)
+// zeroing aur BUDDY_NOZERO dono ke saath, same seed. Peak pe fragmentation
+// bhi dikhate hain (sabse bada free block vs total free).
+#define KHEAP_BENCH_SLOTS 256
+#define KHEAP_BENCH_OPS 16384
+static void *kheap_bench_ptrs[KHEAP_BENCH_SLOTS];
+
+static uint32_t kheap_bench_rate(uint32_t ops, uint64_t cycles,
+                                 uint64_t hpet_ticks) {
+  uint32_t period_fs = hpet_get_period_fs();
+  if (hpet_ticks && period_fs) {
+    // ops / (ticks * period_fs / 1e15)
+    return (uint32_t)(((uint64_t)ops * 1000000000000000ULL) /
+                      (hpet_ticks * period_fs));
+  }
+  // HPET nahi hai toh cycles per op hi dikha do
+  return ops ? (uint32_t)(cycles / ops) : 0;
+}
+
+static void kheap_bench_run(const char *label, uint32_t flags) {
+  uint32_t seed = 0x1234567;
+  uint32_t ops = 0, worst_frag = 0;
+  buddy_stats_t st;
+
+  uint64_t h1 = hpet_read_counter();
+  uint64_t t1 = rdtsc();
+  for (uint32_t i = 0; i < KHEAP_BENCH_OPS; i++) {
+    seed = seed * 1103515245 + 12345;
+    uint32_t slot = (seed >> 8) % KHEAP_BENCH_SLOTS;
+    if (kheap_bench_ptrs[slot]) {
+      kfree(kheap_bench_ptrs[slot]);
+      kheap_bench_ptrs[slot] = 0;
+    } else {
+      // 2KB..64KB, chhote sizes zyada (log distribution)
+      uint32_t size = (2048u << ((seed >> 16) % 6)) + ((seed >> 4) & 0x7FF);
+      kheap_bench_ptrs[slot] = heap_alloc(size, 0, 0, flags);
+    }
+    ops++;
+    if ((i & 1023) == 1023) {
+      kheap_get_stats(&st);
+      if (st.frag_pct > worst_frag)
+        worst_frag = st.frag_pct;
+    }
+  }
+  uint64_t t2 = rdtsc();
+  uint64_t h2 = hpet_read_counter();
+
+  kheap_get_stats(&st);
+  for (int i = 0; i < KHEAP_BENCH_SLOTS; i++) {
+    if (kheap_bench_ptrs[i]) {
+      kfree(kheap_bench_ptrs[i]);
+      kheap_bench_ptrs[i] = 0;
+    }
+  }
+
+  serial_log(label);
+  serial_log_hex("  Rate:        ", kheap_bench_rate(ops, t2 - t1, h2 - h1));
+  serial_log_hex("  Frag % (end):", st.frag_pct);
+  serial_log_hex("  Frag % (max):", worst_frag);
+}
+
+void kheap_benchmark() {
+  serial_log("HEAP BENCH: Random alloc/free mix, 2KB..64KB...");
+  serial_log(hpet_get_period_fs() ? "  Units: ops/sec"
+                                  : "  Units: cycles/op (no HPET)");
+  serial_log_hex("  Ops:         ", KHEAP_BENCH_OPS);
+  kheap_bench_run("  Zeroed (kmalloc):", 0);
+  kheap_bench_run("  No-zero (kmalloc_nozero):", BUDDY_NOZERO);
+
+  buddy_stats_t st;
+  kheap_get_stats(&st);
+  serial_log_hex("  Arenas:          ", kheap.nr_arenas);
+  serial_log_hex("  Free bytes after:", st.free_bytes);
+  serial_log_hex("  Largest free:    ", st.largest_free);
+}
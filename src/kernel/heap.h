@@ -12,6 +12,12 @@ typedef struct header {
   uint32_t magic;      // verification bytes (Canary)
 } header_t;
 
+// Heap growth: initial arena bhar jaye toh PMM se 4MB contiguous chunks
+// naye buddy arenas bante hain (direct map mein, max_address - start_address
+// total tak). 4MB se bade buffers ke liye vmalloc.
+#define KHEAP_MAX_ARENAS 64
+#define KHEAP_GROW_SIZE (4 * 1024 * 1024)
+
 // Define a heap structure
 typedef struct {
   uint32_t start_address;
@@ -20,7 +26,9 @@ typedef struct {
   uint8_t supervisor;
   uint8_t readonly;
   header_t *first_block;
-  buddy_t buddy;
+  buddy_t arenas[KHEAP_MAX_ARENAS]; // [0] = boot arena
+  uint32_t nr_arenas;
+  uint32_t committed; // Saare arenas ka total size
 } kheap_t;
 
 #ifdef __cplusplus
@@ -31,12 +39,26 @@ extern "C" {
 // generic implementation of malloc/free
 void init_kheap(uint32_t start, uint32_t end, uint32_t max);
 
+// Heap mein ek naya arena jodo jo min_size ka block de sake. 1 = badh gaya
+int expand_unix_heap(uint32_t min_size);
+
+// Saare arenas ka combined free/fragmentation haal
+void kheap_get_stats(buddy_stats_t *out);
+
 void *kmalloc_real(uint32_t size, int align, uint32_t *phys);
 void kfree(void *p);
 
+// Raw 4KB page aligned blocks (slab pages, socket rings) - not for kfree()
+void *kheap_alloc_page();
+void kheap_free_page(void *page);
+
 // Wrappers
 void *malloc(uint32_t size);
 void free(void *p);
+void *malloc_nozero(uint32_t size); // Bade buffers jo caller poora likhega
+
+// Boot-time random alloc/free stress benchmark (ops/sec + fragmentation)
+void kheap_benchmark();
 
 #ifdef __cplusplus
 }
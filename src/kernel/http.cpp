@@ -6,6 +6,7 @@
 #include "heap.h"
 #include "http_parser.h"
 #include "memory.h"
+#include "net.h"
 #include <stddef.h>
 #include <stdint.h>
 
@@ -256,7 +257,7 @@ extern "C" int http_get(const char *url, uint8_t *buffer, int max_len,
       return -1;
     }
     net_poll();
-    schedule();
+    net_wait(NET_WAIT_MS);
   }
 
   void *tls_context = is_https ? tls_init(conn, hostname) : nullptr;
@@ -297,7 +298,7 @@ extern "C" int http_get(const char *url, uint8_t *buffer, int max_len,
     if (timer_now_ms() - start > HTTP_TIMEOUT_MS)
       break;
     net_poll();
-    schedule();
+    net_wait(NET_WAIT_MS);
   }
 
   if (is_https)
@@ -13,17 +13,24 @@ isr_common_stub:
     mov ds, ax
     mov es, ax
     mov fs, ax
+    str ax          ; Is CPU ka TSS selector - per-CPU segment theek uske baad
+    add ax, 8
     mov gs, ax
+    cld             ; User/std code ka DF=1 kernel ke rep movs/stos ulta na chalaaye
 
     push esp        ; Pass pointer to registers_t
     call isr_handler
     add esp, 4      ; Clean up stack
 
+isr_exit:           ; sysenter_entry ka iret wala raasta bhi yahin se
     pop eax         ; reload the original data segment descriptor
     mov ds, ax
     mov es, ax
     mov fs, ax
+    test byte [esp + 44], 3 ; Saved CS (pusha 32 + int_no/err 8 + eip 4)
+    jz .kernel_gs   ; Kernel mein laut rahe hain - %gs is CPU ka hi rahe
     mov gs, ax
+.kernel_gs:
 
     popa            ; Pops edi,esi,ebp...
     add esp, 8      ; Cleans up the pushed error code and pushed ISR number
@@ -40,7 +47,10 @@ irq_common_stub:
     mov ds, ax
     mov es, ax
     mov fs, ax
+    str ax          ; Is CPU ka TSS selector - per-CPU segment theek uske baad
+    add ax, 8
     mov gs, ax
+    cld             ; DF=0, isr_common_stub jaisa
 
     push esp        ; Pass pointer to registers_t
     extern irq_handler
@@ -51,12 +61,60 @@ irq_common_stub:
     mov ds, ax
     mov es, ax
     mov fs, ax
+    test byte [esp + 44], 3 ; Saved CS (pusha 32 + int_no/err 8 + eip 4)
+    jz .kernel_gs   ; Kernel mein laut rahe hain - %gs is CPU ka hi rahe
     mov gs, ax
+.kernel_gs:
 
     popa            ; Pops edi,esi,ebp...
     add esp, 8      ; Cleans up the pushed error code and pushed ISR number
     iret
 
+; SYSENTER fast syscall (syscall.cpp). CPU ne diya: CS=0x08, SS=0x10, IF=0,
+; ESP = cpu_t.sysenter_tss. User stub ne: ebp = user esp, [ebp] = wapas aane
+; ka eip. Frame int 0x80 wala hi (registers_t) taaki handlers, fork aur
+; execve ko farak na pade. ds/es/fs user ke 0x23 (flat) hi rehte hain -
+; kernel unse bhi chal jaata hai, reload ka kharcha nahi. Sirf %gs per-CPU.
+[extern sysenter_handler]
+global sysenter_entry
+sysenter_entry:
+    mov esp, [esp]          ; &tss_entries[cpu]
+    mov esp, [esp + 4]      ; TSS.esp0 - current task ka kernel stack top
+    push dword 0x23         ; ss
+    push ebp                ; useresp
+    pushf
+    or dword [esp], 0x200   ; User ka IF (SYSENTER ne band kiya tha)
+    push dword 0x1B         ; cs
+    push dword 0            ; eip - sysenter_handler [ebp] se bharta hai
+    push dword 0            ; err_code
+    push dword 128          ; int_no
+    pusha
+    push dword 0x23         ; ds
+
+    str ax                  ; eax pusha mein bach gaya
+    add ax, 8
+    mov gs, ax
+    cld
+
+    push esp
+    call sysenter_handler
+    add esp, 4
+    test eax, eax
+    jz isr_exit             ; execve ne frame badla - iret, saare registers
+
+    add esp, 4              ; ds - user ka hi hai
+    mov ax, 0x23
+    mov gs, ax
+    popa
+    add esp, 8              ; int_no, err_code
+    mov edx, [esp]          ; SYSEXIT: eip = edx
+    mov ecx, [esp + 12]     ;          esp = ecx
+    and dword [esp + 8], ~0x200
+    push dword [esp + 8]    ; User eflags, IF abhi band
+    popf
+    sti                     ; sti ke baad ek instruction tak IRQ nahi aata
+    sysexit
+
 ; Macros for ISRs
 %macro ISR_NOERRCODE 1
     global isr%1
@@ -133,6 +191,11 @@ IRQ 44, 44
 IRQ 45, 45
 IRQ 46, 46
 IRQ 47, 47
+; LAPIC timer (clockevent)
+IRQ 48, 48
+; SMP IPIs (smp.h)
+IRQ 49, 49
+IRQ 50, 50
 
 ; System Call (INT 0x80)
 ISR_NOERRCODE 128
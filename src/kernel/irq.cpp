@@ -9,6 +9,9 @@
 
 #include "../drivers/acpi.h"
 #include "apic.h"
+#include "sched.h"
+#include "smp.h"
+#include "spinlock.h"
 
 // ISRs define kiye hain lekin hum macros use kar rahe hain
 // Chalo isr32-47 symbols ko reference karte hain
@@ -56,6 +59,9 @@ void irq_install() {
   set_idt_gate(45, (uint32_t)isr45);
   set_idt_gate(46, (uint32_t)isr46);
   set_idt_gate(47, (uint32_t)isr47);
+  set_idt_gate(48, (uint32_t)isr48); // LAPIC timer
+  set_idt_gate(49, (uint32_t)isr49); // IPI: resched
+  set_idt_gate(50, (uint32_t)isr50); // IPI: TLB shootdown
 }
 
 // Dispatch ke liye ek single handler
@@ -66,7 +72,21 @@ void irq_set_mask(uint8_t irq, bool masked) {
   }
 }
 
+// IPIs aur AP ka tick sirf scheduler/TLB chhoote hain (apne spinlocks) -
+// big kernel lock pe rukna bekaar, aur shootdown ka ack to lock pakde CPU
+// ko hi chahiye. Baaki sab (device IRQs, BSP ka tick - timers, drivers)
+// lock ke andar.
+static inline int irq_needs_kernel_lock(uint32_t vector) {
+  if (vector == IPI_RESCHEDULE_VECTOR || vector == IPI_TLB_VECTOR)
+    return 0;
+  return !(vector == 48 && smp_processor_id());
+}
+
 void irq_handler(registers_t *regs) {
+  int giant = irq_needs_kernel_lock(regs->int_no);
+  if (giant)
+    lock_kernel();
+
   // EOI (End of Interrupt) bhejna zaroori hai
   if (lapic_base) {
     lapic_eoi();
@@ -83,9 +103,19 @@ void irq_handler(registers_t *regs) {
     handler(regs);
   }
 
+  // Handler ne kisi aise task ko jagaaya jo chalte hue ko preempt kare.
+  // Lock pakde hue task ko nahi - uska aakhri unlock switch karega.
+  if (need_resched() && !preempt_count())
+    schedule();
+
   // User mode mein wapas jaane se pehle signals handle karo
   if ((regs->cs & 3) == 3) {
+    lock_kernel(); // Recursive - giant wale pe sirf gehraai badhti hai
     handle_signals(regs);
+    unlock_kernel();
   }
+
+  if (giant)
+    unlock_kernel();
 }
 } // extern "C"
@@ -4,6 +4,9 @@
 #include "../include/idt.h"
 #include "../include/signal.h"
 #include "../include/string.h"
+#include "sched.h"
+#include "smp.h"
+#include "spinlock.h"
 
 extern "C" {
 isr_t interrupt_handlers[256];
@@ -98,10 +101,13 @@ const char *exception_messages[] = {"Division By Zero",
                                     "Reserved",
                                     "Reserved"};
 
-extern "C" void isr_handler(registers_t *regs) {
+static void do_isr(registers_t *regs) {
   if (interrupt_handlers[regs->int_no] != 0) {
     isr_t handler = interrupt_handlers[regs->int_no];
     handler(regs);
+    // Syscall (pipe write, kill...) ne kisi ko jagaaya ho to yahin switch
+    if (need_resched() && !preempt_count())
+      schedule();
     return;
   }
 
@@ -145,3 +151,11 @@ extern "C" void isr_handler(registers_t *regs) {
   for (;;)
     ;
 }
+
+// Syscalls aur exceptions big kernel lock ke andar (smp.h). exit_process
+// wapas nahi aata - uska schedule() lock chhod chuka hota hai.
+extern "C" void isr_handler(registers_t *regs) {
+  lock_kernel();
+  do_isr(regs);
+  unlock_kernel();
+}
@@ -6,6 +6,8 @@
 #include "../include/string.h"
 #include "heap.h"
 #include "memory.h"
+#include "slab.h"
+#include "vmalloc.h"
 
 extern "C" {
 
@@ -214,7 +216,7 @@ int fs_read_internal(uint32_t inode_id, void *buffer, uint32_t len,
 
 vfs_node_t *kfs_mount_wrapper(struct filesystem *fs, void *device) {
   // Return root node (inode 0)
-  vfs_node_t *node = (vfs_node_t *)kmalloc(sizeof(vfs_node_t));
+  vfs_node_t *node = (vfs_node_t *)kmem_cache_alloc(vfs_node_cache);
   memset(node, 0, sizeof(vfs_node_t));
   strcpy(node->name, "kfs_root");
   node->inode = 0; // Root inode
@@ -229,7 +231,7 @@ vfs_node_t *kfs_lookup_wrapper(vfs_node_t *dir, const char *name) {
   if (inode < 0)
     return 0; // Not found
 
-  vfs_node_t *node = (vfs_node_t *)kmalloc(sizeof(vfs_node_t));
+  vfs_node_t *node = (vfs_node_t *)kmem_cache_alloc(vfs_node_cache);
   memset(node, 0, sizeof(vfs_node_t));
   strncpy(node->name, name, 255);
   node->inode = inode;
@@ -354,7 +356,8 @@ void kernel_fs_init() {
   // 1. Allocate Disk Memory
   // 4096 blocks * 4096 bytes = 16MB
   uint32_t disk_size = MAX_BLOCKS * BLOCK_SIZE;
-  disk_memory = (uint8_t *)kmalloc(disk_size);
+  // 16MB - contiguous nahi chahiye, vmalloc
+  disk_memory = (uint8_t *)vmalloc(disk_size);
   // Assuming kmalloc_aligned exists or normal kmalloc is aligned enough.
   // Fallback to kmalloc if aligned not available, usually 8-byte aligned. 4k
   // needed? No, just pointer.
@@ -7,6 +7,7 @@
 #include "../include/vfs.h"
 #include "heap.h"
 #include "memory.h"
+#include "slab.h"
 #include "process.h" // For FD table via current_process
 
 extern "C" {
@@ -66,7 +67,7 @@ int v_open(const char *path, int flags) {
 
   // 5. Store Description
   file_description_t *desc =
-      (file_description_t *)kmalloc(sizeof(file_description_t));
+      (file_description_t *)kmem_cache_alloc(file_desc_cache);
   desc->node = node;
   desc->offset = 0;
   desc->flags = flags;
@@ -0,0 +1,174 @@
+#include "ktimer.h"
+#include "clockevent.h"
+#include "spinlock.h"
+
+extern uint32_t tick;
+
+static ktimer_t *tv_root[KTIMER_ROOT_SIZE];
+static ktimer_t *tv[KTIMER_LEVELS][KTIMER_LVL_SIZE];
+static uint32_t timer_jiffies = 0; // Agla tick jo abhi chalana baaki hai
+
+// Wheel + timer_jiffies. Callbacks (sched_wakeup, mod_timer) ke waqt
+// chhoda jaata hai - woh khud ye lock lete hain.
+static DEFINE_SPINLOCK(timer_lock, "timers");
+
+// Jiska callback abhi chal raha hai (lock chhoda hua hai) - timer_del_sync
+// iske khatam hone tak rukta hai
+static ktimer_t *volatile running_timer = 0;
+
+// Level n (0 = root ke upar wala) mein timer_jiffies ka slot
+static inline int ktimer_index(int n) {
+  return (timer_jiffies >> (KTIMER_ROOT_BITS + n * KTIMER_LVL_BITS)) &
+         (KTIMER_LVL_SIZE - 1);
+}
+
+static void ktimer_link(ktimer_t **head, ktimer_t *timer) {
+  timer->next = *head;
+  if (*head)
+    (*head)->pprev = &timer->next;
+  *head = timer;
+  timer->pprev = head;
+}
+
+static void ktimer_unlink(ktimer_t *timer) {
+  *timer->pprev = timer->next;
+  if (timer->next)
+    timer->next->pprev = timer->pprev;
+  timer->next = 0;
+  timer->pprev = 0;
+}
+
+// Expiry kitni door hai uske hisaab se level aur slot chuno
+static void ktimer_enqueue(ktimer_t *timer) {
+  uint32_t expires = timer->expires;
+  uint32_t idx = expires - timer_jiffies;
+  ktimer_t **slot;
+
+  if ((int32_t)idx < 0) {
+    // Pehle hi nikal chuka - agle chalne wale slot mein
+    slot = &tv_root[timer_jiffies & (KTIMER_ROOT_SIZE - 1)];
+  } else if (idx < KTIMER_ROOT_SIZE) {
+    slot = &tv_root[expires & (KTIMER_ROOT_SIZE - 1)];
+  } else {
+    int n = 0;
+    while (n < KTIMER_LEVELS - 1 &&
+           idx >= (1u << (KTIMER_ROOT_BITS + (n + 1) * KTIMER_LVL_BITS)))
+      n++;
+    slot = &tv[n][(expires >> (KTIMER_ROOT_BITS + n * KTIMER_LVL_BITS)) &
+                  (KTIMER_LVL_SIZE - 1)];
+  }
+  ktimer_link(slot, timer);
+}
+
+// Level n ka ek slot khaali karke uske timers neeche wale levels mein.
+// Returns index - 0 matlab ye level bhi ghoom gaya, agla level bhi cascade.
+static int ktimer_cascade(int n, int index) {
+  ktimer_t *t = tv[n][index];
+  tv[n][index] = 0;
+  while (t) {
+    ktimer_t *next = t->next;
+    ktimer_enqueue(t);
+    t = next;
+  }
+  return index;
+}
+
+int timer_add(ktimer_t *timer, uint32_t expires) {
+  uint32_t eflags = spin_lock_irqsave(&timer_lock);
+  if (timer_pending(timer)) {
+    spin_unlock_irqrestore(&timer_lock, eflags);
+    return -1;
+  }
+  timer->expires = expires;
+  ktimer_enqueue(timer);
+  clockevent_timer_added(expires);
+  spin_unlock_irqrestore(&timer_lock, eflags);
+  return 0;
+}
+
+int mod_timer(ktimer_t *timer, uint32_t expires) {
+  uint32_t eflags = spin_lock_irqsave(&timer_lock);
+  int was_pending = timer_pending(timer);
+  if (was_pending)
+    ktimer_unlink(timer);
+  timer->expires = expires;
+  ktimer_enqueue(timer);
+  clockevent_timer_added(expires);
+  spin_unlock_irqrestore(&timer_lock, eflags);
+  return was_pending;
+}
+
+int mod_timer_ms(ktimer_t *timer, uint32_t ms) {
+  return mod_timer(timer, tick + msecs_to_ticks(ms));
+}
+
+int timer_del(ktimer_t *timer) {
+  uint32_t eflags = spin_lock_irqsave(&timer_lock);
+  int was_pending = timer_pending(timer);
+  if (was_pending)
+    ktimer_unlink(timer);
+  spin_unlock_irqrestore(&timer_lock, eflags);
+  return was_pending;
+}
+
+int timer_del_sync(ktimer_t *timer) {
+  for (;;) {
+    uint32_t eflags = spin_lock_irqsave(&timer_lock);
+    int was_pending = timer_pending(timer);
+    if (was_pending)
+      ktimer_unlink(timer);
+    if (running_timer != timer) {
+      spin_unlock_irqrestore(&timer_lock, eflags);
+      return was_pending;
+    }
+    // Callback doosre CPU pe chal raha hai - khud ko dobara daal bhi sakta
+    // hai, isliye har baar phir se unlink
+    spin_unlock_irqrestore(&timer_lock, eflags);
+    while (running_timer == timer)
+      asm volatile("pause" ::: "memory");
+  }
+}
+
+void run_timers(void) {
+  uint32_t eflags = spin_lock_irqsave(&timer_lock);
+  while ((int32_t)(tick - timer_jiffies) >= 0) {
+    int index = timer_jiffies & (KTIMER_ROOT_SIZE - 1);
+    if (!index) {
+      int n = 0;
+      while (n < KTIMER_LEVELS && !ktimer_cascade(n, ktimer_index(n)))
+        n++;
+    }
+    timer_jiffies++;
+
+    // Slot ko local list pe le lo: callback kisi aur expired timer ko
+    // timer_del kare ya khud ko mod_timer se wapas daale, dono sahi chalen
+    ktimer_t *work = tv_root[index];
+    tv_root[index] = 0;
+    if (work)
+      work->pprev = &work;
+    while (work) {
+      ktimer_t *t = work;
+      ktimer_unlink(t);
+      running_timer = t;
+      // Interrupts band hi rehte hain - local work list koi aur nahi chhoota
+      spin_unlock(&timer_lock);
+      t->fn(t);
+      spin_lock(&timer_lock);
+      running_timer = 0;
+    }
+  }
+  spin_unlock_irqrestore(&timer_lock, eflags);
+}
+
+uint32_t timer_next_expiry(void) {
+  uint32_t eflags = spin_lock_irqsave(&timer_lock);
+  uint32_t next = (timer_jiffies | (KTIMER_ROOT_SIZE - 1)) + 1;
+  for (uint32_t j = timer_jiffies; j != next; j++) {
+    if (tv_root[j & (KTIMER_ROOT_SIZE - 1)]) {
+      next = j;
+      break;
+    }
+  }
+  spin_unlock_irqrestore(&timer_lock, eflags);
+  return next;
+}
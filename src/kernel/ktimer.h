@@ -0,0 +1,88 @@
+// Kernel timers - hierarchical timing wheel (Linux ke purane timer.c jaisa)
+#ifndef KTIMER_H
+#define KTIMER_H
+
+#include "../include/types.h"
+
+// Tick rate - LAPIC clockevent ho ya PIT fallback, tick isi rate se badhta
+#define TIMER_HZ 50
+#define MS_PER_TICK (1000 / TIMER_HZ)
+#define NS_PER_TICK (1000000000 / TIMER_HZ)
+
+// Paanch levels: pehla 256 slots (har tick ka apna), baaki 64-64 slots,
+// har level pichhle se 256/64 guna mota. Timer apne expiry ke hisaab se
+// kisi level ke slot mein baithta hai; level 0 ka index ghoom ke 0 pe aaye
+// tab agle level ka ek slot neeche "cascade" hota hai. Har tick sirf ek
+// slot chalta hai - kharcha O(expired), process/timer count se nahi.
+#define KTIMER_ROOT_BITS 8
+#define KTIMER_LVL_BITS 6
+#define KTIMER_ROOT_SIZE (1 << KTIMER_ROOT_BITS)
+#define KTIMER_LVL_SIZE (1 << KTIMER_LVL_BITS)
+#define KTIMER_LEVELS 4 // Root ke upar
+
+struct ktimer;
+typedef void (*ktimer_fn_t)(struct ktimer *timer);
+
+// Jis struct ka timer hai usi mein embed karo (process, tcb...), callback
+// data se apna object nikaal leta hai. Callback timer IRQ mein chalta hai -
+// interrupts band, sleep/schedule mana.
+typedef struct ktimer {
+  struct ktimer *next;
+  struct ktimer **pprev; // 0 = pending nahi
+  uint32_t expires;      // Absolute tick
+  ktimer_fn_t fn;
+  void *data;
+} ktimer_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static inline void timer_setup(ktimer_t *timer, ktimer_fn_t fn, void *data) {
+  timer->next = 0;
+  timer->pprev = 0;
+  timer->expires = 0;
+  timer->fn = fn;
+  timer->data = data;
+}
+
+static inline int timer_pending(const ktimer_t *timer) {
+  return timer->pprev != 0;
+}
+
+// ms -> ticks, upar round (0 ms bhi kam se kam agla tick)
+static inline uint32_t msecs_to_ticks(uint32_t ms) {
+  uint32_t t = (ms + MS_PER_TICK - 1) / MS_PER_TICK;
+  return t ? t : 1;
+}
+
+// expires (absolute tick) pe fn chalao. Pehle se pending ho to -1.
+int timer_add(ktimer_t *timer, uint32_t expires);
+
+// Pending ho ya na ho, naya expiry. Pehle pending tha to 1, warna 0.
+int mod_timer(ktimer_t *timer, uint32_t expires);
+
+// Ab se ms baad (tick granularity, upar round)
+int mod_timer_ms(ktimer_t *timer, uint32_t ms);
+
+// Hatao. Pending tha to 1, warna 0. Apne hi callback se bhi safe.
+int timer_del(ktimer_t *timer);
+
+// timer_del, aur callback abhi (doosre CPU pe) chal raha ho to uske khatam
+// hone tak ruko. Iske baad timer wala object free kar sakte ho. Apne callback
+// se ya callback jo lock leta hai use pakad ke mat bulao - deadlock.
+int timer_del_sync(ktimer_t *timer);
+
+// Timer IRQ se, tick badhne ke baad: jitne ticks chhoote sab chala do
+void run_timers(void);
+
+// Nohz ke liye: kis tick tak koi timer nahi bajega. Root wheel mein timer
+// ho to uska exact tick, warna agla cascade point (tab upar wale levels ke
+// timers neeche aate hain, phir se poochh lena).
+uint32_t timer_next_expiry(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
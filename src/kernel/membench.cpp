@@ -0,0 +1,233 @@
+#include "membench.h"
+#include "../drivers/hpet.h"
+#include "../drivers/serial.h"
+#include "../include/string.h"
+#include "fpu.h"
+#include "tsc.h"
+#include "vmalloc.h"
+
+// Purane src/lib/string.cpp routines, tulna ke liye jaise ke taise. GCC inhe
+// wapas memcpy/memset calls mein na badle, isliye loop patterns band.
+#define OLD_ROUTINE                                                            \
+  static __attribute__((noinline,                                             \
+                        optimize("no-tree-loop-distribute-patterns")))
+
+OLD_ROUTINE void *old_memcpy(void *dest, const void *src, int count) {
+  if (count >= 4 && ((uint32_t)dest & 3) == 0 && ((uint32_t)src & 3) == 0) {
+    uint32_t *d32 = (uint32_t *)dest;
+    const uint32_t *s32 = (const uint32_t *)src;
+    while (count >= 4) {
+      *d32++ = *s32++;
+      count -= 4;
+    }
+    dest = (void *)d32;
+    src = (const void *)s32;
+  }
+  char *dest8 = (char *)dest;
+  const char *src8 = (const char *)src;
+  while (count--)
+    *dest8++ = *src8++;
+  return dest;
+}
+
+OLD_ROUTINE void *old_memmove(void *dest, const void *src, int count) {
+  char *d = (char *)dest;
+  const char *s = (const char *)src;
+  if (d < s) {
+    while (count--)
+      *d++ = *s++;
+  } else {
+    char *lasts = (char *)s + (count - 1);
+    char *lastd = (char *)d + (count - 1);
+    while (count--)
+      *lastd-- = *lasts--;
+  }
+  return dest;
+}
+
+OLD_ROUTINE void *old_memset(void *dest, char val, int count) {
+  char *dest8 = (char *)dest;
+  while (count--)
+    *dest8++ = val;
+  return dest;
+}
+
+OLD_ROUTINE int old_memcmp(const void *s1, const void *s2, int n) {
+  const unsigned char *p1 = (const unsigned char *)s1;
+  const unsigned char *p2 = (const unsigned char *)s2;
+  while (n--) {
+    if (*p1 != *p2)
+      return *p1 - *p2;
+    p1++;
+    p2++;
+  }
+  return 0;
+}
+
+OLD_ROUTINE int old_strlen(const char *str) {
+  int len = 0;
+  while (str[len])
+    len++;
+  return len;
+}
+
+// memchr pehle tha hi nahi; seedha byte loop baseline hai
+OLD_ROUTINE void *old_memchr(const void *s, int c, int n) {
+  const uint8_t *p = (const uint8_t *)s;
+  while (n-- > 0) {
+    if (*p == (uint8_t)c)
+      return (void *)p;
+    p++;
+  }
+  return 0;
+}
+
+enum {
+  MB_MEMCPY,
+  MB_MEMMOVE,
+  MB_MEMSET,
+  MB_MEMCMP,
+  MB_STRLEN,
+  MB_MEMCHR,
+  MB_NR_ROUTINES
+};
+
+static const char *membench_names[MB_NR_ROUTINES] = {
+    "memcpy ", "memmove", "memset ", "memcmp ", "strlen ", "memchr "};
+
+static uint8_t *bench_src;
+static uint8_t *bench_dst;
+static volatile uint32_t bench_sink;
+
+// Ek routine, ek size, iters baar. use_old: purana version.
+static void membench_once(int routine, int use_old, uint32_t size,
+                          uint32_t iters) {
+  uint32_t sink = 0;
+  for (uint32_t i = 0; i < iters; i++) {
+    switch (routine) {
+    case MB_MEMCPY:
+      if (use_old)
+        old_memcpy(bench_dst, bench_src, size);
+      else
+        memcpy(bench_dst, bench_src, size);
+      break;
+    case MB_MEMMOVE:
+      // Overlapping, dest aage: dono versions ka backward path
+      if (use_old)
+        old_memmove(bench_dst + 8, bench_dst, size);
+      else
+        memmove(bench_dst + 8, bench_dst, size);
+      break;
+    case MB_MEMSET:
+      if (use_old)
+        old_memset(bench_dst, (char)i, size);
+      else
+        memset(bench_dst, (char)i, size);
+      break;
+    case MB_MEMCMP:
+      sink += use_old ? old_memcmp(bench_dst, bench_src, size)
+                      : memcmp(bench_dst, bench_src, size);
+      break;
+    case MB_STRLEN:
+      sink += use_old ? old_strlen((const char *)bench_src)
+                      : strlen((const char *)bench_src);
+      break;
+    case MB_MEMCHR:
+      sink += (uint32_t)(use_old ? old_memchr(bench_src, 0xFF, size)
+                                 : memchr(bench_src, 0xFF, size));
+      break;
+    }
+  }
+  bench_sink = sink;
+}
+
+// MB/s (HPET ho to), warna cycles per call
+static uint32_t membench_rate(uint32_t size, uint32_t iters, uint64_t cycles,
+                              uint64_t hpet_ticks) {
+  uint32_t period_fs = hpet_get_period_fs();
+  if (hpet_ticks && period_fs) {
+    uint64_t ns = (hpet_ticks * period_fs) / 1000000ULL;
+    if (!ns)
+      ns = 1;
+    return (uint32_t)(((uint64_t)size * iters * 1000ULL) / ns);
+  }
+  return iters ? (uint32_t)(cycles / iters) : 0;
+}
+
+static uint32_t membench_measure(int routine, int use_old, uint32_t size,
+                                 uint32_t iters) {
+  uint64_t h1 = hpet_read_counter();
+  uint64_t t1 = rdtsc();
+  membench_once(routine, use_old, size, iters);
+  uint64_t t2 = rdtsc();
+  uint64_t h2 = hpet_read_counter();
+  return membench_rate(size, iters, t2 - t1, h2 - h1);
+}
+
+static void membench_append(char *line, const char *s) { strcat(line, s); }
+
+static void membench_append_num(char *line, uint32_t v, int width) {
+  char num[12];
+  itoa((int)v, num, 10);
+  for (int pad = width - strlen(num); pad > 0; pad--)
+    membench_append(line, " ");
+  membench_append(line, num);
+}
+
+void string_benchmark() {
+  // memmove dest+8 tak likhta hai, strlen ko terminator chahiye
+  bench_src = (uint8_t *)vmalloc(MEMBENCH_MAX_SIZE + 64);
+  bench_dst = (uint8_t *)vmalloc(MEMBENCH_MAX_SIZE + 64);
+  if (!bench_src || !bench_dst) {
+    serial_log("MEM BENCH: Buffers nahi mile, skip.");
+    if (bench_src)
+      vfree(bench_src);
+    if (bench_dst)
+      vfree(bench_dst);
+    return;
+  }
+
+  serial_log("MEM BENCH: Old loops vs rep movsd / SSE2 non-temporal...");
+  serial_log(fpu_has_sse2() ? "  SSE2 non-temporal path: on (>= 256KB)"
+                            : "  SSE2 non-temporal path: off (no SSE2)");
+  serial_log(hpet_get_period_fs() ? "  Units: MB/s (old -> new)"
+                                  : "  Units: cycles/call (old -> new)");
+
+  for (uint32_t size = MEMBENCH_MIN_SIZE; size <= MEMBENCH_MAX_SIZE;
+       size <<= 2) {
+    uint32_t iters = MEMBENCH_BYTES / size;
+    if (!iters)
+      iters = 1;
+
+    // Dono buffers barabar (memcmp poora chale), 0xFF kahin nahi (memchr
+    // poora chale), size-1 pe terminator (strlen)
+    memset(bench_src, 'a', size + 64);
+    memcpy(bench_dst, bench_src, size + 64);
+    bench_src[size - 1] = 0;
+    bench_dst[size - 1] = 0;
+
+    for (int r = 0; r < MB_NR_ROUTINES; r++) {
+      if (r == MB_MEMCMP || r == MB_MEMMOVE || r == MB_MEMSET)
+        memcpy(bench_dst, bench_src, size + 64); // Pichhle writes mita do
+
+      uint32_t old_rate = membench_measure(r, 1, size, iters);
+      if (r == MB_MEMCMP || r == MB_MEMMOVE || r == MB_MEMSET)
+        memcpy(bench_dst, bench_src, size + 64);
+      uint32_t new_rate = membench_measure(r, 0, size, iters);
+
+      char line[96];
+      line[0] = 0;
+      membench_append(line, "  ");
+      membench_append(line, membench_names[r]);
+      membench_append_num(line, size, 8);
+      membench_append(line, "B:");
+      membench_append_num(line, old_rate, 8);
+      membench_append(line, " ->");
+      membench_append_num(line, new_rate, 8);
+      serial_log(line);
+    }
+  }
+
+  vfree(bench_src);
+  vfree(bench_dst);
+}
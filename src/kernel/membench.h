@@ -0,0 +1,14 @@
+#ifndef MEMBENCH_H
+#define MEMBENCH_H
+
+#include "../include/types.h"
+
+// Boot-time string/memory library benchmark: purane byte/word loops vs
+// naye rep movsd / SSE2 non-temporal routines, 16B se 4MB tak
+#define MEMBENCH_MIN_SIZE 16
+#define MEMBENCH_MAX_SIZE (4 * 1024 * 1024)
+#define MEMBENCH_BYTES (1024 * 1024) // Har size pe kam se kam itna data
+
+void string_benchmark();
+
+#endif
@@ -29,6 +29,13 @@ void *kmalloc(uint32_t size) {
   return placement_kmalloc(size, 0, 0);
 }
 
+// Buddy block ka memset skip - stacks, rings, bade I/O buffers ke liye
+void *kmalloc_nozero(uint32_t size) {
+  if (heap_ready)
+    return malloc_nozero(size);
+  return placement_kmalloc(size, 0, 0);
+}
+
 void *kmalloc_a(uint32_t size, int align, uint32_t *phys) {
   if (heap_ready)
     return kmalloc_real(size, align, phys);
@@ -9,6 +9,7 @@ extern "C" {
 
 void init_memory(uint32_t start_address);
 void *kmalloc(uint32_t size);
+void *kmalloc_nozero(uint32_t size); // Not zeroed (sizes > 2048)
 void *kmalloc_a(uint32_t size, int align, uint32_t *phys);
 void kmalloc_align_page();
 void set_heap_status(int status);
@@ -8,8 +8,10 @@
 #include "heap.h"
 #include "memory.h"
 #include "paging.h" // Correct local include
+#include "pmm.h"
 #include "process.h"
 #include "vm.h"
+#include "vma.h"
 
 extern "C" {
 
@@ -57,9 +59,20 @@ int sys_mprotect(void *addr, size_t len, int prot) {
 
   // Size ko page boundary pe round up karo
   size_t pages = (len + 0xFFF) / 0x1000;
+  if (start + pages * 0x1000 > KERNEL_VIRTUAL_BASE)
+    return -EINVAL;
+
+  // Pehle VMAs - fault handler inhi se prot padhta hai. Beech mein unmapped
+  // hole ho toh POSIX ke hisaab se ENOMEM.
+  if (vma_protect(&current_process->vmas, start, start + pages * 0x1000,
+                  prot & (PROT_READ | PROT_WRITE | PROT_EXEC)) != 0)
+    return -ENOMEM;
 
-  // PROT_* ko page flags mein convert karo
+  // PROT_* ko page flags mein convert karo. PROT_NONE page present rehta hai
+  // (frame na khoye) par USER bit hat jaata hai, toh user access fault karega.
   uint32_t flags = PTE_PRESENT;
+  if (prot & (PROT_READ | PROT_WRITE | PROT_EXEC))
+    flags |= PTE_USER;
   if (prot & PROT_WRITE)
     flags |= PTE_WRITE;
   if (!(prot & PROT_EXEC))
@@ -76,9 +89,16 @@ int sys_mprotect(void *addr, size_t len, int prot) {
       continue;
     }
 
-    // Preserve physical address, update flags
+    // Preserve physical address, update flags (SHARED/COW bits bhi rakho -
+    // read-only karne se COW page, jaise zero page, private nahi ho jaata)
     uint32_t phys = *pte & ~0xFFF;
-    *pte = phys | flags;
+    uint32_t page_flags = flags | (*pte & (PTE_SHARED | PTE_COW));
+    if ((page_flags & PTE_WRITE) && !(page_flags & PTE_SHARED) &&
+        ((*pte & PTE_COW) || pmm_frame_refs((void *)phys))) {
+      // Frame abhi fork ke saath shared hai - write pe copy banegi
+      page_flags = (page_flags & ~PTE_WRITE) | PTE_COW;
+    }
+    *pte = phys | page_flags;
   }
 
   // TLB flush karo kyunki protection badla hai
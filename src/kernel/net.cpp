@@ -6,6 +6,8 @@
 #include "../drivers/serial.h"
 #include "../include/string.h"
 #include "e1000.h"
+#include "ktimer.h"
+#include "wait_queue.h"
 
 // Our network identity
 // Our network identity
@@ -37,6 +39,33 @@ static u8 gateway_mac[6] = {0xFF, 0xFF, 0xFF,
 u32 gateway_ip = 0x0202000A;                   // 10.0.2.2
 volatile int gateway_mac_known = 0;
 
+// Gateway ARP entry aging: reply ke ARP_REACHABLE_MS baad dobara poochho,
+// ARP_MAX_PROBES jawab na aaye to MAC bhool jao (broadcast pe wapas).
+// Timer IRQ mein sirf flag - bhejna net_poll se (e1000_send reentrant nahi)
+#define ARP_REACHABLE_MS 60000
+#define ARP_RETRY_MS 5000
+#define ARP_MAX_PROBES 3
+static ktimer_t arp_timer;
+static volatile int arp_refresh_due = 0;
+static int arp_probes = 0;
+
+static void arp_timeout(ktimer_t *timer) {
+  (void)timer;
+  arp_refresh_due = 1;
+  net_kick();
+}
+
+extern "C" void tcp_timer_run(void);
+
+static wait_queue_t net_wait_queue = WAIT_QUEUE_INIT;
+
+extern "C" void net_kick(void) { wake_up_all(&net_wait_queue); }
+
+extern "C" void net_wait(uint32_t ms) {
+  uint32_t ticks = e1000_irq_enabled() ? msecs_to_ticks(ms) : 1;
+  sleep_on_timeout(&net_wait_queue, ticks);
+}
+
 // Byte order helpers
 static inline u16 htons(u16 x) { return (x << 8) | (x >> 8); }
 static inline u32 htonl(u32 x) {
@@ -133,6 +162,8 @@ void handle_arp(u8 *packet) {
         gateway_mac[i] = arp->sha[i];
       }
       gateway_mac_known = 1;
+      arp_probes = 0;
+      mod_timer_ms(&arp_timer, ARP_REACHABLE_MS);
       serial_log("ARP: Gateway MAC learned!");
       serial_log_hex("  MAC[0-1]: ", (gateway_mac[0] << 8) | gateway_mac[1]);
       serial_log_hex("  MAC[2-3]: ", (gateway_mac[2] << 8) | gateway_mac[3]);
@@ -405,6 +436,18 @@ extern "C" void net_poll(void) {
       last_cleanup = now;
   }
 
+  if (arp_refresh_due) {
+    arp_refresh_due = 0;
+    if (++arp_probes > ARP_MAX_PROBES && gateway_mac_known) {
+      gateway_mac_known = 0;
+      serial_log("ARP: Gateway entry expired");
+    }
+    send_arp_request(gateway_ip);
+    mod_timer_ms(&arp_timer, ARP_RETRY_MS);
+  }
+
+  tcp_timer_run();
+
   u8 buf[2048];
   int processed = 0;
   while (processed < 32) { // Process up to 32 packets in a burst
@@ -413,12 +456,18 @@ extern "C" void net_poll(void) {
       net_rx_handler(buf, len);
       processed++;
   }
+
+  // Protocol state badli ho sakti hai - jo uska intezaar kar rahe the unhe
+  // jagao
+  if (processed)
+    net_kick();
 }
 
 // ============== Initialization ==============
 
 extern "C" void net_init(void) {
   serial_log("NET: Network Stack Initialized");
+  timer_setup(&arp_timer, arp_timeout, nullptr);
 
   // Send ARP request for gateway to learn its MAC
   // This is CRITICAL - without gateway MAC, routing won't work
@@ -73,4 +73,12 @@ struct dns_hdr {
 extern "C" void net_poll();
 extern "C" void net_init();
 
+// Net stack ke event ka intezaar: packet aaya (e1000 IRQ), kisi net_poll ne
+// packets process kiye, ya net timer baja - ya ms guzar gaye. Polling loops
+// "net_poll(); schedule();" ki jagah isse block karte hain. RX IRQ na ho to
+// har tick jaagta hai.
+#define NET_WAIT_MS 100
+extern "C" void net_wait(uint32_t ms);
+extern "C" void net_kick(void); // Saare waiters jagao (IRQ se bhi)
+
 #endif
@@ -17,20 +17,29 @@ extern "C" uint32_t _rodata_start;
 extern "C" uint32_t _rodata_end;
 
 #include "shm.h"
+#include "syscall.h"
 #include "vm.h"
-
-// Circular include se bachne ke liye jugad
-typedef struct process process_t;
-extern process_t *current_process;
+#include "vma.h"
+#include "vmalloc.h"
 
 void page_fault_handler(registers_t *regs);
-bool handle_demand_paging(uint32_t faulting_address);
 
 void page_fault_handler(registers_t *regs) {
   uint32_t faulting_address;
   asm volatile("mov %%cr2, %0" : "=r"(faulting_address));
 
-  if (handle_demand_paging(faulting_address)) {
+  // Present page pe write (P=1, W=1): fork ke baad ka COW page ya zero page.
+  // VMA read-only ho toh COW nahi todna (PE images ke VMA nahi hote).
+  if ((regs->err_code & 3) == 3) {
+    vma_t *vma = current_process
+                     ? vma_find(&current_process->vmas, faulting_address)
+                     : 0;
+    if ((!vma || (vma->prot & VMA_WRITE)) &&
+        vm_handle_cow_fault(faulting_address))
+      return;
+  }
+
+  if (handle_demand_paging(faulting_address, regs->err_code)) {
     return; // Galti sudhar li!
   }
 
@@ -46,12 +55,30 @@ void page_fault_handler(registers_t *regs) {
     return;
   }
 
+  // Syscall ne user ka kharab pointer chhua - kernel nahi, process ki galti.
+  // Yahan exit_process nahi (fault ke andar, locks pakde ho sakte hain):
+  // SIGSEGV pending karo aur syscall_handler ke recovery point pe lauto,
+  // syscall -EFAULT deta hai aur signal return path pe deliver hota hai.
+  // Entry ke baad koi spinlock pakda ho to unwind unhe latka deta - panic.
+  syscall_fixup_t *fixup = current_process ? current_process->syscall_fixup : 0;
+  if (faulting_address < KERNEL_VIRTUAL_BASE && fixup) {
+    if (preempt_count() == fixup->preempt_count) {
+      serial_log("PAGE FAULT: Bad user pointer in syscall, -EFAULT.");
+      sys_kill(current_process->id, SIGSEGV);
+      regs->eip = (uint32_t)syscall_fault_unwind;
+      return;
+    }
+    serial_log("PAGE FAULT: Bad user pointer under a spinlock.");
+  }
+
   serial_log("KERNEL PANIC: Page Fault ho gaya");
   for (;;)
     ;
 }
 
-bool handle_demand_paging(uint32_t addr) {
+// Fault ko process ke VMAs se sulajhao. Kisi area ke bahar ka address (wild
+// pointer) ya prot ke khilaaf access -> false (SIGSEGV).
+bool handle_demand_paging(uint32_t addr, uint32_t err_code) {
   // Check if page is already mapped
   uint32_t *pte = paging_get_pte(addr);
   if (pte && (*pte & 1)) {
@@ -60,59 +87,50 @@ bool handle_demand_paging(uint32_t addr) {
     return false;
   }
 
-  // 0. Kernel Heap Demand Paging (0xC0000000+)
-  // Only for addresses OUTSIDE the pre-mapped 512MB region
-  if (addr >= 0xE0000000) { // > 512MB virtual = beyond pre-mapped region
-    uint32_t page_base = addr & 0xFFFFF000;
-    uint32_t phys = (uint32_t)pmm_alloc_block();
-    if (!phys)
-      return false;                  // OOM
-    vm_map_page(phys, page_base, 3); // Supervisor | RW | Present
-    return true;
+  // 0. 512MB direct map ke upar sirf vmalloc areas hain, jo poore mapped
+  // aate hain. Yahan fault = guard page / overflow / wild pointer.
+  if (addr >= 0xE0000000) {
+    if (is_vmalloc_addr((void *)addr))
+      serial_log_hex("PAGE FAULT: vmalloc guard page / free area: ", addr);
+    return false;
   }
 
   if (!current_process)
     return false;
 
-  // 1. SHM Range check karo (0x70000000 se 0x80000000 tak)
-  if (addr >= 0x70000000 && addr < 0x80000000) {
-    shm_segment_t *seg = shm_get_segment(addr);
-    if (seg) {
-      uint32_t page_base = addr & 0xFFFFF000;
-      uint32_t phys_base =
-          (uint32_t)(uintptr_t)seg->phys_addr + (page_base - seg->virt_start);
-
-      serial_log_hex("DEMAND: Mapping SHM at ", addr);
-      vm_map_page(phys_base, page_base, 7); // User|RW|Present
-      return true;
-    } else {
-      serial_log_hex("DEMAND FAIL: SHM Segment not found for ", addr);
-    }
-  }
+  vma_t *vma = vma_find(&current_process->vmas, addr);
+  if (!vma)
+    return false;
+  if ((err_code & 2) && !(vma->prot & VMA_WRITE))
+    return false;
+  if (!vma->prot)
+    return false; // PROT_NONE
 
-  // 2. User Heap check karo (0x40000000 se heap_end tak). Thoda grace (2MB)
-  // diya hai.
-  // Warning: This logic effectively maps ANY user address as heap currently.
-  // Ideally should restrict to current_process->heap_end
-  if (addr >= 0x00400000 &&
-      addr < 0x70000000) { // Restricting slightly to avoid conflicts
-    uint32_t page_base = addr & 0xFFFFF000;
-    uint32_t phys = (uint32_t)pmm_alloc_block();
-    serial_log_hex("DEMAND: Mapping USER HEAP at ", addr);
-    vm_map_page(phys, page_base, 7);
-    return true;
-  }
+  uint32_t page_base = addr & 0xFFFFF000;
+  uint32_t flags = PTE_PRESENT | PTE_USER;
+  if (vma->prot & VMA_WRITE)
+    flags |= PTE_RW;
 
-  // 3. User Stack check karo (0xB0000000 ke paas)
-  if (addr >= 0xAF000000 && addr <= 0xB0000000) {
-    uint32_t page_base = addr & 0xFFFFF000;
-    uint32_t phys = (uint32_t)pmm_alloc_block();
-    serial_log_hex("DEMAND: Mapping STACK at ", addr);
-    vm_map_page(phys, page_base, 7);
+  switch (vma->backing) {
+  case VMA_SHM: {
+    shm_segment_t *seg = shm_get_segment(addr);
+    if (!seg)
+      return false;
+    uint32_t phys_base =
+        (uint32_t)(uintptr_t)seg->phys_addr + (page_base - seg->virt_start);
+    pmm_ref_frame((void *)(uintptr_t)phys_base);
+    vm_map_page(phys_base, page_base, flags | PTE_SHARED);
     return true;
   }
 
-  return false;
+  case VMA_FILE:
+    // Executable ke segments (file-backed, pehle touch pe file se padho)
+    return elf_handle_fault(&current_process->image, addr, flags);
+
+  default:
+    // Anonymous (mmap / heap / stack): read pe zero page, write pe naya frame
+    return vm_map_anon_page(addr, flags, err_code & 2);
+  }
 }
 
 void paging_map(uint32_t phys, uint32_t virt, uint32_t flags) {
@@ -176,6 +194,9 @@ void init_paging() {
 
   switch_page_directory(kernel_directory);
   serial_log("PAGING: Higher-Half & Identity Enabled.");
+
+  vmalloc_init();
+  vm_init_zero_page();
 }
 
 void switch_page_directory(uint32_t *dir) {
@@ -193,10 +214,13 @@ uint32_t *paging_get_pte(uint32_t virt) {
   uint32_t pd_index = virt >> 22;
   uint32_t pt_index = (virt >> 12) & 0x03FF;
 
-  // Kaunsa directory use karna hai dekho
-  uint32_t *dir = current_directory ? current_directory : kernel_directory;
-  if (!dir)
+  // Jo directory abhi CR3 mein hai wahi dekho (process switch sirf CR3 badalta
+  // hai, current_directory nahi)
+  if (!kernel_directory)
     return 0;
+  uint32_t cr3;
+  asm volatile("mov %%cr3, %0" : "=r"(cr3));
+  uint32_t *dir = (uint32_t *)PHYS_TO_VIRT(cr3 & 0xFFFFF000);
 
   // Check karo page table hai ya nahi
   if (!(dir[pd_index] & 1))
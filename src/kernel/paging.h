@@ -20,6 +20,9 @@ extern uint32_t *current_directory;
 #define PTE_RW 0x2
 #define PTE_USER 0x4
 #define PTE_WRITE PTE_RW
+// OS-available bits (9-11), CPU inhe ignore karta hai
+#define PTE_COW 0x200    // Read-only, pehle write pe private copy banegi
+#define PTE_SHARED 0x400 // SHM page: fork pe share, kabhi COW nahi
 #define PTE_NX                                                                 \
   0x80000000 // Only valid if EFER.NXE is enabled, harmless if ignored in 32-bit
              // without PAE usually?
@@ -33,4 +36,9 @@ extern uint32_t *current_directory;
 
 uint32_t *paging_get_pte(uint32_t virt);
 
+// Current process ke VMAs se page laao (fault ke bina bhi - sysenter pehle se
+// bula leta hai). err_code page fault jaisa; false = address kisi area mein
+// nahi ya prot ke khilaaf.
+bool handle_demand_paging(uint32_t addr, uint32_t err_code);
+
 #endif
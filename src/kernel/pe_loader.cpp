@@ -7,6 +7,7 @@
 #include "memory.h"
 #include "pmm.h"
 #include "vm.h"
+#include "vmalloc.h"
 
 // --- WinAPI Bridge Functions ---
 // These are target addresses for the IAT thunks
@@ -42,7 +43,8 @@ static uint32_t resolve_import(const char *dll, const char *func) {
   return 0;
 }
 
-uint32_t load_pe(const char *filename, uint32_t *top_address) {
+uint32_t load_pe(const char *filename, uint32_t *top_address,
+                 uint32_t *pd_phys) {
   serial_log("PE: Loading file via VFS...");
   serial_log(filename);
 
@@ -52,20 +54,23 @@ uint32_t load_pe(const char *filename, uint32_t *top_address) {
     return 0;
   }
 
-  uint8_t *buffer = (uint8_t *)kmalloc(node->size);
+  // Poori file - contiguous block ki zaroorat nahi, vmalloc
+  uint8_t *buffer = (uint8_t *)vmalloc(node->size);
+  if (!buffer)
+    return 0;
   vfs_read(node, 0, buffer, node->size);
 
   IMAGE_DOS_HEADER *dos_hdr = (IMAGE_DOS_HEADER *)buffer;
   if (dos_hdr->magic != MZ_MAGIC) {
     serial_log("PE ERROR: Invalid MZ Magic.");
-    kfree(buffer);
+    vfree(buffer);
     return 0;
   }
 
   IMAGE_NT_HEADERS32 *nt_hdr = (IMAGE_NT_HEADERS32 *)(buffer + dos_hdr->lfanew);
   if (nt_hdr->Signature != PE_MAGIC) {
     serial_log("PE ERROR: Invalid PE Signature.");
-    kfree(buffer);
+    vfree(buffer);
     return 0;
   }
 
@@ -99,26 +104,26 @@ uint32_t load_pe(const char *filename, uint32_t *top_address) {
     uint32_t end_page = (start_addr + mem_size + 0xFFF) & 0xFFFFF000;
 
     for (uint32_t page = start_page; page < end_page; page += 4096) {
-      if (vm_get_phys(page) == 0) {
+      if (vm_get_phys_pd(pd_phys, page) == 0) {
         void *phys = pmm_alloc_block();
         if (!phys) {
           serial_log("PE ERROR: Memory allocation failed.");
-          kfree(buffer);
+          vfree(buffer);
           return 0;
         }
-        vm_map_page((uint32_t)phys, page, 7); // User/Read/Write
+        vm_map_page_pd(pd_phys, (uint32_t)phys, page, 7); // User/Read/Write
       }
     }
 
-    // Copy raw data from file
+    // Copy raw data from file (target PD may not be the one in CR3)
     if (file_size > 0) {
-      memcpy((void *)start_addr, buffer + section[i].PointerToRawData,
-             file_size);
+      vm_copy_to_pd(pd_phys, start_addr, buffer + section[i].PointerToRawData,
+                    file_size);
     }
 
     // Zero remaining memory for the section (BSS alike)
     if (mem_size > file_size) {
-      memset((void *)(start_addr + file_size), 0, mem_size - file_size);
+      vm_copy_to_pd(pd_phys, start_addr + file_size, 0, mem_size - file_size);
     }
   }
 
@@ -147,7 +152,8 @@ uint32_t load_pe(const char *filename, uint32_t *top_address) {
           const char *func_name = (const char *)(buffer + (*orig_thunk) + 2);
           uint32_t addr = resolve_import(dll_name, func_name);
           if (addr != 0) {
-            *thunk = addr; // Replace IAT entry with our bridge
+            // Replace IAT entry with our bridge
+            vm_copy_to_pd(pd_phys, (uint32_t)thunk, &addr, sizeof(addr));
           } else {
             serial_log("PE WARNING: Unresolved import: ");
             serial_log(func_name);
@@ -164,6 +170,6 @@ uint32_t load_pe(const char *filename, uint32_t *top_address) {
     *top_address = (max_addr + 0xFFF) & 0xFFFFF000;
   }
 
-  kfree(buffer);
+  vfree(buffer);
   return entry_point;
 }
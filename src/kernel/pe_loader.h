@@ -3,6 +3,9 @@
 
 #include <stdint.h>
 
-uint32_t load_pe(const char *filename, uint32_t *top_address);
+// Sections are mapped and filled in the given page directory (physical
+// address) - it does not have to be the one in CR3
+uint32_t load_pe(const char *filename, uint32_t *top_address,
+                 uint32_t *pd_phys);
 
 #endif
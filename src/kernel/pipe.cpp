@@ -1,8 +1,10 @@
 #include "pipe.h"
 #include "../drivers/serial.h"
+#include "../include/poll.h"
 #include "../include/string.h"
 #include "heap.h"
 #include "memory.h"
+#include "slab.h"
 #include "process.h"
 
 void pipe_init() {
@@ -27,8 +29,8 @@ uint32_t pipe_read(vfs_node_t *node, uint32_t offset, uint32_t size,
         break; // Jitna mila utna leke khush raho
 
       // Ruko zara, sabar karo (Data ka wait)
-      current_process->state = PROCESS_WAITING;
-      schedule();
+      wait_event(&pipe->read_wait,
+                 pipe->head != pipe->tail || pipe->write_closed);
       continue;
     }
 
@@ -36,16 +38,9 @@ uint32_t pipe_read(vfs_node_t *node, uint32_t offset, uint32_t size,
     pipe->head = (pipe->head + 1) % PIPE_SIZE;
   }
 
-  // Jo wait kar rahe hain unhe jagao (shayad koi likhne wala ho)
-  process_t *p = ready_queue;
-  if (p) {
-    process_t *start = p;
-    do {
-      if (p->state == PROCESS_WAITING)
-        p->state = PROCESS_READY;
-      p = p->next;
-    } while (p && p != start);
-  }
+  // Jagah bani - sirf isi pipe ke likhne wale jagao
+  if (read_bytes > 0)
+    wake_up(&pipe->write_wait);
 
   return read_bytes;
 }
@@ -65,8 +60,11 @@ uint32_t pipe_write(vfs_node_t *node, uint32_t offset, uint32_t size,
         break; // Jitna likha gaya utna kaafi hai abhi ke liye
 
       // Jagah nahi hai, thoda ruko
-      current_process->state = PROCESS_WAITING;
-      schedule();
+      wait_event(&pipe->write_wait,
+                 (pipe->tail + 1) % PIPE_SIZE != pipe->head ||
+                     pipe->read_closed);
+      if (pipe->read_closed)
+        break;
       continue;
     }
 
@@ -75,19 +73,34 @@ uint32_t pipe_write(vfs_node_t *node, uint32_t offset, uint32_t size,
   }
 
   // Padhne walon ko jagao, maal aa gaya hai
-  process_t *p = ready_queue;
-  if (p) {
-    process_t *start = p;
-    do {
-      if (p->state == PROCESS_WAITING)
-        p->state = PROCESS_READY;
-      p = p->next;
-    } while (p && p != start);
-  }
+  if (written_bytes > 0)
+    wake_up(&pipe->read_wait);
 
   return written_bytes;
 }
 
+int pipe_poll(vfs_node_t *node, wait_queue_t **wq) {
+  pipe_t *pipe = (pipe_t *)node->impl;
+  if (!pipe)
+    return POLLNVAL;
+
+  int revents = 0;
+  if (node->read == pipe_read) {
+    if (pipe->head != pipe->tail)
+      revents |= POLLIN;
+    if (pipe->write_closed)
+      revents |= POLLHUP; // read 0 (EOF) turant
+    *wq = &pipe->read_wait;
+  } else {
+    if ((pipe->tail + 1) % PIPE_SIZE != pipe->head)
+      revents |= POLLOUT;
+    if (pipe->read_closed)
+      revents |= POLLERR; // write 0 turant
+    *wq = &pipe->write_wait;
+  }
+  return revents;
+}
+
 void pipe_close(vfs_node_t *node) {
   pipe_t *pipe = (pipe_t *)node->impl;
   if (!pipe)
@@ -98,21 +111,14 @@ void pipe_close(vfs_node_t *node) {
   if (node->flags & 0x2)
     pipe->write_closed = 1;
 
+  // Doosri taraf wale ko batao ki dukaan band ho gayi (EOF / EPIPE)
+  wake_up_all(&pipe->read_wait);
+  wake_up_all(&pipe->write_wait);
+
   if (pipe->read_closed && pipe->write_closed) {
     kfree(pipe->buffer);
     kfree(pipe);
   }
-
-  // Baakiyo ko batao ki dukaan band ho rahi hai ya khul rahi hai
-  process_t *p = ready_queue;
-  if (p) {
-    process_t *start = p;
-    do {
-      if (p->state == PROCESS_WAITING)
-        p->state = PROCESS_READY;
-      p = p->next;
-    } while (p && p != start);
-  }
 }
 
 int sys_pipe(uint32_t *filedes) {
@@ -126,7 +132,7 @@ int sys_pipe(uint32_t *filedes) {
   if (!pipe)
     return -1;
 
-  pipe->buffer = (uint8_t *)kmalloc(PIPE_SIZE);
+  pipe->buffer = (uint8_t *)kmalloc_nozero(PIPE_SIZE);
   if (!pipe->buffer) {
     kfree(pipe);
     return -1;
@@ -136,9 +142,11 @@ int sys_pipe(uint32_t *filedes) {
   pipe->tail = 0;
   pipe->read_closed = 0;
   pipe->write_closed = 0;
+  wait_queue_init(&pipe->read_wait);
+  wait_queue_init(&pipe->write_wait);
 
   // Read end ke liye VFS node banao
-  vfs_node_t *read_node = (vfs_node_t *)kmalloc(sizeof(vfs_node_t));
+  vfs_node_t *read_node = (vfs_node_t *)kmem_cache_alloc(vfs_node_cache);
   memset(read_node, 0, sizeof(vfs_node_t));
   strcpy(read_node->name, "pipe_read");
   read_node->impl = (void *)pipe;
@@ -148,7 +156,7 @@ int sys_pipe(uint32_t *filedes) {
   read_node->ref_count = 1;
 
   // Write end ke liye VFS node banao
-  vfs_node_t *write_node = (vfs_node_t *)kmalloc(sizeof(vfs_node_t));
+  vfs_node_t *write_node = (vfs_node_t *)kmem_cache_alloc(vfs_node_cache);
   memset(write_node, 0, sizeof(vfs_node_t));
   strcpy(write_node->name, "pipe_write");
   write_node->impl = (void *)pipe;
@@ -179,14 +187,14 @@ int sys_pipe(uint32_t *filedes) {
   }
 
   file_description_t *desc1 =
-      (file_description_t *)kmalloc(sizeof(file_description_t));
+      (file_description_t *)kmem_cache_alloc(file_desc_cache);
   desc1->node = read_node;
   desc1->offset = 0;
   desc1->flags = 0; // O_RDONLY
   desc1->ref_count = 1;
 
   file_description_t *desc2 =
-      (file_description_t *)kmalloc(sizeof(file_description_t));
+      (file_description_t *)kmem_cache_alloc(file_desc_cache);
   desc2->node = write_node;
   desc2->offset = 0;
   desc2->flags = 1; // O_WRONLY
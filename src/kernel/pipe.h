@@ -3,6 +3,7 @@
 
 #include "../include/types.h"
 #include "../include/vfs.h"
+#include "wait_queue.h"
 
 #define PIPE_SIZE 4096
 
@@ -13,7 +14,8 @@ typedef struct {
   uint32_t size;
   uint8_t read_closed;
   uint8_t write_closed;
-  // We'll add wait queues here later if needed for advanced blocking
+  wait_queue_t read_wait;  // Khaali pipe pe padhne wale
+  wait_queue_t write_wait; // Bhari pipe pe likhne wale
 } pipe_t;
 
 #ifdef __cplusplus
@@ -30,6 +32,10 @@ uint32_t pipe_write(vfs_node_t *node, uint32_t offset, uint32_t size,
                     uint8_t *buffer);
 void pipe_close(vfs_node_t *node);
 
+// Kaunse POLL* events abhi taiyaar (read end: POLLIN/POLLHUP, write end:
+// POLLOUT/POLLERR). wq = jis queue pe intezaar karna ho.
+int pipe_poll(vfs_node_t *node, wait_queue_t **wq);
+
 #ifdef __cplusplus
 }
 #endif
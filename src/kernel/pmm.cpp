@@ -1,23 +1,89 @@
 #include "pmm.h"
+#include "../drivers/hpet.h"
 #include "../drivers/serial.h"
 #include "../include/string.h"
+#include "spinlock.h"
+#include "tsc.h"
 
 // Ek uint32_t mein 32 blocks fit hote hain
 #define BLOCKS_PER_UINT32 32
 
+// 4GB / 4KB = 1M frames -> 32K bitmap words -> 1K summary words
+#define PMM_MAX_BITMAP_WORDS (0x100000 / BLOCKS_PER_UINT32)
+#define PMM_SUMMARY_WORDS (PMM_MAX_BITMAP_WORDS / BLOCKS_PER_UINT32)
+
+#define PMM_NO_FRAME 0xFFFFFFFF
+#define PMM_FRAME_FREE_HEAD 0x01 // Frame ek free buddy block ka head hai
+#define PMM_FRAME_PINNED 0x02    // Kabhi free nahi hota (shared zero page)
+
+// Har physical frame ka metadata (bitmap ke theek baad rakha hai)
+typedef struct pmm_frame {
+  uint32_t next;  // Free list mein agla head (frame index)
+  uint32_t prev;  // Free list mein pichla head
+  uint8_t order;  // Buddy order (sirf free head ke liye valid)
+  uint8_t flags;  // PMM_FRAME_*
+  uint16_t refs;  // Extra sharers (COW / SHM); 0 = akela owner
+} pmm_frame_t;
+
+// Zone: buddy free lists + summary bitmap ka apna hissa
+typedef struct pmm_zone {
+  const char *name;
+  uint32_t start_frame;
+  uint32_t end_frame;
+  uint32_t free_head[PMM_MAX_ORDER + 1];
+  uint32_t nr_free[PMM_MAX_ORDER + 1];
+  uint32_t free_frames;
+  uint32_t summary_start; // Is zone ke summary words [start, end)
+  uint32_t summary_end;
+  uint32_t summary_hint; // Isse neeche ke saare summary words full hain
+} pmm_zone_t;
+
 static uint32_t *pmm_bitmap = 0;
 static uint32_t pmm_mem_size = 0;
 static uint32_t pmm_max_blocks = 0;
 static uint32_t pmm_used_blocks = 0;
 
+static pmm_frame_t *pmm_frames = 0;
+static uint32_t pmm_metadata_size = 0;
+static pmm_zone_t pmm_zones[PMM_NUM_ZONES];
+// Boot page tables sirf neeche ki memory map karti hain, isliye init_paging
+// tak DMA zone pehle; uske baad Normal zone pehle (DMA ko bacha ke rakho)
+static int pmm_zone_order[PMM_NUM_ZONES] = {PMM_ZONE_DMA, PMM_ZONE_NORMAL};
+
+// Summary bitmap: har bit ek pmm_bitmap word ko represent karta hai.
+// Bit set = woh word poora bhara hua hai (0xFFFFFFFF), usme free frame nahi.
+static uint32_t pmm_summary[PMM_SUMMARY_WORDS];
+static uint32_t pmm_bitmap_words = 0;
+static uint32_t pmm_summary_words = 0;
+
+// Bitmap, buddy lists, frame refs - sab ek lock. Sabse andar wala lock hai
+// (heap, vmalloc, page fault isse lete hain), andar se kuch aur nahi leta.
+static DEFINE_SPINLOCK(pmm_lock, "pmm");
+
+static inline pmm_zone_t *zone_of_frame(uint32_t frame) {
+  return frame < pmm_zones[PMM_ZONE_NORMAL].start_frame
+             ? &pmm_zones[PMM_ZONE_DMA]
+             : &pmm_zones[PMM_ZONE_NORMAL];
+}
+
 // Bitmap mein bit set karo (Used mark karo)
 static inline void mmap_set(int bit) {
-  pmm_bitmap[bit / 32] |= (1 << (bit % 32));
+  uint32_t word = bit / 32;
+  pmm_bitmap[word] |= (1 << (bit % 32));
+  if (pmm_bitmap[word] == 0xFFFFFFFF && word < pmm_bitmap_words)
+    pmm_summary[word / 32] |= (1u << (word % 32));
 }
 
 // Bitmap mein bit unset karo (Free mark karo)
 static inline void mmap_unset(int bit) {
-  pmm_bitmap[bit / 32] &= ~(1 << (bit % 32));
+  uint32_t word = bit / 32;
+  pmm_bitmap[word] &= ~(1 << (bit % 32));
+  if (word < pmm_bitmap_words) {
+    pmm_summary[word / 32] &= ~(1u << (word % 32));
+    pmm_zone_t *z = zone_of_frame(bit);
+    if (word / 32 < z->summary_hint)
+      z->summary_hint = word / 32;
+  }
 }
 
 // Check karo ki bit set hai ya nahi
@@ -25,9 +91,23 @@ static inline int mmap_test(int bit) {
   return pmm_bitmap[bit / 32] & (1 << (bit % 32));
 }
 
-// Pehla free block dhundo jiska bit 0 ho
+// Zone ka pehla free block dhundo jiska bit 0 ho
+// Summary word se seedha khali bitmap word milta hai, phir usme khali bit.
 // Agar sab full hai toh -1 wapas karo
-static int mmap_first_free() {
+static int mmap_first_free(pmm_zone_t *z) {
+  for (uint32_t s = z->summary_hint; s < z->summary_end; s++) {
+    if (pmm_summary[s] != 0xFFFFFFFF) {
+      uint32_t word = s * 32 + __builtin_ctz(~pmm_summary[s]);
+      z->summary_hint = s;
+      return word * 32 + __builtin_ctz(~pmm_bitmap[word]);
+    }
+  }
+  z->summary_hint = z->summary_end;
+  return -1;
+}
+
+// Purana linear scan - sirf pmm_benchmark() mein comparison ke liye
+static int mmap_first_free_linear() {
   for (uint32_t i = 0; i < pmm_max_blocks / 32; i++) {
     if (pmm_bitmap[i] != 0xFFFFFFFF) {
       for (int j = 0; j < 32; j++) {
@@ -40,6 +120,183 @@ static int mmap_first_free() {
   return -1;
 }
 
+// Zone ke andar bitmap pe free run dhundo (order > PMM_MAX_ORDER ke liye, aur
+// benchmark mein purane path ke liye)
+static int mmap_find_run(uint32_t start, uint32_t end, uint32_t count) {
+  uint32_t consecutive = 0;
+  int start_frame = -1;
+
+  for (uint32_t i = start; i < end; i++) {
+    if (!mmap_test(i)) {
+      if (consecutive == 0)
+        start_frame = i;
+      consecutive++;
+      if (consecutive == count)
+        return start_frame;
+    } else {
+      consecutive = 0;
+      start_frame = -1;
+    }
+  }
+  return -1;
+}
+
+// ============================================================================
+// Buddy free lists (frame indices, doubly linked -> O(1) remove)
+// ============================================================================
+
+static void buddy_list_insert(pmm_zone_t *z, uint32_t frame, uint32_t order) {
+  pmm_frame_t *f = &pmm_frames[frame];
+  f->order = order;
+  f->flags |= PMM_FRAME_FREE_HEAD;
+  f->prev = PMM_NO_FRAME;
+  f->next = z->free_head[order];
+  if (f->next != PMM_NO_FRAME)
+    pmm_frames[f->next].prev = frame;
+  z->free_head[order] = frame;
+  z->nr_free[order]++;
+  z->free_frames += 1u << order;
+}
+
+static void buddy_list_remove(pmm_zone_t *z, uint32_t frame, uint32_t order) {
+  pmm_frame_t *f = &pmm_frames[frame];
+  if (f->prev != PMM_NO_FRAME)
+    pmm_frames[f->prev].next = f->next;
+  else
+    z->free_head[order] = f->next;
+  if (f->next != PMM_NO_FRAME)
+    pmm_frames[f->next].prev = f->prev;
+  f->flags &= ~PMM_FRAME_FREE_HEAD;
+  z->nr_free[order]--;
+  z->free_frames -= 1u << order;
+}
+
+// 2^order frames ka aligned block wapas do, buddies ke saath jodte hue
+static void buddy_free_block(uint32_t frame, uint32_t order) {
+  pmm_zone_t *z = zone_of_frame(frame);
+  while (order < PMM_MAX_ORDER) {
+    uint32_t buddy = frame ^ (1u << order);
+    if (buddy < z->start_frame || buddy + (1u << order) > z->end_frame)
+      break;
+    pmm_frame_t *b = &pmm_frames[buddy];
+    if (!(b->flags & PMM_FRAME_FREE_HEAD) || b->order != order)
+      break;
+    buddy_list_remove(z, buddy, order);
+    frame &= ~(1u << order);
+    order++;
+  }
+  buddy_list_insert(z, frame, order);
+}
+
+// [start, start+count) ko sabse bade aligned blocks mein tod ke free karo
+static void buddy_give_range(uint32_t start, uint32_t count) {
+  while (count) {
+    uint32_t order = 0;
+    while (order < PMM_MAX_ORDER && !(start & ((2u << order) - 1)) &&
+           (2u << order) <= count)
+      order++;
+    buddy_free_block(start, order);
+    start += 1u << order;
+    count -= 1u << order;
+  }
+}
+
+// Ek free frame ko uske buddy block se nikaalo (block ko split karte hue)
+static void buddy_take_frame(uint32_t frame) {
+  pmm_zone_t *z = zone_of_frame(frame);
+  for (uint32_t order = 0; order <= PMM_MAX_ORDER; order++) {
+    uint32_t head = frame & ~((1u << order) - 1);
+    pmm_frame_t *h = &pmm_frames[head];
+    if (!(h->flags & PMM_FRAME_FREE_HEAD) || h->order != order)
+      continue;
+
+    buddy_list_remove(z, head, order);
+    while (order > 0) {
+      order--;
+      uint32_t half = 1u << order;
+      if (frame >= head + half) {
+        buddy_list_insert(z, head, order);
+        head += half;
+      } else {
+        buddy_list_insert(z, head + half, order);
+      }
+    }
+    return;
+  }
+  serial_log_hex("PMM: Frame kisi buddy block mein nahi mila! ", frame);
+}
+
+static uint32_t order_for_count(uint32_t count) {
+  uint32_t order = 0;
+  while ((1u << order) < count)
+    order++;
+  return order;
+}
+
+// Zone se count frames (physically contiguous) nikaalo, log time mein
+static int zone_alloc_run(pmm_zone_t *z, uint32_t count) {
+  if (z->free_frames < count)
+    return -1;
+
+  uint32_t order = order_for_count(count);
+  if (order > PMM_MAX_ORDER) {
+    // Buddy se bada run - bitmap scan hi sahara hai
+    int start = mmap_find_run(z->start_frame, z->end_frame, count);
+    if (start == -1)
+      return -1;
+    for (uint32_t k = 0; k < count; k++) {
+      buddy_take_frame(start + k);
+      mmap_set(start + k);
+    }
+    pmm_used_blocks += count;
+    return start;
+  }
+
+  for (uint32_t o = order; o <= PMM_MAX_ORDER; o++) {
+    uint32_t frame = z->free_head[o];
+    if (frame == PMM_NO_FRAME)
+      continue;
+
+    buddy_list_remove(z, frame, o);
+    while (o > order) {
+      o--;
+      buddy_list_insert(z, frame + (1u << o), o); // Upar wala aadha free
+    }
+
+    for (uint32_t k = 0; k < count; k++)
+      mmap_set(frame + k);
+    pmm_used_blocks += count;
+
+    // Power-of-two se bacha hua tail wapas kar do
+    uint32_t block = 1u << order;
+    if (block > count)
+      buddy_give_range(frame + count, block - count);
+    return frame;
+  }
+  return -1;
+}
+
+static void zone_setup(int idx, const char *name, uint32_t start,
+                       uint32_t end) {
+  pmm_zone_t *z = &pmm_zones[idx];
+  z->name = name;
+  z->start_frame = start;
+  z->end_frame = end;
+  for (int o = 0; o <= PMM_MAX_ORDER; o++) {
+    z->free_head[o] = PMM_NO_FRAME;
+    z->nr_free[o] = 0;
+  }
+  z->free_frames = 0;
+  z->summary_start = (start / 32 + 31) / 32;
+  z->summary_end = end / 32 / 32;
+  if (end >= pmm_max_blocks)
+    z->summary_end = pmm_summary_words;
+  z->summary_hint = z->summary_start;
+
+  if (end > start)
+    buddy_give_range(start, end - start);
+}
+
 void pmm_init(uint32_t mem_size, uint32_t *bitmap) {
   pmm_mem_size = mem_size;
   pmm_bitmap = bitmap;
@@ -52,28 +309,65 @@ void pmm_init(uint32_t mem_size, uint32_t *bitmap) {
          bitmap_size); // Ab bitmap saaf karo (0 = free)
   pmm_used_blocks = 0;
 
+  pmm_bitmap_words = pmm_max_blocks / 32;
+  pmm_summary_words = (pmm_bitmap_words + 31) / 32;
+  memset(pmm_summary, 0, sizeof(pmm_summary));
+  // Aakhri summary word ke bahar wale bits ko full maano
+  if (pmm_bitmap_words % 32)
+    pmm_summary[pmm_summary_words - 1] = ~((1u << (pmm_bitmap_words % 32)) - 1);
+
+  // Frame table bitmap ke theek baad (page aligned)
+  uint32_t frames_at = ((uint32_t)(uintptr_t)bitmap + bitmap_size + 0xFFF) &
+                       0xFFFFF000;
+  pmm_frames = (pmm_frame_t *)(uintptr_t)frames_at;
+  memset(pmm_frames, 0, pmm_max_blocks * sizeof(pmm_frame_t));
+  pmm_metadata_size =
+      (frames_at - (uint32_t)(uintptr_t)bitmap) +
+      ((pmm_max_blocks * sizeof(pmm_frame_t) + 0xFFF) & 0xFFFFF000);
+
+  // Zones: DMA (<16MB, ISA DMA ke liye) aur NORMAL (baaki sab)
+  uint32_t dma_end = PMM_DMA_LIMIT / PMM_BLOCK_SIZE;
+  if (dma_end > pmm_max_blocks)
+    dma_end = pmm_max_blocks;
+  pmm_zones[PMM_ZONE_NORMAL].start_frame = dma_end; // zone_of_frame ke liye
+  zone_setup(PMM_ZONE_DMA, "DMA", 0, dma_end);
+  zone_setup(PMM_ZONE_NORMAL, "Normal", dma_end, pmm_max_blocks);
+
   serial_log("PMM: Bitmap taiyar hai.");
   serial_log_hex("  Mem Size:  ", mem_size);
   serial_log_hex("  Blocks:    ", pmm_max_blocks);
   serial_log_hex("  Bitmap at: ", (uint32_t)(uintptr_t)bitmap);
+  serial_log_hex("  Frames at: ", frames_at);
+  serial_log_hex("  Meta Size: ", pmm_metadata_size);
   serial_log_hex("  Used:      ", pmm_used_blocks);
   serial_log_hex("  Free:      ", pmm_max_blocks - pmm_used_blocks);
   serial_log_hex("  UsedAddr:  ", (uint32_t)(uintptr_t)&pmm_used_blocks);
 }
 
+uint32_t pmm_get_metadata_size() { return pmm_metadata_size; }
+
+void pmm_enable_normal_zone() {
+  pmm_zone_order[0] = PMM_ZONE_NORMAL;
+  pmm_zone_order[1] = PMM_ZONE_DMA;
+  serial_log("PMM: Normal zone ab pehle, DMA zone fallback.");
+}
+
 void pmm_mark_region_used(uint32_t base, uint32_t size) {
   uint32_t align = base / PMM_BLOCK_SIZE;
   uint32_t blocks = size / PMM_BLOCK_SIZE;
   if (size % PMM_BLOCK_SIZE)
     blocks++;
 
-  for (; blocks > 0; blocks--) {
+  uint32_t eflags = spin_lock_irqsave(&pmm_lock);
+  for (; blocks > 0 && align < pmm_max_blocks; blocks--) {
     if (!mmap_test(align)) {
+      buddy_take_frame(align);
       mmap_set(align);
       pmm_used_blocks++;
     }
     align++;
   }
+  spin_unlock_irqrestore(&pmm_lock, eflags);
 }
 
 void pmm_mark_region_free(uint32_t base, uint32_t size) {
@@ -82,20 +376,25 @@ void pmm_mark_region_free(uint32_t base, uint32_t size) {
   if (size % PMM_BLOCK_SIZE)
     blocks++;
 
-  for (; blocks > 0; blocks--) {
+  uint32_t eflags = spin_lock_irqsave(&pmm_lock);
+  for (; blocks > 0 && align < pmm_max_blocks; blocks--) {
     if (mmap_test(align)) {
       mmap_unset(align);
       pmm_used_blocks--;
+      buddy_free_block(align, 0);
     }
     align++;
   }
+  spin_unlock_irqrestore(&pmm_lock, eflags);
 }
 
 void *pmm_alloc_block() {
   static uint32_t alloc_count = 0;
 
+  uint32_t eflags = spin_lock_irqsave(&pmm_lock);
   uint32_t free_count = pmm_get_free_block_count();
   if (free_count <= 0) {
+    spin_unlock_irqrestore(&pmm_lock, eflags);
     serial_log("PMM: Out of Memory!");
     serial_log_hex("  Used:  ", pmm_used_blocks);
     serial_log_hex("  Max:   ", pmm_max_blocks);
@@ -103,8 +402,11 @@ void *pmm_alloc_block() {
     return 0;
   }
 
-  int frame = mmap_first_free();
+  int frame = mmap_first_free(&pmm_zones[pmm_zone_order[0]]);
+  if (frame == -1)
+    frame = mmap_first_free(&pmm_zones[pmm_zone_order[1]]);
   if (frame == -1) {
+    spin_unlock_irqrestore(&pmm_lock, eflags);
     serial_log("PMM: Out of Memory (Verify)!");
     serial_log_hex("  Used: ", pmm_used_blocks);
     serial_log_hex("  Max:  ", pmm_max_blocks);
@@ -112,9 +414,11 @@ void *pmm_alloc_block() {
     return 0;
   }
 
+  buddy_take_frame(frame);
   mmap_set(frame);
   pmm_used_blocks++;
   alloc_count++;
+  spin_unlock_irqrestore(&pmm_lock, eflags);
 
   uint32_t addr = frame * PMM_BLOCK_SIZE;
   return (void *)addr;
@@ -123,59 +427,135 @@ void *pmm_alloc_block() {
 void *pmm_alloc_contiguous_blocks(uint32_t count) {
   if (count == 0)
     return 0;
-  if (pmm_get_free_block_count() < count)
+
+  uint32_t eflags = spin_lock_irqsave(&pmm_lock);
+  int frame = -1;
+  if (pmm_get_free_block_count() >= count) {
+    frame = zone_alloc_run(&pmm_zones[pmm_zone_order[0]], count);
+    if (frame == -1)
+      frame = zone_alloc_run(&pmm_zones[pmm_zone_order[1]], count);
+  }
+  spin_unlock_irqrestore(&pmm_lock, eflags);
+  if (frame == -1)
     return 0;
+  return (void *)(frame * PMM_BLOCK_SIZE);
+}
 
-  uint32_t consecutive = 0;
-  int start_frame = -1;
+void *pmm_alloc_dma_blocks(uint32_t count) {
+  if (count == 0)
+    return 0;
 
-  for (uint32_t i = 0; i < pmm_max_blocks; i++) {
-    if (!mmap_test(i)) {
-      if (consecutive == 0)
-        start_frame = i;
-      consecutive++;
-      if (consecutive == count) {
-        // Mil gaya continuous chunk!
-        for (uint32_t k = 0; k < count; k++) {
-          mmap_set(start_frame + k);
-        }
-        pmm_used_blocks += count;
-        return (void *)(start_frame * PMM_BLOCK_SIZE);
-      }
-    } else {
-      consecutive = 0;
-      start_frame = -1;
-    }
+  uint32_t eflags = spin_lock_irqsave(&pmm_lock);
+  int frame = zone_alloc_run(&pmm_zones[PMM_ZONE_DMA], count);
+  spin_unlock_irqrestore(&pmm_lock, eflags);
+  if (frame == -1) {
+    serial_log_hex("PMM: DMA zone mein jagah nahi, frames: ", count);
+    return 0;
   }
-  return 0;
+  return (void *)(frame * PMM_BLOCK_SIZE);
 }
 
 void pmm_free_block(void *p) {
   uint32_t addr = (uint32_t)p;
-  int frame = addr / PMM_BLOCK_SIZE;
+  uint32_t frame = addr / PMM_BLOCK_SIZE;
+  if (frame >= pmm_max_blocks)
+    return; // MMIO / framebuffer - PMM ka nahi hai
+
+  if (pmm_frames[frame].flags & PMM_FRAME_PINNED)
+    return; // Hazaaron PTEs mein mapped ho sakta hai, refs nahi ginte
 
-  if (mmap_test(frame)) {
+  uint32_t eflags = spin_lock_irqsave(&pmm_lock);
+  if (pmm_frames[frame].refs) {
+    pmm_frames[frame].refs--; // Koi aur abhi bhi use kar raha hai
+  } else if (mmap_test(frame)) {
     mmap_unset(frame);
     pmm_used_blocks--;
+    buddy_free_block(frame, 0);
   }
+  spin_unlock_irqrestore(&pmm_lock, eflags);
+}
+
+void pmm_ref_frame(void *p) {
+  uint32_t frame = (uint32_t)p / PMM_BLOCK_SIZE;
+  if (frame >= pmm_max_blocks)
+    return;
+  uint32_t eflags = spin_lock_irqsave(&pmm_lock);
+  if (mmap_test(frame) && !(pmm_frames[frame].flags & PMM_FRAME_PINNED))
+    pmm_frames[frame].refs++;
+  spin_unlock_irqrestore(&pmm_lock, eflags);
+}
+
+void pmm_pin_frame(void *p) {
+  uint32_t frame = (uint32_t)p / PMM_BLOCK_SIZE;
+  if (frame >= pmm_max_blocks)
+    return;
+  uint32_t eflags = spin_lock_irqsave(&pmm_lock);
+  if (mmap_test(frame))
+    pmm_frames[frame].flags |= PMM_FRAME_PINNED;
+  spin_unlock_irqrestore(&pmm_lock, eflags);
+}
+
+uint32_t pmm_frame_refs(void *p) {
+  uint32_t frame = (uint32_t)p / PMM_BLOCK_SIZE;
+  if (frame >= pmm_max_blocks)
+    return 0;
+  return pmm_frames[frame].refs;
 }
 
 void pmm_free_contiguous_blocks(void *p, uint32_t count) {
   uint32_t addr = (uint32_t)p;
-  int frame = addr / PMM_BLOCK_SIZE;
+  uint32_t frame = addr / PMM_BLOCK_SIZE;
+  if (frame >= pmm_max_blocks)
+    return;
+  if (frame + count > pmm_max_blocks)
+    count = pmm_max_blocks - frame;
 
+  // Used frames ke runs ek saath buddy ko wapas do
+  uint32_t eflags = spin_lock_irqsave(&pmm_lock);
+  uint32_t run_start = 0, run_len = 0;
   for (uint32_t i = 0; i < count; i++) {
-    if (mmap_test(frame + i)) {
+    if (pmm_frames[frame + i].flags & PMM_FRAME_PINNED) {
+      if (run_len) {
+        buddy_give_range(run_start, run_len);
+        run_len = 0;
+      }
+    } else if (pmm_frames[frame + i].refs) {
+      pmm_frames[frame + i].refs--;
+      if (run_len) {
+        buddy_give_range(run_start, run_len);
+        run_len = 0;
+      }
+    } else if (mmap_test(frame + i)) {
       mmap_unset(frame + i);
       pmm_used_blocks--;
+      if (run_len == 0)
+        run_start = frame + i;
+      run_len++;
+    } else if (run_len) {
+      buddy_give_range(run_start, run_len);
+      run_len = 0;
     }
   }
+  if (run_len)
+    buddy_give_range(run_start, run_len);
+  spin_unlock_irqrestore(&pmm_lock, eflags);
 }
 
 uint32_t pmm_get_free_block_count() { return pmm_max_blocks - pmm_used_blocks; }
 
 uint32_t pmm_get_block_count() { return pmm_max_blocks; }
 
+void pmm_get_zone_stats(int zone, pmm_zone_stats_t *out) {
+  if (zone < 0 || zone >= PMM_NUM_ZONES || !out)
+    return;
+  pmm_zone_t *z = &pmm_zones[zone];
+  out->start = z->start_frame * PMM_BLOCK_SIZE;
+  out->end = z->end_frame * PMM_BLOCK_SIZE;
+  out->free_blocks = z->free_frames;
+  for (int o = 0; o <= PMM_MAX_ORDER; o++)
+    out->nr_free[o] = z->nr_free[o];
+}
+
 void pmm_print_stats() {
   uint32_t free_blocks = pmm_get_free_block_count();
   uint32_t used_blocks = pmm_used_blocks;
@@ -187,3 +567,118 @@ void pmm_print_stats() {
   serial_log_hex("  Free Blocks:  ", free_blocks);
   serial_log_hex("  Free Memory (KB): ", free_blocks * 4);
 }
+
+void pmm_print_buddy_stats() {
+  for (int i = 0; i < PMM_NUM_ZONES; i++) {
+    pmm_zone_t *z = &pmm_zones[i];
+    serial_log("PMM Buddy Zone:");
+    serial_log(z->name);
+    serial_log_hex("  Free Frames: ", z->free_frames);
+    // Har order pe kitne free blocks - fragmentation yahin dikhta hai
+    for (int o = 0; o <= PMM_MAX_ORDER; o++) {
+      serial_log_hex("  Order: ", o);
+      serial_log_hex("    Free Blocks: ", z->nr_free[o]);
+    }
+  }
+}
+
+// Boot-time microbenchmark: purana linear scan vs summary bitmap / buddy.
+// Dono path ek hi bitmap pe chalte hain, har round ke baad frames wapas.
+#define PMM_BENCH_FRAMES 1024
+#define PMM_BENCH_RUNS 16
+#define PMM_BENCH_RUN_FRAMES 256
+static uint32_t pmm_bench_frames[PMM_BENCH_FRAMES];
+
+static uint32_t pmm_bench_rate(uint32_t allocs, uint64_t cycles,
+                               uint64_t hpet_ticks) {
+  uint32_t period_fs = hpet_get_period_fs();
+  if (hpet_ticks && period_fs) {
+    // allocs / (ticks * period_fs / 1e15)
+    return (uint32_t)(((uint64_t)allocs * 1000000000000000ULL) /
+                      (hpet_ticks * period_fs));
+  }
+  // HPET nahi hai toh cycles per alloc hi dikha do
+  return allocs ? (uint32_t)(cycles / allocs) : 0;
+}
+
+void pmm_benchmark() {
+  uint32_t count = PMM_BENCH_FRAMES;
+  if (pmm_get_free_block_count() < count)
+    count = pmm_get_free_block_count();
+
+  serial_log("PMM BENCH: Linear scan vs summary bitmap...");
+
+  // 1. Purana path
+  uint64_t h1 = hpet_read_counter();
+  uint64_t t1 = rdtsc();
+  for (uint32_t i = 0; i < count; i++) {
+    int frame = mmap_first_free_linear();
+    buddy_take_frame(frame);
+    mmap_set(frame);
+    pmm_used_blocks++;
+    pmm_bench_frames[i] = frame * PMM_BLOCK_SIZE;
+  }
+  uint64_t t2 = rdtsc();
+  uint64_t h2 = hpet_read_counter();
+  for (uint32_t i = 0; i < count; i++)
+    pmm_free_block((void *)pmm_bench_frames[i]);
+
+  // 2. Naya path (asli pmm_alloc_block)
+  uint64_t h3 = hpet_read_counter();
+  uint64_t t3 = rdtsc();
+  for (uint32_t i = 0; i < count; i++)
+    pmm_bench_frames[i] = (uint32_t)pmm_alloc_block();
+  uint64_t t4 = rdtsc();
+  uint64_t h4 = hpet_read_counter();
+  for (uint32_t i = 0; i < count; i++)
+    pmm_free_block((void *)pmm_bench_frames[i]);
+
+  serial_log(hpet_get_period_fs() ? "  Units: allocs/sec"
+                                  : "  Units: cycles/alloc (no HPET)");
+  serial_log_hex("  Allocs:      ", count);
+  serial_log_hex("  Old (linear):", pmm_bench_rate(count, t2 - t1, h2 - h1));
+  serial_log_hex("  New (summary):", pmm_bench_rate(count, t4 - t3, h4 - h3));
+
+  // 3. Contiguous runs: bitmap scan vs buddy
+  serial_log("PMM BENCH: Contiguous runs, bitmap scan vs buddy...");
+  pmm_zone_t *z = &pmm_zones[PMM_ZONE_NORMAL];
+  uint32_t runs = 0;
+  h1 = hpet_read_counter();
+  t1 = rdtsc();
+  for (; runs < PMM_BENCH_RUNS; runs++) {
+    int start = mmap_find_run(0, pmm_max_blocks, PMM_BENCH_RUN_FRAMES);
+    if (start == -1)
+      break;
+    for (uint32_t k = 0; k < PMM_BENCH_RUN_FRAMES; k++) {
+      buddy_take_frame(start + k);
+      mmap_set(start + k);
+    }
+    pmm_used_blocks += PMM_BENCH_RUN_FRAMES;
+    pmm_bench_frames[runs] = start * PMM_BLOCK_SIZE;
+  }
+  t2 = rdtsc();
+  h2 = hpet_read_counter();
+  for (uint32_t i = 0; i < runs; i++)
+    pmm_free_contiguous_blocks((void *)pmm_bench_frames[i],
+                               PMM_BENCH_RUN_FRAMES);
+
+  uint32_t buddy_runs = 0;
+  h3 = hpet_read_counter();
+  t3 = rdtsc();
+  for (; buddy_runs < PMM_BENCH_RUNS; buddy_runs++) {
+    int start = zone_alloc_run(z, PMM_BENCH_RUN_FRAMES);
+    if (start == -1)
+      break;
+    pmm_bench_frames[buddy_runs] = start * PMM_BLOCK_SIZE;
+  }
+  t4 = rdtsc();
+  h4 = hpet_read_counter();
+  for (uint32_t i = 0; i < buddy_runs; i++)
+    pmm_free_contiguous_blocks((void *)pmm_bench_frames[i],
+                               PMM_BENCH_RUN_FRAMES);
+
+  serial_log_hex("  Runs:        ", runs);
+  serial_log_hex("  Old (scan):  ", pmm_bench_rate(runs, t2 - t1, h2 - h1));
+  serial_log_hex("  New (buddy): ",
+                 pmm_bench_rate(buddy_runs, t4 - t3, h4 - h3));
+}
@@ -7,6 +7,23 @@
 #define PMM_BLOCK_SIZE 4096
 #define PMM_BLOCKS_PER_BYTE 8
 
+// Buddy orders 0..10 (4KB .. 4MB)
+#define PMM_MAX_ORDER 10
+
+// Zones: DMA (<16MB, ISA DMA jaise SB16 channel 5) aur Normal
+#define PMM_ZONE_DMA 0
+#define PMM_ZONE_NORMAL 1
+#define PMM_NUM_ZONES 2
+#define PMM_DMA_LIMIT 0x01000000
+
+// Per-zone free statistics (fragmentation dekhne ke liye)
+typedef struct pmm_zone_stats {
+  uint32_t start;                      // Zone ka physical start
+  uint32_t end;                        // Zone ka physical end
+  uint32_t free_blocks;                // Free 4KB frames
+  uint32_t nr_free[PMM_MAX_ORDER + 1]; // Free buddy blocks per order
+} pmm_zone_stats_t;
+
 // API to initialize the PMM
 // mem_size: Total physical memory size in bytes
 // bitmap: Pointer to a valid memory region to store the bitmap
@@ -16,13 +33,26 @@ void pmm_init(uint32_t mem_size, uint32_t *bitmap);
 // Returns physical address, or 0 if OOM
 void *pmm_alloc_block();
 
-// Allocate contiguous 4KB blocks
+// Allocate contiguous 4KB blocks (buddy, log time for runs up to 4MB)
 void *pmm_alloc_contiguous_blocks(uint32_t count);
 void pmm_free_contiguous_blocks(void *p, uint32_t count);
 
-// Free a 4KB block
+// Allocate contiguous blocks from the <16MB DMA zone only. Buddy blocks are
+// naturally aligned, so runs up to 128KB never cross a 64K/128K DMA boundary.
+void *pmm_alloc_dma_blocks(uint32_t count);
+
+// Free a 4KB block. Shared frames (refs > 0) sirf ek ref chhodte hain.
 void pmm_free_block(void *p);
 
+// Frame sharing (COW fork, SHM): har extra mapping ek ref leti hai, aur har
+// pmm_free_block ek ref wapas karta hai. Aakhri free pe frame sach mein free.
+void pmm_ref_frame(void *p);
+uint32_t pmm_frame_refs(void *p); // Extra sharers (0 = akela owner)
+
+// Allocated frame ko pin karo: pmm_free_block/pmm_ref_frame use ignore karte
+// hain (shared zero page jaise frames jo unginat PTEs mein mapped hain)
+void pmm_pin_frame(void *p);
+
 // Helper to mark a specific region as used (e.g., Kernel code, Modules)
 void pmm_mark_region_used(uint32_t base, uint32_t size);
 
@@ -34,7 +64,21 @@ uint32_t pmm_get_free_block_count();
 
 uint32_t pmm_get_block_count();
 
+// Bytes used by the bitmap + frame table (reserve this after pmm_init)
+uint32_t pmm_get_metadata_size();
+
+// Call once init_paging has mapped all of RAM: single-frame and contiguous
+// allocations then prefer the Normal zone and keep DMA frames in reserve.
+void pmm_enable_normal_zone();
+
 // Print memory statistics
 void pmm_print_stats();
 
+// Per-order free block counts for a zone
+void pmm_get_zone_stats(int zone, pmm_zone_stats_t *out);
+void pmm_print_buddy_stats();
+
+// Boot-time microbenchmark: old linear scan vs summary bitmap allocation
+void pmm_benchmark();
+
 #endif
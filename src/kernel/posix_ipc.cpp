@@ -11,9 +11,75 @@
 #include "heap.h"
 #include "memory.h"
 #include "process.h"
+#include "sched.h"
+#include "spinlock.h"
+#include "wait_queue.h"
 
 extern "C" {
 
+// ============================================================================
+// Semaphore wait queues
+// ============================================================================
+// sem_t user memory mein hai (8 bytes, libc ka layout) - wait queue usmein
+// nahi aa sakti. Futex jaisa: (address space, address) ki key pe ek chhota
+// table, slot tab tak zinda jab tak koi so raha hai. Exact key match, to
+// sem_post sirf usi semaphore ka ek waiter jagata hai.
+#define SEM_WAITQ_SLOTS 32
+
+struct sem_waitq {
+  uint32_t *mm; // page_directory, named sems (kernel memory) ke liye 0
+  const sem_t *sem;
+  int users;
+  wait_queue_t wq;
+};
+
+static struct sem_waitq sem_waitqs[SEM_WAITQ_SLOTS];
+
+// sem->value / waiters aur sem_waitqs table. Order: sem -> wq -> runqueue
+static DEFINE_SPINLOCK(sem_lock, "posix_sem");
+
+static bool sem_is_named(const sem_t *sem);
+
+static uint32_t *sem_mm(const sem_t *sem) {
+  return sem_is_named(sem) ? 0 : current_process->page_directory;
+}
+
+// sem_lock pakda hua. create = 0 pe sirf dhundho.
+static struct sem_waitq *sem_waitq_get(const sem_t *sem, bool create) {
+  uint32_t *mm = sem_mm(sem);
+  struct sem_waitq *free_slot = 0;
+  for (int i = 0; i < SEM_WAITQ_SLOTS; i++) {
+    struct sem_waitq *q = &sem_waitqs[i];
+    if (q->users && q->sem == sem && q->mm == mm)
+      return q;
+    if (!q->users && !free_slot)
+      free_slot = q;
+  }
+  if (!create || !free_slot)
+    return 0;
+  free_slot->mm = mm;
+  free_slot->sem = sem;
+  wait_queue_init(&free_slot->wq);
+  return free_slot;
+}
+
+// sem_lock pakda hua
+static inline bool sem_try_down(sem_t *sem) {
+  if (sem->value > 0) {
+    sem->value--;
+    return true;
+  }
+  return false;
+}
+
+// wait_event ki condition - lock khud leta hai
+static bool sem_try_down_locked(sem_t *sem) {
+  uint32_t eflags = spin_lock_irqsave(&sem_lock);
+  bool ok = sem_try_down(sem);
+  spin_unlock_irqrestore(&sem_lock, eflags);
+  return ok;
+}
+
 // ============================================================================
 // Unnamed Semaphores
 // ============================================================================
@@ -51,41 +117,50 @@ int sem_wait(sem_t *sem) {
   if (!sem)
     return -1;
 
-  while (1) {
-    asm volatile("cli");
+  uint32_t eflags = spin_lock_irqsave(&sem_lock);
 
-    if (sem->value > 0) {
-      sem->value--;
-      asm volatile("sti");
-      return 0;
-    }
+  if (sem_try_down(sem)) {
+    spin_unlock_irqrestore(&sem_lock, eflags);
+    return 0;
+  }
 
+  struct sem_waitq *q = sem_waitq_get(sem, true);
+  if (!q) {
+    // Table bhari - purana tareeka, har tick dekh lo
     sem->waiters++;
-    asm volatile("sti");
-
-    // Block until signaled
-    current_process->state = PROCESS_WAITING;
-    schedule();
-
-    asm volatile("cli");
+    while (!sem_try_down(sem)) {
+      spin_unlock_irqrestore(&sem_lock, eflags);
+      process_sleep(1);
+      eflags = spin_lock_irqsave(&sem_lock);
+    }
     sem->waiters--;
-    asm volatile("sti");
+    spin_unlock_irqrestore(&sem_lock, eflags);
+    return 0;
   }
+  q->users++;
+  sem->waiters++;
+  spin_unlock_irqrestore(&sem_lock, eflags);
+
+  // Block until signaled - exclusive, ek post ek hi waiter jagata hai
+  wait_event_exclusive(&q->wq, sem_try_down_locked(sem));
+
+  eflags = spin_lock_irqsave(&sem_lock);
+  sem->waiters--;
+  q->users--;
+  spin_unlock_irqrestore(&sem_lock, eflags);
+  return 0;
 }
 
 int sem_trywait(sem_t *sem) {
   if (!sem)
     return -1;
 
-  asm volatile("cli");
-
-  if (sem->value > 0) {
-    sem->value--;
-    asm volatile("sti");
+  uint32_t eflags = spin_lock_irqsave(&sem_lock);
+  bool ok = sem_try_down(sem);
+  spin_unlock_irqrestore(&sem_lock, eflags);
+  if (ok)
     return 0;
-  }
 
-  asm volatile("sti");
   // errno = EAGAIN;
   return -1;
 }
@@ -99,33 +174,24 @@ int sem_post(sem_t *sem) {
   if (!sem)
     return -1;
 
-  asm volatile("cli");
+  uint32_t eflags = spin_lock_irqsave(&sem_lock);
 
   if (sem->value == 0x7FFFFFFF) {
-    asm volatile("sti");
+    spin_unlock_irqrestore(&sem_lock, eflags);
     // errno = EOVERFLOW;
     return -1;
   }
 
   sem->value++;
 
-  // Wake up one waiter
+  // Wake up one waiter - sirf isi semaphore ka
   if (sem->waiters > 0) {
-    // In a real implementation, we'd wake a specific process
-    process_t *p = ready_queue;
-    if (p) {
-      process_t *start = p;
-      do {
-        if (p->state == PROCESS_WAITING) {
-          p->state = PROCESS_READY;
-          break;
-        }
-        p = p->next;
-      } while (p && p != start);
-    }
+    struct sem_waitq *q = sem_waitq_get(sem, false);
+    if (q)
+      wake_up(&q->wq);
   }
 
-  asm volatile("sti");
+  spin_unlock_irqrestore(&sem_lock, eflags);
   return 0;
 }
 
@@ -152,6 +218,11 @@ struct named_sem {
 static struct named_sem named_sems[MAX_NAMED_SEMS];
 static int named_sems_initialized = 0;
 
+static bool sem_is_named(const sem_t *sem) {
+  return (const void *)sem >= (const void *)&named_sems[0] &&
+         (const void *)sem < (const void *)&named_sems[MAX_NAMED_SEMS];
+}
+
 static void init_named_sems(void) {
   if (named_sems_initialized)
     return;
@@ -263,6 +334,8 @@ struct message_queue {
   struct message *tail;
   int ref_count;
   int unlinked;
+  wait_queue_t recv_wait; // Khaali queue pe mq_receive
+  wait_queue_t send_wait; // Bhari queue pe mq_send
 };
 
 static struct message_queue mqueues[MAX_MESSAGE_QUEUES];
@@ -312,7 +385,7 @@ mqd_t mq_open(const char *name, int oflag, ...) {
     if (!mqueues[i].name[0]) {
       strncpy(mqueues[i].name, name, 63);
       mqueues[i].name[63] = 0;
-      mqueues[i].attr.mq_flags = 0;
+      mqueues[i].attr.mq_flags = oflag & O_NONBLOCK;
       mqueues[i].attr.mq_maxmsg = MAX_MESSAGES;
       mqueues[i].attr.mq_msgsize = MAX_MSG_SIZE;
       mqueues[i].attr.mq_curmsgs = 0;
@@ -320,6 +393,8 @@ mqd_t mq_open(const char *name, int oflag, ...) {
       mqueues[i].tail = 0;
       mqueues[i].ref_count = 1;
       mqueues[i].unlinked = 0;
+      wait_queue_init(&mqueues[i].recv_wait);
+      wait_queue_init(&mqueues[i].send_wait);
       return i;
     }
   }
@@ -344,6 +419,9 @@ int mq_close(mqd_t mqdes) {
     mqueues[mqdes].name[0] = 0;
     mqueues[mqdes].head = 0;
     mqueues[mqdes].tail = 0;
+    // Sote hue sender/receiver ko batao ki queue gayi
+    wake_up_all(&mqueues[mqdes].recv_wait);
+    wake_up_all(&mqueues[mqdes].send_wait);
   }
 
   return 0;
@@ -367,6 +445,8 @@ int mq_unlink(const char *name) {
         mqueues[i].name[0] = 0;
         mqueues[i].head = 0;
         mqueues[i].tail = 0;
+        wake_up_all(&mqueues[i].recv_wait);
+        wake_up_all(&mqueues[i].send_wait);
       }
       return 0;
     }
@@ -385,10 +465,17 @@ int mq_send(mqd_t mqdes, const char *msg_ptr, size_t msg_len,
     return -1;
 
   if (mqueues[mqdes].attr.mq_curmsgs >= mqueues[mqdes].attr.mq_maxmsg) {
-    // Queue full - would block
-    // For now, return error
-    // errno = EAGAIN;
-    return -1;
+    if (mqueues[mqdes].attr.mq_flags & O_NONBLOCK) {
+      // errno = EAGAIN;
+      return -1;
+    }
+    // Queue full - receiver jagah banaye tab tak so (ek slot, ek sender)
+    struct mq_attr *attr = &mqueues[mqdes].attr;
+    wait_event_exclusive(&mqueues[mqdes].send_wait,
+                         attr->mq_curmsgs < attr->mq_maxmsg ||
+                             !mqueues[mqdes].name[0]);
+    if (!mqueues[mqdes].name[0])
+      return -1;
   }
 
   struct message *msg = (struct message *)kmalloc(sizeof(struct message));
@@ -417,6 +504,7 @@ int mq_send(mqd_t mqdes, const char *msg_ptr, size_t msg_len,
   }
 
   mqueues[mqdes].attr.mq_curmsgs++;
+  wake_up(&mqueues[mqdes].recv_wait);
 
   return 0;
 }
@@ -436,9 +524,15 @@ ssize_t mq_receive(mqd_t mqdes, char *msg_ptr, size_t msg_len,
     return -1;
 
   if (!mqueues[mqdes].head) {
-    // Queue empty - would block
-    // errno = EAGAIN;
-    return -1;
+    if (mqueues[mqdes].attr.mq_flags & O_NONBLOCK) {
+      // errno = EAGAIN;
+      return -1;
+    }
+    // Queue empty - sender ke maal tak so (ek message, ek receiver)
+    wait_event_exclusive(&mqueues[mqdes].recv_wait,
+                         mqueues[mqdes].head || !mqueues[mqdes].name[0]);
+    if (!mqueues[mqdes].name[0])
+      return -1;
   }
 
   struct message *msg = mqueues[mqdes].head;
@@ -447,6 +541,7 @@ ssize_t mq_receive(mqd_t mqdes, char *msg_ptr, size_t msg_len,
     mqueues[mqdes].tail = 0;
 
   mqueues[mqdes].attr.mq_curmsgs--;
+  wake_up(&mqueues[mqdes].send_wait);
 
   size_t copy_len = (msg->len < msg_len) ? msg->len : msg_len;
   memcpy(msg_ptr, msg->data, copy_len);
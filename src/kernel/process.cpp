@@ -5,29 +5,84 @@
 #include "../include/string.h"
 #include "../kernel/memory.h"
 #include "elf_loader.h"
+#include "fpu.h"
 #include "gdt.h"
 #include "heap.h"
 #include "net.h"
 #include "paging.h"
 #include "pe_loader.h"
 #include "pmm.h"
+#include "sched.h"
 #include "shm.h"
+#include "slab.h"
+#include "uring.h"
 #include "vm.h"
 
-process_t *current_process = 0;
 process_t *ready_queue = 0;
+process_t *idle_process = 0;
 uint32_t next_pid = 1;
 
+// ready_queue ki circular list aur next_pid. Keyboard IRQ (Ctrl+C) bhi list
+// ghoomta hai, isliye hamesha irqsave.
+DEFINE_SPINLOCK(tasklist_lock, "tasklist");
+
+extern uint32_t tick;
+
+// process_t ~2.3KB hai, kmalloc-2048 mein fit nahi hota - apna exact-size
+// cache. Bahut saara code zeroed process_t maan ke chalta hai (vmas, image,
+// unveils...), isliye KMEM_ZERO.
+static kmem_cache_t *process_cache = 0;
+
 extern "C" uint32_t
     stack_top; // Asli stack ki choti (kernel_entry.asm se aayi hai)
 extern "C" void switch_task(uint32_t *old_esp, uint32_t new_esp,
                             uint32_t new_cr3);
 extern "C" void fork_child_return();
 
+static uint32_t alloc_pid() {
+  uint32_t eflags = spin_lock_irqsave(&tasklist_lock);
+  uint32_t pid = next_pid++;
+  spin_unlock_irqrestore(&tasklist_lock, eflags);
+  return pid;
+}
+
+// Naya process current ke baad list mein, phir scheduler ki queue pe
+static void process_link(process_t *p, int inherit) {
+  uint32_t eflags = spin_lock_irqsave(&tasklist_lock);
+  p->next = current_process->next;
+  current_process->next = p;
+  spin_unlock_irqrestore(&tasklist_lock, eflags);
+  sched_new_task(p, inherit);
+}
+
+// List se hatao - tasklist_lock pakda hua
+static void __process_unlink(process_t *p) {
+  if (p->next == p) {
+    ready_queue = 0;
+    return;
+  }
+  process_t *curr = ready_queue;
+  while (curr->next != p)
+    curr = curr->next;
+  curr->next = p->next;
+  if (ready_queue == p)
+    ready_queue = p->next;
+}
+
+// Path ka aakhri hissa, kaat ke name[] mein
+static void process_set_name(process_t *proc, const char *path) {
+  const char *base = strrchr(path, '/');
+  base = base ? base + 1 : path;
+  strncpy(proc->name, base, sizeof(proc->name) - 1);
+  proc->name[sizeof(proc->name) - 1] = 0;
+}
+
 void init_multitasking() {
   serial_log("SCHED: Multitasking shuru kar rahe hain...");
 
-  current_process = (process_t *)kmalloc(sizeof(process_t));
+  process_cache = kmem_cache_create("process", sizeof(process_t), KMEM_ZERO);
+
+  set_current((process_t *)kmem_cache_alloc(process_cache));
   current_process->id = 0;
   current_process->state = PROCESS_RUNNING;
   current_process->parent = 0;
@@ -44,24 +99,73 @@ void init_multitasking() {
   current_process->time_remaining = DEFAULT_TIME_SLICE;
   current_process->sleep_until = 0;
   current_process->pledges = PLEDGE_ALL;
+  // Boot context PRIO class mein: fair tasks ke hote hue sirf hlt karta hai
+  current_process->sched_class = SCHED_CLASS_PRIO;
+  current_process->exec_start = sched_clock_ns();
   strcpy(current_process->cwd, "/");
+  process_set_name(current_process, "kernel");
 
   current_process->next = current_process;
   ready_queue = current_process;
+  idle_process = current_process;
+  sched_init_cpu(0, current_process); // BSP ka idle, CPU 0 pe pinned
 
   serial_log("SCHED: Enabled.");
 }
 
-void create_kernel_thread(void (*fn)()) {
+// Naye kernel thread ka pehla kadam (create_kernel_thread ka stack yahan
+// "ret" karta hai): switch poora karo, phir big kernel lock ke saath fn.
+// Kernel threads lock pakad ke hi chalte hain, schedule() mein chhodte hain.
+static void kthread_start(void (*fn)()) {
+  schedule_tail();
+  local_irq_enable();
+  lock_kernel();
+  fn();
+  // fn ko lautna nahi chahiye tha - zombie ban ke CPU chhodo
+  current_process->state = PROCESS_ZOMBIE;
+  schedule();
+  for (;;)
+    asm volatile("hlt");
+}
+
+// Zombie ka aakhri schedule() doosre CPU pe abhi switch_task ke beech ho
+// sakta hai - uske stack se utarne tak free mat karo
+static void wait_task_off_cpu(process_t *p) {
+  while (p->on_cpu)
+    asm volatile("pause" ::: "memory");
+}
+
+process_t *create_idle_process(uint32_t cpu) {
+  process_t *idle = (process_t *)kmem_cache_alloc(process_cache);
+  idle->id = 0; // Har CPU ka idle PID 0 (BSP jaisa)
+  idle->state = PROCESS_RUNNING;
+  idle->page_directory = (uint32_t *)VIRT_TO_PHYS(kernel_directory);
+  // AP isi stack pe trampoline se aata hai
+  uint32_t stack = (uint32_t)kmalloc(SMP_AP_STACK_SIZE);
+  idle->kernel_stack_top = stack + SMP_AP_STACK_SIZE;
+  idle->priority = DEFAULT_PRIORITY;
+  idle->time_slice = DEFAULT_TIME_SLICE;
+  idle->time_remaining = DEFAULT_TIME_SLICE;
+  idle->pledges = PLEDGE_ALL;
+  idle->sched_class = SCHED_CLASS_IDLE;
+  idle->cpu = cpu;
+  strcpy(idle->cwd, "/");
+  process_set_name(idle, "idle");
+  idle->next = idle; // Process list mein nahi - ps/kill/wait ko nahi dikhta
+  return idle;
+}
+
+process_t *create_kernel_thread(void (*fn)()) {
   // Naya kernel thread banao
-  process_t *new_proc = (process_t *)kmalloc(sizeof(process_t));
-  new_proc->id = next_pid++;
+  process_t *new_proc = (process_t *)kmem_cache_alloc(process_cache);
+  new_proc->id = alloc_pid();
   new_proc->state = PROCESS_READY;
   new_proc->parent = current_process;
   new_proc->exit_code = 0;
   new_proc->page_directory = (uint32_t *)VIRT_TO_PHYS(kernel_directory);
   new_proc->heap_end = 0;
   new_proc->pledges = PLEDGE_ALL;
+  process_set_name(new_proc, "kthread");
 
   new_proc->priority = DEFAULT_PRIORITY;
   new_proc->time_slice = DEFAULT_TIME_SLICE;
@@ -71,21 +175,42 @@ void create_kernel_thread(void (*fn)()) {
   uint32_t *stack = (uint32_t *)kmalloc(16384);
   uint32_t *top = stack + 4096;
 
+  // switch_task ka "ret" kthread_start(fn) pe, interrupts band (IF=0) -
+  // schedule_tail se pehle koi IRQ switch na kare
   *(--top) = (uint32_t)fn;
+  *(--top) = 0; // kthread_start ka return address - wapas nahi aata
+  *(--top) = (uint32_t)kthread_start;
   *(--top) = 0;
   *(--top) = 0;
   *(--top) = 0;
   *(--top) = 0;
-  *(--top) = 0x0202;
+  *(--top) = 0x0002;
 
   new_proc->esp = (uint32_t)top;
   new_proc->kernel_stack_top = (uint32_t)stack + 4096;
 
-  new_proc->next = current_process->next;
-  current_process->next = new_proc;
+  process_link(new_proc, 0);
+  return new_proc;
+}
+
+// Kernel thread ka stack create_kernel_thread ke 16KB kmalloc se hai (aur
+// kernel_stack_top uske base + 4096 pe set hota hai), user processes jaisa
+// 4KB kstack nahi
+void reap_kernel_thread(process_t *proc) {
+  wait_task_off_cpu(proc);
+  sched_dequeue(proc);
+  uint32_t eflags = spin_lock_irqsave(&tasklist_lock);
+  __process_unlink(proc);
+  spin_unlock_irqrestore(&tasklist_lock, eflags);
+  timer_del_sync(&proc->sleep_timer);
+  timer_del_sync(&proc->alarm_timer);
+  kfree((void *)(proc->kernel_stack_top - 4096));
+  fpu_release(proc);
+  kmem_cache_free(process_cache, proc);
 }
 
 void user_mode_entry(uint32_t entry, uint32_t utop) {
+  schedule_tail();
   asm volatile("  \
         cli; \
         mov $0x23, %%ax; \
@@ -108,29 +233,52 @@ void user_mode_entry(uint32_t entry, uint32_t utop) {
                : "eax");
 }
 
-extern "C" void create_user_process(const char *filename, char *const argv[]) {
-  // Disable interrupts during process creation to prevent race conditions
-  uint32_t eflags;
-  asm volatile("pushf; pop %0; cli" : "=r"(eflags));
-
-  // User process load karne ka jugad
-  uint32_t phys_pd = (uint32_t)pd_create();
-  if (!phys_pd) {
-    // Restore interrupts
-    if (eflags & 0x200)
-      asm volatile("sti");
-    return;
+// Naye executable ke VMAs: ELF segments (file-backed) aur stack window
+static void register_exec_vmas(process_t *proc) {
+  vma_list_t *vmas = &proc->vmas;
+  vma_clear(vmas);
+
+  for (int i = 0; i < proc->image.count; i++) {
+    elf_region_t *r = &proc->image.regions[i];
+    uint32_t start = r->vaddr & 0xFFFFF000;
+    uint32_t end = (r->vaddr + r->memsz + 0xFFF) & 0xFFFFF000;
+    uint32_t prot = 0;
+    if (r->flags & PF_R)
+      prot |= VMA_READ;
+    if (r->flags & PF_W)
+      prot |= VMA_WRITE;
+    if (r->flags & PF_X)
+      prot |= VMA_EXEC;
+
+    // Pichle segment ke saath share hone wala page dono ka prot leta hai
+    vma_t *shared = vma_find(vmas, start);
+    if (shared) {
+      prot |= shared->prot;
+      vma_remove(vmas, start, start + 4096);
+    }
+    if (vma_insert(vmas, start, end, prot, VMA_FILE) != 0)
+      serial_log_hex("PROC: VMA insert failed for segment ", r->vaddr);
   }
 
-  uint32_t phys_old_pd;
-  asm volatile("mov %%cr3, %0" : "=r"(phys_old_pd));
+  vma_insert(vmas, USER_STACK_LOW, USER_STACK_HIGH, VMA_READ | VMA_WRITE,
+             VMA_STACK);
+}
 
-  uint32_t *old_pd_ptr = current_process->page_directory;
-  current_process->page_directory = (uint32_t *)phys_pd;
-  pd_switch((uint32_t *)phys_pd);
+extern "C" void create_user_process(const char *filename, char *const argv[]) {
+  // User process load karne ka jugad. Loading interrupts on rehke hoti hai -
+  // sirf process list mein daalte waqt tasklist_lock chahiye.
+  uint32_t phys_pd = (uint32_t)pd_create();
+  if (!phys_pd)
+    return;
 
+  // Naya image seedha naye PD mein banta hai (vm_*_pd) - current_process ka
+  // page_directory aur CR3 apne hi rehte hain, beech ka switch/fault bhi
+  // parent ke address space pe chalta hai
   uint32_t top_addr = 0;
   uint32_t entry = 0;
+  elf_image_t image;
+  image.node = 0;
+  image.count = 0;
 
   // Detect format
   uint8_t magic[4];
@@ -139,37 +287,34 @@ extern "C" void create_user_process(const char *filename, char *const argv[]) {
     vfs_read(node, 0, magic, 4);
     if (magic[0] == 0x7F && magic[1] == 'E' && magic[2] == 'L' &&
         magic[3] == 'F') {
-      entry = load_elf(filename, &top_addr);
+      entry = load_elf(filename, &top_addr, &image);
     } else if (magic[0] == 'M' && magic[1] == 'Z') {
-      entry = load_pe(filename, &top_addr);
+      entry = load_pe(filename, &top_addr, (uint32_t *)phys_pd);
     } else {
       serial_log("PROC ERROR: Unknown executable format");
     }
   }
 
-  // Restore parent PD in current process struct
-  current_process->page_directory = old_pd_ptr;
-  pd_switch((uint32_t *)phys_old_pd);
-
   if (entry == 0) {
     serial_log("PROC ERROR: Failed to load ELF");
+    elf_image_release(&image);
     pd_destroy((uint32_t *)phys_pd); // Clean up new PD
-    // Restore interrupts
-    if (eflags & 0x200)
-      asm volatile("sti");
     return;
   }
 
   serial_log_hex("PROC: Created user process from ", entry);
 
-  process_t *new_proc = (process_t *)kmalloc(sizeof(process_t));
-  new_proc->id = next_pid++;
+  process_t *new_proc = (process_t *)kmem_cache_alloc(process_cache);
+  new_proc->id = alloc_pid();
   new_proc->state = PROCESS_READY;
   new_proc->parent = current_process;
   new_proc->exit_code = 0;
   new_proc->page_directory = (uint32_t *)phys_pd;
   new_proc->heap_end = top_addr;
+  new_proc->image = image; // Ref ab process ka
+  register_exec_vmas(new_proc);
   new_proc->pledges = PLEDGE_ALL;
+  process_set_name(new_proc, filename);
 
   for (int i = 0; i < MAX_PROCESS_FILES; i++)
     new_proc->fd_table[i] = 0;
@@ -178,7 +323,7 @@ extern "C" void create_user_process(const char *filename, char *const argv[]) {
   if (tty) {
     for (int i = 0; i < 3; i++) {
       file_description_t *desc =
-          (file_description_t *)kmalloc(sizeof(file_description_t));
+          (file_description_t *)kmem_cache_alloc(file_desc_cache);
       desc->node = tty;
       desc->offset = 0;
       desc->flags = O_RDWR;
@@ -193,7 +338,7 @@ extern "C" void create_user_process(const char *filename, char *const argv[]) {
   else
     strcpy(new_proc->cwd, "/");
 
-  uint32_t *kstack = (uint32_t *)kmalloc(4096);
+  uint32_t *kstack = (uint32_t *)kmalloc_nozero(4096);
   uint32_t *ktop = kstack + 1024;
 
   uint32_t stack_phys = (uint32_t)pmm_alloc_block();
@@ -204,62 +349,47 @@ extern "C" void create_user_process(const char *filename, char *const argv[]) {
 
   new_proc->unveils = 0;
 
-  pd_switch((uint32_t *)phys_pd);
-  vm_map_page(stack_phys, user_stack_virt, 7);
-  vm_map_page((uint32_t)pmm_alloc_block(), user_stack_virt - 0x1000, 7);
-  vm_map_page((uint32_t)pmm_alloc_block(), user_stack_virt + 0x1000, 7);
-  pd_switch((uint32_t *)phys_old_pd);
+  uint32_t *pd = (uint32_t *)phys_pd;
+  vm_map_page_pd(pd, stack_phys, user_stack_virt, 7);
+  vm_map_page_pd(pd, (uint32_t)pmm_alloc_block(), user_stack_virt - 0x1000, 7);
+  vm_map_page_pd(pd, (uint32_t)pmm_alloc_block(), user_stack_virt + 0x1000, 7);
 
   new_proc->entry_point = entry;
   new_proc->user_stack_top = user_stack_virt + 4096;
 
-  // Copy argv to stack
-  uint32_t *old_stack_pd = current_process->page_directory;
-  current_process->page_directory = (uint32_t *)phys_pd;
-  pd_switch((uint32_t *)phys_pd);
-
-  uint32_t *ustack = (uint32_t *)new_proc->user_stack_top;
-  // ... (argc/argv copy logic)
+  // Copy argv to stack - naye PD ke frames mein, kernel mapping se
+  uint32_t ustack = new_proc->user_stack_top;
   int argc = 0;
   if (argv) {
     while (argv[argc])
       argc++;
   }
 
-  // Copy strings first
-  uint32_t arg_ptrs[16]; // Max 16 args
-  if (argc > 16)
+  // argc, argv, argv[0..argc-1], NULL - user stack pe isi kram mein
+  uint32_t frame[2 + 16 + 1];
+  if (argc > 16) // Max 16 args
     argc = 16;
 
+  // Copy strings first
   for (int i = argc - 1; i >= 0; i--) {
     int len = strlen(argv[i]) + 1;
-    ustack = (uint32_t *)((uint32_t)ustack - len);
-    memcpy(ustack, argv[i], len);
-    arg_ptrs[i] = (uint32_t)ustack;
+    ustack -= len;
+    vm_copy_to_pd(pd, ustack, argv[i], len);
+    frame[2 + i] = ustack;
   }
+  frame[2 + argc] = 0; // null terminator
 
   // Align stack
-  ustack = (uint32_t *)((uint32_t)ustack & ~3);
-
-  // Pointers to strings (argv array)
-  ustack -= (argc + 1);
-  uint32_t argv_base = (uint32_t)ustack;
-  for (int i = 0; i < argc; i++) {
-    ustack[i] = arg_ptrs[i];
-  }
-  ustack[argc] = 0; // null terminator
-
-  // argc, argv
-  ustack -= 1;
-  *ustack = argv_base;
-  ustack -= 1;
-  *ustack = (uint32_t)argc;
+  ustack &= ~3;
 
-  new_proc->user_stack_top = (uint32_t)ustack;
+  // Pointers to strings (argv array), phir argc, argv
+  ustack -= (argc + 1) * 4;
+  frame[1] = ustack;
+  frame[0] = (uint32_t)argc;
+  ustack -= 2 * 4;
+  vm_copy_to_pd(pd, ustack, frame, (argc + 3) * 4);
 
-  // Restore parent PD
-  current_process->page_directory = old_stack_pd;
-  pd_switch((uint32_t *)phys_old_pd);
+  new_proc->user_stack_top = ustack;
 
   *(--ktop) = (uint32_t)new_proc->user_stack_top;
   *(--ktop) = (uint32_t)entry;
@@ -270,80 +400,106 @@ extern "C" void create_user_process(const char *filename, char *const argv[]) {
   *(--ktop) = 0;
   *(--ktop) = 0;
   *(--ktop) = 0;
-  *(--ktop) = 0x0202;
+  *(--ktop) = 0x0002; // IF=0 jab tak schedule_tail, iret khud kholega
 
   new_proc->esp = (uint32_t)ktop;
   new_proc->kernel_stack_top = (uint32_t)kstack + 4096;
 
-  new_proc->next = current_process->next;
-  current_process->next = new_proc;
+  new_proc->priority = DEFAULT_PRIORITY;
+  new_proc->time_slice = DEFAULT_TIME_SLICE;
+  new_proc->time_remaining = DEFAULT_TIME_SLICE;
 
-  serial_log("SCHED: User Process ready hai.");
+  process_link(new_proc, 0);
 
-  // Restore interrupts
-  if (eflags & 0x200)
-    asm volatile("sti");
+  serial_log("SCHED: User Process ready hai.");
 }
 
 void schedule() {
-  // Ab kaunsa process chalega?
+  // Ab kaunsa process chalega? Faisla sched_pick_next ka - is CPU ki O(1)
+  // PRIO queue ya fair tree, chahe kitne bhi processes soye ya blocked hon
   if (!current_process)
     return;
-
-  if (current_process->state == PROCESS_RUNNING) {
-    current_process->time_remaining--;
-    if (current_process->time_remaining > 0) {
-      process_t *p = current_process->next;
-      int found_higher = 0;
-      while (p != current_process) {
-        if (p->state == PROCESS_READY &&
-            p->priority < current_process->priority) {
-          found_higher = 1;
-          break;
-        }
-        p = p->next;
-      }
-      if (!found_higher)
-        return;
-    }
+  if (preempt_count()) {
+    // Spinlock pakad ke so rahe hain - agla task bhi preempt nahi hoga
+    serial_log_hex("SCHED: Scheduling while atomic! preempt_count: ",
+                   preempt_count());
   }
 
-  process_t *old = current_process;
-  process_t *best = 0;
-  process_t *p = old->next;
-
-  do {
-    if (p->state == PROCESS_READY ||
-        (p == old && old->state == PROCESS_RUNNING)) {
-      if (!best || p->priority < best->priority)
-        best = p;
-    }
-    p = p->next;
-  } while (p != old->next);
+  uint32_t eflags = local_irq_save();
+  runqueue_t *rq = this_rq();
+  spin_lock(&rq->lock);
 
-  if (!best)
-    return;
-  if (best == old && old->state == PROCESS_RUNNING) {
-    current_process->time_remaining = current_process->time_slice;
+  process_t *old = current_process;
+  process_t *next = sched_pick_next(rq, old);
+  if (!next || next == old) {
+    if (next)
+      old->state = PROCESS_RUNNING; // Block hone se pehle hi jag gaya tha
+    spin_unlock(&rq->lock);
+    local_irq_restore(eflags);
     return;
   }
 
-  if (old->state == PROCESS_RUNNING)
-    old->state = PROCESS_READY;
-
-  current_process = best;
-  current_process->state = PROCESS_RUNNING;
-  current_process->time_remaining = current_process->time_slice;
+  next->state = PROCESS_RUNNING;
+  next->on_cpu = 1;
+  set_current(next);
+  // old queue pe wapas ho sakta hai, par on_cpu tab tak 1 jab tak hum uske
+  // stack se utar na jaayein (next ka schedule_tail) - tab tak koi aur CPU
+  // use na churaaye, na reap kare
+  this_cpu()->prev = old;
+  // Big kernel lock switch ke paar nahi jaata - next apni gehraai khud
+  // wapas lega (ya seedha user mode mein jaayega)
+  int depth = release_kernel_lock();
+  spin_unlock(&rq->lock);
 
   // Konsa process chal raha hai, console pe dekh lo debugging ke liye
-  // if (current_process->id != old->id) {
-  //   serial_log_hex("SCHED: Switching to PID ", current_process->id);
+  // if (next->id != old->id) {
+  //   serial_log_hex("SCHED: Switching to PID ", next->id);
   // }
 
-  set_kernel_stack(current_process->kernel_stack_top);
+  set_kernel_stack(next->kernel_stack_top);
+  fpu_switch_to(old, next);
+
+  switch_task(&old->esp, next->esp, (uint32_t)next->page_directory);
+  // old phir chal raha hai - shayad kisi aur CPU pe
+  schedule_tail();
+  reacquire_kernel_lock(depth);
+  local_irq_restore(eflags);
+}
+
+void schedule_tail() {
+  cpu_t *cpu = this_cpu();
+  process_t *prev = cpu->prev;
+  cpu->prev = 0;
+  if (prev) {
+    asm volatile("" ::: "memory"); // prev ke stack ka kaam khatam
+    prev->on_cpu = 0;
+  }
+}
+
+void schedule_yield() {
+  if (!current_process)
+    return;
+  current_process->sched_yield = 1;
+  schedule();
+}
+
+static void sleep_timeout(ktimer_t *timer) {
+  process_t *p = (process_t *)timer->data;
+  if (p->state == PROCESS_SLEEPING)
+    sched_wakeup(p);
+}
 
-  switch_task(&old->esp, current_process->esp,
-              (uint32_t)current_process->page_directory);
+void process_sleep(uint32_t ticks) {
+  process_t *p = current_process;
+  // Timer arm hone se pehle IRQ na aaye, warna wakeup chhoot jaaye
+  uint32_t eflags = local_irq_save();
+  p->sleep_until = tick + ticks;
+  p->state = PROCESS_SLEEPING;
+  timer_setup(&p->sleep_timer, sleep_timeout, p);
+  timer_add(&p->sleep_timer, p->sleep_until);
+  schedule();
+  timer_del(&p->sleep_timer); // Signal ne jaldi jagaaya ho to
+  local_irq_restore(eflags);
 }
 
 void enter_user_mode() {
@@ -372,16 +528,14 @@ void enter_user_mode() {
 int get_pid() { return current_process ? current_process->id : -1; }
 
 int fork_process(registers_t *parent_regs) {
-  asm volatile("cli");
-
+  // Interrupts khule - page table copy lamba hai. Frame refs pmm_lock ke
+  // neeche, aur child list pe sabse aakhir mein judta hai.
   uint32_t phys_new_pd = (uint32_t)pd_clone(current_process->page_directory);
-  if (!phys_new_pd) {
-    asm volatile("sti");
+  if (!phys_new_pd)
     return -1;
-  }
 
-  process_t *child = (process_t *)kmalloc(sizeof(process_t));
-  child->id = next_pid++;
+  process_t *child = (process_t *)kmem_cache_alloc(process_cache);
+  child->id = alloc_pid();
   child->state = PROCESS_READY;
   child->parent = current_process;
   child->exit_code = 0;
@@ -389,8 +543,15 @@ int fork_process(registers_t *parent_regs) {
   child->entry_point = current_process->entry_point;
   child->user_stack_top = current_process->user_stack_top;
   child->heap_end = current_process->heap_end;
+  elf_image_copy(&child->image, &current_process->image);
+  child->vmas = current_process->vmas;
   strcpy(child->cwd, current_process->cwd);
+  strcpy(child->name, current_process->name);
   child->pledges = current_process->pledges;
+  child->priority = current_process->priority;
+  child->time_slice = current_process->time_slice;
+  child->time_remaining = current_process->time_slice;
+  fpu_fork(child, current_process);
 
   for (int i = 0; i < MAX_PROCESS_FILES; i++) {
     child->fd_table[i] = current_process->fd_table[i];
@@ -398,7 +559,7 @@ int fork_process(registers_t *parent_regs) {
       child->fd_table[i]->ref_count++;
   }
 
-  uint32_t *child_kstack = (uint32_t *)kmalloc(4096);
+  uint32_t *child_kstack = (uint32_t *)kmalloc_nozero(4096);
   child->kernel_stack_top = (uint32_t)child_kstack + 4096;
 
   uint32_t *stack_ptr = (uint32_t *)(child->kernel_stack_top);
@@ -426,19 +587,16 @@ int fork_process(registers_t *parent_regs) {
   *(--stack_ptr) = 0;
   *(--stack_ptr) = 0;
   *(--stack_ptr) = 0;
-  *(--stack_ptr) = 0x0202;
+  *(--stack_ptr) = 0x0002; // IF=0 jab tak schedule_tail, iret khud kholega
 
   serial_log_hex("PROC: Forked child PID ", child->id);
   child->esp = (uint32_t)stack_ptr;
-  child->next = current_process->next;
-  current_process->next = child;
-
-  asm volatile("sti");
+  process_link(child, 1);
   return child->id;
 }
 
 void exit_process(int status) {
-  asm volatile("cli");
+  local_irq_disable(); // Wapas nahi aana - schedule() hi aage le jaayega
   current_process->state = PROCESS_ZOMBIE;
   current_process->exit_code = (uint32_t)status;
   for (int i = 0; i < MAX_PROCESS_FILES; i++) {
@@ -453,62 +611,67 @@ void exit_process(int status) {
       }
     }
   }
-  if (current_process->parent)
+  elf_image_release(&current_process->image);
+  fpu_release(current_process);
+  uring_release(current_process);
+  // Parent doosre CPU pe reap karke process_t free kar sakta hai - koi
+  // callback (alarm/sleep/wq timeout) us waqt bhi chal raha na ho
+  timer_del_sync(&current_process->alarm_timer);
+  timer_del_sync(&current_process->sleep_timer);
+  if (current_process->parent) {
     sys_kill(current_process->parent->id, SIGCHLD);
+    wake_up_all(&current_process->parent->child_wait);
+  }
   schedule();
 }
 
 int wait_process(int *status) {
+  wait_queue_entry_t wait;
+  init_wait_entry(&wait, 0);
   while (true) {
-    asm volatile("cli");
+    // Pehle queue pe, phir scan - scan ke baad exit hua bachcha bhi hamein
+    // jagaayega. Free lock ke bahar (heap apne locks leta hai).
+    uint32_t eflags = prepare_to_wait(&current_process->child_wait, &wait);
+    spin_lock(&tasklist_lock);
     process_t *child = 0;
+    bool has_children = false;
     process_t *p = ready_queue;
     do {
-      if (p->parent == current_process && p->state == PROCESS_ZOMBIE) {
-        child = p;
-        break;
+      if (p->parent == current_process) {
+        has_children = true;
+        if (p->state == PROCESS_ZOMBIE) {
+          child = p;
+          break;
+        }
       }
       p = p->next;
     } while (p != ready_queue);
 
+    if (child)
+      __process_unlink(child);
+    spin_unlock(&tasklist_lock);
+
     if (child) {
+      finish_wait(&current_process->child_wait, &wait, eflags);
       uint32_t pid = child->id;
       if (status)
         *status = child->exit_code;
-      if (child->next == child)
-        ready_queue = 0;
-      else {
-        process_t *curr = ready_queue;
-        while (curr->next != child)
-          curr = curr->next;
-        curr->next = child->next;
-        if (ready_queue == child)
-          ready_queue = child->next;
-      }
+      wait_task_off_cpu(child);
+      sched_dequeue(child);
       kfree((void *)(child->kernel_stack_top - 4096));
       pd_destroy(child->page_directory);
-      kfree(child);
-      asm volatile("sti");
+      fpu_release(child);
+      kmem_cache_free(process_cache, child);
       return (int)pid;
     }
 
-    bool has_children = false;
-    p = ready_queue;
-    do {
-      if (p->parent == current_process) {
-        has_children = true;
-        break;
-      }
-      p = p->next;
-    } while (p != ready_queue);
-
     if (!has_children) {
-      asm volatile("sti");
+      finish_wait(&current_process->child_wait, &wait, eflags);
       return -1;
     }
-    current_process->state = PROCESS_WAITING;
-    asm volatile("sti");
+    // Sirf apne bachche ke exit pe jaago, har process ke nahi
     schedule();
+    finish_wait(&current_process->child_wait, &wait, eflags);
   }
 }
 
@@ -527,6 +690,9 @@ int exec_process(registers_t *regs, const char *path, char *const argv[],
   }
 
   vm_clear_user_mappings();
+  vma_clear(&current_process->vmas);
+  elf_image_release(&current_process->image);
+  uring_release(current_process); // Region upar VMA ke saath gaya
   uint32_t top_addr = 0;
   uint32_t entry = 0;
 
@@ -537,9 +703,9 @@ int exec_process(registers_t *regs, const char *path, char *const argv[],
     vfs_read(node, 0, magic, 4);
     if (magic[0] == 0x7F && magic[1] == 'E' && magic[2] == 'L' &&
         magic[3] == 'F') {
-      entry = load_elf(kernel_path, &top_addr);
+      entry = load_elf(kernel_path, &top_addr, &current_process->image);
     } else if (magic[0] == 'M' && magic[1] == 'Z') {
-      entry = load_pe(kernel_path, &top_addr);
+      entry = load_pe(kernel_path, &top_addr, current_process->page_directory);
     } else {
       serial_log("EXEC: Unknown format.");
     }
@@ -560,7 +726,10 @@ int exec_process(registers_t *regs, const char *path, char *const argv[],
   current_process->entry_point = entry;
   current_process->user_stack_top = user_stack_virt + 4096;
   current_process->heap_end = top_addr;
+  register_exec_vmas(current_process);
   current_process->pledges = PLEDGE_ALL; // Reset pledges for new exec
+  process_set_name(current_process, kernel_path);
+  fpu_release(current_process);           // Naya program saaf FPU state se
   regs->eip = entry;
   regs->useresp = current_process->user_stack_top;
 
@@ -578,14 +747,20 @@ int exec_process(registers_t *regs, const char *path, char *const argv[],
 
 int sys_waitpid(int pid, int *status, int options) {
   bool nohang = (options & WNOHANG) != 0;
+  wait_queue_entry_t wait;
+  init_wait_entry(&wait, 0);
 
   while (true) {
-    asm volatile("cli");
+    // wait_process jaisa: queue pe pehle, scan tasklist_lock mein
+    uint32_t eflags = prepare_to_wait(&current_process->child_wait, &wait);
+    spin_lock(&tasklist_lock);
     process_t *found = 0;
+    bool has_children = false;
     process_t *p = ready_queue;
 
     if (!p) {
-      asm volatile("sti");
+      spin_unlock(&tasklist_lock);
+      finish_wait(&current_process->child_wait, &wait, eflags);
       return -1; // No processes
     }
 
@@ -608,15 +783,24 @@ int sys_waitpid(int pid, int *status, int options) {
         matches = (p->parent == current_process && p->id == (uint32_t)pid);
       }
 
-      if (matches && p->state == PROCESS_ZOMBIE) {
-        found = p;
-        break;
+      if (matches) {
+        has_children = true;
+        if (p->state == PROCESS_ZOMBIE) {
+          found = p;
+          break;
+        }
       }
 
       p = p->next;
     } while (p != start);
 
+    // Remove from process list
+    if (found)
+      __process_unlink(found);
+    spin_unlock(&tasklist_lock);
+
     if (found) {
+      finish_wait(&current_process->child_wait, &wait, eflags);
       uint32_t child_pid = found->id;
 
       // Return status: exit code in upper 8 bits
@@ -627,72 +811,29 @@ int sys_waitpid(int pid, int *status, int options) {
       current_process->cutime += found->utime + found->cutime;
       current_process->cstime += found->stime + found->cstime;
 
-      // Remove from process list
-      if (found->next == found) {
-        ready_queue = 0;
-      } else {
-        process_t *curr = ready_queue;
-        while (curr->next != found)
-          curr = curr->next;
-        curr->next = found->next;
-        if (ready_queue == found)
-          ready_queue = found->next;
-      }
-
       // Free resources
+      wait_task_off_cpu(found);
+      sched_dequeue(found);
       kfree((void *)(found->kernel_stack_top - 4096));
       pd_destroy(found->page_directory);
-      kfree(found);
-
-      asm volatile("sti");
+      fpu_release(found);
+      kmem_cache_free(process_cache, found);
       return (int)child_pid;
     }
 
-    // Check if we have any matching children
-    bool has_children = false;
-    p = ready_queue;
-    do {
-      bool matches = false;
-      // The following lines were incorrectly placed here in the original diff.
-      // They seem to be part of an ICMP packet processing logic.
-      // int ip_hdr_len = (ip->ver_ihl & 0x0F) * 4;
-      // int icmp_total_len = htons(ip->len) - ip_hdr_len;
-      // if (icmp_total_len < (int)sizeof(icmp_hdr))
-      //   return;
-      // int icmp_data_len = icmp_total_len - sizeof(icmp_hdr);
-      // if (payload_len < (int)sizeof(icmp_hdr))
-      //   return;
-      // int icmp_data_len = payload_len - sizeof(icmp_hdr);
-      if (pid == -1) {
-        matches = (p->parent == current_process);
-      } else if (pid == 0) {
-        matches =
-            (p->parent == current_process && p->pgid == current_process->pgid);
-      } else if (pid < -1) {
-        matches = (p->parent == current_process && p->pgid == (uint32_t)(-pid));
-      } else {
-        matches = (p->parent == current_process && p->id == (uint32_t)pid);
-      }
-      if (matches) {
-        has_children = true;
-        break;
-      }
-      p = p->next;
-    } while (p != start);
-
     if (!has_children) {
-      asm volatile("sti");
+      finish_wait(&current_process->child_wait, &wait, eflags);
       return -10; // ECHILD
     }
 
     if (nohang) {
-      asm volatile("sti");
+      finish_wait(&current_process->child_wait, &wait, eflags);
       return 0; // No child exited yet
     }
 
-    current_process->state = PROCESS_WAITING;
-    asm volatile("sti");
+    // Sirf apne bachche ke exit pe jaago, har process ke nahi
     schedule();
+    finish_wait(&current_process->child_wait, &wait, eflags);
   }
 }
 
@@ -751,14 +892,16 @@ int sys_waitid(int idtype, int id, void *infop, int options) {
 // ============================================================================
 
 void sys__exit(int status) {
-  asm volatile("cli");
+  local_irq_disable();
 
   current_process->state = PROCESS_ZOMBIE;
   current_process->exit_code = (uint32_t)status;
 
   // Send SIGCHLD to parent
-  if (current_process->parent)
+  if (current_process->parent) {
     sys_kill(current_process->parent->id, SIGCHLD);
+    wake_up_all(&current_process->parent->child_wait);
+  }
 
   // No file descriptor cleanup - that's the difference from exit()
   schedule();
@@ -773,7 +916,14 @@ void sys__exit(int status) {
 // Returns: Previous alarm remaining seconds (0 if none)
 // ============================================================================
 
-extern uint32_t tick;
+// Alarm bajaa: SIGALRM pending, aur blocked/soya ho to jagao
+static void alarm_timeout(ktimer_t *timer) {
+  process_t *p = (process_t *)timer->data;
+  p->pending_signals |= ((sigset_t)1 << SIGALRM);
+  p->alarm_time = 0;
+  if (p->state == PROCESS_WAITING || p->state == PROCESS_SLEEPING)
+    sched_wakeup(p);
+}
 
 uint32_t sys_alarm(uint32_t seconds) {
   if (!current_process)
@@ -784,43 +934,24 @@ uint32_t sys_alarm(uint32_t seconds) {
 
   // Calculate remaining time from old alarm
   if (old_alarm > 0 && old_alarm > tick) {
-    old_remaining = (old_alarm - tick) / 100; // Assuming 100Hz timer
+    old_remaining = (old_alarm - tick) / TIMER_HZ;
   }
 
   // Set new alarm
   if (seconds == 0) {
     current_process->alarm_time = 0; // Cancel alarm
+    timer_del(&current_process->alarm_timer);
   } else {
-    current_process->alarm_time = tick + (seconds * 100); // 100Hz timer
+    current_process->alarm_time = tick + seconds * TIMER_HZ;
+    if (!timer_pending(&current_process->alarm_timer))
+      timer_setup(&current_process->alarm_timer, alarm_timeout,
+                  current_process);
+    mod_timer(&current_process->alarm_timer, current_process->alarm_time);
   }
 
   return old_remaining;
 }
 
-// ============================================================================
-// check_process_alarms - Called from timer interrupt
-// ============================================================================
-
-void check_process_alarms(void) {
-  if (!ready_queue)
-    return;
-
-  process_t *p = ready_queue;
-  process_t *start = p;
-  do {
-    if (p->alarm_time > 0 && tick >= p->alarm_time) {
-      // Alarm expired - send SIGALRM
-      p->pending_signals |= ((sigset_t)1 << SIGALRM);
-      p->alarm_time = 0;
-
-      // Wake up if sleeping
-      if (p->state == PROCESS_WAITING || p->state == PROCESS_SLEEPING)
-        p->state = PROCESS_READY;
-    }
-    p = p->next;
-  } while (p && p != start);
-}
-
 // ============================================================================
 // sys_posix_spawn - Spawn new process (simplified fork+exec)
 // ============================================================================
@@ -840,35 +971,39 @@ int sys_posix_spawn(int *pid_out, const char *path, void *file_actions,
   if (!phys_pd)
     return -12; // ENOMEM
 
-  uint32_t phys_old_pd;
-  asm volatile("mov %%cr3, %0" : "=r"(phys_old_pd));
-
-  pd_switch((uint32_t *)phys_pd);
-
+  // load_elf sirf headers padhta hai, pages pehle fault pe naye PD mein
+  // aate hain - parent ka PD/CR3 chhedne ki zaroorat nahi (path bhi parent
+  // ki memory mein hai)
   uint32_t top_addr = 0;
-  uint32_t entry = load_elf(path, &top_addr);
-
-  pd_switch((uint32_t *)phys_old_pd);
+  elf_image_t image;
+  image.node = 0;
+  image.count = 0;
+  uint32_t entry = load_elf(path, &top_addr, &image);
 
   if (entry == 0) {
+    elf_image_release(&image); // Headers theek the to node ka ref liya tha
     pd_destroy((uint32_t *)phys_pd);
     return -2; // ENOENT
   }
 
-  process_t *new_proc = (process_t *)kmalloc(sizeof(process_t));
+  process_t *new_proc = (process_t *)kmem_cache_alloc(process_cache);
   if (!new_proc) {
+    elf_image_release(&image);
     pd_destroy((uint32_t *)phys_pd);
     return -12; // ENOMEM
   }
 
   // Initialize new process
-  new_proc->id = next_pid++;
+  new_proc->id = alloc_pid();
   new_proc->state = PROCESS_READY;
   new_proc->parent = current_process;
   new_proc->exit_code = 0;
   new_proc->page_directory = (uint32_t *)phys_pd;
   new_proc->heap_end = top_addr;
+  new_proc->image = image;
+  register_exec_vmas(new_proc);
   new_proc->pledges = PLEDGE_ALL;
+  process_set_name(new_proc, path);
   new_proc->pgid = current_process->pgid;
   new_proc->sid = current_process->sid;
 
@@ -909,16 +1044,15 @@ int sys_posix_spawn(int *pid_out, const char *path, void *file_actions,
   new_proc->unveils = 0;
 
   // Allocate kernel stack
-  uint32_t *kstack = (uint32_t *)kmalloc(4096);
+  uint32_t *kstack = (uint32_t *)kmalloc_nozero(4096);
   new_proc->kernel_stack_top = (uint32_t)kstack + 4096;
 
-  // Allocate user stack
-  pd_switch((uint32_t *)phys_pd);
+  // Allocate user stack - seedha naye PD mein
+  uint32_t *pd = (uint32_t *)phys_pd;
   uint32_t user_stack_virt = 0xB0000000;
-  vm_map_page((uint32_t)pmm_alloc_block(), user_stack_virt, 7);
-  vm_map_page((uint32_t)pmm_alloc_block(), user_stack_virt - 0x1000, 7);
-  vm_map_page((uint32_t)pmm_alloc_block(), user_stack_virt + 0x1000, 7);
-  pd_switch((uint32_t *)phys_old_pd);
+  vm_map_page_pd(pd, (uint32_t)pmm_alloc_block(), user_stack_virt, 7);
+  vm_map_page_pd(pd, (uint32_t)pmm_alloc_block(), user_stack_virt - 0x1000, 7);
+  vm_map_page_pd(pd, (uint32_t)pmm_alloc_block(), user_stack_virt + 0x1000, 7);
 
   new_proc->entry_point = entry;
   new_proc->user_stack_top = user_stack_virt + 4096;
@@ -939,8 +1073,7 @@ int sys_posix_spawn(int *pid_out, const char *path, void *file_actions,
   new_proc->esp = (uint32_t)ktop;
 
   // Add to process list
-  new_proc->next = current_process->next;
-  current_process->next = new_proc;
+  process_link(new_proc, 0);
 
   if (pid_out)
     *pid_out = new_proc->id;
@@ -5,7 +5,14 @@
 #include "../include/signal.h"
 #include "../include/types.h"
 #include "../include/vfs.h"
+#include "elf_loader.h"
+#include "ktimer.h"
 #include "paging.h"
+#include "rbtree.h"
+#include "smp.h"
+#include "spinlock.h"
+#include "vma.h"
+#include "wait_queue.h"
 
 #define MAX_PROCESS_FILES 16
 #define DEFAULT_TIME_SLICE 10 // 10 timer ticks (~100ms at 100Hz)
@@ -33,13 +40,18 @@ typedef struct process {
   process_state_t state;     // Current state
   uint32_t exit_code;        // Exit code (for ZOMBIE state)
   struct process *parent;    // Parent process
+  wait_queue_t child_wait;   // wait/waitpid yahan sote, bachcha exit pe jagata
   uint32_t esp;              // Stack Pointer (Kernel Stack)
   uint32_t kernel_stack_top; // Top of kernel stack for TSS
   uint32_t *page_directory;  // Page Directory (Physical Address)
   uint32_t entry_point;      // User mode entry point
   uint32_t user_stack_top;   // Top of user stack
   uint32_t heap_end;         // Current program break (end of heap)
+  void *fpu_state; // 512-byte FXSAVE area, pehle #NM pe lazily (fpu.cpp)
+  elf_image_t image;         // Executable ke file-backed segments
+  vma_list_t vmas;           // User address space ke areas
   file_description_t *fd_table[MAX_PROCESS_FILES]; // File Descriptor Table
+  struct uring *uring; // SQ/CQ rings (uring.cpp), 0 = SYS_URING_SETUP nahi
 
   // User/Group IDs
   uint32_t uid;  // Real user ID
@@ -54,9 +66,35 @@ typedef struct process {
   int time_slice;       // Time quantum in ticks
   int time_remaining;   // Remaining ticks before reschedule
   uint32_t sleep_until; // Tick count to wake up (for sleep)
+  ktimer_t sleep_timer; // sleep_until pe jagaata hai
+
+  // Scheduler (sched.cpp): class, queue links aur per-task stats
+  int sched_class;          // SCHED_CLASS_PRIO/FAIR/FIFO/RR
+  int nice;                 // -20..19, fair class mein weight
+  int rt_priority;          // 1..99 FIFO/RR ke liye, warna 0
+  int sched_yield;          // Agle pick pe CPU chhod do
+  int on_rq;                // Kisi run queue pe hai (sirf READY)
+  struct process *rq_next;  // PRIO class list
+  struct process *rq_prev;
+  int rq_prio;              // Jis priority list pe queued hai
+  rb_node_t fair_node;      // FAIR class tree
+  uint64_t vruntime;        // Weighted runtime (ns), tree ki key
+  uint64_t slice_exec;      // sum_exec_runtime jab ye slice shuru hua
+  uint64_t exec_start;      // sched_clock jab CPU mila / last update
+  uint64_t sum_exec_runtime; // Kul CPU time (ns)
+  uint64_t wait_start;      // sched_clock jab queue pe aaya
+  uint64_t wait_sum;        // Kul READY-par-chal-nahi-raha time (ns)
+  uint32_t nr_switches;     // Kitni baar CPU mila
+  uint64_t wake_stamp;      // sched_clock jab block se jaaga
+  uint32_t wakeup_lat_ns;   // Pichhle wakeup se CPU milne tak
+  uint32_t wakeup_lat_max_ns;
+  uint32_t cpu;          // Jis CPU ki run queue pe hai / pichhli baar chala
+  volatile int on_cpu;   // CPU pe hai - switch_task poora hone tak bhi
+  uint32_t cpus_allowed; // Kin CPUs pe chal sakta hai (bit = CPU)
 
   // Alarm timer
   uint32_t alarm_time; // Tick when SIGALRM should be sent (0 = disabled)
+  ktimer_t alarm_timer;
 
   // Signal handling
   struct sigaction signal_actions[64];
@@ -73,6 +111,7 @@ typedef struct process {
   uint32_t start_time; // Process start time (tick)
 
   char cwd[256];    // Current Working Directory
+  char name[32];    // Executable ka basename (procinfo/ps), exec pe badalta
   uint32_t pledges; // Pledges (Bitmask of allowed actions)
 
   struct unveil_node {
@@ -81,6 +120,9 @@ typedef struct process {
     struct unveil_node *next;
   } *unveils;
 
+  // Chalti syscall ka recovery point (syscall.h), bahar 0
+  struct syscall_fixup *syscall_fixup;
+
   struct process *next; // Next process in list
 } process_t;
 
@@ -94,17 +136,26 @@ typedef struct process {
 #define PLEDGE_INET 0x40 // Network
 #define PLEDGE_ALL 0xFFFFFFFF
 
-extern process_t *current_process;
+// current_process: har CPU ka apna, smp.h mein (%gs se)
 extern process_t *ready_queue;
+extern spinlock_t tasklist_lock; // ready_queue list + next_pid
+extern process_t *idle_process; // PID 0, boot context - sirf hlt
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 void init_multitasking();
-void create_kernel_thread(void (*fn)());
+process_t *create_kernel_thread(void (*fn)());
+void reap_kernel_thread(process_t *proc); // Zombie/never-run thread free karo
 void create_user_process(const char *filename, char *const argv[]);
 void schedule();
+void schedule_yield(); // Slice chhod do, barabar priority walon ko mauka
+// Naye task ka pehla kaam (switch_task ke baad): pichhle task ka on_cpu
+// saaf - ab wo migrate/reap ho sakta hai
+void schedule_tail();
+// AP ka idle task: process list mein nahi, sirf us CPU pe (smp.cpp)
+process_t *create_idle_process(uint32_t cpu);
 int get_pid();
 void enter_user_mode();
 int fork_process(registers_t *regs);
@@ -125,8 +176,9 @@ void sys__exit(int status);
 // Alarm timer
 uint32_t sys_alarm(uint32_t seconds);
 
-// Check and deliver alarms (called from timer)
-void check_process_alarms(void);
+// Current process ko ticks tak sulao. Signal/sched_wakeup pehle bhi jaga
+// sakta hai - caller tick dekh ke pata kare.
+void process_sleep(uint32_t ticks);
 
 // posix_spawn (simplified fork+exec)
 int sys_posix_spawn(int *pid, const char *path, void *file_actions, void *attrp,
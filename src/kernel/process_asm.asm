@@ -1,6 +1,7 @@
 [BITS 32]
 global switch_task
 global fork_child_return
+extern schedule_tail
 
 ; Fork child return stub - called when a forked child is first scheduled
 ; The child's stack has a registers_t frame ready for iret
@@ -9,6 +10,10 @@ global fork_child_return
 fork_child_return:
     ; At this point, ESP points to the registers_t structure
     ; We need to restore segments and registers, then iret
+
+    ; Parent ka switch poora karo (prev->on_cpu = 0). Interrupts abhi band
+    ; hain (eflags 0x002), iret user ki eflags wapas laayega
+    call schedule_tail
     
     ; First, restore DS from the saved value
     pop eax
@@ -8,12 +8,11 @@
 #include "../include/errno.h"
 #include "../include/signal.h"
 #include "../include/string.h"
+#include "futex.h"
 #include "heap.h"
 #include "memory.h"
 #include "process.h"
 
-extern void create_kernel_thread(void (*fn)());
-
 extern "C" {
 
 // ============================================================================
@@ -211,6 +210,7 @@ void pthread_exit(void *retval) {
 
   t->retval = retval;
   t->exited = 1;
+  futex_wake((volatile uint32_t *)&t->exited, 0x7FFFFFFF);
 
   // Call TSD destructors
   for (int i = 0; i < MAX_TSD_KEYS; i++) {
@@ -252,10 +252,9 @@ int pthread_join(pthread_t thread, void **retval) {
 
   t->joined = 1;
 
-  // Wait for thread to exit
-  while (!t->exited) {
-    schedule();
-  }
+  // Wait for thread to exit - exited word pe so, pthread_exit jagata hai
+  while (!t->exited)
+    futex_wait((volatile uint32_t *)&t->exited, 0, 0);
 
   if (retval)
     *retval = t->retval;
@@ -445,6 +444,9 @@ int pthread_attr_getstackaddr(const pthread_attr_t *attr, void **stackaddr) {
 int pthread_attr_setschedpolicy(pthread_attr_t *attr, int policy) {
   if (!attr)
     return EINVAL;
+  // Scheduler sirf yehi teen jaanta hai (sched.h: FIFO/RR = RT classes)
+  if (policy != SCHED_OTHER && policy != SCHED_FIFO && policy != SCHED_RR)
+    return ENOTSUP;
 
   attr->schedpolicy = policy;
   return 0;
@@ -458,6 +460,27 @@ int pthread_attr_getschedpolicy(const pthread_attr_t *attr, int *policy) {
   return 0;
 }
 
+int pthread_attr_setschedparam(pthread_attr_t *attr,
+                               const struct sched_param *param) {
+  if (!attr || !param)
+    return EINVAL;
+  // RT policies 1-99, SCHED_OTHER ke liye 0
+  if (param->sched_priority < 0 || param->sched_priority > 99)
+    return EINVAL;
+
+  attr->schedpriority = param->sched_priority;
+  return 0;
+}
+
+int pthread_attr_getschedparam(const pthread_attr_t *attr,
+                               struct sched_param *param) {
+  if (!attr || !param)
+    return EINVAL;
+
+  param->sched_priority = attr->schedpriority;
+  return 0;
+}
+
 // ============================================================================
 // Mutex Functions
 // ============================================================================
@@ -472,6 +495,28 @@ static inline int atomic_cas(volatile int *ptr, int expected, int desired) {
   return result == expected;
 }
 
+// Purani value lautata hai
+static inline int atomic_xchg(volatile int *ptr, int val) {
+  asm volatile("xchgl %0, %1" : "+r"(val), "+m"(*ptr) : : "memory");
+  return val;
+}
+
+// Purani value lautata hai
+static inline int atomic_add(volatile int *ptr, int delta) {
+  asm volatile("lock xaddl %0, %1" : "+r"(delta), "+m"(*ptr) : : "memory");
+  return delta;
+}
+
+#define FUTEX_WORD(p) ((volatile uint32_t *)(p))
+#define FUTEX_WAKE_ALL 0x7FFFFFFF
+
+// Contended path: 2 likh do (unlock ko pata chale koi so raha hai) aur
+// tab tak so jab tak xchg ko 0 na mile
+static void mutex_lock_slow(pthread_mutex_t *mutex) {
+  while (atomic_xchg(&mutex->locked, 2) != 0)
+    futex_wait(FUTEX_WORD(&mutex->locked), 2, 0);
+}
+
 int pthread_mutex_init(pthread_mutex_t *mutex,
                        const pthread_mutexattr_t *attr) {
   if (!mutex)
@@ -512,11 +557,9 @@ int pthread_mutex_lock(pthread_mutex_t *mutex) {
     return EDEADLK;
   }
 
-  // Spin until we acquire the lock
-  while (!atomic_cas(&mutex->locked, 0, 1)) {
-    // Yield to other threads
-    schedule();
-  }
+  // Fast path ek CAS, contention pe futex pe so
+  if (!atomic_cas(&mutex->locked, 0, 1))
+    mutex_lock_slow(mutex);
 
   mutex->owner = self;
   mutex->recursive_count = 1;
@@ -566,7 +609,8 @@ int pthread_mutex_unlock(pthread_mutex_t *mutex) {
   }
 
   mutex->owner = 0;
-  mutex->locked = 0;
+  if (atomic_xchg(&mutex->locked, 0) == 2)
+    futex_wake(FUTEX_WORD(&mutex->locked), 1);
 
   return 0;
 }
@@ -645,20 +689,23 @@ int pthread_cond_wait(pthread_cond_t *cond, pthread_mutex_t *mutex) {
 
   cond->mutex = mutex;
   int my_signal = cond->signal_count;
-  cond->waiters = cond->waiters + 1;
+  atomic_add(&cond->waiters, 1);
 
   // Release mutex while waiting
   pthread_mutex_unlock(mutex);
 
-  // Wait for signal
-  while (cond->signal_count == my_signal) {
-    schedule();
-  }
+  // Wait for signal - beech mein signal aa gaya to futex_wait turant
+  // -EAGAIN deta hai. Spurious wakeup POSIX mein allowed hai.
+  futex_wait(FUTEX_WORD(&cond->signal_count), (uint32_t)my_signal, 0);
 
-  cond->waiters = cond->waiters - 1;
+  atomic_add(&cond->waiters, -1);
 
-  // Re-acquire mutex
-  pthread_mutex_lock(mutex);
+  // Re-acquire mutex - seedha contended state mein, kyunki broadcast ne
+  // baaki waiters mutex pe requeue kiye ho sakte hain aur unhe hamara
+  // unlock hi jagayega
+  mutex_lock_slow(mutex);
+  mutex->owner = pthread_self();
+  mutex->recursive_count = 1;
 
   return 0;
 }
@@ -673,8 +720,11 @@ int pthread_cond_signal(pthread_cond_t *cond) {
   if (!cond)
     return EINVAL;
 
-  if (cond->waiters > 0)
-    cond->signal_count = cond->signal_count + 1;
+  // Koi nahi so raha to syscall/futex ka kharcha nahi
+  if (cond->waiters > 0) {
+    atomic_add(&cond->signal_count, 1);
+    futex_wake(FUTEX_WORD(&cond->signal_count), 1);
+  }
 
   return 0;
 }
@@ -683,8 +733,17 @@ int pthread_cond_broadcast(pthread_cond_t *cond) {
   if (!cond)
     return EINVAL;
 
-  // Wake all waiters
-  cond->signal_count += cond->waiters;
+  if (cond->waiters == 0)
+    return 0;
+
+  // Wake all waiters - ek jagao, baaki seedha mutex ke futex pe (sab ek
+  // saath jaag ke mutex pe ladein, usse bachne ke liye)
+  atomic_add(&cond->signal_count, 1);
+  if (cond->mutex)
+    futex_requeue(FUTEX_WORD(&cond->signal_count), 1,
+                  FUTEX_WORD(&cond->mutex->locked), FUTEX_WAKE_ALL);
+  else
+    futex_wake(FUTEX_WORD(&cond->signal_count), FUTEX_WAKE_ALL);
 
   return 0;
 }
@@ -715,11 +774,11 @@ int pthread_rwlock_init(pthread_rwlock_t *rwlock,
   if (!rwlock)
     return EINVAL;
 
-  rwlock->readers = 0;
-  rwlock->writers = 0;
+  rwlock->state = 0;
+  rwlock->seq = 0;
+  rwlock->waiters = 0;
   rwlock->write_waiters = 0;
   rwlock->write_owner = 0;
-  pthread_mutex_init(&rwlock->lock, 0);
 
   return 0;
 }
@@ -728,28 +787,40 @@ int pthread_rwlock_destroy(pthread_rwlock_t *rwlock) {
   if (!rwlock)
     return EINVAL;
 
-  if (rwlock->readers > 0 || rwlock->writers > 0)
+  if (rwlock->state != 0)
     return EBUSY;
 
-  pthread_mutex_destroy(&rwlock->lock);
   return 0;
 }
 
+// Writer na ho aur koi writer line mein na ho to reader count badhao
+static bool rwlock_try_read(pthread_rwlock_t *rwlock) {
+  int state = rwlock->state;
+  while (state >= 0 && !rwlock->write_waiters) {
+    if (atomic_cas(&rwlock->state, state, state + 1))
+      return true;
+    state = rwlock->state;
+  }
+  return false;
+}
+
 int pthread_rwlock_rdlock(pthread_rwlock_t *rwlock) {
   if (!rwlock)
     return EINVAL;
 
-  pthread_mutex_lock(&rwlock->lock);
+  if (rwlock_try_read(rwlock))
+    return 0;
 
-  // Wait while there are writers or write waiters
-  while (rwlock->writers > 0 || rwlock->write_waiters > 0) {
-    pthread_mutex_unlock(&rwlock->lock);
-    schedule();
-    pthread_mutex_lock(&rwlock->lock);
+  // waiters pehle badhao, phir seq padho: unlock ya to hamara waiters
+  // dekhega (aur seq badhayega), ya hum uska khula state dekhenge
+  atomic_add(&rwlock->waiters, 1);
+  for (;;) {
+    int seq = rwlock->seq;
+    if (rwlock_try_read(rwlock))
+      break;
+    futex_wait(FUTEX_WORD(&rwlock->seq), (uint32_t)seq, 0);
   }
-
-  rwlock->readers = rwlock->readers + 1;
-  pthread_mutex_unlock(&rwlock->lock);
+  atomic_add(&rwlock->waiters, -1);
 
   return 0;
 }
@@ -758,39 +829,27 @@ int pthread_rwlock_tryrdlock(pthread_rwlock_t *rwlock) {
   if (!rwlock)
     return EINVAL;
 
-  if (pthread_mutex_trylock(&rwlock->lock) != 0)
-    return EBUSY;
-
-  if (rwlock->writers > 0 || rwlock->write_waiters > 0) {
-    pthread_mutex_unlock(&rwlock->lock);
-    return EBUSY;
-  }
-
-  rwlock->readers = rwlock->readers + 1;
-  pthread_mutex_unlock(&rwlock->lock);
-
-  return 0;
+  return rwlock_try_read(rwlock) ? 0 : EBUSY;
 }
 
 int pthread_rwlock_wrlock(pthread_rwlock_t *rwlock) {
   if (!rwlock)
     return EINVAL;
 
-  pthread_mutex_lock(&rwlock->lock);
-  rwlock->write_waiters = rwlock->write_waiters + 1;
-
-  // Wait while there are readers or writers
-  while (rwlock->readers > 0 || rwlock->writers > 0) {
-    pthread_mutex_unlock(&rwlock->lock);
-    schedule();
-    pthread_mutex_lock(&rwlock->lock);
+  if (!atomic_cas(&rwlock->state, 0, PTHREAD_RWLOCK_WRLOCKED)) {
+    atomic_add(&rwlock->write_waiters, 1);
+    atomic_add(&rwlock->waiters, 1);
+    for (;;) {
+      int seq = rwlock->seq;
+      if (atomic_cas(&rwlock->state, 0, PTHREAD_RWLOCK_WRLOCKED))
+        break;
+      futex_wait(FUTEX_WORD(&rwlock->seq), (uint32_t)seq, 0);
+    }
+    atomic_add(&rwlock->waiters, -1);
+    atomic_add(&rwlock->write_waiters, -1);
   }
 
-  rwlock->write_waiters = rwlock->write_waiters - 1;
-  rwlock->writers = rwlock->writers + 1;
   rwlock->write_owner = pthread_self();
-  pthread_mutex_unlock(&rwlock->lock);
-
   return 0;
 }
 
@@ -798,18 +857,10 @@ int pthread_rwlock_trywrlock(pthread_rwlock_t *rwlock) {
   if (!rwlock)
     return EINVAL;
 
-  if (pthread_mutex_trylock(&rwlock->lock) != 0)
+  if (!atomic_cas(&rwlock->state, 0, PTHREAD_RWLOCK_WRLOCKED))
     return EBUSY;
 
-  if (rwlock->readers > 0 || rwlock->writers > 0) {
-    pthread_mutex_unlock(&rwlock->lock);
-    return EBUSY;
-  }
-
-  rwlock->writers = rwlock->writers + 1;
   rwlock->write_owner = pthread_self();
-  pthread_mutex_unlock(&rwlock->lock);
-
   return 0;
 }
 
@@ -817,16 +868,21 @@ int pthread_rwlock_unlock(pthread_rwlock_t *rwlock) {
   if (!rwlock)
     return EINVAL;
 
-  pthread_mutex_lock(&rwlock->lock);
-
-  if (rwlock->writers > 0) {
-    rwlock->writers = rwlock->writers + 1;
+  int state = rwlock->state;
+  if (state == PTHREAD_RWLOCK_WRLOCKED) {
     rwlock->write_owner = 0;
-  } else if (rwlock->readers > 0) {
-    rwlock->readers--;
+    atomic_xchg(&rwlock->state, 0);
+  } else if (state > 0) {
+    if (atomic_add(&rwlock->state, -1) != 1)
+      return 0; // Aakhri reader nahi - kisi ko jagaane ki zaroorat nahi
+  } else {
+    return EPERM;
   }
 
-  pthread_mutex_unlock(&rwlock->lock);
+  if (rwlock->waiters > 0) {
+    atomic_add(&rwlock->seq, 1);
+    futex_wake(FUTEX_WORD(&rwlock->seq), FUTEX_WAKE_ALL);
+  }
 
   return 0;
 }
@@ -1015,12 +1071,12 @@ int pthread_once(pthread_once_t *once_control, void (*init_routine)(void)) {
 // Yield
 // ============================================================================
 int pthread_yield(void) {
-  schedule();
+  schedule_yield();
   return 0;
 }
 
 int sched_yield(void) {
-  schedule();
+  schedule_yield();
   return 0;
 }
 
@@ -4,6 +4,7 @@
 #include "../include/vfs.h"
 #include "heap.h"
 #include "memory.h"
+#include "slab.h"
 #include "process.h"
 
 extern "C" {
@@ -31,7 +32,7 @@ static int pty_fifo_read(pty_fifo_t *fifo, char *buf, int len, bool nonblock) {
   if (fifo->count == 0) {
     if (nonblock)
       return -11; // -EAGAIN
-    sleep_on(&fifo->wait);
+    wait_event(&fifo->wait, fifo->count > 0);
   }
   int read_bytes = 0;
   while (read_bytes < len && fifo->count > 0) {
@@ -168,7 +169,7 @@ int sys_pty_create(int *master_fd_out, int *slave_fd_out) {
   pty->slave_tty.private_data = pty;
 
   // Create VFS nodes
-  vfs_node_t *master_node = (vfs_node_t *)kmalloc(sizeof(vfs_node_t));
+  vfs_node_t *master_node = (vfs_node_t *)kmem_cache_alloc(vfs_node_cache);
   memset(master_node, 0, sizeof(vfs_node_t));
   strcpy(master_node->name, "ptm");
   itoa(pty_idx, master_node->name + 3, 10);
@@ -179,7 +180,7 @@ int sys_pty_create(int *master_fd_out, int *slave_fd_out) {
   master_node->close = pty_close;
   master_node->impl = pty;
 
-  vfs_node_t *slave_node = (vfs_node_t *)kmalloc(sizeof(vfs_node_t));
+  vfs_node_t *slave_node = (vfs_node_t *)kmem_cache_alloc(vfs_node_cache);
   memset(slave_node, 0, sizeof(vfs_node_t));
   strcpy(slave_node->name, "pts");
   itoa(pty_idx, slave_node->name + 3, 10);
@@ -213,7 +214,7 @@ int sys_pty_create(int *master_fd_out, int *slave_fd_out) {
 
   // Wrap in file_description_t
   file_description_t *mdesc =
-      (file_description_t *)kmalloc(sizeof(file_description_t));
+      (file_description_t *)kmem_cache_alloc(file_desc_cache);
   mdesc->node = master_node;
   mdesc->offset = 0;
   mdesc->flags = 3; // O_RDWR
@@ -221,7 +222,7 @@ int sys_pty_create(int *master_fd_out, int *slave_fd_out) {
   current_process->fd_table[mfd] = mdesc;
 
   file_description_t *sdesc =
-      (file_description_t *)kmalloc(sizeof(file_description_t));
+      (file_description_t *)kmem_cache_alloc(file_desc_cache);
   sdesc->node = slave_node;
   sdesc->offset = 0;
   sdesc->flags = 3; // O_RDWR
@@ -0,0 +1,205 @@
+#include "rbtree.h"
+
+static inline int rb_is_red(rb_node_t *n) { return n && n->color == RB_RED; }
+static inline int rb_is_black(rb_node_t *n) { return !rb_is_red(n); }
+
+static void rb_replace_child(rb_node_t *old, rb_node_t *new_node,
+                             rb_node_t *parent, rb_root_t *root) {
+  if (!parent)
+    root->node = new_node;
+  else if (parent->left == old)
+    parent->left = new_node;
+  else
+    parent->right = new_node;
+}
+
+static void rb_rotate_left(rb_node_t *x, rb_root_t *root) {
+  rb_node_t *y = x->right;
+  x->right = y->left;
+  if (y->left)
+    y->left->parent = x;
+  y->parent = x->parent;
+  rb_replace_child(x, y, x->parent, root);
+  y->left = x;
+  x->parent = y;
+}
+
+static void rb_rotate_right(rb_node_t *x, rb_root_t *root) {
+  rb_node_t *y = x->left;
+  x->left = y->right;
+  if (y->right)
+    y->right->parent = x;
+  y->parent = x->parent;
+  rb_replace_child(x, y, x->parent, root);
+  y->right = x;
+  x->parent = y;
+}
+
+void rb_insert_color(rb_node_t *node, rb_root_t *root) {
+  rb_node_t *parent;
+  while ((parent = node->parent) && parent->color == RB_RED) {
+    rb_node_t *gparent = parent->parent;
+    if (parent == gparent->left) {
+      rb_node_t *uncle = gparent->right;
+      if (rb_is_red(uncle)) {
+        // Uncle bhi laal: rang palto, problem do level upar
+        uncle->color = RB_BLACK;
+        parent->color = RB_BLACK;
+        gparent->color = RB_RED;
+        node = gparent;
+        continue;
+      }
+      if (node == parent->right) {
+        rb_rotate_left(parent, root);
+        node = parent;
+        parent = node->parent;
+      }
+      parent->color = RB_BLACK;
+      gparent->color = RB_RED;
+      rb_rotate_right(gparent, root);
+    } else {
+      rb_node_t *uncle = gparent->left;
+      if (rb_is_red(uncle)) {
+        uncle->color = RB_BLACK;
+        parent->color = RB_BLACK;
+        gparent->color = RB_RED;
+        node = gparent;
+        continue;
+      }
+      if (node == parent->left) {
+        rb_rotate_right(parent, root);
+        node = parent;
+        parent = node->parent;
+      }
+      parent->color = RB_BLACK;
+      gparent->color = RB_RED;
+      rb_rotate_left(gparent, root);
+    }
+  }
+  root->node->color = RB_BLACK;
+}
+
+// Black node hatne ke baad x (shayad NULL) ki jagah ek "extra black" fix karo
+static void rb_erase_fixup(rb_node_t *x, rb_node_t *parent, rb_root_t *root) {
+  while (x != root->node && rb_is_black(x)) {
+    if (x == parent->left) {
+      rb_node_t *w = parent->right;
+      if (rb_is_red(w)) {
+        w->color = RB_BLACK;
+        parent->color = RB_RED;
+        rb_rotate_left(parent, root);
+        w = parent->right;
+      }
+      if (rb_is_black(w->left) && rb_is_black(w->right)) {
+        w->color = RB_RED;
+        x = parent;
+        parent = x->parent;
+      } else {
+        if (rb_is_black(w->right)) {
+          w->left->color = RB_BLACK;
+          w->color = RB_RED;
+          rb_rotate_right(w, root);
+          w = parent->right;
+        }
+        w->color = parent->color;
+        parent->color = RB_BLACK;
+        if (w->right)
+          w->right->color = RB_BLACK;
+        rb_rotate_left(parent, root);
+        x = root->node;
+        break;
+      }
+    } else {
+      rb_node_t *w = parent->left;
+      if (rb_is_red(w)) {
+        w->color = RB_BLACK;
+        parent->color = RB_RED;
+        rb_rotate_right(parent, root);
+        w = parent->left;
+      }
+      if (rb_is_black(w->right) && rb_is_black(w->left)) {
+        w->color = RB_RED;
+        x = parent;
+        parent = x->parent;
+      } else {
+        if (rb_is_black(w->left)) {
+          w->right->color = RB_BLACK;
+          w->color = RB_RED;
+          rb_rotate_left(w, root);
+          w = parent->left;
+        }
+        w->color = parent->color;
+        parent->color = RB_BLACK;
+        if (w->left)
+          w->left->color = RB_BLACK;
+        rb_rotate_right(parent, root);
+        x = root->node;
+        break;
+      }
+    }
+  }
+  if (x)
+    x->color = RB_BLACK;
+}
+
+void rb_erase(rb_node_t *node, rb_root_t *root) {
+  rb_node_t *child, *parent;
+  int color;
+
+  if (node->left && node->right) {
+    // Do bachche: in-order successor node ki jagah lega
+    rb_node_t *succ = node->right;
+    while (succ->left)
+      succ = succ->left;
+
+    child = succ->right;
+    color = succ->color;
+    if (succ->parent == node) {
+      parent = succ;
+    } else {
+      parent = succ->parent;
+      parent->left = child;
+      if (child)
+        child->parent = parent;
+      succ->right = node->right;
+      node->right->parent = succ;
+    }
+    succ->left = node->left;
+    node->left->parent = succ;
+    succ->parent = node->parent;
+    succ->color = node->color;
+    rb_replace_child(node, succ, node->parent, root);
+  } else {
+    child = node->left ? node->left : node->right;
+    parent = node->parent;
+    color = node->color;
+    if (child)
+      child->parent = parent;
+    rb_replace_child(node, child, parent, root);
+  }
+
+  if (color == RB_BLACK)
+    rb_erase_fixup(child, parent, root);
+}
+
+rb_node_t *rb_first(const rb_root_t *root) {
+  rb_node_t *n = root->node;
+  if (!n)
+    return 0;
+  while (n->left)
+    n = n->left;
+  return n;
+}
+
+rb_node_t *rb_next(const rb_node_t *node) {
+  if (node->right) {
+    node = node->right;
+    while (node->left)
+      node = node->left;
+    return (rb_node_t *)node;
+  }
+  rb_node_t *parent;
+  while ((parent = node->parent) && node == parent->right)
+    node = parent;
+  return parent;
+}
@@ -0,0 +1,48 @@
+#ifndef RBTREE_H
+#define RBTREE_H
+
+#include "../include/types.h"
+
+// Intrusive red-black tree (Linux jaisa): node struct ke andar embed hota
+// hai, caller khud compare karke rb_link_node se jagah dhoondta hai, phir
+// rb_insert_color tree ko balance karta hai. Koi allocation nahi.
+
+#define RB_RED 0
+#define RB_BLACK 1
+
+typedef struct rb_node {
+  struct rb_node *parent;
+  struct rb_node *left;
+  struct rb_node *right;
+  int color;
+} rb_node_t;
+
+typedef struct rb_root {
+  rb_node_t *node;
+} rb_root_t;
+
+#define rb_entry(ptr, type, member)                                            \
+  ((type *)((char *)(ptr) - __builtin_offsetof(type, member)))
+
+static inline void rb_link_node(rb_node_t *node, rb_node_t *parent,
+                                rb_node_t **link) {
+  node->parent = parent;
+  node->left = node->right = 0;
+  node->color = RB_RED;
+  *link = node;
+}
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void rb_insert_color(rb_node_t *node, rb_root_t *root);
+void rb_erase(rb_node_t *node, rb_root_t *root);
+rb_node_t *rb_first(const rb_root_t *root);
+rb_node_t *rb_next(const rb_node_t *node);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
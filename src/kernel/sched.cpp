@@ -0,0 +1,1022 @@
+#include "sched.h"
+#include "../drivers/hpet.h"
+#include "../drivers/serial.h"
+#include "../include/errno.h"
+#include "clockevent.h"
+#include "clocksource.h"
+#include "smp.h"
+#include "tsc.h"
+
+// Har CPU ki run queue; rq->lock uske fair, rt aur stat ko bhi bachata hai.
+// Do queues ek saath (stealing) hamesha address order mein.
+runqueue_t runqueues[SMP_MAX_CPUS];
+uint32_t avenrun[3];
+
+static void __sched_dequeue(runqueue_t *rq, process_t *p);
+
+// Clock: clocksource (TSC ya HPET) se ns
+uint64_t sched_clock_ns() { return clocksource_ns(); }
+
+static inline int sched_rt(process_t *p) {
+  return p->sched_class == SCHED_CLASS_FIFO || p->sched_class == SCHED_CLASS_RR;
+}
+
+// Saari classes ko ek line mein rakhne ke liye: PRIO/RT task = priority * 2
+// (RT ki priority 0-98, to hamesha sabse aage), poori fair class =
+// SCHED_FAIR_PRIO * 2 - 1 (barabar priority ke PRIO tasks se thoda aage).
+// Kam rank = pehle chalega.
+static inline int sched_rank(process_t *p) {
+  if (p->sched_class == SCHED_CLASS_FAIR)
+    return SCHED_FAIR_PRIO * 2 - 1;
+  if (p->sched_class == SCHED_CLASS_IDLE)
+    return SCHED_NR_PRIO * 2; // Sabke baad
+  return p->priority * 2;
+}
+
+// ============================================================================
+// PRIO + RT classes: O(1) bitmap run queue
+// ============================================================================
+
+static inline int sched_prio(process_t *p) {
+  int prio = p->priority;
+  if (prio < 0)
+    prio = 0;
+  if (prio >= SCHED_NR_PRIO)
+    prio = SCHED_NR_PRIO - 1;
+  return prio;
+}
+
+// head = preempt hua RT task, apni baari na khoye
+static void rq_enqueue(runqueue_t *rq, process_t *p, int head) {
+  int prio = sched_prio(p);
+  p->rq_prio = prio;
+  if (head) {
+    p->rq_prev = 0;
+    p->rq_next = rq->head[prio];
+    if (rq->head[prio])
+      rq->head[prio]->rq_prev = p;
+    else
+      rq->tail[prio] = p;
+    rq->head[prio] = p;
+  } else {
+    p->rq_next = 0;
+    p->rq_prev = rq->tail[prio];
+    if (rq->tail[prio])
+      rq->tail[prio]->rq_next = p;
+    else
+      rq->head[prio] = p;
+    rq->tail[prio] = p;
+  }
+  rq->bitmap[prio >> 5] |= (1u << (prio & 31));
+  rq->nr_running++;
+}
+
+static void rq_dequeue(runqueue_t *rq, process_t *p) {
+  // Enqueue ke waqt wali priority, beech mein badli ho to bhi sahi list
+  int prio = p->rq_prio;
+  if (p->rq_prev)
+    p->rq_prev->rq_next = p->rq_next;
+  else
+    rq->head[prio] = p->rq_next;
+  if (p->rq_next)
+    p->rq_next->rq_prev = p->rq_prev;
+  else
+    rq->tail[prio] = p->rq_prev;
+  if (!rq->head[prio])
+    rq->bitmap[prio >> 5] &= ~(1u << (prio & 31));
+  p->rq_next = p->rq_prev = 0;
+  rq->nr_running--;
+}
+
+// Pehla set bit (from ya usse neeche ki priority) = sabse oonchi priority
+// jiske paas READY process hai
+static inline int rq_first_prio(runqueue_t *rq, int from) {
+  int i = from >> 5;
+  uint32_t word = rq->bitmap[i] & (~0u << (from & 31));
+  for (;;) {
+    if (word)
+      return (i << 5) + __builtin_ctz(word);
+    if (++i >= SCHED_BITMAP_WORDS)
+      return -1;
+    word = rq->bitmap[i];
+  }
+}
+
+// from = SCHED_MAX_RT_PRIO: throttled RT lists ko chhod ke dekho.
+// rq->lock pakda hua.
+static process_t *rq_peek_from(runqueue_t *rq, int from) {
+  process_t *p = 0;
+  int prio;
+  while ((prio = rq_first_prio(rq, from)) >= 0) {
+    p = rq->head[prio];
+    if (p->state == PROCESS_READY)
+      break;
+    __sched_dequeue(rq, p); // Wake ke baad dobara block ho gaya, queue se bahar
+    p = 0;
+  }
+  return p;
+}
+
+process_t *rq_peek() {
+  runqueue_t *rq = this_rq();
+  uint32_t eflags = spin_lock_irqsave(&rq->lock);
+  process_t *p = rq_peek_from(rq, 0);
+  spin_unlock_irqrestore(&rq->lock, eflags);
+  return p;
+}
+
+// ============================================================================
+// FAIR class: vruntime red-black tree
+// ============================================================================
+
+// Linux ka nice -> weight table: har nice step ~10% CPU ka farak
+static const uint32_t fair_nice_weight[40] = {
+    88761, 71755, 56483, 46273, 36291, // -20
+    29154, 23254, 18705, 14949, 11916, // -15
+    9548,  7620,  6100,  4904,  3906,  // -10
+    3121,  2501,  1991,  1586,  1277,  // -5
+    1024,  820,   655,   526,   423,   // 0
+    335,   272,   215,   172,   137,   // 5
+    110,   87,    70,    56,    45,    // 10
+    36,    29,    23,    18,    15,    // 15
+};
+
+// 2^32 / weight - har tick pe 64-bit divide (__udivdi3 ka bit loop) ki
+// jagah multiply + shift, clocksource ke mult/shift jaisa
+static const uint32_t fair_nice_wmult[40] = {
+    48388,     59856,     76040,     92818,     118348,    // -20
+    147320,    184698,    229616,    287308,    360437,    // -15
+    449829,    563644,    704093,    875809,    1099582,   // -10
+    1376151,   1717300,   2157191,   2708050,   3363326,   // -5
+    4194304,   5237765,   6557202,   8165337,   10153587,  // 0
+    12820798,  15790321,  19976592,  24970740,  31350126,  // 5
+    39045157,  49367440,  61356676,  76695844,  95443717,  // 10
+    119304647, 148102320, 186737708, 238609294, 286331153, // 15
+};
+
+// delta * NICE_0_LOAD * wmult >> 32, NICE_0_LOAD = 2^10
+#define FAIR_WMULT_SHIFT 22
+
+static inline uint32_t fair_weight(process_t *p) {
+  return fair_nice_weight[p->nice - NICE_MIN];
+}
+
+// Asli ns ko weight ke hisaab se virtual ns mein
+static inline uint64_t fair_delta(uint64_t delta, process_t *p) {
+  if (p->nice == 0)
+    return delta;
+  return mul_u64_u32_shr(delta, fair_nice_wmult[p->nice - NICE_MIN],
+                         FAIR_WMULT_SHIFT);
+}
+
+// Ye task ek latency period mein kitna chale: period ko load mein baanto.
+// Bahut saare tasks hon to period min_gran * nr tak badh jaata hai. Sab
+// 32-bit mein: weight/load ka Q15 hissa (weight <= 88761, << 15 32 bits
+// mein aata hai), period nr clamp karke 2^32 ns se chhota.
+#define FAIR_SHARE_SHIFT 15
+#define FAIR_NR_MAX 1024
+
+static uint64_t fair_slice(runqueue_t *rq, process_t *p) {
+  uint32_t nr = rq->fair.nr_running;
+  uint32_t load = rq->fair.load;
+  uint32_t weight = fair_weight(p);
+  if (!p->on_rq) {
+    nr++;
+    load += weight;
+  }
+  if (nr > FAIR_NR_MAX)
+    nr = FAIR_NR_MAX;
+  uint32_t period = (uint32_t)SCHED_FAIR_LATENCY_NS;
+  if (nr * (uint32_t)SCHED_FAIR_MIN_GRAN_NS > period)
+    period = nr * (uint32_t)SCHED_FAIR_MIN_GRAN_NS;
+  uint32_t share = (weight << FAIR_SHARE_SHIFT) / load;
+  uint32_t slice = (uint32_t)(((uint64_t)period * share) >> FAIR_SHARE_SHIFT);
+  return slice < SCHED_FAIR_MIN_GRAN_NS ? SCHED_FAIR_MIN_GRAN_NS : slice;
+}
+
+static inline process_t *fair_peek(runqueue_t *rq) {
+  return rq->fair.leftmost
+             ? rb_entry(rq->fair.leftmost, process_t, fair_node)
+             : 0;
+}
+
+static void fair_enqueue(runqueue_t *rq, process_t *p) {
+  rb_node_t **link = &rq->fair.tasks.node;
+  rb_node_t *parent = 0;
+  int leftmost = 1;
+  while (*link) {
+    parent = *link;
+    process_t *e = rb_entry(parent, process_t, fair_node);
+    // Barabar vruntime wale right mein - FIFO order bana rahe
+    if ((int64_t)(p->vruntime - e->vruntime) < 0) {
+      link = &parent->left;
+    } else {
+      link = &parent->right;
+      leftmost = 0;
+    }
+  }
+  rb_link_node(&p->fair_node, parent, link);
+  rb_insert_color(&p->fair_node, &rq->fair.tasks);
+  if (leftmost)
+    rq->fair.leftmost = &p->fair_node;
+  rq->fair.nr_running++;
+  rq->fair.load += fair_weight(p);
+}
+
+static void fair_dequeue(runqueue_t *rq, process_t *p) {
+  if (rq->fair.leftmost == &p->fair_node)
+    rq->fair.leftmost = rb_next(&p->fair_node);
+  rb_erase(&p->fair_node, &rq->fair.tasks);
+  rq->fair.nr_running--;
+  rq->fair.load -= fair_weight(p);
+}
+
+// min_vruntime sirf aage badhta hai: chalte task aur leftmost mein jo kam ho
+static void fair_update_min_vruntime(runqueue_t *rq, process_t *curr) {
+  uint64_t vr = rq->fair.min_vruntime;
+  int have = 0;
+  if (curr && curr->sched_class == SCHED_CLASS_FAIR &&
+      curr->state == PROCESS_RUNNING) {
+    vr = curr->vruntime;
+    have = 1;
+  }
+  process_t *left = fair_peek(rq);
+  if (left && (!have || (int64_t)(left->vruntime - vr) < 0))
+    vr = left->vruntime;
+  if ((int64_t)(vr - rq->fair.min_vruntime) > 0)
+    rq->fair.min_vruntime = vr;
+}
+
+// Jaagne wale ko thoda credit (aadha latency), par purana sota hua task
+// apne puraane kam vruntime se sabko bhookha na maare
+static void fair_place_wakeup(runqueue_t *rq, process_t *p) {
+  uint64_t vmin = rq->fair.min_vruntime;
+  uint64_t credit = SCHED_FAIR_LATENCY_NS / 2;
+  vmin = vmin > credit ? vmin - credit : 0;
+  if ((int64_t)(p->vruntime - vmin) < 0)
+    p->vruntime = vmin;
+}
+
+// ============================================================================
+// RT throttling
+// ============================================================================
+
+// Naya window: budget wapas, throttled RT tasks phir se chal sakte hain
+static void rt_replenish(runqueue_t *rq, uint64_t now) {
+  if (now - rq->rt.period_start < SCHED_RT_PERIOD_NS)
+    return;
+  rq->rt.period_start = now;
+  rq->rt.rt_time = 0;
+  rq->rt.throttled = 0;
+}
+
+static void rt_account(runqueue_t *rq, uint64_t delta) {
+  rq->rt.rt_time += delta;
+  if (!rq->rt.throttled && rq->rt.rt_time > SCHED_RT_RUNTIME_NS) {
+    rq->rt.throttled = 1;
+    rq->rt.nr_throttled++;
+    serial_log("SCHED: RT budget exhausted, throttling RT tasks");
+  }
+}
+
+// ============================================================================
+// Class dispatch + accounting
+// ============================================================================
+
+// Chalte task ka runtime (fair ho to vruntime, RT ho to budget) abhi tak
+// update karo
+static void sched_update_curr(runqueue_t *rq, process_t *curr, uint64_t now) {
+  if (curr->exec_start && now > curr->exec_start) {
+    uint64_t delta = now - curr->exec_start;
+    curr->sum_exec_runtime += delta;
+    if (curr->sched_class == SCHED_CLASS_IDLE)
+      rq->stat.idle_ns += delta;
+    else
+      rq->stat.busy_ns += delta;
+    if (curr->sched_class == SCHED_CLASS_FAIR)
+      curr->vruntime += fair_delta(delta, curr);
+    else if (sched_rt(curr))
+      rt_account(rq, delta);
+  }
+  curr->exec_start = now;
+  if (curr->sched_class == SCHED_CLASS_FAIR)
+    fair_update_min_vruntime(rq, curr);
+}
+
+// __ wale: rq->lock pehle se pakda hua
+static void __sched_enqueue_at(runqueue_t *rq, process_t *p, int head) {
+  if (p->sched_class == SCHED_CLASS_IDLE)
+    return; // Idle task queue pe nahi jaata
+  if (!p->on_rq) {
+    if (p->sched_class == SCHED_CLASS_FAIR)
+      fair_enqueue(rq, p);
+    else
+      rq_enqueue(rq, p, head);
+    p->on_rq = 1;
+    p->wait_start = sched_clock_ns();
+  }
+}
+
+static void __sched_dequeue(runqueue_t *rq, process_t *p) {
+  if (p->on_rq) {
+    if (p->sched_class == SCHED_CLASS_FAIR)
+      fair_dequeue(rq, p);
+    else
+      rq_dequeue(rq, p);
+    p->on_rq = 0;
+  }
+}
+
+// p jis CPU ki queue pe hai (p->cpu) uska lock. Stealing lock ke bina
+// p->cpu badal sakta hai, isliye lene ke baad dobara dekho.
+static runqueue_t *task_rq_lock(process_t *p, uint32_t *eflags) {
+  for (;;) {
+    runqueue_t *rq = cpu_rq(p->cpu);
+    *eflags = spin_lock_irqsave(&rq->lock);
+    if (rq == cpu_rq(p->cpu))
+      return rq;
+    spin_unlock_irqrestore(&rq->lock, *eflags);
+  }
+}
+
+void sched_enqueue(process_t *p) {
+  uint32_t eflags;
+  runqueue_t *rq = task_rq_lock(p, &eflags);
+  __sched_enqueue_at(rq, p, 0);
+  spin_unlock_irqrestore(&rq->lock, eflags);
+}
+
+void sched_dequeue(process_t *p) {
+  uint32_t eflags;
+  runqueue_t *rq = task_rq_lock(p, &eflags);
+  __sched_dequeue(rq, p);
+  spin_unlock_irqrestore(&rq->lock, eflags);
+}
+
+// Saari classes mein se sabse pehle chalne wala READY task (queue se
+// hataaye bina). Throttled ho to RT tasks nahi dikhte.
+static process_t *sched_peek(runqueue_t *rq) {
+  process_t *prio =
+      rq_peek_from(rq, rq->rt.throttled ? SCHED_MAX_RT_PRIO : 0);
+  process_t *fair = fair_peek(rq);
+  while (fair && fair->state != PROCESS_READY) {
+    __sched_dequeue(rq, fair);
+    fair = fair_peek(rq);
+  }
+  if (!fair)
+    return prio;
+  if (!prio)
+    return fair;
+  return sched_rank(prio) < sched_rank(fair) ? prio : fair;
+}
+
+// Queue pe READY + chalta hua, idle task ko chhod ke. Bina lock padho to
+// sirf andaaza (balancing ke liye kaafi).
+static uint32_t rq_nr_runnable(runqueue_t *rq) {
+  uint32_t nr = rq->nr_running + rq->fair.nr_running;
+  process_t *idle = rq->idle;
+  if (idle && idle->on_rq)
+    nr--; // Boot context, cpu_idle se pehle
+  process_t *curr = rq->curr;
+  if (curr && curr != idle && curr->state == PROCESS_RUNNING)
+    nr++;
+  return nr;
+}
+
+// Us CPU ko schedule() karwao: apna ho to flag kaafi (IRQ/syscall exit
+// dekhega), doosra ho to IPI
+static void sched_resched_cpu(uint32_t cpu) {
+  cpus[cpu].need_resched = 1;
+  if (cpu != smp_processor_id())
+    smp_send_reschedule(cpu);
+}
+
+// Fork/spawn balancing: naya task sabse halke online CPU pe
+static uint32_t sched_select_cpu(process_t *p) {
+  uint32_t best = smp_processor_id();
+  uint32_t best_load = rq_nr_runnable(cpu_rq(best));
+  for (uint32_t c = 0; c < SMP_MAX_CPUS; c++) {
+    if (!cpus[c].online || !(p->cpus_allowed & (1u << c)))
+      continue;
+    uint32_t load = rq_nr_runnable(cpu_rq(c));
+    if (load < best_load) {
+      best = c;
+      best_load = load;
+    }
+  }
+  return best;
+}
+
+// p rq pe intezaar karega (chalta task preempt nahi hua) aur koi CPU khaali
+// baitha hai: use jaga do, wo idle loop mein p ko churaa lega. Apna CPU
+// khaali ho to IRQ se lautte hi wahi karega.
+static void sched_kick_idle(runqueue_t *rq, process_t *p) {
+  if (smp_nr_online < 2)
+    return;
+  for (uint32_t c = 0; c < SMP_MAX_CPUS; c++) {
+    runqueue_t *other = cpu_rq(c);
+    if (other == rq || !cpus[c].online || !(p->cpus_allowed & (1u << c)))
+      continue;
+    if (other->curr == other->idle && !rq_nr_runnable(other)) {
+      if (c != smp_processor_id())
+        smp_send_reschedule(c);
+      return;
+    }
+  }
+}
+
+void sched_new_task(process_t *p, int inherit) {
+  process_t *parent = p->parent;
+  if (inherit && parent) {
+    p->sched_class = parent->sched_class;
+    p->nice = parent->nice;
+    p->rt_priority = parent->rt_priority;
+  } else {
+    p->sched_class = SCHED_DEFAULT_CLASS;
+    p->nice = 0;
+    p->rt_priority = 0;
+  }
+  p->sum_exec_runtime = 0;
+  p->wait_sum = 0;
+  p->nr_switches = 0;
+  p->exec_start = 0;
+  p->wake_stamp = 0;
+  p->wakeup_lat_ns = 0;
+  p->wakeup_lat_max_ns = 0;
+  p->cpus_allowed = SCHED_CPUS_ALL;
+  p->on_cpu = 0;
+  p->cpu = sched_select_cpu(p);
+
+  runqueue_t *rq = cpu_rq(p->cpu);
+  uint32_t eflags = spin_lock_irqsave(&rq->lock);
+  if (p->sched_class == SCHED_CLASS_FAIR) {
+    // Start debit: naya task ek slice peeche se shuru, warna fork bomb
+    // baaki sabko rok de. Parent ka vruntime sirf usi queue pe matlab rakhta
+    // hai (har queue ka min_vruntime alag).
+    uint64_t vr = rq->fair.min_vruntime + fair_delta(fair_slice(rq, p), p);
+    if (inherit && parent && parent->cpu == p->cpu &&
+        parent->sched_class == SCHED_CLASS_FAIR &&
+        (int64_t)(parent->vruntime - vr) > 0)
+      vr = parent->vruntime;
+    p->vruntime = vr;
+  }
+  __sched_enqueue_at(rq, p, 0);
+  if (rq->curr && rq->curr == rq->idle)
+    sched_resched_cpu(rq->cpu); // Khaali CPU - turant utha le
+  if (rq->cpu == 0)
+    clockevent_kick();
+  spin_unlock_irqrestore(&rq->lock, eflags);
+}
+
+void sched_wakeup(process_t *p) {
+  if (!p)
+    return;
+  uint32_t eflags;
+  runqueue_t *rq = task_rq_lock(p, &eflags);
+  if (p->state == PROCESS_WAITING || p->state == PROCESS_SLEEPING ||
+      p->state == PROCESS_READY) {
+    if (p->state != PROCESS_READY) {
+      if (p->sched_class == SCHED_CLASS_FAIR)
+        fair_place_wakeup(rq, p);
+      p->wake_stamp = sched_clock_ns();
+    }
+    p->state = PROCESS_READY;
+    __sched_enqueue_at(rq, p, 0);
+
+    // Wakeup preemption: jaagne wala us CPU pe chalte hue se kaafi aage ho
+    // to resched (doosra CPU ho to IPI)
+    int resched = 0;
+    process_t *curr = rq->curr;
+    if (curr && curr != p && curr->state == PROCESS_RUNNING) {
+      if (sched_rt(p) && rq->rt.throttled) {
+        // Budget khatam - window ke end tak intezaar
+      } else if (sched_rank(p) < sched_rank(curr)) {
+        resched = 1;
+      } else if (p->sched_class == SCHED_CLASS_FAIR &&
+                 curr->sched_class == SCHED_CLASS_FAIR) {
+        sched_update_curr(rq, curr, sched_clock_ns());
+        if ((int64_t)(curr->vruntime - p->vruntime) >
+            (int64_t)SCHED_FAIR_WAKEUP_GRAN_NS)
+          resched = 1;
+      }
+    }
+    if (resched)
+      sched_resched_cpu(rq->cpu);
+    else if (curr != p)
+      sched_kick_idle(rq, p);
+    if (rq->cpu == 0)
+      clockevent_kick();
+  }
+  spin_unlock_irqrestore(&rq->lock, eflags);
+}
+
+uint32_t sched_nr_runnable() {
+  uint32_t nr = 0;
+  for (uint32_t c = 0; c < SMP_MAX_CPUS; c++)
+    if (c == 0 || cpus[c].online)
+      nr += rq_nr_runnable(cpu_rq(c));
+  return nr;
+}
+
+uint32_t sched_nr_runnable_cpu(uint32_t cpu) {
+  return rq_nr_runnable(cpu_rq(cpu));
+}
+
+// ============================================================================
+// Load balancing: work stealing. Task apne CPU ki queue pe hi jaagta hai
+// (cache garam), aur jo CPU khaali ho ya baaki se kaafi halka ho wo sabse
+// lambi queue se ek READY task kheench leta hai.
+// ============================================================================
+
+static inline int sched_can_migrate(process_t *p, uint32_t cpu) {
+  // on_cpu: queue pe wapas aa gaya par abhi bhi apne stack pe switch ho
+  // raha hai - doosra CPU us stack pe nahi chadh sakta
+  return p->state == PROCESS_READY && !p->on_cpu &&
+         (p->cpus_allowed & (1u << cpu));
+}
+
+// src ka sabse pehle chalne wala task jo cpu pe ja sake. Dono locks pakde.
+static process_t *sched_find_stealable(runqueue_t *src, uint32_t cpu) {
+  process_t *best = 0;
+  int from = src->rt.throttled ? SCHED_MAX_RT_PRIO : 0;
+  for (int prio = rq_first_prio(src, from); prio >= 0 && !best;
+       prio = rq_first_prio(src, prio + 1)) {
+    for (process_t *p = src->head[prio]; p; p = p->rq_next) {
+      if (sched_can_migrate(p, cpu)) {
+        best = p;
+        break;
+      }
+    }
+  }
+  for (rb_node_t *n = src->fair.leftmost; n; n = rb_next(n)) {
+    process_t *p = rb_entry(n, process_t, fair_node);
+    if (sched_can_migrate(p, cpu)) {
+      if (!best || sched_rank(p) < sched_rank(best))
+        best = p;
+      break;
+    }
+  }
+  return best;
+}
+
+static void sched_migrate(runqueue_t *src, runqueue_t *dst, process_t *p) {
+  uint64_t wait_start = p->wait_start;
+  __sched_dequeue(src, p);
+  // vruntime sirf apni queue ke min_vruntime ke hisaab se matlab rakhta hai
+  if (p->sched_class == SCHED_CLASS_FAIR)
+    p->vruntime = p->vruntime - src->fair.min_vruntime + dst->fair.min_vruntime;
+  p->cpu = dst->cpu;
+  __sched_enqueue_at(dst, p, 0);
+  p->wait_start = wait_start; // Wait stats queue badalne se reset na hon
+  dst->nr_migrations++;
+}
+
+// Sabse bhaari CPU se ek task is CPU (rq) pe, agar load ka farak 2 ya
+// zyada ho - khaali CPU ke liye matlab wahan koi task intezaar mein hai, aur
+// ek task do CPUs ke beech jhoolta nahi. Interrupts band, koi rq lock
+// pakda nahi. Returns 1 agar task aaya.
+static int sched_balance(runqueue_t *rq) {
+  if (smp_nr_online < 2)
+    return 0;
+  uint32_t mine = rq_nr_runnable(rq);
+  runqueue_t *busiest = 0;
+  uint32_t max = mine + 1;
+  for (uint32_t c = 0; c < SMP_MAX_CPUS; c++) {
+    runqueue_t *other = cpu_rq(c);
+    if (other == rq || !cpus[c].online)
+      continue;
+    uint32_t load = rq_nr_runnable(other);
+    if (load > max) {
+      max = load;
+      busiest = other;
+    }
+  }
+  if (!busiest)
+    return 0;
+
+  runqueue_t *first = rq < busiest ? rq : busiest;
+  runqueue_t *second = rq < busiest ? busiest : rq;
+  spin_lock(&first->lock);
+  spin_lock(&second->lock);
+  process_t *p = sched_find_stealable(busiest, rq->cpu);
+  if (p)
+    sched_migrate(busiest, rq, p);
+  spin_unlock(&second->lock);
+  spin_unlock(&first->lock);
+  return p != 0;
+}
+
+void sched_balance_tick() {
+  uint32_t eflags = local_irq_save();
+  if (sched_balance(this_rq()))
+    set_need_resched();
+  local_irq_restore(eflags);
+}
+
+#define SCHED_KEEP 0         // old chalta rahe
+#define SCHED_PREEMPT 1      // old queue ke tail pe
+#define SCHED_PREEMPT_HEAD 2 // old apni list ke head pe (RT, baari baaki)
+
+// Chalta hua old, queue ka best cand: kya old ko hatna chahiye? yield =
+// old ne khud CPU chhoda, resched = wakeup preemption.
+static int sched_should_preempt(runqueue_t *rq, process_t *old,
+                                process_t *cand, int yield, int resched) {
+  if (old->sched_class == SCHED_CLASS_IDLE)
+    return cand ? SCHED_PREEMPT : SCHED_KEEP;
+  if (old->sched_class == SCHED_CLASS_FAIR) {
+    if (!cand)
+      return SCHED_KEEP;
+    if (sched_rank(cand) < sched_rank(old))
+      return SCHED_PREEMPT;
+    if (cand->sched_class != SCHED_CLASS_FAIR)
+      return SCHED_KEEP; // Neeche wali PRIO priority fair class ke baad
+    if (yield || resched)
+      return SCHED_PREEMPT;
+    uint64_t ideal = fair_slice(rq, old);
+    uint64_t ran = old->sum_exec_runtime - old->slice_exec;
+    if (ran >= ideal)
+      return SCHED_PREEMPT;
+    if (ran < SCHED_FAIR_MIN_GRAN_NS)
+      return SCHED_KEEP;
+    return (int64_t)(old->vruntime - cand->vruntime) > (int64_t)ideal
+               ? SCHED_PREEMPT
+               : SCHED_KEEP;
+  }
+
+  if (sched_rt(old)) {
+    // Throttled: cand normal task hi hoga (peek RT chhod deta hai)
+    if (rq->rt.throttled)
+      return cand ? SCHED_PREEMPT : SCHED_KEEP;
+    if (cand && sched_rank(cand) < sched_rank(old))
+      return SCHED_PREEMPT_HEAD;
+    int expired = 0;
+    if (old->sched_class == SCHED_CLASS_RR && --old->time_remaining <= 0) {
+      old->time_remaining = old->time_slice;
+      expired = 1;
+    }
+    // FIFO ka koi slice nahi: barabar wale ki baari sirf yield pe
+    if ((yield || expired) && cand && sched_rank(cand) <= sched_rank(old))
+      return SCHED_PREEMPT;
+    return SCHED_KEEP;
+  }
+
+  // PRIO class: fixed slice, slice baaki ho to sirf oonchi rank preempt
+  // kare, khatam ho to barabar rank wale ki bhi baari (round robin)
+  old->time_remaining--;
+  if (!yield && !resched && old->time_remaining > 0)
+    return cand && sched_rank(cand) < sched_rank(old) ? SCHED_PREEMPT
+                                                      : SCHED_KEEP;
+  if (cand && sched_rank(cand) <= sched_rank(old))
+    return SCHED_PREEMPT;
+  old->time_remaining = old->time_slice;
+  return SCHED_KEEP;
+}
+
+process_t *sched_pick_next(runqueue_t *rq, process_t *old) {
+  uint64_t now = sched_clock_ns();
+  clockevent_update_jiffies(now);
+  rt_replenish(rq, now);
+  sched_update_curr(rq, old, now);
+
+  int yield = old->sched_yield;
+  int resched = need_resched();
+  old->sched_yield = 0;
+  clear_need_resched();
+
+  // Sone se pehle hi jag gaya tha aur phir se block hua: queue se bahar
+  if (old->on_rq && old->state != PROCESS_READY)
+    __sched_dequeue(rq, old);
+
+  process_t *next = sched_peek(rq);
+  if (old->state == PROCESS_RUNNING) {
+    int how = sched_should_preempt(rq, old, next, yield, resched);
+    if (how == SCHED_KEEP)
+      return old;
+    old->state = PROCESS_READY;
+    __sched_enqueue_at(rq, old, how == SCHED_PREEMPT_HEAD);
+  }
+  if (!next) {
+    // Koi runnable nahi: is CPU ka idle task (boot ke dauraan, cpu_idle se
+    // pehle, PID 0 khud queue pe hota hai to yahan tak nahi aate)
+    process_t *idle = rq->idle;
+    if (!idle || idle == old || idle->sched_class != SCHED_CLASS_IDLE)
+      return 0;
+    next = idle;
+  }
+
+  __sched_dequeue(rq, next);
+  if (next->wait_start && now > next->wait_start)
+    next->wait_sum += now - next->wait_start;
+  next->wait_start = 0;
+  if (next->wake_stamp) {
+    uint64_t lat = now > next->wake_stamp ? now - next->wake_stamp : 0;
+    next->wakeup_lat_ns = lat > 0xFFFFFFFFULL ? 0xFFFFFFFF : (uint32_t)lat;
+    if (next->wakeup_lat_ns > next->wakeup_lat_max_ns)
+      next->wakeup_lat_max_ns = next->wakeup_lat_ns;
+    next->wake_stamp = 0;
+  }
+  next->exec_start = now;
+  next->slice_exec = next->sum_exec_runtime;
+  next->time_remaining = next->time_slice;
+  if (next != old) {
+    next->nr_switches++;
+    rq->nr_switches++;
+  }
+  rq->curr = next;
+  return next;
+}
+
+// Class badalne ka common hissa: queue se hatao, accounting band karo,
+// naye class ke hisaab se fields set karke wapas queue pe
+static void sched_change(process_t *p, int sched_class, int nice,
+                         int rt_priority) {
+  uint32_t eflags;
+  runqueue_t *rq = task_rq_lock(p, &eflags);
+  int queued = p->on_rq;
+  if (queued)
+    __sched_dequeue(rq, p);
+  if (p == rq->curr)
+    sched_update_curr(rq, p, sched_clock_ns());
+
+  if (p->sched_class != sched_class && sched_class == SCHED_CLASS_FAIR)
+    p->vruntime = rq->fair.min_vruntime; // Fair class mein naye jaisa
+  if (sched_class == SCHED_CLASS_FIFO || sched_class == SCHED_CLASS_RR) {
+    p->priority = SCHED_MAX_RT_PRIO - 1 - rt_priority;
+    p->time_slice = SCHED_RR_TIMESLICE;
+  } else if (sched_rt(p)) {
+    p->priority = DEFAULT_PRIORITY; // RT se normal mein wapas
+    p->time_slice = DEFAULT_TIME_SLICE;
+  }
+  if (p->time_remaining > p->time_slice)
+    p->time_remaining = p->time_slice;
+  p->sched_class = sched_class;
+  p->nice = nice;
+  p->rt_priority = rt_priority;
+
+  if (queued)
+    __sched_enqueue_at(rq, p, 0);
+  if (p == rq->curr)
+    sched_resched_cpu(rq->cpu);
+  spin_unlock_irqrestore(&rq->lock, eflags);
+}
+
+int sched_setattr(process_t *p, int sched_class, int nice) {
+  if (p->sched_class == SCHED_CLASS_IDLE)
+    return -EINVAL;
+  if (sched_class != SCHED_CLASS_PRIO && sched_class != SCHED_CLASS_FAIR)
+    return -EINVAL;
+  if (nice < NICE_MIN || nice > NICE_MAX)
+    return -EINVAL;
+  sched_change(p, sched_class, nice, 0);
+  return 0;
+}
+
+int sched_setscheduler(process_t *p, int policy, int rt_priority) {
+  int sched_class;
+  if (p->sched_class == SCHED_CLASS_IDLE)
+    return -EINVAL;
+  if (policy == SCHED_FIFO)
+    sched_class = SCHED_CLASS_FIFO;
+  else if (policy == SCHED_RR)
+    sched_class = SCHED_CLASS_RR;
+  else if (policy == SCHED_OTHER)
+    sched_class = sched_rt(p) ? SCHED_DEFAULT_CLASS : p->sched_class;
+  else
+    return -EINVAL;
+
+  if (policy == SCHED_OTHER) {
+    if (rt_priority != 0)
+      return -EINVAL;
+  } else if (rt_priority < SCHED_RT_PRIO_MIN ||
+             rt_priority > SCHED_RT_PRIO_MAX) {
+    return -EINVAL;
+  }
+  sched_change(p, sched_class, p->nice, rt_priority);
+  return 0;
+}
+
+int sched_setparam(process_t *p, int rt_priority) {
+  if (!sched_rt(p))
+    return rt_priority == 0 ? 0 : -EINVAL;
+  if (rt_priority < SCHED_RT_PRIO_MIN || rt_priority > SCHED_RT_PRIO_MAX)
+    return -EINVAL;
+  sched_change(p, p->sched_class, p->nice, rt_priority);
+  return 0;
+}
+
+// ============================================================================
+// Idle task, CPU time aur load average
+// ============================================================================
+
+static ktimer_t loadavg_timer;
+
+static inline uint32_t calc_load(uint32_t load, uint32_t exp,
+                                 uint32_t active) {
+  uint32_t newload = load * exp + active * (LOAD_FIXED_1 - exp);
+  if (active >= load)
+    newload += LOAD_FIXED_1 - 1; // Upar round, warna 1.00 tak kabhi na pahunche
+  return newload >> LOAD_FSHIFT;
+}
+
+// Timer IRQ se har LOAD_FREQ_TICKS
+static void loadavg_update(ktimer_t *timer) {
+  uint32_t active = sched_nr_runnable() << LOAD_FSHIFT;
+  avenrun[0] = calc_load(avenrun[0], LOAD_EXP_1, active);
+  avenrun[1] = calc_load(avenrun[1], LOAD_EXP_5, active);
+  avenrun[2] = calc_load(avenrun[2], LOAD_EXP_15, active);
+  mod_timer(timer, timer->expires + LOAD_FREQ_TICKS);
+}
+
+// Ek CPU ka stat, chalte task ka time jod ke
+static cpu_stat_t rq_cpu_stat(runqueue_t *rq) {
+  uint32_t eflags = spin_lock_irqsave(&rq->lock);
+  if (rq->curr)
+    sched_update_curr(rq, rq->curr, sched_clock_ns());
+  cpu_stat_t stat = rq->stat;
+  spin_unlock_irqrestore(&rq->lock, eflags);
+  return stat;
+}
+
+void sched_cpu_time(uint64_t *idle_ns, uint64_t *busy_ns) {
+  *idle_ns = 0;
+  *busy_ns = 0;
+  for (uint32_t c = 0; c < SMP_MAX_CPUS; c++) {
+    if (c != 0 && !cpus[c].online)
+      continue;
+    cpu_stat_t stat = rq_cpu_stat(cpu_rq(c));
+    *idle_ns += stat.idle_ns;
+    *busy_ns += stat.busy_ns;
+  }
+}
+
+void sched_cpu_info(uint32_t cpu, cpu_info_t *info) {
+  runqueue_t *rq = cpu_rq(cpu);
+  cpu_stat_t stat = rq_cpu_stat(rq);
+  info->nr_running = rq_nr_runnable(rq);
+  info->nr_switches = rq->nr_switches;
+  info->nr_migrations = rq->nr_migrations;
+  info->busy_ns = stat.busy_ns;
+  info->idle_ns = stat.idle_ns;
+}
+
+void sched_init_cpu(uint32_t cpu, process_t *idle) {
+  runqueue_t *rq = cpu_rq(cpu);
+  spin_lock_init(&rq->lock, "runqueue");
+  rq->cpu = cpu;
+  rq->idle = idle;
+  rq->curr = idle;
+  cpus[cpu].idle = idle;
+  idle->cpu = cpu;
+  idle->cpus_allowed = 1u << cpu; // Idle task kabhi migrate nahi hota
+  idle->on_cpu = 1;
+}
+
+void cpu_idle() {
+  extern uint32_t tick;
+  runqueue_t *rq = this_rq();
+  uint32_t eflags = spin_lock_irqsave(&rq->lock);
+  process_t *self = current_process;
+  __sched_dequeue(rq, self);
+  sched_update_curr(rq, self, sched_clock_ns()); // Boot ka time busy mein
+  self->sched_class = SCHED_CLASS_IDLE;
+  spin_unlock_irqrestore(&rq->lock, eflags);
+  if (rq->cpu == 0) { // Timers BSP ke tick pe - load average ek hi jagah
+    timer_setup(&loadavg_timer, loadavg_update, 0);
+    timer_add(&loadavg_timer, tick + LOAD_FREQ_TICKS);
+  }
+
+  for (;;) {
+    // cli ke baad check, phir "sti; hlt" - sti ke baad wali ek instruction
+    // tak interrupt nahi aata, isliye check aur hlt ke beech jaagne wala
+    // wakeup chhootta nahi (wo IRQ hlt ko hi todta hai)
+    local_irq_disable();
+    spin_lock(&rq->lock);
+    // Throttled RT yahan nahi dikhta - tab bhi hlt
+    process_t *next = sched_peek(rq);
+    spin_unlock(&rq->lock);
+    // Apni queue khaali - doosre CPU ki queue se churao
+    if (!next && sched_balance(rq))
+      next = self;
+    if (next) {
+      local_irq_enable();
+      schedule();
+    } else {
+      asm volatile("sti; hlt");
+    }
+  }
+}
+
+// ============================================================================
+// Boot benchmark: do kernel threads (pid 0 aur ek pinger) schedule_yield se
+// ping-pong karte hain, saath mein N blocked "idle" processes padey hain.
+// Purana schedule() har switch pe poori list do baar ghoomta tha; uska pick
+// bhi yahan dobara chala ke naapte hain.
+// ============================================================================
+
+#define SCHED_BENCH_ROUNDS 2000
+#define SCHED_BENCH_MAX_IDLE 100
+
+static volatile int sched_bench_stop = 0;
+static process_t *sched_bench_idle[SCHED_BENCH_MAX_IDLE];
+
+static void sched_bench_pinger() {
+  while (!sched_bench_stop)
+    schedule_yield();
+  current_process->state = PROCESS_ZOMBIE;
+  schedule();
+  for (;;)
+    asm volatile("hlt");
+}
+
+// Kabhi chalta hi nahi - bas list mein blocked pada rehta hai
+static void sched_bench_idle_fn() {
+  for (;;)
+    asm volatile("hlt");
+}
+
+// Purane schedule() ka pick: higher-priority scan + best scan, dono O(n)
+static process_t *sched_legacy_pick(process_t *old) {
+  process_t *p = old->next;
+  while (p != old) {
+    if (p->state == PROCESS_READY && p->priority < old->priority)
+      break;
+    p = p->next;
+  }
+  process_t *best = 0;
+  p = old->next;
+  do {
+    if (p->state == PROCESS_READY ||
+        (p == old && old->state == PROCESS_RUNNING)) {
+      if (!best || p->priority < best->priority)
+        best = p;
+    }
+    p = p->next;
+  } while (p != old->next);
+  return best;
+}
+
+static uint32_t sched_bench_ns(uint64_t hpet_ticks, uint32_t count) {
+  uint32_t period_fs = hpet_get_period_fs();
+  if (!period_fs || !count)
+    return 0;
+  return (uint32_t)((hpet_ticks * period_fs) / 1000000ULL / count);
+}
+
+static void sched_bench_run(uint32_t nr_idle) {
+  for (uint32_t i = 0; i < nr_idle; i++) {
+    process_t *p = create_kernel_thread(sched_bench_idle_fn);
+    sched_dequeue(p);
+    p->state = PROCESS_WAITING;
+    sched_bench_idle[i] = p;
+  }
+
+  sched_bench_stop = 0;
+  process_t *pinger = create_kernel_thread(sched_bench_pinger);
+  sched_setattr(pinger, SCHED_CLASS_PRIO, 0); // pid 0 ke saath round robin
+  schedule_yield(); // Pinger ko ek baar chala do (pehla switch thanda hota hai)
+
+  runqueue_t *rq = this_rq();
+  uint32_t switches = rq->nr_switches;
+  uint64_t h1 = hpet_read_counter();
+  uint64_t t1 = rdtsc();
+  for (uint32_t i = 0; i < SCHED_BENCH_ROUNDS; i++)
+    schedule_yield();
+  uint64_t t2 = rdtsc();
+  uint64_t h2 = hpet_read_counter();
+  switches = rq->nr_switches - switches;
+
+  // Pick cost: purana list scan vs run queue peek
+  volatile process_t *sink;
+  uint64_t t3 = rdtsc();
+  for (uint32_t i = 0; i < SCHED_BENCH_ROUNDS; i++)
+    sink = sched_legacy_pick(current_process);
+  uint64_t t4 = rdtsc();
+  for (uint32_t i = 0; i < SCHED_BENCH_ROUNDS; i++)
+    sink = rq_peek();
+  uint64_t t5 = rdtsc();
+  (void)sink;
+
+  sched_bench_stop = 1;
+  while (pinger->state != PROCESS_ZOMBIE)
+    schedule_yield();
+  reap_kernel_thread(pinger);
+  for (uint32_t i = 0; i < nr_idle; i++)
+    reap_kernel_thread(sched_bench_idle[i]);
+
+  serial_log_hex("  Idle processes:     ", nr_idle);
+  if (switches) {
+    serial_log_hex("    Switch cycles:    ", (uint32_t)((t2 - t1) / switches));
+    serial_log_hex("    Switch ns:        ", sched_bench_ns(h2 - h1, switches));
+  }
+  serial_log_hex("    Old pick cycles:  ",
+                 (uint32_t)((t4 - t3) / SCHED_BENCH_ROUNDS));
+  serial_log_hex("    O(1) pick cycles: ",
+                 (uint32_t)((t5 - t4) / SCHED_BENCH_ROUNDS));
+}
+
+void sched_benchmark() {
+  serial_log("SCHED BENCH: Context switch latency vs idle process count...");
+  sched_bench_run(1);
+  sched_bench_run(10);
+  sched_bench_run(SCHED_BENCH_MAX_IDLE);
+}
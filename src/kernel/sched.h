@@ -0,0 +1,217 @@
+#ifndef SCHED_H
+#define SCHED_H
+
+#include "../include/types.h"
+#include "process.h"
+#include "rbtree.h"
+#include "smp.h"
+#include "spinlock.h"
+
+// Scheduler - chaar classes ek saath:
+//
+// SCHED_CLASS_PRIO: O(1) run queue. Har priority (0-139, kam number = zyada
+// important) ki apni FIFO list, aur 140-bit bitmap jisme bit set matlab us
+// priority pe koi READY process hai. Pick-next = bitmap ka pehla set bit
+// (bsf) + us list ka head. Fixed time slice, strict priority.
+//
+// SCHED_CLASS_FAIR: CFS jaisa. Har task ka vruntime (ns, nice ke weight se
+// scale) aur runnable tasks ek red-black tree mein vruntime se sorted. Sabse
+// kam vruntime wala (leftmost) agla chalta hai; slice latency target ko
+// runnable load mein baant ke nikalta hai, aur jaagne wala task chalte hue
+// ko preempt kar sakta hai.
+//
+// Poori fair class SCHED_FAIR_PRIO pe baithti hai: usse oonchi priority ke
+// PRIO tasks fair tasks ko preempt karte hain, barabar ya neeche wale tabhi
+// chalte hain jab koi fair task runnable na ho.
+//
+// SCHED_CLASS_FIFO / SCHED_CLASS_RR: real-time, POSIX SCHED_FIFO/SCHED_RR.
+// Linux ki tarah PRIO queue ki priority 0-99 RT ke liye hai: rt_priority
+// 1-99 (zyada = zyada important) priority 99 - rt_priority pe queue hota
+// hai, isliye RT task har normal task ko preempt karta hai. FIFO tab tak
+// chalta hai jab tak block/yield na kare; RR ko SCHED_RR_TIMESLICE ke baad
+// barabar priority walon ki baari. Oonchi priority se preempt hua RT task
+// apni list ke head pe wapas jaata hai. RT throttling: har
+// SCHED_RT_PERIOD_NS mein RT tasks milke SCHED_RT_RUNTIME_NS se zyada nahi
+// chal sakte, baaki time normal tasks ka - bhaaga hua RT loop box ko
+// lock nahi kar sakta.
+//
+// SCHED_CLASS_IDLE: har CPU ka idle task (BSP pe PID 0, boot ke baad
+// cpu_idle mein). Kabhi queue pe nahi; tabhi chalta hai jab koi aur
+// runnable na ho, aur koi bhi jaagta task use turant preempt karta hai. Idle task "sti; hlt"
+// mein CPU ko sulaata hai, aur jitna time wo chala wahi CPU ka idle time.
+//
+// Sirf READY processes queue pe rehte hain - chalta hua (RUNNING), soya,
+// blocked ya zombie process queue se bahar.
+//
+// SMP: har CPU ki apni runqueue_t (yehi saari classes), task p->cpu wali pe.
+// Naya task sabse halke CPU pe, jaagta task apne purane CPU pe (doosra ho
+// to IPI), aur khaali/halka CPU bhaari queue se task churaata hai.
+
+#define SCHED_CLASS_PRIO 0
+#define SCHED_CLASS_FAIR 1
+#define SCHED_CLASS_FIFO 2
+#define SCHED_CLASS_RR 3
+#define SCHED_CLASS_IDLE 4
+// Naye (fork nahi) processes aur SCHED_OTHER pe lautne wale RT tasks. Fair
+// class opt-in hai - SYS_SCHED_SETATTR se per process.
+#define SCHED_DEFAULT_CLASS SCHED_CLASS_PRIO
+
+// POSIX policies (pthread.h wale hi values) - sched_setscheduler inhe class
+// mein badalta hai
+#define SCHED_OTHER 0
+#define SCHED_FIFO 1
+#define SCHED_RR 2
+
+#define SCHED_NR_PRIO 140
+#define SCHED_BITMAP_WORDS ((SCHED_NR_PRIO + 31) / 32)
+#define SCHED_FAIR_PRIO DEFAULT_PRIORITY
+#define SCHED_MAX_RT_PRIO 100 // Queue priority 0-99 sirf RT tasks
+#define SCHED_RT_PRIO_MIN 1   // sched_param.sched_priority range
+#define SCHED_RT_PRIO_MAX 99
+
+#define NICE_MIN -20
+#define NICE_MAX 19
+#define NICE_0_LOAD 1024
+
+// Fair class tunables (ns). Timer 50Hz (20ms tick) hai, isliye targets usi
+// hisaab se - slice tick se chhota ho to bhi preemption agle tick pe hi.
+#define SCHED_FAIR_LATENCY_NS 40000000ULL     // Sab runnable tasks ek baar
+#define SCHED_FAIR_MIN_GRAN_NS 4000000ULL     // Isse chhota slice nahi
+#define SCHED_FAIR_WAKEUP_GRAN_NS 4000000ULL  // Wakeup preemption margin
+
+// RT tunables. RR slice ticks mein (5 x 20ms), budget ns mein.
+#define SCHED_RR_TIMESLICE 5
+#define SCHED_RT_PERIOD_NS 1000000000ULL  // Throttling window
+#define SCHED_RT_RUNTIME_NS 950000000ULL  // Window mein max RT CPU time
+
+typedef struct fair_rq {
+  rb_root_t tasks;      // vruntime se sorted, chalta hua task tree mein nahi
+  rb_node_t *leftmost;  // Cached rb_first
+  uint64_t min_vruntime; // Monotonic, naye/jaagne wale tasks ki baseline
+  uint32_t nr_running;
+  uint32_t load; // Queued tasks ke weights ka sum
+} fair_rq_t;
+
+typedef struct rt_bandwidth {
+  uint64_t period_start; // Current window kab shuru hua
+  uint64_t rt_time;      // Is window mein RT tasks ka CPU time
+  int throttled;         // Budget khatam, window khatam hone tak RT band
+  uint32_t nr_throttled; // Kitni baar throttle hua
+} rt_bandwidth_t;
+
+// CPU time (har CPU ka apna): idle task ka time vs baaki sab
+typedef struct cpu_stat {
+  uint64_t idle_ns;
+  uint64_t busy_ns;
+} cpu_stat_t;
+
+// Har CPU ki apni run queue. Task sirf p->cpu wali queue pe hota hai;
+// doosri pe le jaana (stealing) dono locks pakad ke.
+typedef struct runqueue {
+  spinlock_t lock; // Saari classes ki queues + accounting, interrupts band
+  uint32_t bitmap[SCHED_BITMAP_WORDS];
+  process_t *head[SCHED_NR_PRIO];
+  process_t *tail[SCHED_NR_PRIO];
+  uint32_t nr_running;  // Queue pe READY processes
+  uint32_t nr_switches; // Asli context switches (dono classes)
+  fair_rq_t fair;
+  rt_bandwidth_t rt; // RT budget bhi per-CPU
+  cpu_stat_t stat;
+  process_t *curr; // Is CPU pe chalta task
+  process_t *idle; // Is CPU ka idle task
+  uint32_t cpu;
+  uint32_t nr_migrations; // Doosri queues se churaaye tasks
+} runqueue_t;
+
+#define SCHED_CPUS_ALL 0xFFFFFFFFu // cpus_allowed: koi bhi CPU
+
+// Load average (Linux jaisa): har LOAD_FREQ pe runnable tasks ki ginti
+// 1/5/15 min ke exponential averages mein, fixed-point (FSHIFT bits)
+#define LOAD_FSHIFT 11
+#define LOAD_FIXED_1 (1 << LOAD_FSHIFT)
+#define LOAD_FREQ_TICKS (5 * TIMER_HZ + 1) // ~5 sec, tick ke saath sync na ho
+#define LOAD_EXP_1 1884  // 1/exp(5sec/1min) fixed-point
+#define LOAD_EXP_5 2014  // 1/exp(5sec/5min)
+#define LOAD_EXP_15 2037 // 1/exp(5sec/15min)
+#define LOAD_INT(x) ((x) >> LOAD_FSHIFT)
+#define LOAD_FRAC(x) LOAD_INT(((x) & (LOAD_FIXED_1 - 1)) * 100)
+
+extern runqueue_t runqueues[SMP_MAX_CPUS];
+extern uint32_t avenrun[3]; // 1, 5, 15 min load, LOAD_FSHIFT fixed-point
+
+#define cpu_rq(c) (&runqueues[(c)])
+#define this_rq() cpu_rq(smp_processor_id())
+
+// Wakeup ne chalte hue task ko preempt karna ho to us CPU ka need_resched
+// (spinlock.h) - irq/syscall exit pe schedule() use dekh ke turant switch
+// karta hai, doosre CPU ko IPI.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Clocksource se ns (koi source na ho to 0, tab runtime/wait stats nahi
+// badhte)
+uint64_t sched_clock_ns();
+
+// Task ki class ki queue pe daalo / hatao, pehle se queued ho to kuch nahi
+void sched_enqueue(process_t *p);
+void sched_dequeue(process_t *p);
+
+// Naya process (fork/spawn/thread): class aur nice parent se, fair
+// vruntime min_vruntime ke baad, phir queue pe
+void sched_new_task(process_t *p, int inherit);
+
+// Blocked/sleeping process ko READY karke queue pe daalo. Zombie aur
+// chalte hue process ko nahi chhoota. Interrupt context se bhi safe.
+void sched_wakeup(process_t *p);
+
+// schedule() ka dimaag: old ko chalne do (old return), ya agla task queue se
+// nikal ke do (old RUNNING tha to wapas queue pe), ya 0 agar koi nahi.
+// rq is CPU ki, rq->lock pakda hua (interrupts band).
+process_t *sched_pick_next(runqueue_t *rq, process_t *old);
+
+// Normal class (PRIO/FAIR) aur nice badlo; RT task normal ban jaata hai.
+// Returns 0 ya -EINVAL.
+int sched_setattr(process_t *p, int sched_class, int nice);
+
+// POSIX policy (SCHED_OTHER/SCHED_FIFO/SCHED_RR) aur RT priority. OTHER
+// ke liye rt_priority 0, FIFO/RR ke liye 1-99. Returns 0 ya -EINVAL.
+int sched_setscheduler(process_t *p, int policy, int rt_priority);
+
+// Policy wahi, sirf RT priority badlo (normal task ke liye sirf 0 valid)
+int sched_setparam(process_t *p, int rt_priority);
+
+// Idle (PID 0) ke alawa kitne tasks chal rahe ya READY hain - clockevent
+// isi se tay karta hai ki periodic tick chahiye ya nahi
+uint32_t sched_nr_runnable();
+uint32_t sched_nr_runnable_cpu(uint32_t cpu); // Sirf us CPU ki queue
+
+// CPU ki run queue taiyaar, idle uska idle task (pinned). BSP ke liye
+// init_multitasking, AP ke liye smp_ap_entry.
+void sched_init_cpu(uint32_t cpu, process_t *idle);
+
+// Har tick (har CPU): baaki CPUs se load ka farak 2+ ho to ek task kheencho
+void sched_balance_tick();
+
+// Boot context ko idle task bana do aur kabhi wapas mat aao: runnable task
+// ho to schedule(), warna "sti; hlt". Load average tracking bhi yahin se.
+void cpu_idle() __attribute__((noreturn));
+
+// Saare CPUs ka cpu_stat jod ke, abhi tak ka (chalte tasks ka time bhi)
+void sched_cpu_time(uint64_t *idle_ns, uint64_t *busy_ns);
+
+// Ek CPU ke scheduler stats (nr_running, switches, migrations, time)
+void sched_cpu_info(uint32_t cpu, cpu_info_t *info);
+
+// Is CPU ki PRIO class ka queue head, ya 0 (non-READY entries yahin hat jaati hain)
+process_t *rq_peek();
+
+// Boot benchmark: 1, 10, 100 idle processes ke saath switch latency
+void sched_benchmark();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
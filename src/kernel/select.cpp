@@ -8,7 +8,9 @@
 #include "../include/poll.h"
 #include "../include/time.h"
 #include "../include/vfs.h"
+#include "pipe.h"
 #include "process.h"
+#include "socket.h"
 
 extern "C" {
 
@@ -18,30 +20,38 @@ extern uint32_t tick;
 // ============================================================================
 // Check if fd is ready for I/O
 // ============================================================================
-static int fd_is_readable(int fd) {
-  if (!current_process || fd < 0 || fd >= MAX_PROCESS_FILES)
-    return 0;
-  vfs_node_t *node = current_process->fd_table[fd]->node;
+int fd_poll(int fd, int events, struct wait_queue **wq) {
+  if (wq)
+    *wq = 0;
+  if (!current_process || fd < 0 || fd >= MAX_PROCESS_FILES ||
+      !current_process->fd_table[fd])
+    return POLLNVAL;
+  return node_poll(current_process->fd_table[fd]->node, events, wq);
+}
+
+int node_poll(vfs_node_t *node, int events, struct wait_queue **wq) {
+  wait_queue_t *dummy;
+  if (!wq)
+    wq = &dummy;
+  *wq = 0;
   if (!node)
-    return 0;
+    return POLLNVAL;
+
+  // Pipes aur sockets apna ring dekhte hain; files aur baaki devices kabhi
+  // block nahi karte maan lo
+  if (node->read == pipe_read || node->write == pipe_write)
+    return pipe_poll(node, wq);
+  if (node->flags == VFS_SOCKET)
+    return socket_vfs_poll(node, events, wq);
+  return POLLIN | POLLOUT;
+}
 
-  // For pipes and sockets, check if there's data
-  // For regular files, always readable
-  // Simplified: assume always readable for now
-  return 1;
+static int fd_is_readable(int fd) {
+  return fd_poll(fd, POLLIN, 0) & (POLLIN | POLLHUP);
 }
 
 static int fd_is_writable(int fd) {
-  if (!current_process || fd < 0 || fd >= MAX_PROCESS_FILES)
-    return 0;
-  vfs_node_t *node = current_process->fd_table[fd]->node;
-  if (!node)
-    return 0;
-
-  // For pipes and sockets, check if buffer has space
-  // For regular files, always writable
-  // Simplified: assume always writable for now
-  return 1;
+  return fd_poll(fd, POLLOUT, 0) & (POLLOUT | POLLERR);
 }
 
 static int fd_has_exception(int fd) {
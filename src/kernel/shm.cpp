@@ -4,9 +4,11 @@
 #include "../include/string.h"
 #include "heap.h"
 #include "memory.h"
+#include "paging.h"
 #include "pmm.h"
 #include "process.h"
 #include "vm.h"
+#include "vma.h"
 
 extern "C" {
 
@@ -102,9 +104,25 @@ void *sys_shmat(int shmid) {
   uint32_t phys = (uint32_t)(uintptr_t)seg->phys_addr;
   uint32_t num_pages = (seg->size + 4095) / SHM_PAGE_SIZE;
 
+  vma_list_t *vmas = &current_process->vmas;
+  vma_t *vma = vma_find(vmas, virt);
+  if (!vma || vma->backing != VMA_SHM) {
+    if (vma_insert(vmas, virt, virt + num_pages * SHM_PAGE_SIZE,
+                   VMA_READ | VMA_WRITE, VMA_SHM) != 0) {
+      serial_log_hex("SHM: VMA register failed for segment ", shmid);
+      return 0;
+    }
+  }
+
   for (uint32_t i = 0; i < num_pages; i++) {
-    vm_map_page(phys + i * SHM_PAGE_SIZE, virt + i * SHM_PAGE_SIZE,
-                7); // User|RW|Present
+    uint32_t page_phys = phys + i * SHM_PAGE_SIZE;
+    uint32_t page_virt = virt + i * SHM_PAGE_SIZE;
+    if (vm_get_phys(page_virt) == page_phys)
+      continue; // Pehle se attached hai
+    // Har mapping ek frame ref leti hai, taaki process exit pe pd_destroy
+    // segment ki memory free na kar de. PTE_SHARED -> fork pe COW nahi.
+    pmm_ref_frame((void *)(uintptr_t)page_phys);
+    vm_map_page(page_phys, page_virt, 7 | PTE_SHARED); // User|RW|Present
   }
 
   seg->ref_count++;
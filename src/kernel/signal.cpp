@@ -8,6 +8,7 @@
 #include "../include/errno.h"
 #include "heap.h"
 #include "process.h"
+#include "sched.h"
 
 extern "C" {
 
@@ -296,11 +297,15 @@ int sys_kill(int pid, int signum) {
     // Fall through to pgid handling
   }
 
+  // Keyboard IRQ (Ctrl+C) bhi list ghoomta hai - irqsave
+  uint32_t eflags = spin_lock_irqsave(&tasklist_lock);
+  int ret = -ESRCH;
+
   if (pid == -1) {
     // Sabko signal bhejo (khud ko aur init ko chhod ke)
     process_t *p = ready_queue;
     if (!p)
-      return -ESRCH;
+      goto out;
 
     bool found = false;
     process_t *start = p;
@@ -311,12 +316,13 @@ int sys_kill(int pid, int signum) {
         found = true;
         // Agar soya hua hai toh jagao
         if (p->state == PROCESS_WAITING)
-          p->state = PROCESS_READY;
+          sched_wakeup(p);
       }
       p = p->next;
     } while (p && p != start);
 
-    return found ? 0 : -ESRCH;
+    ret = found ? 0 : -ESRCH;
+    goto out;
   }
 
   if (pid < -1) {
@@ -324,7 +330,7 @@ int sys_kill(int pid, int signum) {
     int pgid = -pid;
     process_t *p = ready_queue;
     if (!p)
-      return -ESRCH;
+      goto out;
 
     bool found = false;
     process_t *start = p;
@@ -334,32 +340,38 @@ int sys_kill(int pid, int signum) {
           p->pending_signals |= ((sigset_t)1 << signum);
         found = true;
         if (p->state == PROCESS_WAITING)
-          p->state = PROCESS_READY;
+          sched_wakeup(p);
       }
       p = p->next;
     } while (p && p != start);
 
-    return found ? 0 : -ESRCH;
+    ret = found ? 0 : -ESRCH;
+    goto out;
   }
 
-  // pid > 0: Send to specific process
-  process_t *p = ready_queue;
-  if (!p)
-    return -ESRCH;
+  {
+    // pid > 0: Send to specific process
+    process_t *p = ready_queue;
+    if (!p)
+      goto out;
 
-  process_t *start = p;
-  do {
-    if (p->id == (uint32_t)pid) {
-      if (!signal_zero)
-        p->pending_signals |= ((sigset_t)1 << signum);
-      if (p->state == PROCESS_WAITING)
-        p->state = PROCESS_READY;
-      return 0;
-    }
-    p = p->next;
-  } while (p && p != start);
+    process_t *start = p;
+    do {
+      if (p->id == (uint32_t)pid) {
+        if (!signal_zero)
+          p->pending_signals |= ((sigset_t)1 << signum);
+        if (p->state == PROCESS_WAITING)
+          sched_wakeup(p);
+        ret = 0;
+        break;
+      }
+      p = p->next;
+    } while (p && p != start);
+  }
 
-  return -ESRCH;
+out:
+  spin_unlock_irqrestore(&tasklist_lock, eflags);
+  return ret;
 }
 
 // ============================================================================
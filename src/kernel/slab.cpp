@@ -2,31 +2,54 @@
 #include "../drivers/serial.h"
 #include "../include/string.h"
 #include "heap.h"
-
+#include "process.h"
+#include "spinlock.h"
 
 #define PAGE_SIZE 4096
 
-struct slab_header_t;
-
-struct slab_cache_t {
-  uint32_t object_size;
-  slab_header_t *first_slab;
-};
+// Slab kis list pe hai
+#define SLAB_PARTIAL 0
+#define SLAB_FULL 1
+#define SLAB_EMPTY 2
+#define SLAB_NR_LISTS 3
 
 struct slab_header_t {
   uint32_t magic;        // Magic to identify slab pages
-  slab_cache_t *cache;   // Pointer back to cache manager
-  slab_header_t *next;   // Next slab in this cache
+  kmem_cache_t *cache;   // Pointer back to cache manager
+  slab_header_t *next;   // Next slab on the same list
   slab_header_t *prev;   // Prev slab
-  uint32_t free_objects; // Count of free objects
-  uint32_t first_free;   // Index of first free object (freelist head)
-                         // Objects follow immediately after header
-  // Helper array (bitmask or linked list indices) might be needed,
-  // but for simplicity we'll use an embedded free list in the objects
-  // themselves.
+  void *freelist;        // First free object (embedded next pointer)
+  uint16_t inuse;        // Allocated objects in this slab
+  uint16_t list;         // SLAB_PARTIAL / SLAB_FULL / SLAB_EMPTY
+                         // Objects follow after the header (16-byte aligned)
+};
+
+// 16 pe aligned taaki KMEM_HWALIGN objects (FXSAVE area) seedha fit ho jaayein
+#define SLAB_OBJ_OFFSET ((sizeof(slab_header_t) + 15) & ~15u)
+#define SLAB_MAX_OBJ (PAGE_SIZE - SLAB_OBJ_OFFSET)
+
+struct kmem_cache {
+  spinlock_t lock; // Teeno lists + counters. Lock order: cache -> kheap
+  char name[KMEM_NAME_LEN];
+  uint32_t object_size;
+  uint32_t flags;
+  uint32_t objs_per_slab;
+  slab_header_t *lists[SLAB_NR_LISTS];
+  uint32_t nr_slabs;
+  uint32_t nr_empty;
+  uint32_t active;
+  uint32_t hits;
+  uint32_t misses;
+  uint32_t frees;
+  uint32_t reclaimed;
 };
 
-// Caches for powers of 2 (32 to 2048)
+// Cache descriptors static table mein - cache banane ke liye heap nahi chahiye
+static kmem_cache_t cache_table[KMEM_MAX_CACHES];
+static int nr_caches = 0;
+static DEFINE_SPINLOCK(cache_table_lock, "slab_table");
+
+// kmalloc size classes (powers of 2, 32 to 2048)
 // Indices:
 // 0: 32
 // 1: 64
@@ -36,10 +59,13 @@ struct slab_header_t {
 // 5: 1024
 // 6: 2048
 #define MAX_SLAB_INDEX 6
-slab_cache_t slab_caches[MAX_SLAB_INDEX + 1];
+static kmem_cache_t *kmalloc_caches[MAX_SLAB_INDEX + 1];
+
+kmem_cache_t *vfs_node_cache = 0;
+kmem_cache_t *file_desc_cache = 0;
 
 // Helpers
-int get_slab_index(uint32_t size) {
+static int get_slab_index(uint32_t size) {
   if (size <= 32)
     return 0;
   if (size <= 64)
@@ -57,90 +83,172 @@ int get_slab_index(uint32_t size) {
   return -1;
 }
 
-void slab_init() {
-  uint32_t sizes[] = {32, 64, 128, 256, 512, 1024, 2048};
-  for (int i = 0; i <= MAX_SLAB_INDEX; i++) {
-    slab_caches[i].object_size = sizes[i];
-    slab_caches[i].first_slab = 0;
+static void slab_list_add(kmem_cache_t *cache, slab_header_t *slab, int list) {
+  slab->list = list;
+  slab->prev = 0;
+  slab->next = cache->lists[list];
+  if (slab->next)
+    slab->next->prev = slab;
+  cache->lists[list] = slab;
+}
+
+static void slab_list_del(kmem_cache_t *cache, slab_header_t *slab) {
+  if (slab->prev)
+    slab->prev->next = slab->next;
+  else
+    cache->lists[slab->list] = slab->next;
+  if (slab->next)
+    slab->next->prev = slab->prev;
+  slab->next = slab->prev = 0;
+}
+
+static void slab_move(kmem_cache_t *cache, slab_header_t *slab, int list) {
+  slab_list_del(cache, slab);
+  slab_list_add(cache, slab, list);
+}
+
+static slab_header_t *slab_grow(kmem_cache_t *cache) {
+  // Page seedha buddy se - page aligned, header offset 0 pe
+  void *page = kheap_alloc_page();
+  if (!page) {
+    serial_log("SLAB: OOM allocating slab page!");
+    return 0;
   }
-  serial_log("SLAB: Initialized.");
+
+  slab_header_t *slab = (slab_header_t *)page;
+  slab->magic = SLAB_MAGIC;
+  slab->cache = cache;
+  slab->inuse = 0;
+  slab->next = slab->prev = 0;
+
+  // Embed free list in objects: pehle 4 bytes = next free object
+  uint8_t *base = (uint8_t *)slab + SLAB_OBJ_OFFSET;
+  slab->freelist = base;
+  for (uint32_t i = 0; i < cache->objs_per_slab - 1; i++)
+    *(void **)(base + i * cache->object_size) =
+        base + (i + 1) * cache->object_size;
+  *(void **)(base + (cache->objs_per_slab - 1) * cache->object_size) = 0;
+  return slab;
 }
 
-void *slab_alloc(uint32_t size) {
-  int idx = get_slab_index(size);
-  if (idx == -1)
-    return 0; // Too big for slab
+static void slab_release(kmem_cache_t *cache, slab_header_t *slab) {
+  slab_list_del(cache, slab);
+  cache->nr_slabs--;
+  cache->nr_empty--;
+  cache->reclaimed++;
+  slab->magic = 0; // Stale kfree ab isse slab nahi samjhega
+  kheap_free_page(slab);
+}
 
-  slab_cache_t *cache = &slab_caches[idx];
+kmem_cache_t *kmem_cache_create(const char *name, uint32_t size,
+                                uint32_t flags) {
+  // Free list pointer object ke andar hi rehta hai, aur 8-byte alignment
+  if (size < sizeof(void *))
+    size = sizeof(void *);
+  size = (size + 7) & ~7u;
+  if (flags & KMEM_HWALIGN)
+    size = (size + 15) & ~15u;
+  if (size > SLAB_MAX_OBJ) {
+    serial_log("SLAB: Object bada hai, ek page mein nahi aayega:");
+    serial_log(name);
+    return 0;
+  }
 
-  // 1. Search existing slabs
-  slab_header_t *slab = cache->first_slab;
-  while (slab) {
-    if (slab->free_objects > 0) {
-      break;
-    }
-    slab = slab->next;
+  uint32_t eflags = spin_lock_irqsave(&cache_table_lock);
+  if (nr_caches >= KMEM_MAX_CACHES) {
+    spin_unlock_irqrestore(&cache_table_lock, eflags);
+    serial_log("SLAB: Cache table full!");
+    return 0;
   }
+  kmem_cache_t *cache = &cache_table[nr_caches++];
+  spin_unlock_irqrestore(&cache_table_lock, eflags);
 
-  // 2. Create new slab if needed
-  if (!slab) {
-    // Allocate a page from the MAIN heap (page aligned)
-    // We use kmalloc_a(4096, 1, 0) but we need to ensure we don't recurse
-    // infinitely. kmalloc calls slab_alloc. So we must ensure slab_alloc is NOT
-    // called for 4096 bytes. 4096 > 2048, so it goes to main heap. Safe.
-    uint32_t phys;
-    void *page = kmalloc_real(PAGE_SIZE, 1, &phys);
-    if (!page) {
-      serial_log("SLAB: OOM allocating slab page!");
+  memset(cache, 0, sizeof(kmem_cache_t));
+  strncpy(cache->name, name, KMEM_NAME_LEN - 1);
+  spin_lock_init(&cache->lock, cache->name); // lockstat mein cache ke naam se
+  cache->object_size = size;
+  cache->flags = flags;
+  cache->objs_per_slab = SLAB_MAX_OBJ / size;
+  return cache;
+}
+
+void *kmem_cache_alloc(kmem_cache_t *cache) {
+  if (!cache)
+    return 0;
+
+  uint32_t eflags = spin_lock_irqsave(&cache->lock);
+
+  // 1. Partial slab, warna cached empty slab, warna naya page
+  slab_header_t *slab = cache->lists[SLAB_PARTIAL];
+  if (!slab && (slab = cache->lists[SLAB_EMPTY])) {
+    slab_move(cache, slab, SLAB_PARTIAL);
+    cache->nr_empty--;
+  }
+  if (slab) {
+    cache->hits++;
+  } else {
+    // Page lock ke bahar - heap OOM pe kmem_reap() har cache ka lock leta hai
+    spin_unlock_irqrestore(&cache->lock, eflags);
+    slab = slab_grow(cache);
+    if (!slab)
       return 0;
-    }
-
-    slab = (slab_header_t *)page;
-    slab->magic = SLAB_MAGIC;
-    slab->cache = cache;
-    slab->prev = 0;
-    slab->next = cache->first_slab;
-    if (cache->first_slab) {
-      cache->first_slab->prev = slab;
-    }
-    cache->first_slab = slab;
-
-    // Initialize Objects
-    // Layout: [Header] [Obj 0] [Obj 1] ...
-    // Embed free list in objects. First 4 bytes of free object = index of next
-    // free object.
-
-    uint32_t available_size = PAGE_SIZE - sizeof(slab_header_t);
-    uint32_t max_objs = available_size / cache->object_size;
-
-    slab->free_objects = max_objs;
-    slab->first_free = 0;
-
-    uint8_t *base = (uint8_t *)slab + sizeof(slab_header_t);
-
-    // Link all objects
-    for (uint32_t i = 0; i < max_objs - 1; i++) {
-      uint32_t *obj_ptr = (uint32_t *)(base + i * cache->object_size);
-      *obj_ptr = i + 1; // Point to next index
-    }
-    // Last object
-    uint32_t *last_obj =
-        (uint32_t *)(base + (max_objs - 1) * cache->object_size);
-    *last_obj = -1; // End of list
+    eflags = spin_lock_irqsave(&cache->lock);
+    cache->nr_slabs++;
+    slab_list_add(cache, slab, SLAB_PARTIAL);
+    cache->misses++;
   }
 
-  // 3. Allocate object
-  uint32_t obj_idx = slab->first_free;
-  uint8_t *base = (uint8_t *)slab + sizeof(slab_header_t);
-  uint32_t *obj_ptr = (uint32_t *)(base + obj_idx * cache->object_size);
+  // 2. Allocate object
+  void *obj = slab->freelist;
+  slab->freelist = *(void **)obj;
+  slab->inuse++;
+  cache->active++;
+  if (slab->inuse == cache->objs_per_slab)
+    slab_move(cache, slab, SLAB_FULL);
+
+  spin_unlock_irqrestore(&cache->lock, eflags);
 
-  slab->first_free = *obj_ptr; // Next free is what was stored here
-  slab->free_objects--;
+  if (cache->flags & KMEM_ZERO)
+    memset(obj, 0, cache->object_size);
+  return obj;
+}
+
+void *kmem_cache_zalloc(kmem_cache_t *cache) {
+  void *obj = kmem_cache_alloc(cache);
+  if (obj && !(cache->flags & KMEM_ZERO))
+    memset(obj, 0, cache->object_size);
+  return obj;
+}
+
+// Object ka slab header dhoondo: slab pages buddy se page aligned aate hain
+static slab_header_t *slab_of(void *ptr) {
+  slab_header_t *slab = (slab_header_t *)((uint32_t)ptr & 0xFFFFF000);
+  if (slab->magic != SLAB_MAGIC)
+    return 0;
+  if (slab->cache < &cache_table[0] || slab->cache >= &cache_table[nr_caches])
+    return 0;
+  return slab;
+}
+
+static void slab_free_obj(slab_header_t *slab, void *ptr) {
+  kmem_cache_t *cache = slab->cache;
+  int was_full = (slab->list == SLAB_FULL);
 
-  // Clear the memory (good practice, also clears the freelist pointer)
-  memset(obj_ptr, 0, cache->object_size);
+  *(void **)ptr = slab->freelist;
+  slab->freelist = ptr;
+  slab->inuse--;
+  cache->active--;
+  cache->frees++;
 
-  return (void *)obj_ptr;
+  if (slab->inuse == 0) {
+    slab_move(cache, slab, SLAB_EMPTY);
+    cache->nr_empty++;
+    // Bahut saare khaali slabs pakad ke mat baitho
+    if (cache->nr_empty > KMEM_EMPTY_KEEP)
+      slab_release(cache, slab);
+  } else if (was_full) {
+    slab_move(cache, slab, SLAB_PARTIAL);
+  }
 }
 
 int slab_free(void *ptr) {
@@ -148,35 +256,113 @@ int slab_free(void *ptr) {
     return 0;
 
   // Check if this pointer belongs to a slab page
-  // Slab pages are 4KB aligned, but kmalloc returns aligned+4.
-  uint32_t page_start = (uint32_t)ptr & 0xFFFFF000;
-  slab_header_t *slab = (slab_header_t *)(page_start + 4);
-
-  if (slab->magic != SLAB_MAGIC) {
+  slab_header_t *slab = slab_of(ptr);
+  if (!slab)
     return 0; // Not a slab page
-  }
-
-  // Calculate index
-  uint8_t *base = (uint8_t *)slab + sizeof(slab_header_t);
-  uint32_t offset = (uint32_t)ptr - (uint32_t)base;
 
   // Basic sanity check
-  if (offset % slab->cache->object_size != 0) {
+  uint32_t offset = (uint32_t)ptr - ((uint32_t)slab + SLAB_OBJ_OFFSET);
+  if ((uint32_t)ptr < (uint32_t)slab + SLAB_OBJ_OFFSET ||
+      offset % slab->cache->object_size != 0) {
     serial_log("SLAB: Warning, freeing invalid pointer (misaligned)!");
-    return 0; // Should panic/assert here
+    return 1; // Slab page hai - buddy ko mat bhejo
   }
 
-  uint32_t obj_idx = offset / slab->cache->object_size;
+  kmem_cache_t *cache = slab->cache;
+  uint32_t eflags = spin_lock_irqsave(&cache->lock);
+  slab_free_obj(slab, ptr);
+  spin_unlock_irqrestore(&cache->lock, eflags);
+  return 1; // Handled
+}
 
-  // Return to freelist
-  uint32_t *obj_ptr = (uint32_t *)ptr;
-  *obj_ptr = slab->first_free;
-  slab->first_free = obj_idx;
-  slab->free_objects++;
+void kmem_cache_free(kmem_cache_t *cache, void *obj) {
+  if (!obj)
+    return;
+  slab_header_t *slab = slab_of(obj);
+  if (!slab || slab->cache != cache) {
+    serial_log("SLAB: kmem_cache_free galat cache ke saath!");
+    serial_log(cache ? cache->name : "(null)");
+    return;
+  }
+  slab_free(obj);
+}
 
-  // Optional: If slab is empty (all objects free), return page to kheap
-  // But be careful about thrashing. For now, keep it simple.
-  // If we wanted to free: must unlink from cache list first.
+uint32_t kmem_cache_shrink(kmem_cache_t *cache) {
+  uint32_t freed = 0;
+  uint32_t eflags = spin_lock_irqsave(&cache->lock);
+  while (cache->lists[SLAB_EMPTY]) {
+    slab_release(cache, cache->lists[SLAB_EMPTY]);
+    freed++;
+  }
+  spin_unlock_irqrestore(&cache->lock, eflags);
+  return freed;
+}
 
-  return 1; // Handled
+uint32_t kmem_reap() {
+  uint32_t freed = 0;
+  for (int i = 0; i < nr_caches; i++)
+    freed += kmem_cache_shrink(&cache_table[i]);
+  return freed;
+}
+
+void *slab_alloc(uint32_t size) {
+  int idx = get_slab_index(size);
+  if (idx == -1)
+    return 0; // Too big for slab
+  return kmem_cache_alloc(kmalloc_caches[idx]);
+}
+
+int kmem_get_stats(kmem_cache_stats_t *out, int max) {
+  int n = 0;
+  for (int i = 0; i < nr_caches && n < max; i++, n++) {
+    kmem_cache_t *c = &cache_table[i];
+    // out user memory ho sakta hai - page fault lock pakde hue nahi
+    kmem_cache_stats_t snap;
+    kmem_cache_stats_t *s = &snap;
+    uint32_t eflags = spin_lock_irqsave(&c->lock);
+    memcpy(s->name, c->name, KMEM_NAME_LEN);
+    s->object_size = c->object_size;
+    s->objs_per_slab = c->objs_per_slab;
+    s->active_objs = c->active;
+    s->total_objs = c->nr_slabs * c->objs_per_slab;
+    s->slabs = c->nr_slabs;
+    s->empty_slabs = c->nr_empty;
+    s->hits = c->hits;
+    s->misses = c->misses;
+    s->frees = c->frees;
+    s->reclaimed = c->reclaimed;
+    spin_unlock_irqrestore(&c->lock, eflags);
+    out[n] = snap;
+  }
+  return n;
+}
+
+void kmem_print_stats() {
+  for (int i = 0; i < nr_caches; i++) {
+    kmem_cache_t *c = &cache_table[i];
+    serial_log("SLAB Cache:");
+    serial_log(c->name);
+    serial_log_hex("  Object Size: ", c->object_size);
+    serial_log_hex("  Active Objs: ", c->active);
+    serial_log_hex("  Total Objs: ", c->nr_slabs * c->objs_per_slab);
+    serial_log_hex("  Hits: ", c->hits);
+    serial_log_hex("  Misses: ", c->misses);
+    serial_log_hex("  Reclaimed: ", c->reclaimed);
+  }
+}
+
+void slab_init() {
+  static const char *names[] = {"kmalloc-32",  "kmalloc-64",  "kmalloc-128",
+                                "kmalloc-256", "kmalloc-512", "kmalloc-1024",
+                                "kmalloc-2048"};
+  uint32_t sizes[] = {32, 64, 128, 256, 512, 1024, 2048};
+  // Purane callers kmalloc se zeroed memory maan ke chalte hain
+  for (int i = 0; i <= MAX_SLAB_INDEX; i++)
+    kmalloc_caches[i] = kmem_cache_create(names[i], sizes[i], KMEM_ZERO);
+
+  // Har call site khud memset / saare fields set karta hai - zeroing nahi
+  vfs_node_cache = kmem_cache_create("vfs_node", sizeof(vfs_node_t), 0);
+  file_desc_cache =
+      kmem_cache_create("file_description", sizeof(file_description_t), 0);
+  serial_log("SLAB: Initialized.");
 }
@@ -3,14 +3,72 @@
 
 #include "../include/types.h"
 
-// Slab Allocator for small sizes
-// Supported sizes: 32, 64, 128, 256, 512, 1024, 2048
-// Objects larger than 2048 go to the main Large Heap
+// Slab Allocator
+// - kmalloc size classes: 32, 64, 128, 256, 512, 1024, 2048 (kmalloc-N)
+// - Named object caches (kmem_cache_create) hot kernel objects ke liye, exact
+//   size ke saath
+// Har slab ek 4KB page hai jo seedha buddy heap se aata hai: header page ke
+// start pe, objects uske baad. Har cache ki teen lists hain (partial / full /
+// empty), alloc hamesha partial list ke head se O(1) hota hai.
+// kfree() kisi bhi cache ka object uske apne cache mein wapas bhej deta hai.
 
 #define SLAB_MAGIC 0x51AB51AB // "SLAB SLAB"
 
+#define KMEM_NAME_LEN 24
+#define KMEM_MAX_CACHES 32
+
+// kmem_cache_create flags
+#define KMEM_ZERO 0x01    // Har alloc pe object zero karo (opt-in)
+#define KMEM_HWALIGN 0x02 // Objects 16-byte aligned (fxsave/SSE ke liye)
+
+// Har cache itne empty slabs cache mein rakhta hai, baaki page turant buddy
+// heap ko wapas. Memory pressure pe kmem_reap() ye bhi chhod deta hai.
+#define KMEM_EMPTY_KEEP 2
+
+typedef struct kmem_cache kmem_cache_t;
+
+// Per-cache runtime stats (SYS_SLAB_STATS yahi layout user ko deta hai)
+typedef struct kmem_cache_stats {
+  char name[KMEM_NAME_LEN];
+  uint32_t object_size;
+  uint32_t objs_per_slab;
+  uint32_t active_objs; // Abhi allocated objects
+  uint32_t total_objs;  // Saare slabs ki capacity
+  uint32_t slabs;       // partial + full + empty
+  uint32_t empty_slabs;
+  uint32_t hits;      // Alloc jo pehle se maujood slab se mila
+  uint32_t misses;    // Alloc jiske liye naya slab page lena pada
+  uint32_t frees;
+  uint32_t reclaimed; // Buddy heap ko wapas diye gaye slab pages
+} kmem_cache_stats_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 void slab_init();
-void *slab_alloc(uint32_t size);
+void *slab_alloc(uint32_t size); // kmalloc-N classes, object zeroed
 int slab_free(void *ptr); // Returns 1 if handled, 0 if not (passed to kfree)
 
+kmem_cache_t *kmem_cache_create(const char *name, uint32_t size,
+                                uint32_t flags);
+void *kmem_cache_alloc(kmem_cache_t *cache);
+void *kmem_cache_zalloc(kmem_cache_t *cache); // KMEM_ZERO ke bina bhi zeroed
+void kmem_cache_free(kmem_cache_t *cache, void *obj);
+
+// Empty slabs buddy heap ko wapas, returns pages freed
+uint32_t kmem_cache_shrink(kmem_cache_t *cache);
+uint32_t kmem_reap(); // Saare caches shrink (heap OOM pe)
+
+int kmem_get_stats(kmem_cache_stats_t *out, int max); // Returns cache count
+void kmem_print_stats();
+
+// Shared kernel object caches (slab_init mein bante hain)
+extern kmem_cache_t *vfs_node_cache;
+extern kmem_cache_t *file_desc_cache;
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif
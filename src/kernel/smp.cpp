@@ -0,0 +1,311 @@
+// SMP - AP bring-up (INIT/SIPI), IPIs, TLB shootdown aur big kernel lock
+#include "smp.h"
+#include "../drivers/acpi.h"
+#include "../drivers/serial.h"
+#include "../include/idt.h"
+#include "../include/isr.h"
+#include "../include/string.h"
+#include "apic.h"
+#include "clockevent.h"
+#include "fpu.h"
+#include "gdt.h"
+#include "paging.h"
+#include "process.h"
+#include "sched.h"
+#include "spinlock.h"
+#include "syscall.h"
+#include "tsc.h"
+
+extern idt_register_t idt_reg;
+
+cpu_t cpus[SMP_MAX_CPUS];
+volatile uint32_t smp_nr_online = 1;
+
+// smp_trampoline.asm - copy 0x7000 pe, data block BSP har AP se pehle bharta
+extern "C" char smp_trampoline_start[];
+extern "C" char smp_trampoline_end[];
+extern "C" char smp_trampoline_data[];
+
+typedef struct trampoline_data {
+  uint32_t cr3;
+  uint32_t stack;
+  uint32_t entry;
+} trampoline_data_t;
+
+// APs ek ek karke jaagte hain - jo abhi jaag raha hai uska logical number
+static volatile uint32_t ap_booting_cpu = 0;
+
+#define AP_BOOT_TIMEOUT_US 100000
+
+// ============================================================================
+// Big kernel lock: test-and-set + owner CPU. Recursive (IRQ apne hi CPU ke
+// lock pakde syscall ko rok ke phir lock_kernel karta hai), gehraai
+// cpu_t mein - task switch pe schedule() use bachata hai.
+// ============================================================================
+
+#define BKL_NO_OWNER 0xFFFFFFFF
+
+static volatile int bkl_locked = 0;
+static volatile uint32_t bkl_owner = BKL_NO_OWNER;
+
+// Interrupts chalu rehte hue ghoomo - hum preempt hoke doosre CPU pe bhi
+// pahunch sakte hain, isliye har baar CPU dobara padho
+void lock_kernel() {
+  for (;;) {
+    uint32_t eflags = local_irq_save();
+    cpu_t *c = this_cpu();
+    if (bkl_owner == c->id) {
+      c->bkl_depth++;
+      local_irq_restore(eflags);
+      return;
+    }
+    if (!__sync_lock_test_and_set(&bkl_locked, 1)) {
+      bkl_owner = c->id;
+      c->bkl_depth = 1;
+      local_irq_restore(eflags);
+      return;
+    }
+    local_irq_restore(eflags);
+    // Holder shootdown ka ack maang raha ho sakta hai
+    while (bkl_locked) {
+      asm volatile("pause" ::: "memory");
+      smp_tlb_poll();
+    }
+  }
+}
+
+void unlock_kernel() {
+  uint32_t eflags = local_irq_save();
+  cpu_t *c = this_cpu();
+  if (bkl_owner == c->id && c->bkl_depth > 0 && --c->bkl_depth == 0) {
+    bkl_owner = BKL_NO_OWNER;
+    __sync_lock_release(&bkl_locked);
+  }
+  local_irq_restore(eflags);
+}
+
+int release_kernel_lock() {
+  uint32_t eflags = local_irq_save();
+  cpu_t *c = this_cpu();
+  int depth = 0;
+  if (bkl_owner == c->id) {
+    depth = c->bkl_depth;
+    c->bkl_depth = 0;
+    bkl_owner = BKL_NO_OWNER;
+    __sync_lock_release(&bkl_locked);
+  }
+  local_irq_restore(eflags);
+  return depth;
+}
+
+void reacquire_kernel_lock(int depth) {
+  if (!depth)
+    return;
+  lock_kernel();
+  this_cpu()->bkl_depth = depth;
+}
+
+// ============================================================================
+// IPIs
+// ============================================================================
+
+void smp_send_reschedule(uint32_t cpu) {
+  if (cpu >= SMP_MAX_CPUS || !cpus[cpu].online)
+    return;
+  lapic_send_ipi(cpus[cpu].apic_id, IPI_RESCHEDULE_VECTOR);
+}
+
+// need_resched bhejne wale ne pehle hi set kiya hai - irq_handler ke exit
+// pe schedule(). BSP pe AP ne naya timer/task daala ho sakta hai jabki
+// tick ruka hua hai.
+static void ipi_resched_handler(registers_t *regs) {
+  (void)regs;
+  cpu_t *c = this_cpu();
+  c->nr_ipi_resched++;
+  if (c->id == 0)
+    clockevent_ipi();
+}
+
+// Shootdown request - ek waqt pe ek (tlb_lock)
+static DEFINE_SPINLOCK(tlb_lock, "tlb_shootdown");
+static volatile uint32_t tlb_req_start = 0;
+static volatile uint32_t tlb_req_pages = 0;
+
+static void flush_tlb_local(uint32_t start, uint32_t pages) {
+  if (pages > TLB_FLUSH_ALL_PAGES) {
+    uint32_t cr3;
+    asm volatile("mov %%cr3, %0; mov %0, %%cr3" : "=r"(cr3) : : "memory");
+    return;
+  }
+  for (uint32_t i = 0; i < pages; i++)
+    asm volatile("invlpg (%0)" : : "r"(start + i * 4096) : "memory");
+}
+
+void smp_tlb_ack() {
+  uint32_t eflags = local_irq_save();
+  cpu_t *c = this_cpu();
+  if (c->tlb_pending) {
+    flush_tlb_local(tlb_req_start, tlb_req_pages);
+    c->nr_ipi_tlb++;
+    __sync_synchronize();
+    c->tlb_pending = 0; // Bhejne wala ab request globals badal sakta hai
+  }
+  local_irq_restore(eflags);
+}
+
+static void ipi_tlb_handler(registers_t *regs) {
+  (void)regs;
+  smp_tlb_ack();
+}
+
+void smp_flush_tlb_range(uint32_t start, uint32_t pages) {
+  if (smp_nr_online < 2) {
+    flush_tlb_local(start, pages);
+    return;
+  }
+
+  // Dono shootdowns ek saath bhejne wale ek doosre ka intezaar na karein -
+  // tlb_lock ka slowpath bhi request poll karta hai
+  uint32_t eflags = spin_lock_irqsave(&tlb_lock);
+  cpu_t *self = this_cpu();
+  flush_tlb_local(start, pages);
+
+  tlb_req_start = start;
+  tlb_req_pages = pages;
+  __sync_synchronize();
+  for (uint32_t c = 0; c < SMP_MAX_CPUS; c++) {
+    if (c == self->id || !cpus[c].online)
+      continue;
+    cpus[c].tlb_pending = 1;
+    lapic_send_ipi(cpus[c].apic_id, IPI_TLB_VECTOR);
+  }
+  // Interrupts band CPU (kisi spinlock pe ghoomta) IPI nahi lega, par apne
+  // spin loop mein khud ack kar dega
+  for (uint32_t c = 0; c < SMP_MAX_CPUS; c++) {
+    while (cpus[c].tlb_pending)
+      asm volatile("pause" ::: "memory");
+  }
+  self->nr_tlb_flushes++;
+  spin_unlock_irqrestore(&tlb_lock, eflags);
+}
+
+// ============================================================================
+// AP bring-up
+// ============================================================================
+
+void smp_ap_entry() {
+  uint32_t cpu = ap_booting_cpu;
+  cpu_t *c = &cpus[cpu];
+
+  // Trampoline ka flat GDT hatao - ab se %gs = cpus[cpu]
+  gdt_init_ap(cpu);
+  asm volatile("lidt %0" : : "m"(idt_reg));
+  fpu_init_ap();
+  lapic_init_ap();
+  sysenter_init_cpu();
+
+  set_current(c->idle);
+  sched_init_cpu(cpu, c->idle);
+  clockevent_init_ap();
+
+  __sync_synchronize();
+  c->online = 1;
+  __sync_fetch_and_add(&smp_nr_online, 1);
+  cpu_idle();
+}
+
+// INIT, 10ms, do baar SIPI (Intel MP spec). Returns 0 agar AP online aaya.
+static int smp_boot_ap(uint32_t cpu, uint32_t apic_id,
+                       trampoline_data_t *data) {
+  process_t *idle = create_idle_process(cpu);
+  cpus[cpu].apic_id = apic_id;
+  cpus[cpu].idle = idle;
+
+  data->cr3 = VIRT_TO_PHYS(kernel_directory);
+  data->stack = idle->kernel_stack_top;
+  data->entry = (uint32_t)smp_ap_entry;
+  ap_booting_cpu = cpu;
+  __sync_synchronize();
+
+  lapic_send_init(apic_id);
+  udelay(10000);
+  lapic_send_startup(apic_id, SMP_TRAMPOLINE_BASE >> 12);
+  udelay(200);
+  lapic_send_startup(apic_id, SMP_TRAMPOLINE_BASE >> 12);
+
+  for (uint32_t waited = 0; waited < AP_BOOT_TIMEOUT_US; waited += 100) {
+    if (cpus[cpu].online)
+      return 0;
+    udelay(100);
+  }
+
+  // Nahi aaya - INIT se wapas SIPI ke intezaar mein, taaki baad mein jaag
+  // ke agle AP ka number/stack na utha le. Idle task leak (ek baar, boot pe).
+  lapic_send_init(apic_id);
+  cpus[cpu].idle = 0;
+  return -1;
+}
+
+void smp_init() {
+  cpus[0].apic_id = lapic_id();
+  register_interrupt_handler(IPI_RESCHEDULE_VECTOR, ipi_resched_handler);
+  register_interrupt_handler(IPI_TLB_VECTOR, ipi_tlb_handler);
+
+  acpi_madt_t *madt = (acpi_madt_t *)acpi_find_table("APIC");
+  if (!madt) {
+    serial_log("SMP: No MADT, single CPU.");
+    return;
+  }
+
+  uint8_t *base = (uint8_t *)PHYS_TO_VIRT(SMP_TRAMPOLINE_BASE);
+  memcpy(base, smp_trampoline_start,
+         smp_trampoline_end - smp_trampoline_start);
+  trampoline_data_t *data =
+      (trampoline_data_t *)(base +
+                            (smp_trampoline_data - smp_trampoline_start));
+
+  uint32_t next = 1;
+  uint8_t *p = madt->entries;
+  uint8_t *end = (uint8_t *)madt + madt->header.length;
+  while (p + sizeof(acpi_madt_entry_t) <= end) {
+    acpi_madt_entry_t *e = (acpi_madt_entry_t *)p;
+    if (!e->length)
+      break;
+    if (e->type == 0) {
+      acpi_madt_lapic_t *l = (acpi_madt_lapic_t *)e;
+      if ((l->flags & 1) && l->apic_id != cpus[0].apic_id) {
+        if (next >= SMP_MAX_CPUS) {
+          serial_log_hex("SMP: Too many CPUs, skipping APIC ID ", l->apic_id);
+        } else if (smp_boot_ap(next, l->apic_id, data) == 0) {
+          serial_log_hex("SMP: CPU online, APIC ID ", l->apic_id);
+          next++;
+        } else {
+          serial_log_hex("SMP: AP did not start, APIC ID ", l->apic_id);
+        }
+      }
+    }
+    p += e->length;
+  }
+
+  serial_log_hex("SMP: CPUs online: ", smp_nr_online);
+}
+
+int smp_get_cpu_info(cpu_info_t *out, int max) {
+  int n = 0;
+  for (uint32_t c = 0; c < SMP_MAX_CPUS && n < max; c++) {
+    if (!cpus[c].online)
+      continue;
+    // Pehle local mein - out user memory ho sakta hai, runqueue lock pakde
+    // page fault nahi
+    cpu_info_t info;
+    memset(&info, 0, sizeof(info));
+    info.cpu = c;
+    info.apic_id = cpus[c].apic_id;
+    info.online = 1;
+    sched_cpu_info(c, &info);
+    info.nr_ipi_resched = cpus[c].nr_ipi_resched;
+    info.nr_ipi_tlb = cpus[c].nr_ipi_tlb;
+    memcpy(&out[n++], &info, sizeof(info));
+  }
+  return n;
+}
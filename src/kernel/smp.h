@@ -0,0 +1,153 @@
+// SMP - per-CPU data, AP bring-up, IPIs aur big kernel lock
+#ifndef SMP_H
+#define SMP_H
+
+#include "../include/types.h"
+
+// Har CPU ka apna cpu_t. GDT mein har CPU ke liye do entries hain: uska TSS
+// aur theek uske baad ek chhota data segment jiska base &cpus[n] hai. Kernel
+// mein %gs hamesha isi segment pe rehta hai (interrupt stubs "str" se TSS
+// selector padh ke +8 load karte hain), to current task, preempt_count waghera
+// ek hi "mov %gs:off" se milte hain - beech mein preempt hoke doosre CPU pe
+// pahunch jaane ka darr nahi.
+//
+// Kernel abhi bhi ek CPU ke hisaab se likha hai (drivers, VFS, GUI, net),
+// isliye big kernel lock: user mode se kernel mein aate hi (syscall, fault,
+// device IRQ) lock_kernel(), bahar jaate hi unlock_kernel(). schedule() lock
+// chhod deta hai aur task ke wapas chalne pe utni hi gehraai se wapas leta
+// hai - kernel code ke interleavings wahi rehte hain jo ek CPU pe the, aur
+// user mode ka kaam saare CPUs pe saath chalta hai. Scheduler, idle loop,
+// IPIs aur AP ka tick lock ke bina, apne spinlocks se.
+
+#define SMP_MAX_CPUS 8
+#define SMP_TRAMPOLINE_BASE 0x7000 // Kernel 0x8000 pe load hota hai, ek page neeche
+#define SMP_AP_STACK_SIZE 16384
+
+// IPI vectors (LAPIC timer 48 ke baad)
+#define IPI_RESCHEDULE_VECTOR 49 // Naya task queue pe / resched chahiye
+#define IPI_TLB_VECTOR 50        // Kernel mapping badli, TLB flush karo
+
+// Itne se zyada pages ho to invlpg ki jagah poora CR3 reload
+#define TLB_FLUSH_ALL_PAGES 32
+
+struct process;
+
+typedef struct cpu {
+  struct cpu *self;                // %gs:0 - this_cpu()
+  struct process *current;         // Is CPU pe chalta task
+  volatile uint32_t preempt_count; // Spinlocks pakde hain - switch nahi
+  volatile int need_resched;       // IRQ/syscall exit pe schedule()
+  uint32_t id;                     // Logical number, 0 = BSP
+  uint32_t stack_canary; // %gs:20 - gcc -fstack-protector yahin se padhta hai
+  uint32_t apic_id;
+  volatile int online;
+  int bkl_depth;         // Big kernel lock ki gehraai (owner CPU pe)
+  struct process *idle;  // Is CPU ka idle task
+  struct process *prev;  // switch_task ke beech chhoda gaya task
+  struct process *fpu_owner; // Lazy FPU: jiske registers is CPU mein live
+  int fpu_ts;                // CR0.TS ki copy
+  int kernel_fpu_active;
+  uint32_t kernel_fpu_eflags;
+  volatile int tlb_pending; // Shootdown request aayi, ack baaki
+  uint32_t nr_ipi_resched;  // Mile hue IPIs
+  uint32_t nr_ipi_tlb;
+  uint32_t nr_tlb_flushes; // Shootdowns jo is CPU ne bheje
+  // SYSENTER ka ESP sysenter_tss pe (MSR). Entry wahan se TSS, phir esp0
+  // padhta hai; beech mein NMI/debug aaye to neeche ke 16 words mein gire,
+  // TSS pe nahi.
+  uint32_t sysenter_stack[16];
+  uint32_t sysenter_tss; // &tss_entries[id]
+} cpu_t;
+
+// SYS_CPU_INFO yahi layout user ko deta hai
+typedef struct cpu_info {
+  uint32_t cpu;
+  uint32_t apic_id;
+  uint32_t online;
+  uint32_t nr_running;    // Queue pe READY + chalta hua (idle nahi)
+  uint32_t nr_switches;
+  uint32_t nr_migrations; // Is CPU ne doosron se kitne tasks churaaye
+  uint32_t nr_ipi_resched;
+  uint32_t nr_ipi_tlb;
+  uint64_t busy_ns;
+  uint64_t idle_ns;
+} cpu_info_t;
+
+extern cpu_t cpus[SMP_MAX_CPUS];
+extern volatile uint32_t smp_nr_online; // Online CPUs (BSP bhi)
+
+#define CPU_OFF(field) __builtin_offsetof(cpu_t, field)
+
+// i386 gcc canary %gs:20 se leta hai. Sab CPUs pe ek hi value - task ek CPU
+// pe function mein ghusa aur doosre pe nikla to bhi match kare.
+static_assert(CPU_OFF(stack_canary) == 20, "stack canary %gs:20 pe hona chahiye");
+
+static inline cpu_t *this_cpu() {
+  cpu_t *c;
+  asm volatile("mov %%gs:0, %0" : "=r"(c));
+  return c;
+}
+
+static inline uint32_t smp_processor_id() {
+  uint32_t id;
+  asm volatile("mov %%gs:%c1, %0" : "=r"(id) : "i"(CPU_OFF(id)));
+  return id;
+}
+
+static inline struct process *get_current() {
+  struct process *p;
+  asm volatile("mov %%gs:%c1, %0" : "=r"(p) : "i"(CPU_OFF(current)));
+  return p;
+}
+
+static inline void set_current(struct process *p) {
+  asm volatile("mov %0, %%gs:%c1" : : "r"(p), "i"(CPU_OFF(current))
+               : "memory");
+}
+
+#define current_process (get_current())
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// MADT se CPUs gino, har AP ko INIT/SIPI se jagao. BSP pe, clockevent ke
+// baad (AP ka tick usi ki LAPIC calibration se chalta hai).
+void smp_init();
+
+// Trampoline se, har AP yahan aata hai (paging on, apna stack)
+void smp_ap_entry() __attribute__((noreturn));
+
+void smp_send_reschedule(uint32_t cpu);
+
+// Kernel mapping (vmalloc waghera) badli: is CPU pe invlpg, baaki online
+// CPUs ko IPI aur sabke ack tak intezaar. Caller ke paas locks ho sakte hain
+// - intezaar karte CPUs spin loops mein request poll karte hain.
+void smp_flush_tlb_range(uint32_t start, uint32_t pages);
+
+// Pending TLB shootdown ho to abhi nipta do (spin loops se)
+void smp_tlb_ack();
+
+// Big kernel lock. Recursive - IRQ apne hi CPU ke lock pakde code ko rok
+// sakta hai.
+void lock_kernel();
+void unlock_kernel();
+// schedule(): poora chhodo (gehraai lautao), switch ke baad wapas lo
+int release_kernel_lock();
+void reacquire_kernel_lock(int depth);
+
+// Online CPUs ke stats, returns kitne bhare
+int smp_get_cpu_info(cpu_info_t *out, int max);
+
+#ifdef __cplusplus
+}
+#endif
+
+static inline void smp_tlb_poll() {
+  int pending;
+  asm volatile("mov %%gs:%c1, %0" : "=r"(pending) : "i"(CPU_OFF(tlb_pending)));
+  if (pending)
+    smp_tlb_ack();
+}
+
+#endif
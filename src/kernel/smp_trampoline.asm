@@ -0,0 +1,65 @@
+; SMP AP trampoline - BSP ise SMP_TRAMPOLINE_BASE (0x7000) pe copy karke
+; SIPI vector 0x07 bhejta hai. AP real mode mein 0x0700:0000 se shuru hota
+; hai: apna chhota GDT, protected mode, kernel ka CR3, paging on, phir
+; BSP ke bhare stack aur entry (smp_ap_entry) pe.
+;
+; Kernel .text mein hi link hota hai (0xC000xxxx), par chalta copy se - isliye
+; har address TR() se 0x7000 wala banta hai. 0x7000 kernel_directory ke
+; identity map (0-512MB) mein hai, to paging on hone ke baad bhi agla
+; instruction wahi milta hai.
+
+%define TR(x) (0x7000 + (x) - smp_trampoline_start)
+
+[GLOBAL smp_trampoline_start]
+[GLOBAL smp_trampoline_end]
+[GLOBAL smp_trampoline_data]
+
+section .text
+
+[BITS 16]
+smp_trampoline_start:
+    cli
+    cld
+    xor ax, ax
+    mov ds, ax
+    lgdt [TR(tr_gdt_ptr)]
+    mov eax, cr0
+    or eax, 0x1               ; PE
+    mov cr0, eax
+    jmp dword 0x08:TR(tr_protected)
+
+[BITS 32]
+tr_protected:
+    mov ax, 0x10
+    mov ds, ax
+    mov es, ax
+    mov fs, ax
+    mov gs, ax
+    mov ss, ax
+
+    mov eax, [TR(smp_trampoline_data)]     ; cr3 (physical)
+    mov cr3, eax
+    mov eax, cr0
+    or eax, 0x80010000        ; PG | WP, BSP ke paging init jaisa
+    mov cr0, eax
+
+    mov esp, [TR(smp_trampoline_data) + 4] ; Idle task ka stack top
+    mov eax, [TR(smp_trampoline_data) + 8] ; smp_ap_entry (virtual)
+    jmp eax
+
+; Flat code/data - kernel GDT ke 0x08/0x10 jaise. smp_ap_entry asli GDT
+; load karta hai.
+tr_gdt:
+    dq 0
+    dq 0x00CF9A000000FFFF
+    dq 0x00CF92000000FFFF
+tr_gdt_ptr:
+    dw 23
+    dd TR(tr_gdt)
+
+; BSP har AP se pehle bharta hai (smp.cpp: trampoline_data_t)
+smp_trampoline_data:
+    dd 0                      ; cr3
+    dd 0                      ; stack
+    dd 0                      ; entry
+smp_trampoline_end:
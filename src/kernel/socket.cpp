@@ -1,29 +1,36 @@
 #include "socket.h"
 #include "../drivers/serial.h"
+#include "../include/poll.h"
 #include "../include/string.h"
 #include "heap.h"
 #include "memory.h"
+#include "slab.h"
 #include "process.h"
 
 #define MAX_SOCKETS 64
+#define SOCKET_RING_SIZE 4096
 static socket_t *sockets[MAX_SOCKETS];
 
+// socket_t apne cache se. 4KB ring kmalloc se 8KB buddy block kha jata tha
+// (header ki wajah se), isliye seedha ek exact heap page.
+static kmem_cache_t *socket_cache;
+
 void socket_init() {
   for (int i = 0; i < MAX_SOCKETS; i++)
     sockets[i] = 0;
+  socket_cache = kmem_cache_create("socket", sizeof(socket_t), KMEM_ZERO);
 }
 
 static socket_t *alloc_socket() {
   for (int i = 0; i < MAX_SOCKETS; i++) {
     if (!sockets[i]) {
-      sockets[i] = (socket_t *)kmalloc(sizeof(socket_t));
+      sockets[i] = (socket_t *)kmem_cache_alloc(socket_cache);
       if (!sockets[i]) {
         serial_log("SOCKET ERROR: memory kam pad gayi alloc_socket mein");
         return 0;
       }
-      memset(sockets[i], 0, sizeof(socket_t));
       sockets[i]->id = i;
-      sockets[i]->buffer = (uint8_t *)kmalloc(4096);
+      sockets[i]->buffer = (uint8_t *)kheap_alloc_page();
       if (!sockets[i]->buffer) {
         serial_log("SOCKET ERROR: OOM for buffer in alloc_socket");
         kfree(sockets[i]);
@@ -47,27 +54,19 @@ uint32_t socket_read(vfs_node_t *node, uint32_t offset, uint32_t size,
   uint32_t read_bytes = 0;
   while (read_bytes < size) {
     if (sock->head == sock->tail) {
-      if (read_bytes > 0)
-        break;
+      if (read_bytes > 0 || !sock->peer)
+        break; // Peer chala gaya aur ring khaali - EOF
       // Block
-      current_process->state = PROCESS_WAITING;
-      schedule();
+      wait_event(&sock->read_wait, sock->head != sock->tail || !sock->peer);
       continue;
     }
     buffer[read_bytes++] = sock->buffer[sock->head];
-    sock->head = (sock->head + 1) % 4096;
+    sock->head = (sock->head + 1) % SOCKET_RING_SIZE;
   }
 
-  // Baaki processes ko jagao agar wo wait kar rahe hain
-  process_t *p = ready_queue;
-  if (p) {
-    process_t *start = p;
-    do {
-      if (p->state == PROCESS_WAITING)
-        p->state = PROCESS_READY;
-      p = p->next;
-    } while (p && p != start);
-  }
+  // Ring mein jagah bani - peer ke writers (apni queue pe) jagao
+  if (read_bytes > 0 && sock->peer)
+    wake_up(&sock->peer->write_wait);
 
   return read_bytes;
 }
@@ -82,33 +81,68 @@ uint32_t socket_write(vfs_node_t *node, uint32_t offset, uint32_t size,
   socket_t *peer = sock->peer;
   uint32_t written = 0;
   while (written < size) {
-    uint32_t next_tail = (peer->tail + 1) % 4096;
+    uint32_t next_tail = (peer->tail + 1) % SOCKET_RING_SIZE;
     if (next_tail == peer->head) {
       if (written > 0)
         break;
       // Block
-      current_process->state = PROCESS_WAITING;
-      schedule();
+      wait_event(&sock->write_wait,
+                 !sock->peer ||
+                     (peer->tail + 1) % SOCKET_RING_SIZE != peer->head);
+      if (!sock->peer)
+        break; // Sote hue peer close ho gaya
       continue;
     }
     peer->buffer[peer->tail] = buffer[written++];
     peer->tail = next_tail;
   }
 
-  // Peer side pe jo wait kar rahe hain unhe jagao
-  process_t *p = ready_queue;
-  if (p) {
-    process_t *start = p;
-    do {
-      if (p->state == PROCESS_WAITING)
-        p->state = PROCESS_READY;
-      p = p->next;
-    } while (p && p != start);
-  }
+  // Peer side pe jo padhne ke liye so rahe hain unhe jagao
+  if (written > 0)
+    wake_up(&peer->read_wait);
 
   return written;
 }
 
+extern "C" int socket_poll(int sockfd, int timeout_ms); // socket_api.cpp
+
+int socket_vfs_poll(vfs_node_t *node, int events, wait_queue_t **wq) {
+  socket_t *sock = (socket_t *)node->impl;
+  *wq = 0;
+  if (!sock)
+    return POLLNVAL;
+
+  if (sock->domain == AF_INET) {
+    int revents = POLLOUT; // net_send TCP window ka intezaar nahi karta
+    if (socket_poll(sock->net_socket_id, 0) > 0)
+      revents |= POLLIN;
+    return revents;
+  }
+
+  int revents = 0;
+  if (sock->state == SOCKET_LISTENING) {
+    if (sock->backlog_count > 0)
+      revents |= POLLIN; // accept nahi rukega
+  } else if (sock->state == SOCKET_CONNECTED) {
+    socket_t *peer = sock->peer;
+    if (sock->head != sock->tail)
+      revents |= POLLIN;
+    if (!peer)
+      revents |= POLLHUP; // read EOF, write 0 - dono turant
+    else if ((peer->tail + 1) % SOCKET_RING_SIZE != peer->head)
+      revents |= POLLOUT;
+    if (!(events & POLLIN) && peer) {
+      *wq = &sock->write_wait; // socket_write bhi yahin sota hai
+      return revents;
+    }
+  } else if (sock->state == SOCKET_CLOSED) {
+    revents |= POLLHUP;
+  }
+  // Data, peer close, backlog aur connect poora hona - sab read_wait pe
+  *wq = &sock->read_wait;
+  return revents;
+}
+
 void socket_close(vfs_node_t *node) {
   socket_t *sock = (socket_t *)(uintptr_t)node->impl;
   if (!sock)
@@ -116,6 +150,16 @@ void socket_close(vfs_node_t *node) {
 
   sock->state = SOCKET_CLOSED;
 
+  // Peer ko EOF dikhe aur uske readers/writers jaagein - socket free hone
+  // ke baad dangling peer pointer na rahe. Peer ke writers peer ki hi
+  // write_wait pe sote hain - is socket ki queues pe koi baahar wala nahi.
+  if (sock->peer) {
+    socket_t *peer = sock->peer;
+    peer->peer = 0;
+    wake_up_all(&peer->read_wait);
+    wake_up_all(&peer->write_wait);
+  }
+
   // Global array se hatao isse
   for (int i = 0; i < MAX_SOCKETS; i++) {
     if (sockets[i] == sock) {
@@ -126,7 +170,7 @@ void socket_close(vfs_node_t *node) {
 
   // Saman saaf karo (free resources)
   if (sock->buffer) {
-    kfree(sock->buffer);
+    kheap_free_page(sock->buffer);
   }
   kfree(sock);
 }
@@ -170,14 +214,13 @@ int sys_socket(int domain, int type, int protocol) {
     if (net_id < 0)
       return -1;
 
-    socket_t *sock = (socket_t *)kmalloc(sizeof(socket_t));
-    memset(sock, 0, sizeof(socket_t));
+    socket_t *sock = (socket_t *)kmem_cache_alloc(socket_cache);
     sock->domain = AF_INET;
     sock->type = type;
     sock->net_socket_id = net_id;
     sock->state = SOCKET_FREE;
 
-    vfs_node_t *node = (vfs_node_t *)kmalloc(sizeof(vfs_node_t));
+    vfs_node_t *node = (vfs_node_t *)kmem_cache_alloc(vfs_node_cache);
     memset(node, 0, sizeof(vfs_node_t));
     strcpy(node->name, "inet_socket");
     node->impl = (void *)sock;
@@ -190,7 +233,7 @@ int sys_socket(int domain, int type, int protocol) {
     for (int i = 0; i < MAX_PROCESS_FILES; i++) {
       if (!current_process->fd_table[i]) {
         file_description_t *desc =
-            (file_description_t *)kmalloc(sizeof(file_description_t));
+            (file_description_t *)kmem_cache_alloc(file_desc_cache);
         desc->node = node;
         desc->offset = 0;
         desc->flags = O_RDWR;
@@ -217,7 +260,7 @@ int sys_socket(int domain, int type, int protocol) {
   sock->type = type;
   sock->state = SOCKET_FREE;
 
-  vfs_node_t *node = (vfs_node_t *)kmalloc(sizeof(vfs_node_t));
+  vfs_node_t *node = (vfs_node_t *)kmem_cache_alloc(vfs_node_cache);
   if (!node) {
     serial_log("SOCKET ERROR: OOM for vfs_node");
     // TODO: sock ko free karna hai
@@ -235,7 +278,7 @@ int sys_socket(int domain, int type, int protocol) {
   for (int i = 0; i < MAX_PROCESS_FILES; i++) {
     if (!current_process->fd_table[i]) {
       file_description_t *desc =
-          (file_description_t *)kmalloc(sizeof(file_description_t));
+          (file_description_t *)kmem_cache_alloc(file_desc_cache);
       desc->node = node;
       desc->offset = 0;
       desc->flags = O_RDWR;
@@ -339,21 +382,10 @@ int sys_connect(int sockfd, const void *addr, uint32_t addrlen) {
     sock->state = SOCKET_CONNECTING;
 
     // Server ko jagao! (Accept mein betha hoga bechara)
-    process_t *p = ready_queue;
-    if (p) {
-      process_t *start = p;
-      do {
-        if (p->state == PROCESS_WAITING)
-          p->state = PROCESS_READY;
-        p = p->next;
-      } while (p && p != start);
-    }
+    wake_up(&server->read_wait);
 
     // Sula do jab tak connect nahi hota
-    while (sock->state == SOCKET_CONNECTING) {
-      current_process->state = PROCESS_WAITING;
-      schedule();
-    }
+    wait_event(&sock->read_wait, sock->state != SOCKET_CONNECTING);
     return 0;
   }
 
@@ -369,10 +401,8 @@ int sys_accept(int sockfd) {
     return -1;
   socket_t *server = (socket_t *)(uintptr_t)node->impl;
 
-  while (server->backlog_count == 0) {
-    current_process->state = PROCESS_WAITING;
-    schedule();
-  }
+  // Exclusive - ek connection ek hi accept ko milta hai
+  wait_event_exclusive(&server->read_wait, server->backlog_count > 0);
 
   socket_t *client = server->backlog[0];
   for (int i = 0; i < server->backlog_count - 1; i++)
@@ -385,8 +415,9 @@ int sys_accept(int sockfd) {
   conn->peer = client;
   client->peer = conn;
   client->state = SOCKET_CONNECTED;
+  wake_up(&client->read_wait); // Client ko jagao!
 
-  vfs_node_t *conn_node = (vfs_node_t *)kmalloc(sizeof(vfs_node_t));
+  vfs_node_t *conn_node = (vfs_node_t *)kmem_cache_alloc(vfs_node_cache);
   memset(conn_node, 0, sizeof(vfs_node_t));
   strcpy(conn_node->name, "socket_conn");
   conn_node->impl = (void *)conn;
@@ -399,24 +430,12 @@ int sys_accept(int sockfd) {
   for (int i = 0; i < MAX_PROCESS_FILES; i++) {
     if (!current_process->fd_table[i]) {
       file_description_t *desc =
-          (file_description_t *)kmalloc(sizeof(file_description_t));
+          (file_description_t *)kmem_cache_alloc(file_desc_cache);
       desc->node = conn_node;
       desc->offset = 0;
       desc->flags = O_RDWR;
       desc->ref_count = 1;
       current_process->fd_table[i] = desc;
-
-      // Client ko jagao!
-      process_t *p = ready_queue;
-      if (p) {
-        process_t *start = p;
-        do {
-          if (p->state == PROCESS_WAITING)
-            p->state = PROCESS_READY;
-          p = p->next;
-        } while (p && p != start);
-      }
-
       return i;
     }
   }
@@ -471,17 +490,10 @@ int sys_listen(int sockfd, int backlog) {
 }
 
 // Send data (same as write but with flags)
-ssize_t sys_send(int sockfd, const void *buf, size_t len, int flags) {
-  (void)flags; // Flags not fully implemented
-
-  if (sockfd < 0 || sockfd >= MAX_PROCESS_FILES ||
-      !current_process->fd_table[sockfd] || !buf)
+ssize_t socket_node_send(vfs_node_t *node, const void *buf, size_t len,
+                         int flags) {
+  if (!node || node->flags != VFS_SOCKET || !buf)
     return -1;
-  vfs_node_t *node = current_process->fd_table[sockfd]->node;
-  if (!node || node->flags != VFS_SOCKET)
-    if (!node || node->flags != VFS_SOCKET)
-      return -1;
-
   socket_t *sock = (socket_t *)node->impl;
   if (sock->domain == AF_INET) {
     return net_send(sock->net_socket_id, buf, len, flags);
@@ -490,18 +502,21 @@ ssize_t sys_send(int sockfd, const void *buf, size_t len, int flags) {
   return socket_write(node, 0, len, (uint8_t *)buf);
 }
 
-// Receive data (same as read but with flags)
-ssize_t sys_recv(int sockfd, void *buf, size_t len, int flags) {
+ssize_t sys_send(int sockfd, const void *buf, size_t len, int flags) {
   (void)flags; // Flags not fully implemented
 
   if (sockfd < 0 || sockfd >= MAX_PROCESS_FILES ||
-      !current_process->fd_table[sockfd] || !buf)
+      !current_process->fd_table[sockfd])
     return -1;
-  vfs_node_t *node = current_process->fd_table[sockfd]->node;
-  if (!node || node->flags != VFS_SOCKET)
-    if (!node || node->flags != VFS_SOCKET)
-      return -1;
+  return socket_node_send(current_process->fd_table[sockfd]->node, buf, len,
+                          flags);
+}
 
+// Receive data (same as read but with flags)
+ssize_t socket_node_recv(vfs_node_t *node, void *buf, size_t len,
+                         int flags) {
+  if (!node || node->flags != VFS_SOCKET || !buf)
+    return -1;
   socket_t *sock = (socket_t *)node->impl;
   if (sock->domain == AF_INET) {
     return net_recv(sock->net_socket_id, buf, len, flags);
@@ -510,6 +525,16 @@ ssize_t sys_recv(int sockfd, void *buf, size_t len, int flags) {
   return socket_read(node, 0, len, (uint8_t *)buf);
 }
 
+ssize_t sys_recv(int sockfd, void *buf, size_t len, int flags) {
+  (void)flags; // Flags not fully implemented
+
+  if (sockfd < 0 || sockfd >= MAX_PROCESS_FILES ||
+      !current_process->fd_table[sockfd])
+    return -1;
+  return socket_node_recv(current_process->fd_table[sockfd]->node, buf, len,
+                          flags);
+}
+
 // Send datagram (for UDP-style sockets)
 ssize_t sys_sendto(int sockfd, const void *buf, size_t len, int flags,
                    const void *dest_addr, uint32_t addrlen) {
@@ -665,7 +690,7 @@ int sys_getsockopt(int sockfd, int level, int optname, void *optval,
   case SO_RCVBUF:
   case SO_SNDBUF: {
     if (*optlen >= sizeof(int)) {
-      *(int *)optval = 4096; // Our buffer size
+      *(int *)optval = SOCKET_RING_SIZE; // Our buffer size
       *optlen = sizeof(int);
     }
     return 0;
@@ -708,6 +733,13 @@ int sys_shutdown(int sockfd, int how) {
     return -1;
   }
 
+  // Peer ke readers EOF dekhein, hamare writers ko jagah mili
+  if (sock->peer) {
+    wake_up_all(&sock->peer->read_wait);
+    wake_up_all(&sock->peer->write_wait);
+  }
+  wake_up_all(&sock->write_wait);
+
   return 0;
 }
 
@@ -738,8 +770,8 @@ int sys_socketpair(int domain, int type, int protocol, int sv[2]) {
   sock2->peer = sock1;
 
   // Create VFS nodes
-  vfs_node_t *node1 = (vfs_node_t *)kmalloc(sizeof(vfs_node_t));
-  vfs_node_t *node2 = (vfs_node_t *)kmalloc(sizeof(vfs_node_t));
+  vfs_node_t *node1 = (vfs_node_t *)kmem_cache_alloc(vfs_node_cache);
+  vfs_node_t *node2 = (vfs_node_t *)kmem_cache_alloc(vfs_node_cache);
 
   if (!node1 || !node2) {
     if (node1)
@@ -774,7 +806,7 @@ int sys_socketpair(int domain, int type, int protocol, int sv[2]) {
   for (int i = 0; i < MAX_PROCESS_FILES && (fd1 < 0 || fd2 < 0); i++) {
     if (!current_process->fd_table[i]) {
       file_description_t *desc =
-          (file_description_t *)kmalloc(sizeof(file_description_t));
+          (file_description_t *)kmem_cache_alloc(file_desc_cache);
       desc->offset = 0;
       desc->flags = O_RDWR;
       desc->ref_count = 1;
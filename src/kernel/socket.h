@@ -3,6 +3,7 @@
 
 #include "../include/types.h"
 #include "../include/vfs.h"
+#include "wait_queue.h"
 
 #define AF_UNIX 1
 #define AF_INET 2
@@ -39,6 +40,13 @@ typedef struct socket {
   // For AF_INET (network sockets)
   int net_socket_id;
 
+  // Is socket ke ring / state pe sone wale. read_wait: data, peer close,
+  // backlog (accept), connect poora hona. write_wait: is socket ke writers,
+  // peer ki ring mein jagah ya peer close - apni hi queue, taaki peer free
+  // hone pe koi entry uski memory mein na bache.
+  wait_queue_t read_wait;
+  wait_queue_t write_wait;
+
   // We'll reuse the pipe-like ring buffer logic for simplicity
 } socket_t;
 
@@ -67,6 +75,10 @@ int sys_getsockopt(int sockfd, int level, int optname, void *optval,
                    uint32_t *optlen);
 int sys_shutdown(int sockfd, int how);
 int sys_socketpair(int domain, int type, int protocol, int sv[2]);
+// send/recv ek node pe, fd table ke bina (uring ke pakde hue descriptions)
+ssize_t socket_node_send(vfs_node_t *node, const void *buf, size_t len,
+                         int flags);
+ssize_t socket_node_recv(vfs_node_t *node, void *buf, size_t len, int flags);
 int socket_can_accept(int sockfd);
 int socket_can_read(int sockfd);
 
@@ -77,6 +89,10 @@ uint32_t socket_write(vfs_node_t *node, uint32_t offset, uint32_t size,
                       uint8_t *buffer);
 void socket_close(vfs_node_t *node);
 
+// Socket fd ke taiyaar POLL* events. wq = events (POLLIN ya POLLOUT) ke
+// liye sone ki queue, 0 = koi queue nahi (AF_INET - timer se dobara dekho).
+int socket_vfs_poll(vfs_node_t *node, int events, wait_queue_t **wq);
+
 #ifdef __cplusplus
 }
 #endif
@@ -4,6 +4,7 @@
 #include "../drivers/serial.h"
 #include "../include/string.h"
 #include "heap.h"
+#include "net.h"
 #include "net_advanced.h"
 #include <stddef.h>
 #include <stdint.h>
@@ -269,7 +270,7 @@ extern "C" int net_connect(int sockfd, const struct sockaddr *addr,
         serial_log("SOCKET: Connect timeout");
         return -1;
       }
-      schedule();
+      net_wait(NET_WAIT_MS);
     }
 
     s->state = SOCK_STATE_CONNECTED;
@@ -329,7 +330,7 @@ extern "C" int net_recv(int sockfd, void *buf, uint32_t len, int flags) {
       if (timer_now_ms() - start > timeout) {
         return -1; // Timeout
       }
-      schedule();
+      net_wait(NET_WAIT_MS);
     }
 
     return tcp_read_data(tcb, buf, len);
@@ -398,7 +399,7 @@ extern "C" int net_recvfrom(int sockfd, void *buf, uint32_t len, int flags,
     if (timer_now_ms() - start > timeout) {
       return -1;
     }
-    schedule();
+    net_wait(NET_WAIT_MS);
   }
 
   // Parse stored packet
@@ -537,7 +538,7 @@ extern "C" int socket_poll(int sockfd, int timeout_ms) {
       return 0;
     }
 
-    schedule();
+    net_wait(NET_WAIT_MS);
   }
 }
 
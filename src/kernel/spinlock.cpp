@@ -0,0 +1,86 @@
+// Spinlocks - slow path, lock registry aur stats
+#include "spinlock.h"
+#include "../drivers/serial.h"
+#include "../include/string.h"
+#include "process.h"
+
+// Naam wale locks ki list (pehli acquisition pe judte hain)
+static spinlock_t spin_registry_lock; // Bina naam - khud registry mein nahi
+static spinlock_t *spin_registry = 0;
+static uint32_t spin_nr_registered = 0;
+
+extern "C" {
+
+void preempt_schedule(void) {
+  if (preempt_count() || irqs_disabled())
+    return;
+  schedule();
+}
+
+void spin_lock_init(spinlock_t *lock, const char *name) {
+  memset(lock, 0, sizeof(spinlock_t));
+  lock->name = name;
+}
+
+void spin_lock_slowpath(spinlock_t *lock, uint16_t ticket) {
+  lock->contended++;
+  uint32_t loops = 0;
+  while (lock->owner != ticket) {
+    asm volatile("pause" ::: "memory");
+    // Holder TLB shootdown ka ack maang raha ho sakta hai - hum interrupts
+    // band karke ghoom rahe hain, to IPI ki jagah yahin nipta do
+    smp_tlb_poll();
+    // Holder isi CPU pe ho to tabhi chhodega jab hum hatenge - interrupts
+    // band hain ya holder IRQ ne hi hamein rok rakha hai
+    if (++loops == SPIN_LOCKUP_LOOPS) {
+      serial_log("SPINLOCK: Lockup! Lock chhoot hi nahi raha:");
+      serial_log(lock->name ? lock->name : "(unnamed)");
+      serial_log_hex("  Ticket: ", ticket);
+      serial_log_hex("  Owner:  ", lock->owner);
+    }
+  }
+}
+
+void spin_lock_register(spinlock_t *lock) {
+  uint32_t eflags = spin_lock_irqsave(&spin_registry_lock);
+  if (!(lock->flags & SPIN_REGISTERED)) {
+    lock->flags |= SPIN_REGISTERED;
+    lock->stat_next = spin_registry;
+    spin_registry = lock;
+    spin_nr_registered++;
+  }
+  spin_unlock_irqrestore(&spin_registry_lock, eflags);
+}
+
+int spin_get_stats(spinlock_stats_t *out, int max) {
+  // List mein sirf aage judta hai, kabhi hatta nahi - head le lo, phir bina
+  // lock ghoomo (out user memory ho sakta hai, page fault registry lock
+  // pakde hue nahi aana chahiye)
+  uint32_t eflags = spin_lock_irqsave(&spin_registry_lock);
+  spinlock_t *l = spin_registry;
+  spin_unlock_irqrestore(&spin_registry_lock, eflags);
+
+  int n = 0;
+  for (; l && n < max; l = l->stat_next, n++) {
+    spinlock_stats_t *s = &out[n];
+    memset(s->name, 0, SPIN_NAME_LEN);
+    strncpy(s->name, l->name, SPIN_NAME_LEN - 1);
+    s->acquisitions = l->acquisitions;
+    s->contended = l->contended;
+    s->hold_max = l->hold_max;
+    s->hold_total = l->hold_total;
+  }
+  return n;
+}
+
+void spin_print_stats(void) {
+  serial_log_hex("SPINLOCK Stats, locks: ", spin_nr_registered);
+  for (spinlock_t *l = spin_registry; l; l = l->stat_next) {
+    serial_log(l->name);
+    serial_log_hex("  Acquisitions: ", l->acquisitions);
+    serial_log_hex("  Contended:    ", l->contended);
+    serial_log_hex("  Max hold (cycles): ", (uint32_t)l->hold_max);
+  }
+}
+
+} // extern "C"
@@ -0,0 +1,246 @@
+// Spinlocks - ticket lock + IRQ-save, per-lock stats (Linux spinlock.h jaisa)
+#ifndef SPINLOCK_H
+#define SPINLOCK_H
+
+#include "../include/types.h"
+#include "smp.h"
+
+#define EFLAGS_IF 0x200
+
+// ============================================================================
+// Local IRQ flags - sirf is CPU ke interrupts. Purane "cli ... sti" ki
+// jagah: restore wahi IF wapas deta hai jo pehle tha, to nested critical
+// section bahar wale ke interrupts kabhi on nahi karta.
+// ============================================================================
+
+static inline uint32_t local_irq_save() {
+  uint32_t eflags;
+  asm volatile("pushf; pop %0; cli" : "=r"(eflags) : : "memory");
+  return eflags;
+}
+
+static inline void local_irq_restore(uint32_t eflags) {
+  asm volatile("push %0; popf" : : "r"(eflags) : "memory", "cc");
+}
+
+static inline void local_irq_disable() { asm volatile("cli" ::: "memory"); }
+static inline void local_irq_enable() { asm volatile("sti" ::: "memory"); }
+
+static inline int irqs_disabled() {
+  uint32_t eflags;
+  asm volatile("pushf; pop %0" : "=r"(eflags));
+  return !(eflags & EFLAGS_IF);
+}
+
+// ============================================================================
+// Preemption - lock pakde hue task ko timer IRQ switch na kare (warna
+// doosra task lock pe ghoomta reh jaata). Counter aur resched flag per-CPU
+// (cpu_t, %gs se) - ek CPU ka lock doosre CPU ke switch ko nahi rokta.
+// IRQ/syscall exit pe schedule() sirf preempt_count() == 0 pe.
+// ============================================================================
+
+static inline uint32_t preempt_count() {
+  uint32_t count;
+  asm volatile("mov %%gs:%c1, %0"
+               : "=r"(count)
+               : "i"(CPU_OFF(preempt_count))
+               : "memory");
+  return count;
+}
+
+static inline int need_resched() {
+  int resched;
+  asm volatile("mov %%gs:%c1, %0"
+               : "=r"(resched)
+               : "i"(CPU_OFF(need_resched))
+               : "memory");
+  return resched;
+}
+
+static inline void set_need_resched() {
+  asm volatile("movl $1, %%gs:%c0" : : "i"(CPU_OFF(need_resched)) : "memory");
+}
+
+static inline void clear_need_resched() {
+  asm volatile("movl $0, %%gs:%c0" : : "i"(CPU_OFF(need_resched)) : "memory");
+}
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Counter 0 pe aaya aur beech mein resched maanga gaya tha - ab switch
+void preempt_schedule(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+// Ek hi instruction - beech mein IRQ aaye to bhi counter isi CPU ka
+static inline void preempt_disable() {
+  asm volatile("incl %%gs:%c0" : : "i"(CPU_OFF(preempt_count)) : "memory",
+               "cc");
+}
+
+static inline void preempt_enable_no_resched() {
+  asm volatile("decl %%gs:%c0" : : "i"(CPU_OFF(preempt_count)) : "memory",
+               "cc");
+}
+
+static inline void preempt_enable() {
+  preempt_enable_no_resched();
+  if (!preempt_count() && need_resched() && !irqs_disabled())
+    preempt_schedule();
+}
+
+// ============================================================================
+// Ticket spinlock: next = agla ticket, owner = jiski baari. FIFO - koi
+// waiter bhookha nahi rehta. Zero bytes = khula, bina naam (KMEM_ZERO
+// objects mein seedha embed ho jaata hai).
+//
+// Naam wale locks (static lifetime wale hi!) pehli acquisition pe registry
+// mein judte hain aur lockstat mein dikhte hain. Per-object locks (wait
+// queues, futex buckets) bina naam - stats gine jaate hain par list nahi.
+//
+// Jo lock IRQ handler mein bhi liya jaata hai use process context mein
+// hamesha _irqsave se lo. Apne hi CPU ka pakda lock dobara lena deadlock
+// hai - SPIN_LOCKUP_LOOPS ke baad serial pe chillate hain.
+// ============================================================================
+
+#define SPIN_NAME_LEN 24
+#define SPIN_MAX_LOCKS 64 // lockstat kitne dikhaye
+#define SPIN_LOCKUP_LOOPS (1u << 26)
+
+#define SPIN_REGISTERED 0x01
+
+typedef struct spinlock {
+  volatile uint16_t owner;
+  volatile uint16_t next;
+  const char *name;
+  uint32_t flags;
+  uint32_t acquisitions;
+  uint32_t contended;  // Lene pe koi aur pakde hue tha
+  uint64_t hold_start; // TSC, acquire pe
+  uint64_t hold_max;   // Sabse lamba hold (TSC cycles)
+  uint64_t hold_total;
+  struct spinlock *stat_next;
+} spinlock_t;
+
+#define SPINLOCK_INIT(n) {0, 0, (n), 0, 0, 0, 0, 0, 0, 0}
+#define DEFINE_SPINLOCK(x, n) spinlock_t x = SPINLOCK_INIT(n)
+
+// SYS_LOCK_STATS yahi layout user ko deta hai
+typedef struct spinlock_stats {
+  char name[SPIN_NAME_LEN];
+  uint32_t acquisitions;
+  uint32_t contended;
+  uint64_t hold_max;   // TSC cycles
+  uint64_t hold_total; // TSC cycles
+} spinlock_stats_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void spin_lock_init(spinlock_t *lock, const char *name);
+
+// Ticket mil gaya par baari nahi aayi - ghoomo (stats + lockup check)
+void spin_lock_slowpath(spinlock_t *lock, uint16_t ticket);
+
+// Naam wala lock pehli baar liya gaya
+void spin_lock_register(spinlock_t *lock);
+
+// Registry ke locks, returns kitne bhare
+int spin_get_stats(spinlock_stats_t *out, int max);
+void spin_print_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+static inline uint64_t spin_rdtsc() {
+  uint32_t lo, hi;
+  asm volatile("rdtsc" : "=a"(lo), "=d"(hi));
+  return ((uint64_t)hi << 32) | lo;
+}
+
+// Lock mil chuka - stats, hold timer shuru
+static inline void spin_acquired(spinlock_t *lock) {
+  if (lock->name && !(lock->flags & SPIN_REGISTERED))
+    spin_lock_register(lock);
+  lock->acquisitions++;
+  lock->hold_start = spin_rdtsc();
+}
+
+static inline void spin_releasing(spinlock_t *lock) {
+  uint64_t held = spin_rdtsc() - lock->hold_start;
+  lock->hold_total += held;
+  if (held > lock->hold_max)
+    lock->hold_max = held;
+}
+
+// Interrupts jaise hain waise - caller ne pehle hi band kiye hon, ya lock
+// IRQ context mein kabhi na liya jaata ho
+static inline void spin_lock(spinlock_t *lock) {
+  preempt_disable();
+  uint16_t ticket = 1;
+  asm volatile("lock xaddw %0, %1"
+               : "+r"(ticket), "+m"(lock->next)
+               :
+               : "memory", "cc");
+  if (ticket != lock->owner)
+    spin_lock_slowpath(lock, ticket);
+  spin_acquired(lock);
+}
+
+// owner + next ek saath (trylock ka cmpxchg)
+typedef volatile uint32_t __attribute__((may_alias)) spin_word_t;
+
+// Returns 1 agar mil gaya
+static inline int spin_trylock(spinlock_t *lock) {
+  preempt_disable();
+  uint16_t owner = lock->owner;
+  uint32_t old = ((uint32_t)owner << 16) | owner; // next == owner: khula
+  uint32_t taken = ((uint32_t)(uint16_t)(owner + 1) << 16) | owner;
+  uint32_t prev;
+  asm volatile("lock cmpxchgl %2, %1"
+               : "=a"(prev), "+m"(*(spin_word_t *)&lock->owner)
+               : "r"(taken), "0"(old)
+               : "memory", "cc");
+  if (prev != old) {
+    preempt_enable();
+    return 0;
+  }
+  spin_acquired(lock);
+  return 1;
+}
+
+static inline void spin_unlock(spinlock_t *lock) {
+  spin_releasing(lock);
+  asm volatile("" ::: "memory");
+  lock->owner = lock->owner + 1; // Sirf owner likhta hai - x86 pe store kaafi
+  preempt_enable();
+}
+
+// Lock + interrupts band, purani eflags lautata hai
+static inline uint32_t spin_lock_irqsave(spinlock_t *lock) {
+  uint32_t eflags = local_irq_save();
+  spin_lock(lock);
+  return eflags;
+}
+
+static inline void spin_unlock_irqrestore(spinlock_t *lock, uint32_t eflags) {
+  spin_releasing(lock);
+  asm volatile("" ::: "memory");
+  lock->owner = lock->owner + 1;
+  preempt_enable_no_resched();
+  local_irq_restore(eflags);
+  if (!preempt_count() && need_resched() && (eflags & EFLAGS_IF))
+    preempt_schedule();
+}
+
+static inline int spin_is_locked(spinlock_t *lock) {
+  return lock->owner != lock->next;
+}
+
+#endif // SPINLOCK_H
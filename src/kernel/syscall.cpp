@@ -6,6 +6,8 @@
 #include "../include/signal.h"
 #include "../include/string.h"
 #include "../include/vfs.h"
+#include "futex.h"
+#include "gdt.h"
 #include "heap.h"
 #include "memory.h"
 #include "net_advanced.h"
@@ -15,9 +17,15 @@
 #include "process.h"
 #include "pty.h"
 #include "shm.h"
+#include "sched.h"
+#include "slab.h"
+#include "smp.h"
 #include "socket.h"
+#include "spinlock.h"
 #include "tty.h"
+#include "uring.h"
 #include "vm.h"
+#include "vma.h"
 
 struct iovec {
   void *iov_base;
@@ -42,7 +50,7 @@ static const char *version = "#1 SMP";
 static const char *machine = "i686";
 
 // Dekho pointer user space ka hai ya nahi
-static bool validate_user_pointer(const void *ptr, uint32_t size) {
+bool validate_user_pointer(const void *ptr, uint32_t size) {
   uintptr_t p = (uintptr_t)ptr;
   if (p < 0x20000000)
     return false;
@@ -167,10 +175,7 @@ int sys_print_serial(registers_t *regs) {
 
 int sys_get_pid(registers_t *regs) { return current_process->id; }
 
-int sys_open(registers_t *regs) {
-  char *path = (char *)(uintptr_t)regs->ebx;
-  uint32_t flags = regs->ecx;
-
+int do_open(const char *path, uint32_t flags) {
   uint32_t needed = 0;
   if (flags & O_CREAT)
     needed |= PLEDGE_CPATH;
@@ -189,7 +194,7 @@ int sys_open(registers_t *regs) {
   vfs_node_t *node = vfs_resolve_path(path);
   if (node) {
     file_description_t *desc =
-        (file_description_t *)kmalloc(sizeof(file_description_t));
+        (file_description_t *)kmem_cache_alloc(file_desc_cache);
     desc->node = node;
     desc->flags = flags;
     desc->offset = 0;
@@ -209,6 +214,10 @@ int sys_open(registers_t *regs) {
   return -ENOENT;
 }
 
+int sys_open(registers_t *regs) {
+  return do_open((const char *)(uintptr_t)regs->ebx, regs->ecx);
+}
+
 int sys_openat(registers_t *regs) {
   int dirfd = (int)regs->ebx;
   const char *path = (const char *)regs->ecx;
@@ -225,7 +234,7 @@ int sys_openat(registers_t *regs) {
   vfs_node_t *node = vfs_resolve_path_relative(dir_node, path);
   if (node) {
     file_description_t *desc =
-        (file_description_t *)kmalloc(sizeof(file_description_t));
+        (file_description_t *)kmem_cache_alloc(file_desc_cache);
     desc->node = node;
     desc->flags = flags;
     desc->offset = 0;
@@ -245,21 +254,29 @@ int sys_openat(registers_t *regs) {
   return -ENOENT; // Aisa koi file nahi hai
 }
 
-int sys_read(registers_t *regs) {
-  int fd = (int)regs->ebx;
-  uint8_t *buf = (uint8_t *)regs->ecx;
-  uint32_t size = (uint32_t)regs->edx;
-  if (validate_user_pointer(buf, size) && fd >= 0 && fd < MAX_PROCESS_FILES &&
-      current_process->fd_table[fd]) {
-    file_description_t *desc = current_process->fd_table[fd];
-    int n = vfs_read(desc->node, desc->offset, buf, size);
-    if (n > 0)
-      desc->offset += n;
-    return n;
-  }
+int desc_read(file_description_t *desc, void *buf, uint32_t size,
+              uint32_t offset) {
+  if (!validate_user_pointer(buf, size))
+    return -EBADF;
+  if (offset != RW_OFFSET_CUR)
+    return vfs_read(desc->node, offset, (uint8_t *)buf, size);
+  int n = vfs_read(desc->node, desc->offset, (uint8_t *)buf, size);
+  if (n > 0)
+    desc->offset += n;
+  return n;
+}
+
+int do_read(int fd, void *buf, uint32_t size, uint32_t offset) {
+  if (fd >= 0 && fd < MAX_PROCESS_FILES && current_process->fd_table[fd])
+    return desc_read(current_process->fd_table[fd], buf, size, offset);
   return -EBADF;
 }
 
+int sys_read(registers_t *regs) {
+  return do_read((int)regs->ebx, (void *)regs->ecx, (uint32_t)regs->edx,
+                 RW_OFFSET_CUR);
+}
+
 int sys_readv(registers_t *regs) {
   int fd = (int)regs->ebx;
   const struct iovec *iov = (const struct iovec *)regs->ecx;
@@ -285,21 +302,29 @@ int sys_readv(registers_t *regs) {
   return (int)total_read;
 }
 
-int sys_write(registers_t *regs) {
-  int fd = (int)regs->ebx;
-  uint8_t *buf = (uint8_t *)regs->ecx;
-  uint32_t size = (uint32_t)regs->edx;
-  if (validate_user_pointer(buf, size) && fd >= 0 && fd < MAX_PROCESS_FILES &&
-      current_process->fd_table[fd]) {
-    file_description_t *desc = current_process->fd_table[fd];
-    int n = vfs_write(desc->node, desc->offset, buf, size);
-    if (n > 0)
-      desc->offset += n;
-    return n;
-  }
+int desc_write(file_description_t *desc, const void *buf, uint32_t size,
+               uint32_t offset) {
+  if (!validate_user_pointer(buf, size))
+    return -EBADF;
+  if (offset != RW_OFFSET_CUR)
+    return vfs_write(desc->node, offset, (uint8_t *)buf, size);
+  int n = vfs_write(desc->node, desc->offset, (uint8_t *)buf, size);
+  if (n > 0)
+    desc->offset += n;
+  return n;
+}
+
+int do_write(int fd, const void *buf, uint32_t size, uint32_t offset) {
+  if (fd >= 0 && fd < MAX_PROCESS_FILES && current_process->fd_table[fd])
+    return desc_write(current_process->fd_table[fd], buf, size, offset);
   return -EBADF;
 }
 
+int sys_write(registers_t *regs) {
+  return do_write((int)regs->ebx, (const void *)regs->ecx,
+                  (uint32_t)regs->edx, RW_OFFSET_CUR);
+}
+
 int sys_writev(registers_t *regs) {
   int fd = (int)regs->ebx;
   const struct iovec *iov = (const struct iovec *)regs->ecx;
@@ -325,39 +350,53 @@ int sys_writev(registers_t *regs) {
   return (int)total_written;
 }
 
-int sys_close(registers_t *regs) {
-  int fd = (int)regs->ebx;
+void desc_put(file_description_t *desc) {
+  desc->ref_count--;
+  if (desc->ref_count == 0) {
+    if (desc->node->close)
+      desc->node->close(desc->node);
+    kfree(desc);
+  }
+}
+
+int do_close(int fd) {
   if (fd >= 0 && fd < MAX_PROCESS_FILES && current_process->fd_table[fd]) {
     file_description_t *desc = current_process->fd_table[fd];
     current_process->fd_table[fd] = 0;
-
-    desc->ref_count--;
-    if (desc->ref_count == 0) {
-      if (desc->node->close)
-        desc->node->close(desc->node);
-      kfree(desc);
-    }
+    desc_put(desc);
     return 0;
   }
   return -EBADF;
 }
 
+int sys_close(registers_t *regs) { return do_close((int)regs->ebx); }
+
 int sys_sbrk(registers_t *regs) {
   intptr_t increment = (intptr_t)regs->ebx;
   uint32_t old_brk = current_process->heap_end;
   uint32_t new_brk = old_brk + increment;
+  if ((increment > 0 && new_brk < old_brk) ||
+      (increment < 0 && new_brk > old_brk))
+    return -ENOMEM; // Wrap-around
 
   uint32_t old_page_top = (old_brk + 0xFFF) & 0xFFFFF000;
   uint32_t new_page_top = (new_brk + 0xFFF) & 0xFFFFF000;
+  vma_list_t *vmas = &current_process->vmas;
 
   if (new_page_top > old_page_top) {
-    for (uint32_t page = old_page_top; page < new_page_top; page += 4096) {
-      void *phys = pmm_alloc_block();
-      if (!phys)
-        return -ENOMEM; // Memory khatam
-      vm_map_page((uint32_t)phys, page, 7);
-      memset((void *)page, 0, 4096);
-    }
+    // Heap VMA badhao - sirf reserve, pages pehle touch pe aate hain.
+    // mmap/SHM/stack area se takraaye toh mana.
+    if (vma_insert(vmas, old_page_top, new_page_top, VMA_READ | VMA_WRITE,
+                   VMA_HEAP) != 0)
+      return -ENOMEM;
+  } else if (new_page_top < old_page_top) {
+    // Sirf heap hi sikud sakta hai, ELF segments nahi
+    vma_t *heap = vma_find(vmas, new_page_top);
+    if (!heap || heap->backing != VMA_HEAP || heap->end < old_page_top)
+      return -EINVAL;
+    for (uint32_t page = new_page_top; page < old_page_top; page += 4096)
+      vm_unmap_page(page);
+    vma_remove(vmas, new_page_top, old_page_top);
   }
   current_process->heap_end = new_brk;
   return old_brk;
@@ -365,31 +404,33 @@ int sys_sbrk(registers_t *regs) {
 
 int sys_mmap(registers_t *regs) {
   uint32_t addr = regs->ebx;
-  uint32_t length = regs->ecx;
-  if (addr == 0) {
-    static uint32_t next_mmap_addr = 0x80000000;
-    addr = next_mmap_addr;
-    next_mmap_addr += (length + 0xFFF) & 0xFFFFF000;
-  }
-  uint32_t num_pages = (length + 0xFFF) / 4096;
-  for (uint32_t i = 0; i < num_pages; i++) {
-    uint32_t virt = addr + i * 4096;
-    void *phys = pmm_alloc_block();
-    if (!phys)
-      return -ENOMEM;
-    vm_map_page((uint32_t)phys, virt, 7);
-    memset((void *)virt, 0, 4096);
-  }
+  uint32_t length = (regs->ecx + 0xFFF) & 0xFFFFF000;
+  if (length == 0 || length >= USER_MMAP_END - USER_MMAP_BASE)
+    return -EINVAL;
+
+  // Hint tabhi maano jab mmap window mein ho aur khali ho, warna gap dhundo
+  vma_list_t *vmas = &current_process->vmas;
+  addr &= 0xFFFFF000;
+  if (addr < USER_MMAP_BASE || addr + length > USER_MMAP_END ||
+      vma_find_gap(vmas, length, addr, addr + length) != addr)
+    addr = vma_find_gap(vmas, length, USER_MMAP_BASE, USER_MMAP_END);
+  // Sirf reserve karo - reads zero page se, writes pe private frame
+  if (!addr ||
+      vma_insert(vmas, addr, addr + length, VMA_READ | VMA_WRITE, VMA_ANON))
+    return -ENOMEM;
   return addr;
 }
 
 int sys_munmap(registers_t *regs) {
   uint32_t addr = regs->ebx;
-  uint32_t length = regs->ecx;
-  uint32_t num_pages = (length + 0xFFF) / 4096;
-  for (uint32_t i = 0; i < num_pages; i++) {
-    vm_unmap_page(addr + i * 4096);
-  }
+  uint32_t length = (regs->ecx + 0xFFF) & 0xFFFFF000;
+  if ((addr & 0xFFF) || addr + length < addr ||
+      addr + length > KERNEL_VIRTUAL_BASE)
+    return -EINVAL;
+
+  for (uint32_t virt = addr; virt < addr + length; virt += 4096)
+    vm_unmap_page(virt);
+  vma_remove(&current_process->vmas, addr, addr + length);
   return 0;
 }
 
@@ -623,13 +664,7 @@ int sys_dup2_call(registers_t *regs) {
   if (oldfd >= 0 && oldfd < MAX_PROCESS_FILES && newfd >= 0 &&
       newfd < MAX_PROCESS_FILES && current_process->fd_table[oldfd]) {
     if (current_process->fd_table[newfd]) {
-      file_description_t *old_desc = current_process->fd_table[newfd];
-      old_desc->ref_count--;
-      if (old_desc->ref_count == 0) {
-        if (old_desc->node->close)
-          old_desc->node->close(old_desc->node);
-        kfree(old_desc);
-      }
+      desc_put(current_process->fd_table[newfd]);
     }
     current_process->fd_table[newfd] = current_process->fd_table[oldfd];
     current_process->fd_table[newfd]->ref_count++;
@@ -650,10 +685,7 @@ int sys_gettime_call(registers_t *regs) {
 int sys_uptime_call(registers_t *regs) { return (int)tick; }
 
 int sys_sleep_call(registers_t *regs) {
-  uint32_t ticks = regs->ebx;
-  current_process->sleep_until = tick + ticks;
-  current_process->state = PROCESS_SLEEPING;
-  schedule();
+  process_sleep(regs->ebx);
   return 0;
 }
 
@@ -720,6 +752,227 @@ int sys_meminfo_call(registers_t *regs) {
   return -EFAULT;
 }
 
+// Buddy allocator ke per-zone, per-order free counts (load mein
+// fragmentation dekhne ke liye)
+int sys_pmm_stats_call(registers_t *regs) {
+  pmm_zone_stats_t *out = (pmm_zone_stats_t *)regs->ebx;
+  if (!validate_user_pointer(out, sizeof(pmm_zone_stats_t) * PMM_NUM_ZONES))
+    return -EFAULT;
+  for (int i = 0; i < PMM_NUM_ZONES; i++)
+    pmm_get_zone_stats(i, &out[i]);
+  return PMM_NUM_ZONES;
+}
+
+// Lazy anonymous memory ke counters (zero page hits, asli bane pages)
+int sys_vm_stats_call(registers_t *regs) {
+  vm_anon_stats_t *out = (vm_anon_stats_t *)regs->ebx;
+  if (!validate_user_pointer(out, sizeof(vm_anon_stats_t)))
+    return -EFAULT;
+  vm_get_anon_stats(out);
+  return 0;
+}
+
+// Slab caches ke per-cache stats (slabinfo ke liye), returns cache count
+int sys_slab_stats_call(registers_t *regs) {
+  kmem_cache_stats_t *out = (kmem_cache_stats_t *)regs->ebx;
+  int max = (int)regs->ecx;
+  if (max <= 0)
+    return -EINVAL;
+  if (max > KMEM_MAX_CACHES)
+    max = KMEM_MAX_CACHES;
+  if (!validate_user_pointer(out, max * sizeof(kmem_cache_stats_t)))
+    return -EFAULT;
+  return kmem_get_stats(out, max);
+}
+
+// Naam wale spinlocks ke stats (lockstat ke liye), returns lock count
+int sys_lock_stats_call(registers_t *regs) {
+  spinlock_stats_t *out = (spinlock_stats_t *)regs->ebx;
+  int max = (int)regs->ecx;
+  if (max <= 0)
+    return -EINVAL;
+  if (max > SPIN_MAX_LOCKS)
+    max = SPIN_MAX_LOCKS;
+  if (!validate_user_pointer(out, max * sizeof(spinlock_stats_t)))
+    return -EFAULT;
+  return spin_get_stats(out, max);
+}
+
+// Online CPUs ke scheduler/IPI stats (smpbench ke liye), returns CPU count
+int sys_cpu_info_call(registers_t *regs) {
+  cpu_info_t *out = (cpu_info_t *)regs->ebx;
+  int max = (int)regs->ecx;
+  if (max <= 0)
+    return -EINVAL;
+  if (max > SMP_MAX_CPUS)
+    max = SMP_MAX_CPUS;
+  if (!validate_user_pointer(out, max * sizeof(cpu_info_t)))
+    return -EFAULT;
+  return smp_get_cpu_info(out, max);
+}
+
+// Async rings - ek enter mein poori batch (uring.cpp)
+int sys_uring_setup_call(registers_t *regs) {
+  return uring_setup(regs->ebx, (uring_params_t *)regs->ecx);
+}
+
+int sys_uring_enter_call(registers_t *regs) {
+  return uring_enter(regs->ebx, regs->ecx, regs->edx);
+}
+
+// Process ki jaankari, RSS ke saath (VMAs ke andar present pages)
+typedef struct {
+  uint32_t pid;
+  uint32_t ppid;
+  uint32_t state;
+  char name[64];
+  uint32_t rss_pages; // Resident pages (shared COW pages bhi gine jaate hain)
+  uint32_t vm_pages;  // Saare VMAs ka size
+  // Scheduler stats (sched.h)
+  uint32_t sched_class;
+  int32_t nice;
+  int32_t priority;
+  uint32_t runtime_ms;  // Kul CPU time
+  uint32_t wait_ms;     // READY par CPU ka intezaar
+  uint32_t nr_switches; // Kitni baar CPU mila
+  uint32_t vruntime_ms; // Fair class ka virtual runtime
+  int32_t rt_priority;  // FIFO/RR priority, warna 0
+  uint32_t wakeup_lat_us;     // Pichhle wakeup se CPU milne tak
+  uint32_t wakeup_lat_max_us; // Ab tak ka sabse bura
+} procinfo_t;
+
+int sys_procinfo_call(registers_t *regs) {
+  int pid = (int)regs->ebx;
+  procinfo_t *info = (procinfo_t *)regs->ecx;
+  if (!validate_user_pointer(info, sizeof(procinfo_t)))
+    return -EFAULT;
+
+  // Snapshot lock mein (process reap na ho jaaye), user copy bahar - page
+  // fault tasklist_lock pakde hue nahi
+  procinfo_t snap;
+  procinfo_t *out = info;
+  info = &snap;
+  uint32_t eflags = spin_lock_irqsave(&tasklist_lock);
+  process_t *p = ready_queue;
+  if (pid == 0)
+    p = current_process;
+  else if (p) {
+    while (p->id != (uint32_t)pid) {
+      p = p->next;
+      if (p == ready_queue) {
+        p = 0;
+        break;
+      }
+    }
+  }
+  if (!p) {
+    spin_unlock_irqrestore(&tasklist_lock, eflags);
+    return -ESRCH;
+  }
+
+  memset(info, 0, sizeof(procinfo_t));
+  info->pid = p->id;
+  info->ppid = p->parent ? p->parent->id : 0;
+  info->state = p->state;
+  strncpy(info->name, p->name, sizeof(info->name) - 1);
+  info->rss_pages = vma_rss_pages(&p->vmas, p->page_directory);
+  info->vm_pages = vma_total_pages(&p->vmas);
+  info->sched_class = p->sched_class;
+  info->nice = p->nice;
+  info->priority = p->priority;
+  info->runtime_ms = (uint32_t)(p->sum_exec_runtime / 1000000ULL);
+  info->wait_ms = (uint32_t)(p->wait_sum / 1000000ULL);
+  info->nr_switches = p->nr_switches;
+  info->vruntime_ms = (uint32_t)(p->vruntime / 1000000ULL);
+  info->rt_priority = p->rt_priority;
+  info->wakeup_lat_us = p->wakeup_lat_ns / 1000;
+  info->wakeup_lat_max_us = p->wakeup_lat_max_ns / 1000;
+  spin_unlock_irqrestore(&tasklist_lock, eflags);
+  *out = snap;
+  return 0;
+}
+
+// Scheduler syscalls ka target: pid 0 = khud, dusra process sirf root
+static int sched_find_target(int pid, process_t **out) {
+  process_t *p = current_process;
+  if (pid != 0 && (uint32_t)pid != current_process->id) {
+    uint32_t eflags = spin_lock_irqsave(&tasklist_lock);
+    p = ready_queue;
+    while (p && p->id != (uint32_t)pid) {
+      p = p->next;
+      if (p == ready_queue)
+        p = 0;
+    }
+    spin_unlock_irqrestore(&tasklist_lock, eflags);
+    if (!p)
+      return -ESRCH;
+    if (current_process->euid != 0)
+      return -EPERM;
+  }
+  *out = p;
+  return 0;
+}
+
+// sched_setattr(pid, class, nice): nice ghatana (zyada CPU) sirf root.
+int sys_sched_setattr_call(registers_t *regs) {
+  int sched_class = (int)regs->ecx;
+  int nice = (int)regs->edx;
+  process_t *p;
+  int err = sched_find_target((int)regs->ebx, &p);
+  if (err)
+    return err;
+  if (nice < p->nice && current_process->euid != 0)
+    return -EPERM;
+  return sched_setattr(p, sched_class, nice);
+}
+
+// POSIX struct sched_param (userspace syscall.h mein bhi)
+typedef struct {
+  int32_t sched_priority;
+} sched_param_t;
+
+// sched_setscheduler(pid, policy, param): SCHED_FIFO/SCHED_RR sirf root
+int sys_sched_setscheduler_call(registers_t *regs) {
+  int policy = (int)regs->ecx;
+  sched_param_t *param = (sched_param_t *)regs->edx;
+  if (!validate_user_pointer(param, sizeof(sched_param_t)))
+    return -EFAULT;
+  process_t *p;
+  int err = sched_find_target((int)regs->ebx, &p);
+  if (err)
+    return err;
+  if (policy != SCHED_OTHER && current_process->euid != 0)
+    return -EPERM;
+  return sched_setscheduler(p, policy, param->sched_priority);
+}
+
+// sched_setparam(pid, param): RT priority badlo, policy wahi
+int sys_sched_setparam_call(registers_t *regs) {
+  sched_param_t *param = (sched_param_t *)regs->ecx;
+  if (!validate_user_pointer(param, sizeof(sched_param_t)))
+    return -EFAULT;
+  process_t *p;
+  int err = sched_find_target((int)regs->ebx, &p);
+  if (err)
+    return err;
+  if (param->sched_priority != p->rt_priority && current_process->euid != 0)
+    return -EPERM;
+  return sched_setparam(p, param->sched_priority);
+}
+
+// futex(uaddr, op, val, val2, uaddr2): WAIT mein val2 = timeout ms (0 =
+// hamesha), REQUEUE mein nr_requeue
+int sys_futex_call(registers_t *regs) {
+  uint32_t *uaddr = (uint32_t *)regs->ebx;
+  uint32_t *uaddr2 = (uint32_t *)regs->edi;
+  int op = (int)regs->ecx;
+  if (!validate_user_pointer(uaddr, sizeof(uint32_t)))
+    return -EFAULT;
+  if (op == FUTEX_REQUEUE && !validate_user_pointer(uaddr2, sizeof(uint32_t)))
+    return -EFAULT;
+  return sys_futex(uaddr, op, regs->edx, regs->esi, uaddr2);
+}
+
 int sys_getpgrp_call(registers_t *regs) { return current_process->pgid; }
 
 int sys_setpgrp_call(registers_t *regs) {
@@ -1365,7 +1618,7 @@ static syscall_ptr syscall_table[256] = {
     sys_alarm_call,     // 44
     sys_hostname_call,  // 45
     sys_meminfo_call,   // 46
-    nullptr,            // 47 (procinfo)
+    sys_procinfo_call,  // 47
     sys_symlink_call,   // 48
     sys_readlink_call,  // 49
     sys_getpgrp_call,   // 50
@@ -1465,11 +1718,11 @@ static syscall_ptr syscall_table[256] = {
     sys_msync_call,           // 142
     sys_mlock_call,           // 143
     sys_sysconf_call,         // 144
-    nullptr,                  // 145
-    nullptr,                  // 146
-    nullptr,                  // 147
-    nullptr,                  // 148
-    nullptr,                  // 149
+    sys_pmm_stats_call,       // 145
+    sys_vm_stats_call,        // 146
+    sys_slab_stats_call,      // 147
+    sys_sched_setattr_call,   // 148
+    sys_sched_setscheduler_call, // 149
     sys_get_framebuffer_call, // 150
     sys_fb_width_call,        // 151
     sys_fb_height_call,       // 152
@@ -1479,19 +1732,130 @@ static syscall_ptr syscall_table[256] = {
     sys_tcp_test_call,        // 156
     sys_dns_resolve_call,     // 157
     sys_http_get_call,        // 158
-    sys_net_status_call       // 159
+    sys_net_status_call,      // 159
+    sys_sched_setparam_call,  // 160
+    sys_futex_call,           // 161
+    sys_lock_stats_call,      // 162
+    sys_cpu_info_call,        // 163
+    sys_uring_setup_call,     // 164
+    sys_uring_enter_call      // 165
 };
 
 static const int num_syscalls = sizeof(syscall_table) / sizeof(syscall_ptr);
 
-void init_syscalls() { register_interrupt_handler(0x80, syscall_handler); }
+// ============================================================================
+// SYSENTER/SYSEXIT fast path. int 0x80 ka gate, iret aur segment reloads
+// nahi - entry (interrupt.asm) wahi registers_t frame banata hai aur
+// isr_handler se yahi dispatch chalta hai (BKL, resched sab wahi).
+//
+// MSRs: CS = kernel code 0x08 (SYSENTER SS = CS+8, SYSEXIT user CS/SS =
+// CS+16/CS+24 - GDT order yahi hai), EIP = sysenter_entry, ESP = cpu_t ka
+// sysenter_tss. User stub: %ebp = user esp, [%ebp] = wapas aane ka eip.
+// ============================================================================
+
+#define MSR_SYSENTER_CS 0x174
+#define MSR_SYSENTER_ESP 0x175
+#define MSR_SYSENTER_EIP 0x176
+#define CPUID_EDX_SEP (1u << 11)
+
+extern "C" void sysenter_entry();
+
+static int sysenter_supported = -1; // BSP pe pehli baar cpuid se
+
+static inline void wrmsr(uint32_t msr, uint32_t value) {
+  asm volatile("wrmsr" : : "c"(msr), "a"(value), "d"(0));
+}
+
+static int sysenter_detect() {
+  uint32_t eax, ebx, ecx, edx;
+  asm volatile("cpuid"
+               : "=a"(eax), "=b"(ebx), "=c"(ecx), "=d"(edx)
+               : "a"(1));
+  if (!(edx & CPUID_EDX_SEP))
+    return 0;
+  // Pentium Pro SEP batata hai par SYSENTER nahi hai
+  uint32_t family = (eax >> 8) & 0xF, model = (eax >> 4) & 0xF;
+  return !(family == 6 && model < 3 && (eax & 0xF) < 3);
+}
+
+void sysenter_init_cpu() {
+  if (sysenter_supported < 0) {
+    sysenter_supported = sysenter_detect();
+    serial_log(sysenter_supported ? "SYSCALL: SYSENTER fast path enabled"
+                                  : "SYSCALL: No SEP, int 0x80 only");
+  }
+  if (!sysenter_supported)
+    return;
+  cpu_t *c = this_cpu();
+  c->sysenter_tss = (uint32_t)&tss_entries[c->id];
+  wrmsr(MSR_SYSENTER_CS, 0x08);
+  wrmsr(MSR_SYSENTER_ESP, (uint32_t)&c->sysenter_tss);
+  wrmsr(MSR_SYSENTER_EIP, (uint32_t)sysenter_entry);
+}
+
+// Returns 1 agar SYSEXIT se laut sakte hain (ecx/edx user ke liye clobber).
+// execve ne naya eip/esp diya ho to 0 - iret wala raasta saare registers
+// frame se wapas deta hai.
+extern "C" int sysenter_handler(registers_t *regs) {
+  uint32_t usp = regs->useresp;
+  // Return eip user stack pe hai. IF=0 aur bina syscall_fixup ke user pointer
+  // pe fault nahi le sakte: interrupts kholo (demand paging disk padh sakti
+  // hai), BKL ke andar dono pages (usp unaligned ho sakta hai) pehle se laao.
+  // Padhne laayak area ke bahar ka pointer fault nahi, seedha process ki maut.
+  local_irq_enable();
+  lock_kernel();
+  bool ok = usp >= 0x20000000 && usp <= KERNEL_VIRTUAL_BASE - 4;
+  for (uint32_t a = usp; ok && a <= usp + 3; a = (a & 0xFFFFF000) + 0x1000)
+    ok = vm_get_phys(a) || handle_demand_paging(a, 0x4); // User read
+  if (!ok) {
+    serial_log_hex("SYSENTER: Bad user stack, killing. ESP: ", usp);
+    exit_process(-EFAULT);
+  }
+  uint32_t ret_eip = *(volatile uint32_t *)usp;
+  unlock_kernel();
+  regs->eip = ret_eip;
+
+  isr_handler(regs);
+
+  return regs->eip == ret_eip && regs->useresp == usp;
+}
+
+void init_syscalls() {
+  register_interrupt_handler(0x80, syscall_handler);
+  sysenter_init_cpu();
+}
 
 void syscall_handler(registers_t *regs) {
+  // Interrupt gate ne IF band kiya tha - pehle kmalloc ka "sti" anjaane mein
+  // khol deta tha. Ab shared data apne locks se bachta hai, to seedha kholo.
+  local_irq_enable();
+
+  // User pointer pe fault yahan lautta hai (syscall_fault_unwind). SIGSEGV
+  // pehle se pending hai - return path pe deliver hoga.
+  process_t *proc = current_process;
+  syscall_fixup_t fixup;
+  fixup.preempt_count = preempt_count();
+  fixup.bkl_depth = this_cpu()->bkl_depth;
+  if (setjmp(fixup.env)) {
+    // Body ne khud lock_kernel kiya tha to wo gehraai ab koi nahi chhodega
+    this_cpu()->bkl_depth = fixup.bkl_depth;
+    local_irq_enable();
+    proc->syscall_fixup = 0;
+    regs->eax = -EFAULT;
+    return;
+  }
+  proc->syscall_fixup = &fixup;
+
   if (regs->eax < (uint32_t)num_syscalls && syscall_table[regs->eax]) {
-    serial_log_hex("SYSCALL: Called ID ", regs->eax);
     regs->eax = syscall_table[regs->eax](regs);
   } else {
     serial_log_hex("SYSCALL: Unknown ID ", regs->eax);
     regs->eax = -ENOSYS;
   }
+  proc->syscall_fixup = 0;
+}
+
+extern "C" void syscall_fault_unwind() {
+  longjmp(current_process->syscall_fixup->env, 1);
+  __builtin_unreachable();
 }
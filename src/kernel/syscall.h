@@ -1,8 +1,51 @@
 #ifndef SYSCALL_H
 #define SYSCALL_H
 
+#include "../include/setjmp.h"
 #include "../include/types.h"
 
 void init_syscalls();
 
+// SYSENTER MSRs is CPU pe (CPU mein SEP ho to). BSP init_syscalls se, APs
+// smp_ap_entry se.
+void sysenter_init_cpu();
+
+// Pointer user space mein hai (size bytes wrap nahi karte)
+bool validate_user_pointer(const void *ptr, uint32_t size);
+
+// Syscall bodies bina registers_t ke - SYS_OPEN/READ/WRITE/CLOSE aur
+// uring (async rings) dono yahi chalate hain. offset RW_OFFSET_CUR = fd ki
+// position se padho/likho aur aage badhao, warna us offset pe (pread jaisa,
+// position nahi badalti).
+#define RW_OFFSET_CUR 0xFFFFFFFF
+int do_open(const char *path, uint32_t flags);
+int do_read(int fd, void *buf, uint32_t size, uint32_t offset);
+int do_write(int fd, const void *buf, uint32_t size, uint32_t offset);
+int do_close(int fd);
+
+// Wahi, par pakde hue description pe - fd table dobara nahi dekhte (uring
+// ke parked ops, jinka fd beech mein close ya reuse ho sakta hai)
+struct file_description;
+int desc_read(struct file_description *desc, void *buf, uint32_t size,
+              uint32_t offset);
+int desc_write(struct file_description *desc, const void *buf, uint32_t size,
+               uint32_t offset);
+// Reference chhodo - aakhri pe node close aur description free
+void desc_put(struct file_description *desc);
+
+// Syscall ka recovery point. syscall_handler isse stack pe rakhta hai aur
+// current_process->syscall_fixup mein daalta hai; user pointer pe page fault
+// (jo VMA se sulajh na sake) yahan longjmp karke syscall -EFAULT lautata
+// hai - process fault ke andar nahi marta. Entry ki preempt/BKL gehraai se
+// pata chalta hai ki beech mein koi spinlock to nahi pakda.
+typedef struct syscall_fixup {
+  jmp_buf env;
+  uint32_t preempt_count;
+  int bkl_depth;
+} syscall_fixup_t;
+
+// Page fault handler regs->eip ise banata hai: iret syscall ke kernel stack
+// pe yahan aata hai (nested ISR ka BKL chhut chuka) aur longjmp karta hai
+extern "C" void syscall_fault_unwind();
+
 #endif
@@ -4,8 +4,10 @@
 #include "../drivers/serial.h"
 #include "../include/string.h"
 #include "heap.h"
+#include "ktimer.h"
 #include "memory.h"
 #include "net.h" // Access to my_ip
+#include "slab.h"
 #include <stddef.h>
 #include <stdint.h>
 
@@ -14,6 +16,9 @@
 #define MAX_TCP_CONNECTIONS 16
 #define TCP_RX_BUFFER_SIZE 32768 // 32KB to be safe for modern TLS
 #define INITIAL_SEQ 0x1000
+#define TCP_SKB_SIZE (20 + 4 + 1460) // Header + MSS option + MSS payload
+#define TCP_SYN_RTO_MS 1000 // Pehla SYN retransmit, har retry pe double
+#define TCP_SYN_RETRIES 5
 
 /* ================= TCP FLAGS ================= */
 
@@ -75,11 +80,23 @@ typedef struct {
   uint8_t *rx_buffer;
   uint32_t rx_len;
   uint32_t rx_capacity;
+
+  // SYN retransmit: timer IRQ mein sirf rtx_due, bhejna net_poll se
+  ktimer_t rtx_timer;
+  volatile int rtx_due;
+  int rtx_count;
 } tcp_tcb_t;
 
 /* ================= GLOBALS ================= */
 
-static tcp_tcb_t tcp_table[MAX_TCP_CONNECTIONS];
+static tcp_tcb_t *tcp_table[MAX_TCP_CONNECTIONS];
+
+// TCBs aur outgoing segment buffers apne exact-size slab caches se
+static kmem_cache_t *tcp_tcb_cache;
+static kmem_cache_t *tcp_skb_cache;
+
+// Koi rtx_timer baja hai - tcp_timer_run tabhi table dekhta hai
+static volatile int tcp_rtx_pending;
 
 /* ================= BYTE ORDER HELPERS ================= */
 
@@ -96,13 +113,16 @@ static inline uint32_t tcp_ntohl(uint32_t x) { return tcp_htonl(x); }
 
 static tcp_tcb_t *tcp_alloc_tcb() {
   for (int i = 0; i < MAX_TCP_CONNECTIONS; i++) {
-    if (!tcp_table[i].used) {
-      memset(&tcp_table[i], 0, sizeof(tcp_tcb_t));
-      tcp_table[i].used = 1;
-      tcp_table[i].rx_capacity = TCP_RX_BUFFER_SIZE;
-      tcp_table[i].rx_buffer = (uint8_t *)kmalloc(TCP_RX_BUFFER_SIZE);
-      tcp_table[i].rx_len = 0;
-      return &tcp_table[i];
+    if (!tcp_table[i]) {
+      tcp_tcb_t *tcb = (tcp_tcb_t *)kmem_cache_zalloc(tcp_tcb_cache);
+      if (!tcb)
+        return nullptr;
+      tcb->used = 1;
+      tcb->rx_capacity = TCP_RX_BUFFER_SIZE;
+      tcb->rx_buffer = (uint8_t *)kmalloc_nozero(TCP_RX_BUFFER_SIZE);
+      tcb->rx_len = 0;
+      tcp_table[i] = tcb;
+      return tcb;
     }
   }
   return nullptr;
@@ -110,18 +130,24 @@ static tcp_tcb_t *tcp_alloc_tcb() {
 
 static void tcp_free_tcb(tcp_tcb_t *tcb) {
   if (tcb && tcb->used) {
+    timer_del(&tcb->rtx_timer);
     if (tcb->rx_buffer) {
       kfree(tcb->rx_buffer);
     }
-    memset(tcb, 0, sizeof(tcp_tcb_t));
+    for (int i = 0; i < MAX_TCP_CONNECTIONS; i++) {
+      if (tcp_table[i] == tcb)
+        tcp_table[i] = nullptr;
+    }
+    tcb->used = 0;
+    kmem_cache_free(tcp_tcb_cache, tcb);
   }
 }
 
 static tcp_tcb_t *tcp_find(uint32_t src_ip, uint32_t dst_ip, uint16_t src_port,
                            uint16_t dst_port) {
   for (int i = 0; i < MAX_TCP_CONNECTIONS; i++) {
-    tcp_tcb_t *t = &tcp_table[i];
-    if (!t->used)
+    tcp_tcb_t *t = tcp_table[i];
+    if (!t || !t->used)
       continue;
     if (t->local_ip == dst_ip && t->remote_ip == src_ip &&
         t->local_port == dst_port && t->remote_port == src_port)
@@ -165,7 +191,12 @@ static void tcp_send_segment(tcp_tcb_t *tcb, uint8_t flags, void *data,
   bool is_syn = (flags & TCP_SYN) != 0;
   size_t options_len = is_syn ? 4 : 0; // MSS Option: Tag=2, Len=4, Value=1460
   size_t total_len = sizeof(tcp_header_t) + options_len + len;
-  uint8_t *buffer = (uint8_t *)kmalloc(total_len);
+  // MSS tak ke segments (almost saare) slab cache se, bade wale kmalloc se
+  uint8_t *buffer = total_len <= TCP_SKB_SIZE
+                        ? (uint8_t *)kmem_cache_alloc(tcp_skb_cache)
+                        : (uint8_t *)kmalloc(total_len);
+  if (!buffer)
+    return;
   tcp_header_t *tcp = (tcp_header_t *)buffer;
 
   memset(tcp, 0, sizeof(tcp_header_t));
@@ -206,6 +237,40 @@ static void tcp_send_segment(tcp_tcb_t *tcb, uint8_t flags, void *data,
   kfree(buffer);
 }
 
+/* ================= TCP RETRANSMIT ================= */
+
+// Timer IRQ context - e1000_send reentrant nahi, isliye yahan sirf flag
+static void tcp_rtx_timeout(ktimer_t *timer) {
+  tcp_tcb_t *tcb = (tcp_tcb_t *)timer->data;
+  tcb->rtx_due = 1;
+  tcp_rtx_pending = 1;
+  net_kick();
+}
+
+// net_poll se: jin TCBs ka timer baja unka SYN dobara, exponential backoff
+extern "C" void tcp_timer_run() {
+  if (!tcp_rtx_pending)
+    return;
+  tcp_rtx_pending = 0;
+  for (int i = 0; i < MAX_TCP_CONNECTIONS; i++) {
+    tcp_tcb_t *tcb = tcp_table[i];
+    if (!tcb || !tcb->rtx_due)
+      continue;
+    tcb->rtx_due = 0;
+    if (tcb->state != TCP_SYN_SENT)
+      continue;
+    if (++tcb->rtx_count > TCP_SYN_RETRIES) {
+      serial_log("TCP: SYN retries exhausted");
+      tcb->state = TCP_CLOSED;
+      continue;
+    }
+    serial_log("TCP: Retransmit SYN");
+    tcb->snd_nxt = tcb->snd_una; // Wahi seq
+    tcp_send_segment(tcb, TCP_SYN, nullptr, 0);
+    mod_timer_ms(&tcb->rtx_timer, TCP_SYN_RTO_MS << tcb->rtx_count);
+  }
+}
+
 /* ================= TCP CONNECT (Client) ================= */
 
 extern "C" tcp_tcb_t *tcp_connect(uint32_t local_ip, uint16_t local_port,
@@ -225,6 +290,8 @@ extern "C" tcp_tcb_t *tcp_connect(uint32_t local_ip, uint16_t local_port,
   tcb->state = TCP_SYN_SENT;
 
   tcp_send_segment(tcb, TCP_SYN, nullptr, 0);
+  timer_setup(&tcb->rtx_timer, tcp_rtx_timeout, tcb);
+  mod_timer_ms(&tcb->rtx_timer, TCP_SYN_RTO_MS);
   return tcb;
 }
 
@@ -251,6 +318,7 @@ extern "C" void tcp_handle_packet(uint32_t src_ip, uint32_t dst_ip,
       tcb->rcv_nxt = seg_seq + 1;
       tcb->snd_una = seg_ack;
       tcb->state = TCP_ESTABLISHED;
+      timer_del(&tcb->rtx_timer);
       tcp_send_segment(tcb, TCP_ACK, nullptr, 0);
     }
     break;
@@ -369,6 +437,8 @@ extern "C" int tcp_has_data(tcp_tcb_t *tcb) { return tcb && tcb->rx_len > 0; }
 
 extern "C" void tcp_init() {
   for (int i = 0; i < MAX_TCP_CONNECTIONS; i++)
-    tcp_table[i].used = 0;
+    tcp_table[i] = nullptr;
+  tcp_tcb_cache = kmem_cache_create("tcp_tcb", sizeof(tcp_tcb_t), 0);
+  tcp_skb_cache = kmem_cache_create("tcp_skb", TCP_SKB_SIZE, 0);
   serial_log("TCP: Stack initialized with 32KB RX support");
 }
@@ -4,6 +4,7 @@
 #include "../include/mbedtls/error.h"
 #include "../include/mbedtls/ssl.h"
 #include "../include/string.h"
+#include "net.h"
 
 // TCP API from http.cpp
 struct tcp_tcb_t;
@@ -95,7 +96,7 @@ extern "C" void *tls_init(void *tcp_conn, const char *hostname) {
       serial_log_hex("TLS: Still handshaking... State: ", ctx->ssl.state);
     }
     net_poll();
-    schedule();
+    net_wait(NET_WAIT_MS);
   }
   serial_log("TLS: Handshake successful!");
   return ctx;
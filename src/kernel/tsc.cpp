@@ -1,8 +1,8 @@
 #include "tsc.h"
 #include "../drivers/hpet.h"
 #include "../drivers/serial.h"
-
-static uint64_t tsc_freq = 0;
+#include "clocksource.h"
+#include "spinlock.h"
 
 uint64_t rdtsc() {
   uint32_t low, high;
@@ -10,31 +10,77 @@ uint64_t rdtsc() {
   return ((uint64_t)high << 32) | low;
 }
 
-void tsc_calibrate() {
-  serial_log("TSC: Calibrating...");
+static inline void tsc_cpuid(uint32_t leaf, uint32_t *eax, uint32_t *edx) {
+  uint32_t ebx, ecx;
+  asm volatile("cpuid"
+               : "=a"(*eax), "=b"(ebx), "=c"(ecx), "=d"(*edx)
+               : "a"(leaf), "c"(0));
+}
+
+int tsc_present() {
+  uint32_t eax, edx;
+  tsc_cpuid(1, &eax, &edx);
+  return (edx & CPUID_EDX_TSC) != 0;
+}
+
+int tsc_invariant() {
+  uint32_t max_ext, edx;
+  tsc_cpuid(0x80000000, &max_ext, &edx);
+  if (max_ext < 0x80000007)
+    return 0;
+  uint32_t eax;
+  tsc_cpuid(0x80000007, &eax, &edx);
+  return (edx & CPUID_EXT_EDX_INVARIANT_TSC) != 0;
+}
 
-  // Use HPET for calibration if available
+// Ek run: HPET pe TSC_CALIB_NS gino, dono counters ke delta se kHz.
+// Interrupts band - beech mein IRQ aaye to TSC delta galat nahi hota
+// (dono saath chalte hain), par run lamba ho jaata hai.
+static uint32_t tsc_calibrate_once(uint32_t period_fs, uint64_t hpet_cycles) {
+  uint32_t eflags = local_irq_save();
   uint64_t h1 = hpet_read_counter();
   uint64_t t1 = rdtsc();
+  uint64_t h2;
+  do {
+    h2 = hpet_read_counter();
+  } while (h2 - h1 < hpet_cycles);
+  uint64_t t2 = rdtsc();
+  local_irq_restore(eflags);
 
-  // Busy wait for ~10ms (estimating by counter)
-  // Actually, we should check HPET period/frequency
-  // But for a simple estimate:
-  for (int i = 0; i < 1000000; i++)
-    asm volatile("" : : : "memory");
+  uint64_t elapsed_ns = (h2 - h1) * period_fs / 1000000ULL;
+  if (!elapsed_ns)
+    return 0;
+  return (uint32_t)((t2 - t1) * 1000000ULL / elapsed_ns);
+}
 
-  uint64_t h2 = hpet_read_counter();
-  uint64_t t2 = rdtsc();
+uint32_t tsc_calibrate() {
+  uint32_t period_fs = hpet_get_period_fs();
+  if (!period_fs || !tsc_present())
+    return 0;
 
-  // Very rough estimate for now
-  tsc_freq = (t2 - t1);
-  serial_log_hex("TSC: Frequency estimate (ticks per sample): ", tsc_freq);
+  serial_log("TSC: Calibrating against HPET...");
+  uint64_t hpet_cycles = TSC_CALIB_NS * 1000000ULL / period_fs;
+  uint32_t khz[TSC_CALIB_RUNS];
+  for (int i = 0; i < TSC_CALIB_RUNS; i++) {
+    khz[i] = tsc_calibrate_once(period_fs, hpet_cycles);
+    // Insertion sort, median ke liye
+    for (int j = i; j > 0 && khz[j] < khz[j - 1]; j--) {
+      uint32_t t = khz[j];
+      khz[j] = khz[j - 1];
+      khz[j - 1] = t;
+    }
+  }
+  uint32_t result = khz[TSC_CALIB_RUNS / 2];
+  serial_log_hex("TSC: Frequency (kHz): ", result);
+  return result;
 }
 
-void nanosleep(uint64_t ns) {
-  uint64_t start = rdtsc();
-  // Use a simpler condition without division to avoid __udivdi3
-  uint64_t ticks = ns; // Very crude placeholder
-  while ((rdtsc() - start) < ticks)
-    ;
+void ndelay(uint64_t ns) {
+  if (!clocksource)
+    return;
+  uint64_t start = clocksource_ns();
+  while (clocksource_ns() - start < ns)
+    asm volatile("pause");
 }
+
+void udelay(uint32_t us) { ndelay((uint64_t)us * 1000); }
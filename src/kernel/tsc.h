@@ -3,8 +3,22 @@
 
 #include "../include/types.h"
 
+#define CPUID_EDX_TSC (1 << 4)
+#define CPUID_EXT_EDX_INVARIANT_TSC (1 << 8) // Leaf 0x80000007
+#define TSC_CALIB_NS 10000000ULL             // Ek calibration run (10ms)
+#define TSC_CALIB_RUNS 3                     // Median lo
+
 uint64_t rdtsc();
-void tsc_calibrate();
-void nanosleep(uint64_t ns);
+
+// CPU mein TSC hai? Invariant (P-state/C-state se rate nahi badalti)?
+int tsc_present();
+int tsc_invariant();
+
+// HPET counter ke against TSC ki frequency (kHz). HPET/TSC na ho to 0.
+uint32_t tsc_calibrate();
+
+// Busy-wait (clocksource se), scheduler ko chhode bina
+void ndelay(uint64_t ns);
+void udelay(uint32_t us);
 
 #endif
@@ -45,9 +45,7 @@ int tty_read(tty_t *tty, char *buf, int len) {
 
   // Agar canonical mode hai, toh poori line ka wait karo
   if (tty->flags & TTY_CANON) {
-    while (tty->line_ready == 0) {
-      sleep_on(&tty->read_wait);
-    }
+    wait_event(&tty->read_wait, tty->line_ready);
 
     // Poori line copy maaro
     int copy_len = (len < tty->line_len) ? len : tty->line_len;
@@ -58,10 +56,8 @@ int tty_read(tty_t *tty, char *buf, int len) {
     tty->line_ready = 0;
     return copy_len;
   } else {
-    // Raw mode - jo bhi mil raha hai de do
-    if (tty->input_count == 0) {
-      sleep_on(&tty->read_wait);
-    }
+    // Raw mode - jo bhi mil raha hai de do (kam se kam ek byte)
+    wait_event(&tty->read_wait, tty->input_count > 0);
 
     int copied = 0;
     while (copied < len && tty->input_count > 0) {
@@ -81,6 +77,7 @@ void tty_input_char(tty_t *tty, char c) {
   if (tty->flags & TTY_ISIG) {
     if (c == 3) { // Ctrl+C daba diya
       // Foreground process group ko SIGINT bhejo
+      uint32_t eflags = spin_lock_irqsave(&tasklist_lock);
       process_t *p = ready_queue;
       if (p) {
         do {
@@ -90,6 +87,7 @@ void tty_input_char(tty_t *tty, char c) {
           p = p->next;
         } while (p != ready_queue);
       }
+      spin_unlock_irqrestore(&tasklist_lock, eflags);
       return;
     }
   }
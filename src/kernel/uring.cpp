@@ -0,0 +1,304 @@
+// uring - async syscall rings: batch submit, parked ops, completions
+#include "uring.h"
+#include "../include/errno.h"
+#include "../include/poll.h"
+#include "../include/string.h"
+#include "heap.h"
+#include "memory.h"
+#include "process.h"
+#include "sched.h"
+#include "socket.h"
+#include "syscall.h"
+#include "vma.h"
+
+// Region layout: [SQ header][CQ header][SQEs][CQEs]
+#define URING_SQ_OFF 0
+#define URING_CQ_OFF sizeof(uring_ring_t)
+#define URING_SQES_OFF (2 * sizeof(uring_ring_t))
+
+static uring_ring_t *uring_sq(uring_t *r) {
+  return (uring_ring_t *)(r->base + URING_SQ_OFF);
+}
+
+static uring_ring_t *uring_cq(uring_t *r) {
+  return (uring_ring_t *)(r->base + URING_CQ_OFF);
+}
+
+static uring_sqe_t *uring_sqes(uring_t *r) {
+  return (uring_sqe_t *)(r->base + URING_SQES_OFF);
+}
+
+static uring_cqe_t *uring_cqes(uring_t *r) {
+  return (uring_cqe_t *)(r->base + URING_SQES_OFF +
+                         r->sq_entries * sizeof(uring_sqe_t));
+}
+
+// CQ mein kitne CQEs app ne abhi nahi padhe. head app likhta hai - ulta
+// seedha ho to CQ bhara maano.
+static uint32_t uring_cq_ready(uring_t *r) {
+  uint32_t ready = r->cq_tail - uring_cq(r)->head;
+  return ready > r->cq_entries ? r->cq_entries : ready;
+}
+
+static void uring_complete(uring_t *r, uint64_t user_data, int res) {
+  uring_cqe_t *cqe = &uring_cqes(r)[r->cq_tail & (r->cq_entries - 1)];
+  cqe->user_data = user_data;
+  cqe->res = res;
+  cqe->flags = 0;
+  __sync_synchronize(); // CQE pehle, phir tail - app tail dekh ke padhta hai
+  uring_cq(r)->tail = ++r->cq_tail;
+}
+
+// Op kis event pe block karta hai (0 = kabhi nahi, turant chalao)
+static int uring_op_events(const uring_sqe_t *sqe) {
+  switch (sqe->op) {
+  case URING_OP_READ:
+  case URING_OP_RECV:
+    return POLLIN;
+  case URING_OP_WRITE:
+  case URING_OP_SEND:
+    return POLLOUT;
+  case URING_OP_POLL:
+    return (int)(sqe->op_flags & (POLLIN | POLLOUT));
+  default:
+    return 0;
+  }
+}
+
+// fd wale ops ka description: parked op ka pakda hua, warna fd table se
+static file_description_t *uring_op_desc(const uring_sqe_t *sqe,
+                                         file_description_t *pinned) {
+  if (pinned)
+    return pinned;
+  if (sqe->fd < 0 || sqe->fd >= MAX_PROCESS_FILES)
+    return 0;
+  return current_process->fd_table[sqe->fd];
+}
+
+// Op ab bina ruke chalega? wq = jis queue pe iska intezaar karna ho
+static int uring_op_ready(const uring_sqe_t *sqe, file_description_t *pinned,
+                          wait_queue_t **wq) {
+  *wq = 0;
+  int events = uring_op_events(sqe);
+  if (!events)
+    return 1;
+  file_description_t *desc = uring_op_desc(sqe, pinned);
+  if (!desc)
+    return 1; // Turant -EBADF
+  int revents = node_poll(desc->node, events, wq);
+  return (revents & (events | POLLHUP | POLLERR | POLLNVAL)) != 0;
+}
+
+static int uring_execute(const uring_sqe_t *sqe, file_description_t *pinned) {
+  void *buf = (void *)(uintptr_t)sqe->addr;
+  file_description_t *desc = uring_op_desc(sqe, pinned);
+  switch (sqe->op) {
+  case URING_OP_NOP:
+    return 0;
+  case URING_OP_READ:
+    return desc ? desc_read(desc, buf, sqe->len, sqe->off) : -EBADF;
+  case URING_OP_WRITE:
+    return desc ? desc_write(desc, buf, sqe->len, sqe->off) : -EBADF;
+  case URING_OP_SEND:
+  case URING_OP_RECV: {
+    if (!desc)
+      return -EBADF;
+    if (!validate_user_pointer(buf, sqe->len))
+      return -EFAULT;
+    int n = sqe->op == URING_OP_SEND
+                ? socket_node_send(desc->node, buf, sqe->len,
+                                   (int)sqe->op_flags)
+                : socket_node_recv(desc->node, buf, sqe->len,
+                                   (int)sqe->op_flags);
+    return n < 0 ? -EBADF : n; // socket.cpp sirf -1 deta hai
+  }
+  case URING_OP_OPEN:
+    if (!validate_user_pointer(buf, 1))
+      return -EFAULT;
+    return do_open((const char *)buf, sqe->op_flags);
+  case URING_OP_CLOSE:
+    return do_close(sqe->fd);
+  case URING_OP_POLL: {
+    int events = (int)sqe->op_flags | POLLHUP | POLLERR | POLLNVAL;
+    return desc ? node_poll(desc->node, events, 0) & events : POLLNVAL;
+  }
+  default:
+    return -EINVAL;
+  }
+}
+
+// Parked ops jo ab taiyaar hain - chalao, CQE do, description chhodo
+static void uring_reap(uring_t *r) {
+  uint32_t i = 0;
+  while (i < r->nr_inflight) {
+    uring_inflight_t *f = &r->inflight[i];
+    wait_queue_t *wq;
+    if (!uring_op_ready(&f->sqe, f->desc, &wq)) {
+      i++;
+      continue;
+    }
+    uring_complete(r, f->sqe.user_data, uring_execute(&f->sqe, f->desc));
+    desc_put(f->desc);
+    // Aakhri wala is jagah - entry kisi queue pe nahi (sirf wait mein hoti)
+    if (i != --r->nr_inflight)
+      r->inflight[i] = r->inflight[r->nr_inflight];
+  }
+}
+
+// Saare parked ops ki queues pe ek saath so jao - koi bhi wake_up jagaata
+// hai. Queue na ho (AF_INET) to ek tick baad khud dekho.
+static void uring_wait_inflight(uring_t *r) {
+  wait_queue_t *queues[URING_MAX_INFLIGHT];
+  int timed = 0, ready = 0;
+
+  uint32_t eflags = local_irq_save();
+  current_process->state = PROCESS_WAITING;
+  for (uint32_t i = 0; i < r->nr_inflight; i++) {
+    uring_inflight_t *f = &r->inflight[i];
+    init_wait_entry(&f->wait, 0);
+    uring_op_ready(&f->sqe, f->desc, &queues[i]);
+    if (queues[i])
+      prepare_to_wait(queues[i], &f->wait);
+    else
+      timed = 1;
+  }
+  // Sab queues pe aane ke baad hi condition - beech ka wakeup chhoota nahi
+  for (uint32_t i = 0; i < r->nr_inflight && !ready; i++) {
+    wait_queue_t *wq;
+    ready = uring_op_ready(&r->inflight[i].sqe, r->inflight[i].desc, &wq);
+  }
+
+  if (!ready) {
+    if (timed)
+      schedule_timeout(1);
+    else
+      schedule();
+  }
+
+  // prepare_to_wait ne interrupts band hi paaye - asli eflags aakhir mein.
+  // Queues ke maalik har op ke pakde description se zinda hain (close ke
+  // baad bhi), desc_put reap mein finish_wait ke baad hi.
+  for (uint32_t i = 0; i < r->nr_inflight; i++) {
+    if (queues[i])
+      finish_wait(queues[i], &r->inflight[i].wait, eflags & ~0x200);
+  }
+  current_process->state = PROCESS_RUNNING;
+  local_irq_restore(eflags);
+}
+
+int uring_setup(uint32_t entries, uring_params_t *params) {
+  if (!validate_user_pointer(params, sizeof(uring_params_t)))
+    return -EFAULT;
+  if (current_process->uring)
+    return -EBUSY;
+  if (!entries || entries > URING_MAX_ENTRIES)
+    return -EINVAL;
+
+  uint32_t sq_entries = 1;
+  while (sq_entries < entries)
+    sq_entries <<= 1;
+  uint32_t cq_entries = sq_entries * 2;
+  uint32_t size = URING_SQES_OFF + sq_entries * sizeof(uring_sqe_t) +
+                  cq_entries * sizeof(uring_cqe_t);
+  size = (size + 0xFFF) & 0xFFFFF000;
+
+  // mmap jaisa anonymous area - pages pehle touch pe
+  vma_list_t *vmas = &current_process->vmas;
+  uint32_t base = vma_find_gap(vmas, size, USER_MMAP_BASE, USER_MMAP_END);
+  if (!base ||
+      vma_insert(vmas, base, base + size, VMA_READ | VMA_WRITE, VMA_ANON))
+    return -ENOMEM;
+
+  uring_t *r = (uring_t *)kmalloc(sizeof(uring_t));
+  if (!r) {
+    vma_remove(vmas, base, base + size);
+    return -ENOMEM;
+  }
+  r->base = base;
+  r->size = size;
+  r->sq_entries = sq_entries;
+  r->cq_entries = cq_entries;
+
+  uring_ring_t *sq = uring_sq(r);
+  sq->head = 0;
+  sq->tail = 0;
+  sq->mask = sq_entries - 1;
+  sq->entries = sq_entries;
+  uring_ring_t *cq = uring_cq(r);
+  cq->head = 0;
+  cq->tail = 0;
+  cq->mask = cq_entries - 1;
+  cq->entries = cq_entries;
+  current_process->uring = r;
+
+  params->sq_entries = sq_entries;
+  params->cq_entries = cq_entries;
+  params->ring_addr = base;
+  params->ring_size = size;
+  params->sq_off = URING_SQ_OFF;
+  params->cq_off = URING_CQ_OFF;
+  params->sqes_off = URING_SQES_OFF;
+  params->cqes_off = URING_SQES_OFF + sq_entries * sizeof(uring_sqe_t);
+  return 0;
+}
+
+int uring_enter(uint32_t to_submit, uint32_t min_complete, uint32_t flags) {
+  uring_t *r = current_process->uring;
+  if (!r)
+    return -EBADF;
+  if (min_complete > r->cq_entries)
+    min_complete = r->cq_entries;
+
+  uring_reap(r);
+
+  uring_ring_t *sq = uring_sq(r);
+  uint32_t tail = sq->tail;
+  if (tail - r->sq_head > r->sq_entries)
+    return -EINVAL; // App ne tail bigaad diya
+  uint32_t submitted = 0;
+  while (submitted < to_submit && r->sq_head != tail) {
+    // Har op ke liye CQ mein jagah (parked wale apni pehle se rakhte hain),
+    // aur park karne ki jagah - warna baaki SQ mein hi rehne do
+    if (r->cq_entries - uring_cq_ready(r) <= r->nr_inflight ||
+        r->nr_inflight == URING_MAX_INFLIGHT)
+      break;
+
+    uring_sqe_t sqe;
+    memcpy(&sqe, &uring_sqes(r)[r->sq_head & (r->sq_entries - 1)],
+           sizeof(sqe));
+    sq->head = ++r->sq_head;
+    submitted++;
+
+    wait_queue_t *wq;
+    if (sqe.op > URING_OP_LAST || uring_op_ready(&sqe, 0, &wq)) {
+      uring_complete(r, sqe.user_data, uring_execute(&sqe, 0));
+    } else {
+      // Park - fd ab valid hai (ready nahi hua), description pakad lo
+      uring_inflight_t *f = &r->inflight[r->nr_inflight++];
+      f->sqe = sqe;
+      f->desc = current_process->fd_table[sqe.fd];
+      f->desc->ref_count++;
+    }
+  }
+
+  if (flags & URING_ENTER_GETEVENTS) {
+    while (uring_cq_ready(r) < min_complete && r->nr_inflight) {
+      if (current_process->pending_signals & ~current_process->signal_mask)
+        break; // Signal handler chale - app dobara enter karega
+      uring_wait_inflight(r);
+      uring_reap(r);
+    }
+  }
+  return (int)submitted;
+}
+
+void uring_release(process_t *proc) {
+  uring_t *r = proc->uring;
+  if (!r)
+    return;
+  // Parked ops kabhi poore nahi honge - unke descriptions chhodo
+  for (uint32_t i = 0; i < r->nr_inflight; i++)
+    desc_put(r->inflight[i].desc);
+  kfree(r);
+  proc->uring = 0;
+}
@@ -0,0 +1,117 @@
+// uring - async syscall rings (io_uring jaisa), ek SQ/CQ jodi per process
+#ifndef URING_H
+#define URING_H
+
+#include "../include/types.h"
+#include "wait_queue.h"
+
+// Process apni user memory mein ek region paata hai (SYS_URING_SETUP,
+// mmap window mein anonymous VMA): do ring headers, SQE array, CQE array.
+// App SQEs bharke sq->tail badhata hai, phir ek SYS_URING_ENTER poori batch
+// kernel ko de deta hai - har read/write pe ek int 0x80 ki jagah. Kernel
+// sq->head aur cq->tail likhta hai, app cq->head.
+//
+// Jo op abhi block karta (khaali pipe/socket pe read, bhara ring pe write,
+// poll) wo park hota hai - baaki batch chalti rehti hai. Parked ops agle
+// enter pe dobara dekhe jaate hain; GETEVENTS ke saath enter unki objects
+// ki wait queues pe ek saath so jaata hai jab tak min_complete CQEs na hon.
+// Isliye ek thread wala app kai I/O ek saath udaan mein rakh sakta hai.
+//
+// Layout apps/include/uring.h mein bhi hai - dono saath badlo.
+#define URING_MAX_ENTRIES 256 // SQ; CQ iska do guna
+#define URING_MAX_INFLIGHT 64 // Ek saath parked ops
+
+#define URING_OP_NOP 0
+#define URING_OP_READ 1  // fd, addr, len, off
+#define URING_OP_WRITE 2 // fd, addr, len, off
+#define URING_OP_SEND 3  // fd, addr, len, op_flags = send flags
+#define URING_OP_RECV 4  // fd, addr, len, op_flags = recv flags
+#define URING_OP_OPEN 5  // addr = path, op_flags = O_* flags
+#define URING_OP_CLOSE 6 // fd
+#define URING_OP_POLL 7  // fd, op_flags = POLL* events; res = revents
+#define URING_OP_LAST URING_OP_POLL
+
+#define URING_OFF_CUR 0xFFFFFFFF // off: fd ki position (read/write jaisa)
+
+#define URING_ENTER_GETEVENTS 0x1
+
+typedef struct uring_sqe {
+  uint8_t op;
+  uint8_t flags; // Abhi koi nahi, 0
+  uint16_t pad;
+  int32_t fd;
+  uint32_t addr; // Buffer / path (user pointer)
+  uint32_t len;
+  uint32_t off;
+  uint32_t op_flags;
+  uint64_t user_data; // CQE mein waisa hi wapas
+} uring_sqe_t;
+
+typedef struct uring_cqe {
+  uint64_t user_data;
+  int32_t res; // Syscall jaisa: >= 0 result, < 0 -errno
+  uint32_t flags;
+} uring_cqe_t;
+
+typedef struct uring_ring {
+  volatile uint32_t head; // Consumer aage badhata
+  volatile uint32_t tail; // Producer aage badhata
+  uint32_t mask;
+  uint32_t entries;
+  uint32_t pad[4];
+} uring_ring_t;
+
+// SYS_URING_SETUP bharta hai - offsets ring_addr se
+typedef struct uring_params {
+  uint32_t sq_entries;
+  uint32_t cq_entries;
+  uint32_t ring_addr;
+  uint32_t ring_size;
+  uint32_t sq_off;
+  uint32_t cq_off;
+  uint32_t sqes_off;
+  uint32_t cqes_off;
+} uring_params_t;
+
+struct file_description;
+
+typedef struct uring_inflight {
+  uring_sqe_t sqe;          // Kernel ki copy - user ring badal de to bhi
+  // Park hote waqt ka description, ref_count ke saath - close (ya fd reuse)
+  // ke baad bhi node aur uski wait queues zinda, op usi pe chalta hai
+  struct file_description *desc;
+  wait_queue_entry_t wait;  // Enter ke sone tak hi kisi queue pe
+} uring_inflight_t;
+
+typedef struct uring {
+  uint32_t base; // Region ka user address
+  uint32_t size;
+  uint32_t sq_entries;
+  uint32_t cq_entries;
+  uint32_t sq_head; // Kernel ki copies - user wale pe bharosa nahi
+  uint32_t cq_tail;
+  uring_inflight_t inflight[URING_MAX_INFLIGHT];
+  uint32_t nr_inflight;
+} uring_t;
+
+struct process;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// entries (power of two tak upar) wale rings banao. 0 ya -errno.
+int uring_setup(uint32_t entries, uring_params_t *params);
+
+// to_submit SQEs tak chalao; GETEVENTS ho to min_complete CQEs (ya koi
+// parked op na bache) tak ruko. Kitne SQEs liye, ya -errno.
+int uring_enter(uint32_t to_submit, uint32_t min_complete, uint32_t flags);
+
+// Exit/exec pe kernel state chhodo (region VMA ke saath jaata hai)
+void uring_release(struct process *proc);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
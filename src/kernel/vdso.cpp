@@ -0,0 +1,49 @@
+#include "vdso.h"
+#include "../drivers/serial.h"
+#include "../include/string.h"
+#include "../include/time.h"
+#include "clocksource.h"
+#include "ktimer.h"
+#include "paging.h"
+#include "tsc.h"
+
+extern uint32_t tick;
+
+// Kernel ka alias (direct map) - likhte yahin hain
+static uint8_t vdso_page[4096] __attribute__((aligned(4096)));
+static vdso_time_t *vdso = 0;
+
+void vdso_init() {
+  memset(vdso_page, 0, sizeof(vdso_page));
+  vdso_time_t *v = (vdso_time_t *)vdso_page;
+
+  clocksource_t *cs = clocksource;
+  // HPET user mode mein map nahi hai - us par sirf coarse clocks
+  if (cs && cs->read == rdtsc) {
+    v->clock_mode = VDSO_CLOCK_TSC;
+    v->cycle_base = clocksource_cycle_base();
+    v->mult = cs->mult;
+    v->shift = cs->shift;
+  }
+  v->hz = TIMER_HZ;
+  v->tick = tick;
+  v->tick_ns = (uint64_t)tick * NS_PER_TICK;
+  v->boot_time_sec = clock_boot_time_sec();
+  vdso = v;
+
+  paging_map(VIRT_TO_PHYS(vdso_page), VDSO_TIME_ADDR, PTE_PRESENT | PTE_USER);
+  serial_log(v->clock_mode == VDSO_CLOCK_TSC ? "VDSO: Time page, tsc"
+                                             : "VDSO: Time page, coarse only");
+}
+
+void vdso_update_tick(uint64_t now_ns) {
+  vdso_time_t *v = vdso;
+  if (!v)
+    return;
+  v->seq = v->seq + 1;
+  __sync_synchronize();
+  v->tick = tick;
+  v->tick_ns = now_ns;
+  __sync_synchronize();
+  v->seq = v->seq + 1;
+}
@@ -0,0 +1,49 @@
+// vDSO time page - clock_gettime/gettimeofday/uptime bina syscall ke
+#ifndef VDSO_H
+#define VDSO_H
+
+#include "../include/types.h"
+
+// Ek read-only page har process mein isi address pe (Linux ke fixmap jaisa,
+// PDE 1023). Kernel half ki PDE hai, to pd_create ise by value copy karta
+// hai - har naya process bina kuch kiye dekh leta hai. Kernel direct map
+// wale alias se likhta hai (user mapping read-only hai, CR0.WP on).
+//
+// User space: seq padho (odd = likha ja raha, dobara), fields padho, seq
+// phir padho - badla ho to dobara. clock_mode TSC ho to rdtsc se ns
+// (clocksource jaisa hi mult/shift), NONE (HPET ya kuch nahi) to syscall.
+// apps/include/vdso.h mein yahi layout - dono saath badlo.
+#define VDSO_TIME_ADDR 0xFFFFE000
+
+#define VDSO_CLOCK_NONE 0 // Sirf coarse (tick) time, baaki syscall
+#define VDSO_CLOCK_TSC 1  // rdtsc user mode se
+
+typedef struct vdso_time {
+  volatile uint32_t seq;
+  uint32_t clock_mode;
+  uint64_t cycle_base; // clocksource_ns() ka zero
+  uint32_t mult;       // ns = ((cycles - cycle_base) * mult) >> shift
+  uint32_t shift;
+  uint32_t tick;          // Jiffies (SYS_UPTIME)
+  uint32_t hz;            // TIMER_HZ
+  uint64_t tick_ns;       // Pichhle tick update pe monotonic ns (COARSE)
+  uint32_t boot_time_sec; // REALTIME = boot_time_sec + monotonic
+} vdso_time_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Page map karo aur clocksource se bharo. init_paging aur clocksource_init
+// ke baad, pehle process se pehle (pd_create PDE copy karta hai).
+void vdso_init();
+
+// Tick badha - tick aur tick_ns publish karo. Ek hi writer (jiffies_lock
+// ya PIT handler).
+void vdso_update_tick(uint64_t now_ns);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -7,6 +7,7 @@
 #include "../include/string.h"
 #include "heap.h"
 #include "memory.h"
+#include "slab.h"
 
 extern "C" {
 
@@ -32,7 +33,7 @@ static int mount_count = 0;
 // ============================================================================
 
 static vfs_node_t *alloc_node(const char *name, int type) {
-  vfs_node_t *node = (vfs_node_t *)kmalloc(sizeof(vfs_node_t));
+  vfs_node_t *node = (vfs_node_t *)kmem_cache_alloc(vfs_node_cache);
   memset(node, 0, sizeof(vfs_node_t));
   strncpy(node->name, name, 255);
   node->type = (enum vfs_node_type)type; // Cast for safety
@@ -6,6 +6,11 @@
 
 extern uint32_t *kernel_directory;
 
+// Shared zero page: anonymous memory ke saare read faults yahi ek frame
+// read-only (PTE_COW) map karte hain; pehla write private frame banata hai.
+static uint32_t vm_zero_phys = 0;
+static vm_anon_stats_t vm_anon_stats;
+
 uint32_t *pd_create() {
   uint32_t phys_pd = (uint32_t)pmm_alloc_block();
   uint32_t *pd = (uint32_t *)PHYS_TO_VIRT(phys_pd);
@@ -20,10 +25,15 @@ uint32_t *pd_create() {
   return (uint32_t *)phys_pd; // CR3 ke liye physical address wapas karo
 }
 
+// Fork ke liye address space clone karo - Copy-on-Write.
+// Frames copy nahi hote: parent aur child dono ek hi frame read-only map karte
+// hain (PTE_COW) aur har extra mapping ek frame ref leti hai. Pehla write
+// vm_handle_cow_fault() mein private copy banata hai.
 uint32_t *pd_clone(uint32_t *source_pd_phys) {
   uint32_t phys_new_pd = (uint32_t)pd_create();
   uint32_t *new_pd = (uint32_t *)PHYS_TO_VIRT(phys_new_pd);
   uint32_t *source_pd = (uint32_t *)PHYS_TO_VIRT(source_pd_phys);
+  uint32_t pmm_limit = pmm_get_block_count() * PMM_BLOCK_SIZE;
 
   for (int i = 0; i < 768; i++) {
     if (!(source_pd[i] & 1))
@@ -39,19 +49,72 @@ uint32_t *pd_clone(uint32_t *source_pd_phys) {
     new_pd[i] = phys_dest_pt | (source_pd[i] & 0xFFF);
 
     for (int j = 0; j < 1024; j++) {
-      if (src_pt[j] & 1) {
-        uint32_t src_phys = src_pt[j] & 0xFFFFF000;
-        uint32_t dest_phys = (uint32_t)pmm_alloc_block();
+      uint32_t pte = src_pt[j];
+      if (!(pte & 1))
+        continue;
+
+      uint32_t phys = pte & 0xFFFFF000;
+      if (phys >= pmm_limit) {
+        // MMIO / framebuffer - PMM ka frame nahi, seedha share karo
+        dest_pt[j] = pte;
+        continue;
+      }
 
-        memcpy((void *)PHYS_TO_VIRT(dest_phys), (void *)PHYS_TO_VIRT(src_phys),
-               4096);
-        dest_pt[j] = dest_phys | (src_pt[j] & 0xFFF);
+      pmm_ref_frame((void *)phys);
+      if ((pte & PTE_RW) && !(pte & PTE_SHARED)) {
+        pte = (pte & ~PTE_RW) | PTE_COW;
+        src_pt[j] = pte; // Parent bhi ab read-only
       }
+      dest_pt[j] = pte;
     }
   }
+
+  // Parent ke purane writable TLB entries hatao
+  uint32_t cr3;
+  asm volatile("mov %%cr3, %0" : "=r"(cr3));
+  asm volatile("mov %0, %%cr3" ::"r"(cr3) : "memory");
+
   return (uint32_t *)phys_new_pd;
 }
 
+// COW page pe write fault: private copy banao (ya akele owner ho toh seedha
+// writable kar do). true = fault sambhal liya.
+bool vm_handle_cow_fault(uint32_t virt) {
+  uint32_t *pte = paging_get_pte(virt);
+  if (!pte || !(*pte & PTE_PRESENT) || !(*pte & PTE_COW))
+    return false;
+
+  uint32_t page = virt & 0xFFFFF000;
+  uint32_t old_phys = *pte & 0xFFFFF000;
+  uint32_t flags = (*pte & 0xFFF & ~PTE_COW) | PTE_RW;
+
+  if (old_phys == vm_zero_phys) {
+    // Zero page se pehla write - copy ki zaroorat nahi, bas naya zero frame
+    uint32_t new_phys = (uint32_t)pmm_alloc_block();
+    if (!new_phys)
+      return false;
+    memset((void *)PHYS_TO_VIRT(new_phys), 0, 4096);
+    *pte = new_phys | flags;
+    vm_anon_stats.anon_pages++;
+  } else if (pmm_frame_refs((void *)old_phys) == 0) {
+    // Baaki sharers chale gaye - copy ki zaroorat nahi
+    *pte = old_phys | flags;
+  } else {
+    uint32_t new_phys = (uint32_t)pmm_alloc_block();
+    if (!new_phys)
+      return false;
+    memcpy((void *)PHYS_TO_VIRT(new_phys), (void *)PHYS_TO_VIRT(old_phys),
+           4096);
+    *pte = new_phys | flags;
+    pmm_free_block((void *)old_phys); // Apna ref chhodo
+    vm_anon_stats.cow_copies++;
+  }
+
+  asm volatile("invlpg (%0)" ::"r"(page) : "memory");
+  return true;
+}
+
+// Shared (COW/SHM) frames pe pmm_free_block sirf ek ref chhodta hai
 void pd_destroy(uint32_t *pd_phys) {
   uint32_t *pd = (uint32_t *)PHYS_TO_VIRT(pd_phys);
   for (int i = 0; i < 1024; i++) {
@@ -75,10 +138,9 @@ void pd_switch(uint32_t *pd_phys) {
   asm volatile("mov %0, %%cr3" ::"r"(pd_phys));
 }
 
-void vm_map_page(uint32_t phys, uint32_t virt, uint32_t flags) {
-  uint32_t phys_pd;
-  asm volatile("mov %%cr3, %0" : "=r"(phys_pd));
-  uint32_t *pd = (uint32_t *)PHYS_TO_VIRT(phys_pd);
+void vm_map_page_pd(uint32_t *pd_phys, uint32_t phys, uint32_t virt,
+                    uint32_t flags) {
+  uint32_t *pd = (uint32_t *)PHYS_TO_VIRT((uint32_t)pd_phys);
 
   uint32_t pd_index = virt >> 22;
   uint32_t pt_index = (virt >> 12) & 0x03FF;
@@ -93,13 +155,21 @@ void vm_map_page(uint32_t phys, uint32_t virt, uint32_t flags) {
   uint32_t *pt = (uint32_t *)PHYS_TO_VIRT(pd[pd_index] & 0xFFFFF000);
   pt[pt_index] = (phys & 0xFFFFF000) | flags;
 
-  asm volatile("invlpg (%0)" ::"r"(virt) : "memory");
+  // Doosre PD ka TLB entry is CPU pe ho hi nahi sakta
+  uint32_t cr3;
+  asm volatile("mov %%cr3, %0" : "=r"(cr3));
+  if (cr3 == (uint32_t)pd_phys)
+    asm volatile("invlpg (%0)" ::"r"(virt) : "memory");
 }
 
-uint32_t vm_get_phys(uint32_t virt) {
+void vm_map_page(uint32_t phys, uint32_t virt, uint32_t flags) {
   uint32_t phys_pd;
   asm volatile("mov %%cr3, %0" : "=r"(phys_pd));
-  uint32_t *pd = (uint32_t *)PHYS_TO_VIRT(phys_pd);
+  vm_map_page_pd((uint32_t *)phys_pd, phys, virt, flags);
+}
+
+uint32_t vm_get_phys_pd(uint32_t *pd_phys, uint32_t virt) {
+  uint32_t *pd = (uint32_t *)PHYS_TO_VIRT((uint32_t)pd_phys);
 
   uint32_t pd_index = virt >> 22;
   uint32_t pt_index = (virt >> 12) & 0x03FF;
@@ -113,6 +183,36 @@ uint32_t vm_get_phys(uint32_t virt) {
   return (pt[pt_index] & 0xFFFFF000) + (virt & 0xFFF);
 }
 
+uint32_t vm_get_phys(uint32_t virt) {
+  uint32_t phys_pd;
+  asm volatile("mov %%cr3, %0" : "=r"(phys_pd));
+  return vm_get_phys_pd((uint32_t *)phys_pd, virt);
+}
+
+bool vm_copy_to_pd(uint32_t *pd_phys, uint32_t virt, const void *src,
+                   uint32_t len) {
+  // Frame dar frame kernel mapping (PHYS_TO_VIRT) se - CR3 nahi badalta
+  const uint8_t *s = (const uint8_t *)src;
+  while (len) {
+    uint32_t phys = vm_get_phys_pd(pd_phys, virt);
+    if (!phys)
+      return false;
+    uint32_t chunk = 4096 - (virt & 0xFFF);
+    if (chunk > len)
+      chunk = len;
+    uint8_t *dst = (uint8_t *)PHYS_TO_VIRT(phys);
+    if (s) {
+      memcpy(dst, s, chunk);
+      s += chunk;
+    } else {
+      memset(dst, 0, chunk);
+    }
+    virt += chunk;
+    len -= chunk;
+  }
+  return true;
+}
+
 void vm_unmap_page(uint32_t virt) {
   uint32_t phys_pd;
   asm volatile("mov %%cr3, %0" : "=r"(phys_pd));
@@ -131,6 +231,7 @@ void vm_unmap_page(uint32_t virt) {
   asm volatile("invlpg (%0)" ::"r"(virt) : "memory");
 }
 
+// exec ke liye user half saaf karo; COW/SHM frames refcount se bache rehte hain
 void vm_clear_user_mappings() {
   uint32_t phys_pd;
   asm volatile("mov %%cr3, %0" : "=r"(phys_pd));
@@ -151,3 +252,56 @@ void vm_clear_user_mappings() {
   }
   asm volatile("mov %%cr3, %%eax; mov %%eax, %%cr3" ::: "eax");
 }
+
+// [start, end) mein kitne pages present hain (RSS ke liye). Directory switch
+// nahi karta - pd_phys ki tables seedha padhta hai.
+uint32_t vm_count_present(uint32_t *pd_phys, uint32_t start, uint32_t end) {
+  uint32_t *pd = (uint32_t *)PHYS_TO_VIRT(pd_phys);
+  uint32_t count = 0;
+  uint32_t addr = start & 0xFFFFF000;
+  while (addr < end && addr >= (start & 0xFFFFF000)) {
+    uint32_t pd_index = addr >> 22;
+    if (!(pd[pd_index] & 1)) {
+      addr = (pd_index + 1) << 22; // Poori table khali
+      continue;
+    }
+    uint32_t *pt = (uint32_t *)PHYS_TO_VIRT(pd[pd_index] & 0xFFFFF000);
+    uint32_t pte = pt[(addr >> 12) & 0x3FF];
+    if ((pte & 1) && (pte & 0xFFFFF000) != vm_zero_phys)
+      count++; // Zero page kisi ka apna nahi, RSS mein nahi ginte
+    addr += 4096;
+  }
+  return count;
+}
+
+void vm_init_zero_page() {
+  vm_zero_phys = (uint32_t)pmm_alloc_block();
+  if (!vm_zero_phys) {
+    serial_log("VM: Zero page allocate nahi hua, anon memory eager rahegi.");
+    return;
+  }
+  memset((void *)PHYS_TO_VIRT(vm_zero_phys), 0, 4096);
+  pmm_pin_frame((void *)vm_zero_phys);
+  serial_log_hex("VM: Shared zero page at ", vm_zero_phys);
+}
+
+// Anonymous (mmap/heap/stack) page fault. Read: zero page read-only + COW,
+// koi frame kharch nahi. Write: private zeroed frame.
+bool vm_map_anon_page(uint32_t virt, uint32_t flags, bool write) {
+  uint32_t page = virt & 0xFFFFF000;
+  if (!write && vm_zero_phys) {
+    vm_map_page(vm_zero_phys, page, (flags & ~PTE_RW) | PTE_COW);
+    vm_anon_stats.zero_page_hits++;
+    return true;
+  }
+
+  uint32_t phys = (uint32_t)pmm_alloc_block();
+  if (!phys)
+    return false;
+  memset((void *)PHYS_TO_VIRT(phys), 0, 4096);
+  vm_map_page(phys, page, flags);
+  vm_anon_stats.anon_pages++;
+  return true;
+}
+
+void vm_get_anon_stats(vm_anon_stats_t *out) { *out = vm_anon_stats; }
@@ -3,12 +3,23 @@
 
 #include "../include/types.h"
 
+// Lazy anonymous memory counters
+typedef struct vm_anon_stats {
+  uint32_t zero_page_hits; // Read faults served by the shared zero page
+  uint32_t anon_pages;     // Anonymous pages actually materialized
+  uint32_t cow_copies;     // COW breaks that copied a shared frame
+} vm_anon_stats_t;
+
 // Create a new Page Directory with kernel mappings copied
 uint32_t *pd_create();
 
-// Clone a Page Directory (used for fork)
+// Clone a Page Directory (used for fork). User pages are shared copy-on-write
+// with per-frame refcounts; SHM (PTE_SHARED) pages stay shared writable.
 uint32_t *pd_clone(uint32_t *source_pd);
 
+// Break COW sharing on a write fault. Returns true if the fault was handled.
+bool vm_handle_cow_fault(uint32_t virt);
+
 // Destroy a Page Directory (freeing its own structure, but NOT the shared
 // kernel tables)
 void pd_destroy(uint32_t *pd);
@@ -26,6 +37,29 @@ void vm_unmap_page(uint32_t virt);
 // Get physical address for virtual, returns 0 if not mapped
 uint32_t vm_get_phys(uint32_t virt);
 
+// Same for another directory (physical address of the PD), without loading
+// it into CR3 - used to build a new process image from its parent
+void vm_map_page_pd(uint32_t *pd_phys, uint32_t phys, uint32_t virt,
+                    uint32_t flags);
+uint32_t vm_get_phys_pd(uint32_t *pd_phys, uint32_t virt);
+
+// Copy len bytes to virt in the given directory through the kernel mapping
+// of its frames (src 0 = zero fill). False if a page is not mapped.
+bool vm_copy_to_pd(uint32_t *pd_phys, uint32_t virt, const void *src,
+                   uint32_t len);
+
 void vm_clear_user_mappings();
 
+// Count present pages in [start, end) of the given directory
+uint32_t vm_count_present(uint32_t *pd_phys, uint32_t start, uint32_t end);
+
+// Allocate and pin the shared zero page (call after init_paging)
+void vm_init_zero_page();
+
+// Fault in an anonymous page: reads map the zero page read-only (COW),
+// writes get a private zeroed frame. flags are the VMA's PTE flags.
+bool vm_map_anon_page(uint32_t virt, uint32_t flags, bool write);
+
+void vm_get_anon_stats(vm_anon_stats_t *out);
+
 #endif
@@ -0,0 +1,183 @@
+// Virtual Memory Areas - sorted array, binary search lookup
+#include "vma.h"
+#include "../include/string.h"
+#include "vm.h"
+
+extern "C" {
+
+// Pehla area jiska end > addr (count agar koi nahi)
+static int vma_lower_bound(vma_list_t *list, uint32_t addr) {
+  int lo = 0, hi = list->count;
+  while (lo < hi) {
+    int mid = (lo + hi) / 2;
+    if (list->areas[mid].end <= addr)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return lo;
+}
+
+static void vma_open_slot(vma_list_t *list, int idx) {
+  memmove(&list->areas[idx + 1], &list->areas[idx],
+          (list->count - idx) * sizeof(vma_t));
+  list->count++;
+}
+
+static void vma_close_slot(vma_list_t *list, int idx) {
+  memmove(&list->areas[idx], &list->areas[idx + 1],
+          (list->count - idx - 1) * sizeof(vma_t));
+  list->count--;
+}
+
+static bool vma_same_kind(vma_t *v, uint32_t prot, uint32_t backing) {
+  return v->prot == prot && v->backing == backing;
+}
+
+int vma_insert(vma_list_t *list, uint32_t start, uint32_t end, uint32_t prot,
+               uint32_t backing) {
+  if (start >= end)
+    return -1;
+
+  int idx = vma_lower_bound(list, start);
+  if (idx < list->count && list->areas[idx].start < end)
+    return -1; // Overlap
+
+  vma_t *prev = idx > 0 ? &list->areas[idx - 1] : 0;
+  vma_t *next = idx < list->count ? &list->areas[idx] : 0;
+  bool join_prev = prev && prev->end == start &&
+                   vma_same_kind(prev, prot, backing);
+  bool join_next = next && next->start == end &&
+                   vma_same_kind(next, prot, backing);
+
+  if (join_prev && join_next) {
+    prev->end = next->end;
+    vma_close_slot(list, idx);
+  } else if (join_prev) {
+    prev->end = end;
+  } else if (join_next) {
+    next->start = start;
+  } else {
+    if (list->count == VMA_MAX)
+      return -1;
+    vma_open_slot(list, idx);
+    vma_t *v = &list->areas[idx];
+    v->start = start;
+    v->end = end;
+    v->prot = prot;
+    v->backing = backing;
+  }
+  return 0;
+}
+
+vma_t *vma_find(vma_list_t *list, uint32_t addr) {
+  int idx = vma_lower_bound(list, addr);
+  if (idx < list->count && list->areas[idx].start <= addr)
+    return &list->areas[idx];
+  return 0;
+}
+
+int vma_remove(vma_list_t *list, uint32_t start, uint32_t end) {
+  int idx = vma_lower_bound(list, start);
+  while (idx < list->count && list->areas[idx].start < end) {
+    vma_t *v = &list->areas[idx];
+    if (v->start < start && v->end > end) {
+      // Beech se kaatna hai - do hisse
+      if (list->count == VMA_MAX)
+        return -1;
+      vma_open_slot(list, idx + 1);
+      list->areas[idx + 1] = *v;
+      list->areas[idx + 1].start = end;
+      v->end = start;
+      return 0;
+    }
+    if (v->start < start) {
+      v->end = start;
+      idx++;
+    } else if (v->end > end) {
+      v->start = end;
+      return 0;
+    } else {
+      vma_close_slot(list, idx);
+    }
+  }
+  return 0;
+}
+
+int vma_protect(vma_list_t *list, uint32_t start, uint32_t end,
+                uint32_t prot) {
+  // Pehle dekho ki poori range covered hai, aur kitne naye slots lagenge:
+  // sirf do kinare aadhe kat sakte hain, har ek +1 (ek hi area ke beech se
+  // kaate to +2). Beech mein full pe fail hua to range list se gayab ho
+  // jaati jabki pages mapped rehte - isliye kuch badalne se pehle hi mana.
+  uint32_t cur = start;
+  int extra = 0;
+  for (int idx = vma_lower_bound(list, start);
+       idx < list->count && cur < end; idx++) {
+    vma_t *v = &list->areas[idx];
+    if (v->start > cur)
+      return -1;
+    if (v->prot != prot) {
+      if (v->start < start)
+        extra++;
+      if (v->end > end)
+        extra++;
+    }
+    cur = v->end;
+  }
+  if (cur < end)
+    return -1;
+  if (list->count + extra > VMA_MAX)
+    return -1;
+
+  // Har hissa nikaal ke naye prot ke saath wapas daalo
+  while (start < end) {
+    vma_t *v = vma_find(list, start);
+    uint32_t seg_end = v->end < end ? v->end : end;
+    uint32_t backing = v->backing;
+    if (v->prot != prot) {
+      if (vma_remove(list, start, seg_end) != 0 ||
+          vma_insert(list, start, seg_end, prot, backing) != 0)
+        return -1;
+    }
+    start = seg_end;
+  }
+  return 0;
+}
+
+uint32_t vma_find_gap(vma_list_t *list, uint32_t len, uint32_t lo,
+                      uint32_t hi) {
+  len = (len + 0xFFF) & 0xFFFFF000;
+  uint32_t cur = lo;
+  for (int idx = vma_lower_bound(list, lo); idx < list->count; idx++) {
+    vma_t *v = &list->areas[idx];
+    if (v->start >= hi)
+      break;
+    if (v->start > cur && v->start - cur >= len)
+      return cur;
+    if (v->end > cur)
+      cur = v->end;
+  }
+  if (cur < hi && hi - cur >= len)
+    return cur;
+  return 0;
+}
+
+void vma_clear(vma_list_t *list) { list->count = 0; }
+
+uint32_t vma_total_pages(vma_list_t *list) {
+  uint32_t pages = 0;
+  for (int i = 0; i < list->count; i++)
+    pages += (list->areas[i].end - list->areas[i].start) / 4096;
+  return pages;
+}
+
+uint32_t vma_rss_pages(vma_list_t *list, uint32_t *pd_phys) {
+  uint32_t pages = 0;
+  for (int i = 0; i < list->count; i++)
+    pages += vm_count_present(pd_phys, list->areas[i].start,
+                              list->areas[i].end);
+  return pages;
+}
+
+} // extern "C"
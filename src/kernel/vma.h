@@ -0,0 +1,78 @@
+// Virtual Memory Areas - har process ke user address space ka naksha
+#ifndef VMA_H
+#define VMA_H
+
+#include "../include/types.h"
+
+#define VMA_MAX 32
+
+// Protection bits (PROT_* jaise hi)
+#define VMA_READ 0x1
+#define VMA_WRITE 0x2
+#define VMA_EXEC 0x4
+
+// Backing - fault aane pe page kahan se aayega
+#define VMA_ANON 0  // mmap: zero-filled
+#define VMA_HEAP 1  // sbrk: zero-filled
+#define VMA_STACK 2 // User stack: zero-filled
+#define VMA_FILE 3  // ELF segment: process->image se
+#define VMA_SHM 4   // Shared memory segment
+
+// User stack window (ASLR offset isi ke andar rehta hai)
+#define USER_STACK_LOW 0xAF000000
+#define USER_STACK_HIGH 0xB0002000
+
+// mmap(addr = 0) yahan jagah dhundta hai
+#define USER_MMAP_BASE 0x80000000
+#define USER_MMAP_END USER_STACK_LOW
+
+typedef struct vma {
+  uint32_t start; // Page aligned
+  uint32_t end;   // Exclusive, page aligned
+  uint16_t prot;
+  uint16_t backing;
+} vma_t;
+
+// start ke hisaab se sorted, overlap nahi - lookup binary search se
+typedef struct vma_list {
+  vma_t areas[VMA_MAX];
+  int count;
+} vma_list_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// [start, end) register karo. Overlap ya list full ho toh -1.
+// Same prot/backing wale padosi se jud jaata hai (sbrk growth).
+int vma_insert(vma_list_t *list, uint32_t start, uint32_t end, uint32_t prot,
+               uint32_t backing);
+
+// addr wala area, ya 0 (log time)
+vma_t *vma_find(vma_list_t *list, uint32_t addr);
+
+// [start, end) hatao, beech mein ho toh area split hota hai. Full pe -1.
+int vma_remove(vma_list_t *list, uint32_t start, uint32_t end);
+
+// [start, end) ka prot badlo. Range poori mapped na ho ya split ke liye
+// slots na bachein toh -1, aur list jaisi thi waisi rehti hai.
+int vma_protect(vma_list_t *list, uint32_t start, uint32_t end,
+                uint32_t prot);
+
+// [lo, hi) mein len bytes ka pehla khali gap, ya 0
+uint32_t vma_find_gap(vma_list_t *list, uint32_t len, uint32_t lo,
+                      uint32_t hi);
+
+void vma_clear(vma_list_t *list);
+
+// Saare areas ka size (pages mein)
+uint32_t vma_total_pages(vma_list_t *list);
+
+// Areas ke andar present pages (RSS) - pd_phys ki page tables pe walk
+uint32_t vma_rss_pages(vma_list_t *list, uint32_t *pd_phys);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // VMA_H
@@ -0,0 +1,171 @@
+// vmalloc - individual frames ko VMALLOC_START..VMALLOC_END mein map karke
+// bade buffers (GUI back buffer, PE images, ramdisk). Buddy heap ko inke liye
+// 2^n contiguous block nahi dhoondna padta.
+#include "vmalloc.h"
+#include "../drivers/serial.h"
+#include "../include/string.h"
+#include "paging.h"
+#include "pmm.h"
+#include "smp.h"
+#include "spinlock.h"
+
+extern uint32_t *kernel_directory;
+
+typedef struct {
+  uint32_t start; // Page aligned
+  uint32_t pages; // Mapped pages (guard page iske baad, gina nahi)
+} vmalloc_area_t;
+
+// start ke hisaab se sorted
+static vmalloc_area_t vm_areas[VMALLOC_MAX_AREAS];
+static int vm_area_count = 0;
+static uint32_t vm_mapped_pages = 0;
+
+// vm_areas + vmalloc PTEs. Andar se pmm_lock liya jaata hai.
+static DEFINE_SPINLOCK(vmalloc_lock, "vmalloc");
+
+// Shared kernel page table ka PTE (vmalloc_init ne saare tables bana diye)
+static uint32_t *vmalloc_pte(uint32_t virt) {
+  uint32_t *pt =
+      (uint32_t *)PHYS_TO_VIRT(kernel_directory[virt >> 22] & 0xFFFFF000);
+  return &pt[(virt >> 12) & 0x3FF];
+}
+
+void vmalloc_init() {
+  for (uint32_t pd = VMALLOC_START >> 22; pd < (VMALLOC_END >> 22); pd++) {
+    uint32_t phys_pt = (uint32_t)pmm_alloc_block();
+    memset((void *)PHYS_TO_VIRT(phys_pt), 0, 4096);
+    kernel_directory[pd] = phys_pt | 3;
+  }
+  serial_log("VMALLOC: Kernel range 0xE0000000-0xF0000000 taiyar.");
+}
+
+int is_vmalloc_addr(const void *addr) {
+  uint32_t a = (uint32_t)addr;
+  return a >= VMALLOC_START && a < VMALLOC_END;
+}
+
+// First fit gap (guard page ke saath); slot index deta hai ya -1
+static int vmalloc_find_gap(uint32_t span, uint32_t *out) {
+  uint32_t cursor = VMALLOC_START;
+  for (int i = 0; i <= vm_area_count; i++) {
+    uint32_t limit = (i < vm_area_count) ? vm_areas[i].start : VMALLOC_END;
+    if (limit - cursor >= span) {
+      *out = cursor;
+      return i;
+    }
+    if (i < vm_area_count)
+      cursor = vm_areas[i].start + (vm_areas[i].pages + 1) * 4096;
+  }
+  return -1;
+}
+
+// Do pass: pehle PTEs not-present (frame bits rehte hain), saare CPUs ka
+// TLB flush, tab frames wapas - doosre CPU ki puraani TLB entry kisi aur ko
+// mil chuke frame mein na likhe
+static void vmalloc_unmap(uint32_t start, uint32_t pages) {
+  for (uint32_t i = 0; i < pages; i++)
+    *vmalloc_pte(start + i * 4096) &= ~1u;
+  smp_flush_tlb_range(start, pages);
+  for (uint32_t i = 0; i < pages; i++) {
+    uint32_t *pte = vmalloc_pte(start + i * 4096);
+    if (*pte & 0xFFFFF000)
+      pmm_free_block((void *)(*pte & 0xFFFFF000));
+    *pte = 0;
+  }
+}
+
+void *vmalloc(uint32_t size) {
+  if (size == 0)
+    return 0;
+  uint32_t pages = (size + 4095) / 4096;
+  if (pages >= (VMALLOC_END - VMALLOC_START) / 4096)
+    return 0;
+
+  uint32_t eflags = spin_lock_irqsave(&vmalloc_lock);
+  uint32_t start;
+  int slot = (vm_area_count < VMALLOC_MAX_AREAS)
+                 ? vmalloc_find_gap((pages + 1) * 4096, &start)
+                 : -1;
+  if (slot < 0) {
+    spin_unlock_irqrestore(&vmalloc_lock, eflags);
+    serial_log_hex("VMALLOC: Virtual jagah nahi mili, pages: ", pages);
+    return 0;
+  }
+
+  for (uint32_t i = 0; i < pages; i++) {
+    uint32_t phys = (uint32_t)pmm_alloc_block();
+    if (!phys) {
+      vmalloc_unmap(start, i);
+      spin_unlock_irqrestore(&vmalloc_lock, eflags);
+      serial_log_hex("VMALLOC: OOM, pages: ", pages);
+      return 0;
+    }
+    *vmalloc_pte(start + i * 4096) = phys | 3;
+  }
+
+  for (int i = vm_area_count; i > slot; i--)
+    vm_areas[i] = vm_areas[i - 1];
+  vm_areas[slot].start = start;
+  vm_areas[slot].pages = pages;
+  vm_area_count++;
+  vm_mapped_pages += pages;
+
+  spin_unlock_irqrestore(&vmalloc_lock, eflags);
+  return (void *)start;
+}
+
+void *vzalloc(uint32_t size) {
+  void *p = vmalloc(size);
+  if (p)
+    memset(p, 0, size);
+  return p;
+}
+
+void vfree(void *addr) {
+  if (!addr)
+    return;
+  uint32_t start = (uint32_t)addr;
+
+  uint32_t eflags = spin_lock_irqsave(&vmalloc_lock);
+  int lo = 0, hi = vm_area_count - 1, slot = -1;
+  while (lo <= hi) {
+    int mid = (lo + hi) / 2;
+    if (vm_areas[mid].start == start) {
+      slot = mid;
+      break;
+    }
+    if (vm_areas[mid].start < start)
+      lo = mid + 1;
+    else
+      hi = mid - 1;
+  }
+  if (slot < 0) {
+    spin_unlock_irqrestore(&vmalloc_lock, eflags);
+    serial_log_hex("VMALLOC: vfree galat pointer: ", start);
+    return;
+  }
+
+  vmalloc_unmap(start, vm_areas[slot].pages);
+  vm_mapped_pages -= vm_areas[slot].pages;
+  for (int i = slot; i < vm_area_count - 1; i++)
+    vm_areas[i] = vm_areas[i + 1];
+  vm_area_count--;
+  spin_unlock_irqrestore(&vmalloc_lock, eflags);
+}
+
+void vmalloc_get_stats(vmalloc_stats_t *out) {
+  uint32_t eflags = spin_lock_irqsave(&vmalloc_lock);
+  out->areas = vm_area_count;
+  out->pages = vm_mapped_pages;
+  out->largest_gap = 0;
+  uint32_t cursor = VMALLOC_START;
+  for (int i = 0; i <= vm_area_count; i++) {
+    uint32_t limit = (i < vm_area_count) ? vm_areas[i].start : VMALLOC_END;
+    if (limit - cursor > out->largest_gap)
+      out->largest_gap = limit - cursor;
+    if (i < vm_area_count)
+      cursor = vm_areas[i].start + (vm_areas[i].pages + 1) * 4096;
+  }
+  spin_unlock_irqrestore(&vmalloc_lock, eflags);
+}
@@ -0,0 +1,40 @@
+// vmalloc - bade kernel buffers jo physically contiguous nahi chahiye
+#ifndef VMALLOC_H
+#define VMALLOC_H
+
+#include "../include/types.h"
+
+// 512MB direct map (0xC0000000-0xE0000000) ke upar ka kernel virtual range.
+// Iske page tables boot pe kernel_directory mein ban jaate hain, toh har
+// process ka PD (pd_create copy) same tables share karta hai.
+#define VMALLOC_START 0xE0000000
+#define VMALLOC_END 0xF0000000
+#define VMALLOC_MAX_AREAS 128
+
+typedef struct vmalloc_stats {
+  uint32_t areas;       // Live allocations
+  uint32_t pages;       // Mapped frames (guard pages nahi)
+  uint32_t largest_gap; // Sabse bada free virtual gap (bytes)
+} vmalloc_stats_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// init_paging ke end mein, pehle process PD se pehle
+void vmalloc_init();
+
+// Har page alag PMM frame, VMALLOC range mein mapped, peeche ek unmapped
+// guard page. vmalloc zero nahi karta, vzalloc karta hai.
+void *vmalloc(uint32_t size);
+void *vzalloc(uint32_t size);
+void vfree(void *addr);
+
+int is_vmalloc_addr(const void *addr);
+void vmalloc_get_stats(vmalloc_stats_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
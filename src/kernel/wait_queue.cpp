@@ -1,95 +1,154 @@
 // Wait Queue - Implementation of sleep/wake primitives
 #include "wait_queue.h"
-#include "heap.h"
-#include "memory.h"
+#include "ktimer.h"
 #include "process.h"
+#include "sched.h"
+
+extern uint32_t tick;
 
 extern "C" {
 
 void wait_queue_init(wait_queue_t *wq) {
   wq->head = 0;
   wq->tail = 0;
+  spin_lock_init(&wq->lock, 0);
 }
 
-void sleep_on(wait_queue_t *wq) {
-  if (!current_process || !wq)
-    return;
-
-  // Disable interrupts to prevent race conditions
-  asm volatile("cli");
-
-  // Add current process to wait queue
-  wait_queue_entry_t *entry =
-      (wait_queue_entry_t *)kmalloc(sizeof(wait_queue_entry_t));
-  if (!entry) {
-    asm volatile("sti");
-    return;
-  }
-
+void init_wait_entry(wait_queue_entry_t *entry, uint32_t flags) {
   entry->proc = current_process;
+  entry->flags = flags;
+  entry->wq = 0;
   entry->next = 0;
+  entry->prev = 0;
+}
 
-  if (!wq->head) {
-    wq->head = entry;
+// wq->lock pakda hua
+static void wq_add(wait_queue_t *wq, wait_queue_entry_t *entry) {
+  if (entry->flags & WQ_FLAG_EXCLUSIVE) {
+    entry->next = 0;
+    entry->prev = wq->tail;
+    if (wq->tail)
+      wq->tail->next = entry;
+    else
+      wq->head = entry;
     wq->tail = entry;
   } else {
-    wq->tail->next = entry;
-    wq->tail = entry;
+    entry->prev = 0;
+    entry->next = wq->head;
+    if (wq->head)
+      wq->head->prev = entry;
+    else
+      wq->tail = entry;
+    wq->head = entry;
   }
-
-  // Set process state to sleeping
-  current_process->state = PROCESS_WAITING;
-
-  // Re-enable interrupts and yield
-  asm volatile("sti");
-
-  // Yield to scheduler - when we return, we've been woken up
-  schedule();
+  entry->wq = wq;
 }
 
-void wake_up(wait_queue_t *wq) {
-  if (!wq || !wq->head)
-    return;
+static void wq_remove(wait_queue_t *wq, wait_queue_entry_t *entry) {
+  if (entry->prev)
+    entry->prev->next = entry->next;
+  else
+    wq->head = entry->next;
+  if (entry->next)
+    entry->next->prev = entry->prev;
+  else
+    wq->tail = entry->prev;
+  entry->next = 0;
+  entry->prev = 0;
+  entry->wq = 0;
+}
 
-  asm volatile("cli");
+uint32_t prepare_to_wait(wait_queue_t *wq, wait_queue_entry_t *entry) {
+  // Lock sirf list ke liye; interrupts caller ke condition check aur
+  // schedule() tak band rehte hain (eflags finish_wait wapas karta hai)
+  uint32_t eflags = local_irq_save();
+  spin_lock(&wq->lock);
+  if (!entry->wq)
+    wq_add(wq, entry);
+  current_process->state = PROCESS_WAITING;
+  spin_unlock(&wq->lock);
+  return eflags;
+}
 
-  // Remove first entry from queue
-  wait_queue_entry_t *entry = wq->head;
-  wq->head = entry->next;
-  if (!wq->head)
-    wq->tail = 0;
+void finish_wait(wait_queue_t *wq, wait_queue_entry_t *entry,
+                 uint32_t eflags) {
+  // Condition pehle hi sach thi ya schedule ko koi aur nahi mila - tab
+  // state abhi bhi WAITING
+  current_process->state = PROCESS_RUNNING;
+  spin_lock(&wq->lock);
+  if (entry->wq == wq)
+    wq_remove(wq, entry);
+  spin_unlock(&wq->lock);
+  local_irq_restore(eflags);
+}
 
-  // Wake up the process
-  if (entry->proc) {
-    entry->proc->state = PROCESS_READY;
-  }
+// process_sleep wala timer, par WAITING ko bhi jagata hai
+static void wq_timeout(ktimer_t *timer) {
+  process_t *p = (process_t *)timer->data;
+  if (p->state == PROCESS_WAITING || p->state == PROCESS_SLEEPING)
+    sched_wakeup(p);
+}
 
-  kfree(entry);
+uint32_t schedule_timeout(uint32_t ticks) {
+  process_t *p = current_process;
+  uint32_t deadline = tick + ticks;
+  timer_setup(&p->sleep_timer, wq_timeout, p);
+  timer_add(&p->sleep_timer, deadline);
+  schedule();
+  timer_del(&p->sleep_timer);
 
-  asm volatile("sti");
+  int32_t left = (int32_t)(deadline - tick);
+  return left > 0 ? (uint32_t)left : 0;
 }
 
-void wake_up_all(wait_queue_t *wq) {
-  if (!wq)
+void sleep_on(wait_queue_t *wq) {
+  if (!current_process || !wq)
     return;
 
-  asm volatile("cli");
+  wait_queue_entry_t wait;
+  init_wait_entry(&wait, 0);
+  uint32_t eflags = prepare_to_wait(wq, &wait);
+  // Yield to scheduler - when we return, we've been woken up
+  schedule();
+  finish_wait(wq, &wait, eflags);
+}
 
-  while (wq->head) {
-    wait_queue_entry_t *entry = wq->head;
-    wq->head = entry->next;
+uint32_t sleep_on_timeout(wait_queue_t *wq, uint32_t ticks) {
+  if (!current_process || !wq)
+    return 0;
+
+  wait_queue_entry_t wait;
+  init_wait_entry(&wait, 0);
+  uint32_t eflags = prepare_to_wait(wq, &wait);
+  uint32_t left = schedule_timeout(ticks); // wake_up ya timer, jo pehle
+  finish_wait(wq, &wait, eflags);
+  return left;
+}
 
-    if (entry->proc) {
-      entry->proc->state = PROCESS_READY;
-    }
+void wake_up_nr(wait_queue_t *wq, int nr) {
+  if (!wq || !wq->head)
+    return;
 
-    kfree(entry);
+  // Lock order: wq -> runqueue (sched_wakeup)
+  uint32_t eflags = spin_lock_irqsave(&wq->lock);
+  wait_queue_entry_t *entry = wq->head;
+  while (entry) {
+    wait_queue_entry_t *next = entry->next;
+    bool exclusive = entry->flags & WQ_FLAG_EXCLUSIVE;
+    // Entry hatao phir jagao - jaagne wala finish_wait mein dobara na
+    // chhue, aur agla wake_up isko dobara na gine
+    wq_remove(wq, entry);
+    sched_wakeup(entry->proc);
+    if (exclusive && --nr <= 0)
+      break;
+    entry = next;
   }
+  spin_unlock_irqrestore(&wq->lock, eflags);
+}
 
-  wq->tail = 0;
+void wake_up(wait_queue_t *wq) { wake_up_nr(wq, 1); }
 
-  asm volatile("sti");
-}
+void wake_up_all(wait_queue_t *wq) { wake_up_nr(wq, 0x7FFFFFFF); }
 
 int wait_queue_empty(wait_queue_t *wq) { return wq ? (wq->head == 0) : 1; }
 
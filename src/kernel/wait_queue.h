@@ -3,20 +3,35 @@
 #define WAIT_QUEUE_H
 
 #include "../include/types.h"
+#include "spinlock.h"
 
 struct process; // Forward declaration
+struct wait_queue;
 
+// Exclusive waiter: wake_up inme se sirf ek ko jagata hai (accept, sem_wait
+// jaise jahan ek hi jeet sakta hai). Non-exclusive sab jaagte hain.
+#define WQ_FLAG_EXCLUSIVE 0x01
+
+// Entry sone wale ke stack pe rehti hai - koi allocation nahi. Jagaane
+// wala entry ko queue se hata deta hai (wq = 0), finish_wait baaki dekhta
+// hai (timeout / signal se jaage to entry abhi bhi queue mein).
 typedef struct wait_queue_entry {
   struct process *proc;
+  uint32_t flags;
+  struct wait_queue *wq; // Jis queue pe hai, 0 = kisi pe nahi
   struct wait_queue_entry *next;
+  struct wait_queue_entry *prev;
 } wait_queue_entry_t;
 
+// Non-exclusive entries aage, exclusive peeche (Linux jaisa) - wake_up
+// pehle saare non-exclusive jagata hai, phir nr exclusive
 typedef struct wait_queue {
   wait_queue_entry_t *head;
   wait_queue_entry_t *tail;
+  spinlock_t lock; // Bina naam; IRQ handlers bhi jagate hain - irqsave
 } wait_queue_t;
 
-#define WAIT_QUEUE_INIT {0, 0}
+#define WAIT_QUEUE_INIT {0, 0, SPINLOCK_INIT(0)}
 
 #ifdef __cplusplus
 extern "C" {
@@ -25,10 +40,34 @@ extern "C" {
 // Initialize a wait queue
 void wait_queue_init(wait_queue_t *wq);
 
-// Put current process to sleep on this wait queue
+// Current process ke liye entry (flags: 0 ya WQ_FLAG_EXCLUSIVE)
+void init_wait_entry(wait_queue_entry_t *entry, uint32_t flags);
+
+// Interrupts band karke entry queue pe (pehle se na ho to) aur state
+// WAITING. Condition isi ke baad check karo - beech mein wakeup nahi
+// chhoot sakta. Returns purani eflags, finish_wait ko wapas do.
+uint32_t prepare_to_wait(wait_queue_t *wq, wait_queue_entry_t *entry);
+
+// Entry queue se hatao (abhi bhi ho to), state RUNNING, eflags wapas
+void finish_wait(wait_queue_t *wq, wait_queue_entry_t *entry,
+                 uint32_t eflags);
+
+// prepare_to_wait ke baad: zyada se zyada ticks tak so jao. Wakeup,
+// signal ya timeout - bache hue ticks (timeout pe 0).
+uint32_t schedule_timeout(uint32_t ticks);
+
+// Put current process to sleep on this wait queue (ek baar, condition
+// caller dekhe - naye code mein wait_event use karo)
 void sleep_on(wait_queue_t *wq);
 
-// Wake up one process from the queue
+// sleep_on, par zyada se zyada ticks tak. Jaldi jaaga to bache hue ticks,
+// timeout pe 0. Polling loops isse block karte hain taaki idle task chale.
+uint32_t sleep_on_timeout(wait_queue_t *wq, uint32_t ticks);
+
+// Saare non-exclusive aur zyada se zyada nr exclusive waiters jagao
+void wake_up_nr(wait_queue_t *wq, int nr);
+
+// Wake up waiters - non-exclusive sab, exclusive ek
 void wake_up(wait_queue_t *wq);
 
 // Wake up all processes from the queue
@@ -41,4 +80,50 @@ int wait_queue_empty(wait_queue_t *wq);
 }
 #endif
 
+// cond sach hone tak so. Har wakeup ke baad cond dobara (spurious wakeup,
+// signal, kisi aur ne pehle maal utha liya) - cond interrupts band karke
+// check hota hai, isliye IRQ wala producer bhi race nahi karta.
+#define __wait_event(wq, cond, flags)                                        \
+  do {                                                                       \
+    wait_queue_entry_t __wait;                                               \
+    init_wait_entry(&__wait, (flags));                                       \
+    for (;;) {                                                               \
+      uint32_t __eflags = prepare_to_wait((wq), &__wait);                    \
+      if (cond) {                                                            \
+        finish_wait((wq), &__wait, __eflags);                                \
+        break;                                                               \
+      }                                                                      \
+      schedule();                                                            \
+      finish_wait((wq), &__wait, __eflags);                                  \
+    }                                                                        \
+  } while (0)
+
+#define wait_event(wq, cond) __wait_event(wq, cond, 0)
+#define wait_event_exclusive(wq, cond) __wait_event(wq, cond, WQ_FLAG_EXCLUSIVE)
+
+// wait_event, par ticks ki hadd. cond sach hua to bache hue ticks (kam se
+// kam 1), timeout pe 0 - statement expression.
+#define wait_event_timeout(wq, cond, ticks)                                  \
+  ({                                                                         \
+    uint32_t __left = (ticks);                                               \
+    wait_queue_entry_t __wait;                                               \
+    init_wait_entry(&__wait, 0);                                             \
+    for (;;) {                                                               \
+      uint32_t __eflags = prepare_to_wait((wq), &__wait);                    \
+      if (cond) {                                                            \
+        finish_wait((wq), &__wait, __eflags);                                \
+        if (!__left)                                                         \
+          __left = 1;                                                        \
+        break;                                                               \
+      }                                                                      \
+      if (!__left) {                                                         \
+        finish_wait((wq), &__wait, __eflags);                                \
+        break;                                                               \
+      }                                                                      \
+      __left = schedule_timeout(__left);                                     \
+      finish_wait((wq), &__wait, __eflags);                                  \
+    }                                                                        \
+    __left;                                                                  \
+  })
+
 #endif // WAIT_QUEUE_H
@@ -1,56 +1,210 @@
 extern "C" {
 #include "../include/string.h"
+#include "../kernel/fpu.h"
+
+// Kernel ka memory core: rep movsd/stosd mid sizes ke liye (dest 4-byte
+// aligned karke), aur bade buffers (frame copy, 4MB arenas) ke liye SSE2
+// non-temporal stores jo cache ko ganda nahi karte. XMM registers user ke
+// hain, isliye SSE path kernel_fpu_begin ke andar hi chalta hai.
+#define STR_NT_THRESHOLD (256 * 1024)
+#define STR_REP_THRESHOLD 16
+
+static inline void rep_movsb(void *&d, const void *&s, uint32_t n) {
+  asm volatile("rep movsb" : "+D"(d), "+S"(s), "+c"(n) : : "memory");
+}
+
+static inline void rep_movsd(void *&d, const void *&s, uint32_t n) {
+  asm volatile("rep movsl" : "+D"(d), "+S"(s), "+c"(n) : : "memory");
+}
+
+static inline void rep_stosb(void *&d, uint32_t v, uint32_t n) {
+  asm volatile("rep stosb" : "+D"(d), "+c"(n) : "a"(v) : "memory");
+}
+
+static inline void rep_stosd(void *&d, uint32_t v, uint32_t n) {
+  asm volatile("rep stosl" : "+D"(d), "+c"(n) : "a"(v) : "memory");
+}
+
+// 64-byte blocks: unaligned loads, 16-aligned streaming stores. d aligned
+// hona chahiye.
+static void sse_copy_nt(void *&d, const void *&s, uint32_t blocks) {
+  if (!blocks)
+    return;
+  asm volatile("1:\n\t"
+               "prefetchnta 256(%1)\n\t"
+               "movdqu (%1), %%xmm0\n\t"
+               "movdqu 16(%1), %%xmm1\n\t"
+               "movdqu 32(%1), %%xmm2\n\t"
+               "movdqu 48(%1), %%xmm3\n\t"
+               "movntdq %%xmm0, (%0)\n\t"
+               "movntdq %%xmm1, 16(%0)\n\t"
+               "movntdq %%xmm2, 32(%0)\n\t"
+               "movntdq %%xmm3, 48(%0)\n\t"
+               "add $64, %1\n\t"
+               "add $64, %0\n\t"
+               "dec %2\n\t"
+               "jnz 1b\n\t"
+               "sfence"
+               : "+r"(d), "+r"(s), "+r"(blocks)
+               :
+               : "memory");
+}
+
+static void sse_set_nt(void *&d, uint32_t pattern, uint32_t blocks) {
+  if (!blocks)
+    return;
+  asm volatile("movd %2, %%xmm0\n\t"
+               "pshufd $0, %%xmm0, %%xmm0\n\t"
+               "1:\n\t"
+               "movntdq %%xmm0, (%0)\n\t"
+               "movntdq %%xmm0, 16(%0)\n\t"
+               "movntdq %%xmm0, 32(%0)\n\t"
+               "movntdq %%xmm0, 48(%0)\n\t"
+               "add $64, %0\n\t"
+               "dec %1\n\t"
+               "jnz 1b\n\t"
+               "sfence"
+               : "+r"(d), "+r"(blocks)
+               : "r"(pattern)
+               : "memory");
+}
 
 void *memcpy(void *dest, const void *src, int count) {
-  // Optimization: Copy 32-bit words if aligned
-  if (count >= 4 && ((uint32_t)dest & 3) == 0 && ((uint32_t)src & 3) == 0) {
-    uint32_t *d32 = (uint32_t *)dest;
-    const uint32_t *s32 = (const uint32_t *)src;
-    while (count >= 4) {
-      *d32++ = *s32++;
-      count -= 4;
-    }
-    dest = (void *)d32;
-    src = (const void *)s32;
-  }
+  if (count <= 0)
+    return dest;
+  void *d = dest;
+  const void *s = src;
+  uint32_t n = (uint32_t)count;
 
-  // Copy remaining bytes
-  char *dest8 = (char *)dest;
-  const char *src8 = (const char *)src;
-  while (count--) {
-    *dest8++ = *src8++;
+  if (n >= STR_NT_THRESHOLD && kernel_fpu_begin()) {
+    uint32_t head = (0 - (uint32_t)d) & 15;
+    rep_movsb(d, s, head);
+    n -= head;
+    sse_copy_nt(d, s, n >> 6);
+    kernel_fpu_end();
+    n &= 63;
+  } else if (n >= STR_REP_THRESHOLD) {
+    uint32_t head = (0 - (uint32_t)d) & 3;
+    rep_movsb(d, s, head);
+    n -= head;
+    rep_movsd(d, s, n >> 2);
+    n &= 3;
   }
+  rep_movsb(d, s, n);
   return dest;
 }
 
 void *memmove(void *dest, const void *src, int count) {
-  char *d = (char *)dest;
-  const char *s = (const char *)src;
-  if (d < s) {
-    while (count--)
-      *d++ = *s++;
-  } else {
-    char *lasts = (char *)s + (count - 1);
-    char *lastd = (char *)d + (count - 1);
-    while (count--)
-      *lastd-- = *lasts--;
+  uint8_t *d = (uint8_t *)dest;
+  const uint8_t *s = (const uint8_t *)src;
+  if (count <= 0 || d == s)
+    return dest;
+  // Aage ki taraf copy tab bhi safe hai jab dest src se pehle ho
+  if (d < s || d >= s + count)
+    return memcpy(dest, src, count);
+
+  // Overlap, dest aage: peeche se copy (DF=1). Pehle dest ka end 4-byte
+  // aligned karo, phir dwords, phir bache hue bytes.
+  uint32_t n = (uint32_t)count;
+  void *de = d + n - 1;
+  const void *se = s + n - 1;
+  if (n >= STR_REP_THRESHOLD) {
+    uint32_t tail = (uint32_t)(d + n) & 3;
+    n -= tail;
+    asm volatile("std\n\trep movsb\n\tcld"
+                 : "+D"(de), "+S"(se), "+c"(tail)
+                 :
+                 : "memory");
+    uint32_t words = n >> 2;
+    de = (uint8_t *)de - 3;
+    se = (const uint8_t *)se - 3;
+    asm volatile("std\n\trep movsl\n\tcld"
+                 : "+D"(de), "+S"(se), "+c"(words)
+                 :
+                 : "memory");
+    de = (uint8_t *)de + 3;
+    se = (const uint8_t *)se + 3;
+    n &= 3;
   }
+  asm volatile("std\n\trep movsb\n\tcld"
+               : "+D"(de), "+S"(se), "+c"(n)
+               :
+               : "memory");
   return dest;
 }
 
 void *memset(void *dest, char val, int count) {
-  char *dest8 = (char *)dest;
-  while (count--) {
-    *dest8++ = val;
+  if (count <= 0)
+    return dest;
+  void *d = dest;
+  uint32_t n = (uint32_t)count;
+  uint32_t pattern = (uint8_t)val * 0x01010101u;
+
+  if (n >= STR_NT_THRESHOLD && kernel_fpu_begin()) {
+    uint32_t head = (0 - (uint32_t)d) & 15;
+    rep_stosb(d, pattern, head);
+    n -= head;
+    sse_set_nt(d, pattern, n >> 6);
+    kernel_fpu_end();
+    n &= 63;
+  } else if (n >= STR_REP_THRESHOLD) {
+    uint32_t head = (0 - (uint32_t)d) & 3;
+    rep_stosb(d, pattern, head);
+    n -= head;
+    rep_stosd(d, pattern, n >> 2);
+    n &= 3;
   }
+  rep_stosb(d, pattern, n);
   return dest;
 }
 
+// Word-at-a-time helpers: v ke kisi byte ke 0 hone pe high bit set
+#define STR_ONES 0x01010101u
+#define STR_HIGHS 0x80808080u
+#define STR_HAS_ZERO(v) (((v) - STR_ONES) & ~(v) & STR_HIGHS)
+typedef uint32_t __attribute__((may_alias)) str_word_t;
+
 int strlen(const char *str) {
-  int len = 0;
-  while (str[len])
-    len++;
-  return len;
+  const char *p = str;
+  // Align hone tak byte-byte; uske baad aligned dword reads page cross
+  // nahi karte, isliye string ke aage padhna safe hai
+  while ((uint32_t)p & 3) {
+    if (!*p)
+      return p - str;
+    p++;
+  }
+  const str_word_t *w = (const str_word_t *)p;
+  while (!STR_HAS_ZERO(*w))
+    w++;
+  p = (const char *)w;
+  while (*p)
+    p++;
+  return p - str;
+}
+
+void *memchr(const void *s, int c, int n) {
+  const uint8_t *p = (const uint8_t *)s;
+  uint8_t ch = (uint8_t)c;
+  while (n > 0 && ((uint32_t)p & 3)) {
+    if (*p == ch)
+      return (void *)p;
+    p++;
+    n--;
+  }
+  uint32_t pattern = ch * STR_ONES;
+  while (n >= 4) {
+    uint32_t v = *(const str_word_t *)p ^ pattern;
+    if (STR_HAS_ZERO(v))
+      break;
+    p += 4;
+    n -= 4;
+  }
+  while (n-- > 0) {
+    if (*p == ch)
+      return (void *)p;
+    p++;
+  }
+  return 0;
 }
 
 // Simple itoa implementation
@@ -111,7 +265,13 @@ char *strcpy(char *dest, const char *src) {
 int memcmp(const void *s1, const void *s2, int n) {
   const unsigned char *p1 = (const unsigned char *)s1;
   const unsigned char *p2 = (const unsigned char *)s2;
-  while (n--) {
+  // Barabar dwords jaldi skip karo, pehla farak byte-level pe nikalo
+  while (n >= 4 && *(const str_word_t *)p1 == *(const str_word_t *)p2) {
+    p1 += 4;
+    p2 += 4;
+    n -= 4;
+  }
+  while (n-- > 0) {
     if (*p1 != *p2)
       return *p1 - *p2;
     p1++;